@@ -10,6 +10,10 @@
 
 #include "CAppBase.h"
 #include "../Utilities/CTimer.h"
+#include "../Utilities/CFrameAllocator.h"
+#include "../Utilities/CAllocTracker.h"
+#include "../Utilities/CProfiler.h"
+#include "../Utilities/CMetrics.h"
 
 namespace App
 {
@@ -20,7 +24,12 @@ namespace App
 
 	void CAppBase::Run()
 	{
+		Util::CAllocTracker::Instance().EndFrame();
+		Util::CAllocTracker::EndTagFrame();
+		PROFILE_FRAME();
+		Util::CFrameAllocator::Instance().Reset();
 		Util::CTimer::Instance().Tick();
+		Util::CMetrics::Instance().Update();
 	}
 
 	void CAppBase::Destroy() { }
@@ -19,7 +19,9 @@ namespace App
 	CCommandRecord::CCommandRecord() :
 		m_undoSize(0),
 		m_undoBuffer(1024 * 1024, 256, 64),
-		m_redoBuffer(1024 * 1024, 256, 64)
+		m_redoBuffer(1024 * 1024, 256, 64),
+		m_pUndoMetric(Util::CMetrics::Instance().GetGauge("commands.undoBytes")),
+		m_pRedoMetric(Util::CMetrics::Instance().GetGauge("commands.redoBytes"))
 	{
 	}
 
@@ -50,6 +52,8 @@ namespace App
 			}
 		}
 
+		PublishMetrics();
+
 		return bResult;
 	}
 	
@@ -67,6 +71,8 @@ namespace App
 
 		CCommandManager::Instance().Execute(CanUndo() ? CCommandManager::CMD_KEY_UNDO_FILL : CCommandManager::CMD_KEY_UNDO_EMPTY);
 
+		PublishMetrics();
+
 		return true;
 	}
 
@@ -143,6 +149,8 @@ namespace App
 		CCommandManager::Instance().Execute(CanUndo() ? CCommandManager::CMD_KEY_UNDO_FILL : CCommandManager::CMD_KEY_UNDO_EMPTY);
 		CCommandManager::Instance().Execute(CanRedo() ? CCommandManager::CMD_KEY_REDO_FILL : CCommandManager::CMD_KEY_REDO_EMPTY);
 
+		PublishMetrics();
+
 		return true;
 	}
 
@@ -189,6 +197,8 @@ namespace App
 		
 		CCommandManager::Instance().Execute(CanRedo() ? CCommandManager::CMD_KEY_REDO_FILL : CCommandManager::CMD_KEY_REDO_EMPTY);
 
+		PublishMetrics();
+
 		return true;
 	}
 
@@ -201,6 +211,8 @@ namespace App
 
 		CCommandManager::Instance().Execute(CCommandManager::CMD_KEY_UNDO_EMPTY);
 
+		PublishMetrics();
+
 		return true;
 	}
 
@@ -212,6 +224,8 @@ namespace App
 		
 		CCommandManager::Instance().Execute(CCommandManager::CMD_KEY_REDO_EMPTY);
 
+		PublishMetrics();
+
 		return true;
 	}
 
@@ -224,4 +238,10 @@ namespace App
 	{
 		return !m_redoBuffer.Empty() && !m_redoSizeStack.empty() && m_redoSizeStack.back() <= m_redoBuffer.Size();
 	}
+
+	void CCommandRecord::PublishMetrics()
+	{
+		m_pUndoMetric->Set(m_undoBuffer.Size());
+		m_pRedoMetric->Set(m_redoBuffer.Size());
+	}
 };
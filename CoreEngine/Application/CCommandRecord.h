@@ -12,6 +12,7 @@
 #define COMMANDRECORD_H
 
 #include "CCommandBuffer.h"
+#include "../Utilities/CMetrics.h"
 #include <vector>
 #include <stack>
 
@@ -48,6 +49,9 @@ namespace App
 		bool CanUndo() const;
 		bool CanRedo() const;
 
+	private:
+		void PublishMetrics();
+
 	private:
 		Header m_header;
 
@@ -57,6 +61,9 @@ namespace App
 
 		CCommandBuffer m_undoBuffer;
 		CCommandBuffer m_redoBuffer;
+
+		Util::CMetrics::Gauge* m_pUndoMetric;
+		Util::CMetrics::Gauge* m_pRedoMetric;
 	};
 };
 
@@ -58,7 +58,7 @@ namespace Logic
 		
 		// Inline methods.
 		inline void SetProjectionMode(CAMERA_PROJ_MODE projMode) { m_data.projMode = projMode; }
-		inline CAMERA_PROJ_MODE GetProjectionMode() { return m_data.projMode; }
+		inline CAMERA_PROJ_MODE GetProjectionMode() const { return m_data.projMode; }
 
 		inline void SetFOVDegrees(float degrees) { m_data.fov = degrees * Math::g_PiOver180; }
 		inline float GetFOVDegrees() const { return m_data.fov * Math::g_180OverPi; }
@@ -10,6 +10,11 @@
 
 #include "CNodeTransform.h"
 #include "../Application/CCoreManager.h"
+#include "../Utilities/CProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <unordered_map>
 
 namespace Logic
 {
@@ -57,16 +62,16 @@ namespace Logic
 	// Update methods.
 	//----------------------------------------------
 	
+	// Called once per dirty transform, after its parent's update, and possibly on a job thread alongside the rest of its layer.
 	void CNodeTransform::Data::Update()
 	{
-		if(!m_bDirty) { return; }
-
 		Calculate();
 
-		// Create directional vectors from this transform's world matrix.
-		m_right = m_worldMatrix.TransformNormal(Math::SIMD_VEC_RIGHT).Normalized();
-		m_up = m_worldMatrix.TransformNormal(Math::SIMD_VEC_UP).Normalized();
-		m_forward = m_worldMatrix.TransformNormal(Math::SIMD_VEC_FORWARD).Normalized();
+		// Create directional vectors from this transform's world matrix, whose columns are its axes.
+		const Math::SIMDMatrix basis = Math::SIMDMatrix::Transpose(m_worldMatrix);
+		m_right = Math::SIMDVector(basis.rows[0]).Normalized();
+		m_up = Math::SIMDVector(basis.rows[1]).Normalized();
+		m_forward = Math::SIMDVector(basis.rows[2]).Normalized();
 		
 		// Check if physics should be updated as well.
 		/*if(m_bForced && m_pObject && m_pObject->HasPhysics())
@@ -80,42 +85,28 @@ namespace Logic
 		}*/
 
 		m_bForced = false;
-		m_bDirty = false;
 	}
 	
 	void CNodeTransform::Data::Calculate()
 	{
 		if(m_parent)
 		{ // Has parent.
-			m_localMatrix = Math::SIMDMatrix::Scale(m_localScale);
-
-			const float* localEuler = m_localEuler.ToFloat();
-			m_localMatrix *= Math::SIMDMatrix::RotateZ(localEuler[2]);
-			m_localMatrix *= Math::SIMDMatrix::RotateX(localEuler[0]);
-			m_localMatrix *= Math::SIMDMatrix::RotateY(localEuler[1]);
-
-			m_localMatrix *= Math::SIMDMatrix::Translate(m_localPosition);
+			const Data& parent = GetTransform(m_parent);
+			m_localMatrix = Math::SIMDMatrix::ScaleRotateTranslate(m_localScale, m_localEuler, m_localPosition);
 
 			// Update world transforms.
-			m_position = GetTransform(m_parent).GetPosition() + m_localPosition;
+			m_position = parent.GetPosition() + m_localPosition;
 
-			m_euler = GetTransform(m_parent).GetEuler() + m_localEuler;
-			m_rotation.RotateEuler(m_euler);
+			m_euler = parent.GetEuler() + m_localEuler;
+			m_rotation = m_rotation.RotateEuler(m_euler);
 
-			m_scale = Math::SIMDVector::PointwiseProduct(GetTransform(m_parent).GetScale(), m_localScale);
+			m_scale = Math::SIMDVector::PointwiseProduct(parent.GetScale(), m_localScale);
 
-			m_worldMatrix = m_localMatrix * GetTransform(m_parent).m_worldMatrix;
+			m_worldMatrix = m_localMatrix * parent.m_worldMatrix;
 		}
 		else
 		{ // At root.
-			m_worldMatrix = Math::SIMDMatrix::Scale(m_scale);
-
-			const float* euler = m_euler.ToFloat();
-			m_worldMatrix *= Math::SIMDMatrix::RotateZ(euler[2]);
-			m_worldMatrix *= Math::SIMDMatrix::RotateX(euler[0]);
-			m_worldMatrix *= Math::SIMDMatrix::RotateY(euler[1]);
-
-			m_worldMatrix *= Math::SIMDMatrix::Translate(m_position);
+			m_worldMatrix = Math::SIMDMatrix::ScaleRotateTranslate(m_scale, m_euler, m_position);
 			m_localMatrix = m_worldMatrix;
 		}
 	}
@@ -130,11 +121,22 @@ namespace Logic
 		Get().QueueTransform(*this);
 	}
 
+	// Keeps every descendant below its parent's layer, so layers can be updated in order.
+	void CNodeTransform::Data::RefreshLayer()
+	{
+		for(u32 child : m_children)
+		{
+			Data& childRef = GetTransform(child);
+			childRef.m_layer = m_layer + 1;
+			childRef.RefreshLayer();
+		}
+	}
+
 	//----------------------------------------------
 	// Family methods.
 	//----------------------------------------------
 	
-	void CNodeTransform::Data::SetParent(u64 parent)
+	void CNodeTransform::Data::SetParent(u32 parent)
 	{
 		if(parent == m_parent) return;
 
@@ -158,14 +160,7 @@ namespace Logic
 			m_localScale = Math::SIMDVector::PointwiseQuotient(m_scale, parentRef.GetScale());
 			
 			// Calculate new local matrix.
-			m_localMatrix = Math::SIMDMatrix::Scale(m_localScale);
-
-			const float* localEuler = m_localEuler.ToFloat();
-			m_localMatrix *= Math::SIMDMatrix::RotateZ(localEuler[2]);
-			m_localMatrix *= Math::SIMDMatrix::RotateX(localEuler[0]);
-			m_localMatrix *= Math::SIMDMatrix::RotateY(localEuler[1]);
-
-			m_localMatrix *= Math::SIMDMatrix::Translate(m_localPosition);
+			m_localMatrix = Math::SIMDMatrix::ScaleRotateTranslate(m_localScale, m_localEuler, m_localPosition);
 		}
 		else
 		{
@@ -177,9 +172,11 @@ namespace Logic
 			m_localScale = m_scale;
 			m_localMatrix = m_worldMatrix;
 		}
+
+		RefreshLayer();
 	}
 
-	void CNodeTransform::Data::RemoveChild(u64 child)
+	void CNodeTransform::Data::RemoveChild(u32 child)
 	{
 		size_t i, j;
 		for(i = 0, j = 0; i < m_children.size(); ++i)
@@ -408,20 +405,41 @@ namespace Logic
 		App::CCoreManager::Instance().NodeRegistry().RegisterComponent<CNodeTransform>();
 	}
 	
+	// Layers are updated in order, so parents are always up to date before their children read them.
 	void CNodeTransform::Update()
 	{
-		for(size_t i = 0; i < m_maxLayer; ++i)
+		PROFILE_ZONE("CNodeTransform::Update");
+
+		for(u32 layer = 0; layer < m_maxLayer; ++layer)
 		{
-			while(!m_queueList[i].empty())
-			{
-				GetTransform(m_queueList[i].front()).Update();
-				m_queueList[i].pop();
-			}
+			UpdateLayer(layer);
 		}
 
 		m_maxLayer = 0;
 	}
 	
+	//---------------------------------------------
+	// Schedule methods.
+	//---------------------------------------------
+
+	// Transforms only ever read their own parents.
+	void CNodeTransform::DeclareAccess(NODE_PHASE phase, NodeAccess& access) const
+	{
+		access.Declare();
+	}
+
+	u64 CNodeTransform::GetDataDigest() const
+	{
+		u64 digest = Math::FNV1a_64_OFFSET;
+		for(const Data& data : m_pool)
+		{ // Directions through the world matrix are declared in one run, so they're digested as one.
+			const char* pStart = reinterpret_cast<const char*>(&data.m_right);
+			digest = Math::FNV1a_64(digest, pStart, reinterpret_cast<const char*>(&data.m_worldMatrix + 1) - pStart);
+		}
+
+		return digest;
+	}
+
 	//---------------------------------------------
 	// Utility methods.
 	//---------------------------------------------
@@ -430,38 +448,283 @@ namespace Logic
 	{
 		m_maxLayer = std::max(m_maxLayer, transform.m_layer + 1);
 
-		while(m_queueList.size() <= m_maxLayer - 1)
+		while(m_layerList.size() <= m_maxLayer - 1)
 		{
-			m_queueList.push_back(std::queue<u64>());
+			m_layerList.push_back(std::vector<u32>());
 		}
 
-		m_queueList[transform.m_layer].push(transform.m_this);
+		m_layerList[transform.m_layer].push_back(transform.m_this);
+	}
+
+	void CNodeTransform::UpdateLayer(u32 layer)
+	{
+		// Claim each dirty transform once. Ids removed since they were queued are dropped, and transforms reparented deeper are passed on.
+		u32 count = 0;
+		for(size_t i = 0; i < m_layerList[layer].size(); ++i)
+		{
+			const u32 id = m_layerList[layer][i];
+			if(!m_pool.Contains(id)) continue;
+
+			Data& data = m_pool[id];
+			if(!data.m_bDirty) continue;
+
+			if(data.m_layer > layer)
+			{
+				QueueTransform(data);
+				continue;
+			}
+
+			data.m_bDirty = false;
+			m_layerList[layer][count++] = id;
+		}
+
+		m_layerList[layer].resize(count);
+
+		// Transforms in a layer only read their parents, which are done, so the layer can be split freely.
+		const std::vector<u32>& idList = m_layerList[layer];
+		auto UpdateRange = [this, &idList](u32 start, u32 end){
+			for(u32 i = start; i < end; ++i)
+			{
+				m_pool[idList[i]].Update();
+			}
+		};
+
+		if(m_parallelFor && count > BATCH_SIZE)
+		{
+			m_parallelFor(count, BATCH_SIZE, UpdateRange);
+		}
+		else
+		{
+			UpdateRange(0, count);
+		}
+
+		// Children follow their parents, and are queued a layer down.
+		for(u32 i = 0; i < count; ++i)
+		{
+			for(u32 child : m_pool[m_layerList[layer][i]].m_children)
+			{
+				m_pool[child].SetAsDirty(false);
+			}
+		}
+
+		m_layerList[layer].clear();
 	}
 	
 	//---------------------------------------------
 	// Object methods.
 	//---------------------------------------------
 	
-	void* CNodeTransform::AddToObject(u64 objHash)
+	void* CNodeTransform::AddToObject(ObjectHandle handle)
 	{
-		return &m_dataMap.insert({ objHash, Data(objHash) }).first->second;
+		u32 id = m_pool.Find(handle);
+		if(id == CNodePool<Data>::NONE)
+		{
+			id = m_pool.Add(handle, handle.index);
+		}
+
+		return &m_pool[id];
 	}
 	
-	void* CNodeTransform::GetFromObject(u64 objHash)
+	void* CNodeTransform::GetFromObject(ObjectHandle handle)
 	{
-		return &m_dataMap.find(objHash)->second;
+		return &m_pool[m_pool.Find(handle)];
 	}
 
-	bool CNodeTransform::TryToGetFromObject(u64 objHash, void** ppData)
+	bool CNodeTransform::TryToGetFromObject(ObjectHandle handle, void** ppData)
 	{
-		auto elem = m_dataMap.find(objHash);
-		if(elem == m_dataMap.end()) return false;
-		*ppData = &elem->second;
+		const u32 id = m_pool.Find(handle);
+		if(id == CNodePool<Data>::NONE) return false;
+		*ppData = &m_pool[id];
 		return true;
 	}
 
-	void CNodeTransform::RemoveFromObject(u64 objHash)
+	// Children are left at the root, where they are, rather than pointing at a recycled id.
+	void CNodeTransform::RemoveFromObject(ObjectHandle handle)
 	{
-		m_dataMap.erase(objHash);
+		const u32 id = m_pool.Find(handle);
+		if(id == CNodePool<Data>::NONE) return;
+
+		const std::vector<u32> children = m_pool[id].m_children;
+		for(u32 child : children)
+		{
+			GetTransform(child).SetParent(0);
+		}
+
+		GetTransform(id).SetParent(0);
+		m_pool.Remove(id);
+	}
+
+	//---------------------------------------------
+	// Benchmark methods.
+	//---------------------------------------------
+
+	// Both stores are built from the same objects, issued handles for the run, and every pass folds positions into a sum so none of the work
+	//  can be skipped.
+	CNodeTransform::StorageBenchmark CNodeTransform::BenchmarkStorage(u32 objectCount, u32 iterationCount)
+	{
+		StorageBenchmark benchmark { };
+		benchmark.objectCount = objectCount;
+		if(objectCount == 0 || iterationCount == 0) return benchmark;
+
+		std::mt19937_64 random(objectCount);
+		std::vector<u64> keyList(objectCount);
+		std::vector<ObjectHandle> handleList(objectCount);
+		for(u32 i = 0; i < objectCount; ++i)
+		{
+			do
+			{
+				keyList[i] = random();
+			} while(!CObjectTable::Instance().Find(keyList[i]).IsNull());
+
+			handleList[i] = CObjectTable::Instance().Issue(keyList[i]);
+		}
+
+		std::unordered_map<u64, Data> dataMap;
+		dataMap.reserve(objectCount);
+
+		CNodePool<Data> pool;
+		pool.Reserve(objectCount);
+
+		std::vector<u32> idList(objectCount);
+		for(u32 i = 0; i < objectCount; ++i)
+		{
+			const Math::SIMDVector position(static_cast<float>(i), 0.0f, 0.0f);
+
+			dataMap.insert({ keyList[i], Data(0) }).first->second.m_position = position;
+			idList[i] = pool.Add(handleList[i], handleList[i].index);
+			pool[idList[i]].m_position = position;
+		}
+
+		// Shuffle both lists the same way, so lookups don't follow insertion order.
+		std::vector<u32> orderList(objectCount);
+		for(u32 i = 0; i < objectCount; ++i)
+		{
+			orderList[i] = i;
+		}
+
+		std::shuffle(orderList.begin(), orderList.end(), random);
+
+		float sum = 0.0f;
+		auto Measure = [iterationCount](auto&& func){
+			const auto start = std::chrono::steady_clock::now();
+			for(u32 iteration = 0; iteration < iterationCount; ++iteration)
+			{
+				func();
+			}
+
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / static_cast<float>(iterationCount);
+		};
+
+		benchmark.mapLookupTime = Measure([&](){
+			for(u32 i : orderList)
+			{
+				sum += dataMap.find(keyList[i])->second.m_position.ToFloat()[0];
+			}
+		});
+
+		benchmark.poolLookupTime = Measure([&](){
+			for(u32 i : orderList)
+			{
+				sum += pool[idList[i]].m_position.ToFloat()[0];
+			}
+		});
+
+		benchmark.poolHandleLookupTime = Measure([&](){
+			for(u32 i : orderList)
+			{
+				sum += pool[pool.Find(handleList[i])].m_position.ToFloat()[0];
+			}
+		});
+
+		benchmark.mapIterateTime = Measure([&](){
+			for(const auto& elem : dataMap)
+			{
+				sum += elem.second.m_position.ToFloat()[0];
+			}
+		});
+
+		benchmark.poolIterateTime = Measure([&](){
+			for(const Data& data : pool)
+			{
+				sum += data.m_position.ToFloat()[0];
+			}
+		});
+
+		for(const ObjectHandle& handle : handleList)
+		{
+			CObjectTable::Instance().Retire(handle);
+		}
+
+		// Keep the sum observable.
+		if(sum < 0.0f) benchmark.objectCount = 0;
+
+		return benchmark;
+	}
+
+	// The chains are built in this component's own pool, since transforms resolve their parents through it, and are removed afterwards.
+	//  Any transforms already dirty are updated along with the first frame.
+	CNodeTransform::HierarchyBenchmark CNodeTransform::BenchmarkHierarchy(u32 objectCount, u32 depth, u32 iterationCount)
+	{
+		HierarchyBenchmark benchmark { };
+		benchmark.objectCount = objectCount;
+		benchmark.layerCount = std::max(depth, 1U);
+		if(objectCount == 0 || iterationCount == 0) return benchmark;
+
+		// Node i is the child of node i - rootCount, so every chain is 'depth' transforms long.
+		const u32 rootCount = (objectCount + benchmark.layerCount - 1) / benchmark.layerCount;
+
+		std::mt19937_64 random(objectCount);
+		std::vector<ObjectHandle> handleList;
+		std::vector<u32> idList;
+		handleList.reserve(objectCount);
+		idList.reserve(objectCount);
+
+		while(idList.size() < objectCount)
+		{
+			const u64 key = random();
+			if(!CObjectTable::Instance().Find(key).IsNull()) continue;
+
+			const ObjectHandle handle = CObjectTable::Instance().Issue(key);
+			const u32 id = m_pool.Add(handle, handle.index);
+			handleList.push_back(handle);
+			if(idList.size() >= rootCount)
+			{
+				m_pool[id].SetParent(idList[idList.size() - rootCount]);
+			}
+
+			idList.push_back(id);
+		}
+
+		auto Measure = [&](bool bParallel){
+			const ParallelForFunc parallelFor = m_parallelFor;
+			if(!bParallel) m_parallelFor = nullptr;
+
+			const auto start = std::chrono::steady_clock::now();
+			for(u32 iteration = 0; iteration < iterationCount; ++iteration)
+			{
+				const Math::SIMDVector position(static_cast<float>(iteration), 0.0f, 0.0f);
+				for(u32 i = 0; i < rootCount; ++i)
+				{
+					m_pool[idList[i]].SetPosition(position);
+				}
+
+				Update();
+			}
+
+			m_parallelFor = parallelFor;
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / static_cast<float>(iterationCount);
+		};
+
+		benchmark.serialTime = Measure(false);
+		benchmark.parallelTime = Measure(true);
+
+		// Deepest first, so no children are left to reparent.
+		for(u32 i = objectCount; i-- > 0;)
+		{
+			RemoveFromObject(handleList[i]);
+			CObjectTable::Instance().Retire(handleList[i]);
+		}
+
+		return benchmark;
 	}
 };
@@ -12,13 +12,13 @@
 #define CNODETRANSFORM_H
 
 #include "../Objects/CNodeComponent.h"
+#include "../Objects/CNodePool.h"
 #include "../Math/CMathFNV.h"
 #include "../Math/CSIMDMatrix.h"
 #include "../Utilities/CMemAlign.h"
 #include "../Utilities/CMacroUtil.h"
+#include <functional>
 #include <vector>
-#include <queue>
-#include <unordered_map>
 
 class CNodeObject;
 
@@ -40,6 +40,30 @@ namespace Logic
 	public:
 		static const u32 HASH = Math::FNV1a_32(L"Data");
 
+		// Lookup and iteration cost of 'objectCount' transforms in a hash map keyed by object, against the pool, averaged over the iterations run.
+		struct StorageBenchmark
+		{
+			float mapLookupTime; // Milliseconds to look up every transform, in a shuffled order.
+			float poolLookupTime; // The same, by pool id.
+			float poolHandleLookupTime; // The same, by object handle, with its generation checked.
+			float mapIterateTime; // Milliseconds to visit every transform.
+			float poolIterateTime;
+			u32 objectCount;
+		};
+
+		// Time to update 'objectCount' transforms in chains 'depth' deep, every root moved each frame, averaged over the iterations run.
+		struct HierarchyBenchmark
+		{
+			float serialTime; // Milliseconds per frame, with every layer updated on the calling thread.
+			float parallelTime; // Milliseconds per frame, with layers split across the parallel for.
+			u32 objectCount;
+			u32 layerCount;
+		};
+
+		// Runs func over batches of [0, count), and returns once all of them are done. Core Engine has no job system of its own, so the
+		//  application supplies one. Without it, every layer is updated on the calling thread.
+		typedef std::function<void(u32 count, u32 batchSize, std::function<void(u32, u32)> func)> ParallelForFunc;
+
 	public:
 		struct Data : public CMemAlign<16>
 		{
@@ -47,7 +71,7 @@ namespace Logic
 			friend class CNodeTransform;
 
 		public:
-			Data(u64 thisHash) : m_this(thisHash) { Reset(); }
+			Data(u32 thisId) : m_this(thisId) { Reset(); }
 			~Data() { }
 			Data(const Data&) = default;
 			Data(Data&&) = default;
@@ -60,9 +84,10 @@ namespace Logic
 			void Update();
 			void Calculate();
 			void SetAsDirty(bool bForced);
+			void RefreshLayer();
 
-			void SetParent(u64 parent);
-			void RemoveChild(u64 child);
+			void SetParent(u32 parent);
+			void RemoveChild(u32 child);
 
 		public:
 			inline bool IsValid() const { return !m_bForced; }
@@ -139,9 +164,10 @@ namespace Logic
 			Math::SIMDMatrix m_localMatrix;
 			Math::SIMDMatrix m_worldMatrix;
 
-			std::vector<u64> m_children;
-			u64 m_parent = 0;
-			u64 m_this = 0;
+			// Pool ids.
+			std::vector<u32> m_children;
+			u32 m_parent = 0;
+			u32 m_this = 0;
 		};
 
 	public:
@@ -155,24 +181,38 @@ namespace Logic
 		static CNodeTransform& Get() { static CNodeTransform comp; return comp; }
 		void Register();
 		void Update() final;
+
+		inline void SetParallelFor(ParallelForFunc parallelFor) { m_parallelFor = parallelFor; }
+
+		static StorageBenchmark BenchmarkStorage(u32 objectCount, u32 iterationCount);
+		HierarchyBenchmark BenchmarkHierarchy(u32 objectCount, u32 depth, u32 iterationCount);
 		
 	private:
+		void DeclareAccess(NODE_PHASE phase, NodeAccess& access) const final;
+		u64 GetDataDigest() const final;
+
 		void QueueTransform(const Data& transform);
+		void UpdateLayer(u32 layer);
 
-		void* AddToObject(u64 objHash) final;
-		void* GetFromObject(u64 objHash) final;
-		bool TryToGetFromObject(u64 objHash, void** ppData) final;
-		void RemoveFromObject(u64 objHash) final;
+		void* AddToObject(ObjectHandle handle) final;
+		void* GetFromObject(ObjectHandle handle) final;
+		bool TryToGetFromObject(ObjectHandle handle, void** ppData) final;
+		void RemoveFromObject(ObjectHandle handle) final;
 
 	private:
 		// Accessors.
-		static Data& GetTransform(u64 hash) { return Get().m_dataMap.find(hash)->second; }
+		static Data& GetTransform(u32 id) { return Get().m_pool[id]; }
+
+	private:
+		static constexpr u32 BATCH_SIZE = 64;
 
 	private:
 		u32 m_maxLayer;
 
-		std::unordered_map<u64, Data> m_dataMap;
-		std::vector<std::queue<u64>> m_queueList;
+		CNodePool<Data> m_pool;
+		std::vector<std::vector<u32>> m_layerList; // Dirty ids by depth.
+
+		ParallelForFunc m_parallelFor;
 	};
 };
 
@@ -121,6 +121,19 @@ namespace Math
 	{
 		return FNV1a_64(str, std::char_traits<char32_t>::length(str));
 	}
+
+	// Raw bytes, continuing from a previous hash. Lets a key be built up from several buffers, starting from FNV1a_64_OFFSET.
+	constexpr u64 FNV1a_64_OFFSET = 0xcbf29ce484222325;
+
+	inline u64 FNV1a_64(u64 hash, const void* pData, size_t sz)
+	{
+		const u8* pBytes = reinterpret_cast<const u8*>(pData);
+		for(size_t i = 0; i < sz; ++i)
+		{
+			hash = hash ^ pBytes[i];
+			hash *= 0x100000001B3;
+		} return hash;
+	}
 };
 
 #endif
@@ -198,6 +198,30 @@ namespace Math
 		return mtx;
 	}
 
+	SIMDMatrix SIMDMatrix::ScaleRotateTranslate(const SIMDVector& scale, const SIMDVector& euler, const SIMDVector& position)
+	{
+		const float* e = euler.ToFloat();
+		const float* p = position.ToFloat();
+
+		const float sx = sinf(e[0]);
+		const float cx = cosf(e[0]);
+		const float sy = sinf(e[1]);
+		const float cy = cosf(e[1]);
+		const float sz = sinf(e[2]);
+		const float cz = cosf(e[2]);
+
+		// Rotation columns are scaled, and the translation fills the last column.
+		const vf32 s = _mm_or_ps(_mm_and_ps(scale.m_xmm, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))), _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+
+		SIMDMatrix mtx;
+		mtx.rows[0] = _mm_mul_ps(_mm_setr_ps(cy * cz - sy * sx * sz, cy * sz + sy * sx * cz, -sy * cx, p[0]), s);
+		mtx.rows[1] = _mm_mul_ps(_mm_setr_ps(-cx * sz, cx * cz, sx, p[1]), s);
+		mtx.rows[2] = _mm_mul_ps(_mm_setr_ps(sy * cz + cy * sx * sz, sy * sz - cy * sx * cz, cy * cx, p[2]), s);
+		mtx.rows[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+		return mtx;
+	}
+
 	// General methods.
 	void SIMDMatrix::ToIdentity()
 	{
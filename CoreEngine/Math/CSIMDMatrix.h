@@ -67,6 +67,9 @@ namespace Math
 		static SIMDMatrix RotateZ(float theta);
 		static SIMDMatrix Scale(const SIMDVector& scale);
 
+		// Scale(scale) * RotateZ(z) * RotateX(x) * RotateY(y) * Translate(position), built in place rather than through four products.
+		static SIMDMatrix ScaleRotateTranslate(const SIMDVector& scale, const SIMDVector& euler, const SIMDVector& position);
+
 		// General methods.
 		void ToIdentity();
 		void Transpose();
@@ -13,24 +13,30 @@
 
 #include "../Globals/CGlobals.h"
 #include <algorithm>
-#include <functional>
 #include <mutex>
-#include <unordered_set>
+#include <vector>
 
+// Elements live in pages that never move, so a reference stays valid for as long as its element is pulled. Free slots are chained through
+//  the slots themselves, and live elements are kept as a dense list that freeing swaps the last entry into, so an update only ever visits
+//  live elements.
+// Pulls from other threads are queued under their own lock, and join the live list at the start of the next update, so they never wait on
+//  one in flight. Frees do wait, as the update may be running the element being freed.
 template<typename T>
 class CCompBatch
 {
 public:
+	struct Slot;
+
 	class CRef
 	{
 	public:
 		friend CCompBatch;
 
 	public:
-		CRef() : index(0), pRef(nullptr) { }
+		CRef() : pSlot(nullptr), pRef(nullptr) { }
 
 	private:
-		u32 index;
+		Slot* pSlot;
 
 	public:
 		T* pRef;
@@ -38,24 +44,15 @@ public:
 
 	struct Slot
 	{
+		static constexpr u32 PENDING = 0xFFFFFFFF;
+
 		T elem;
-		CRef* pSlotRef = nullptr;
-
-		void UpdateRef(u32 index, CRef* pSlotRef)
-		{
-			this->pSlotRef = pSlotRef;
-			this->pSlotRef->index = index;
-			this->pSlotRef->pRef = &elem;
-		}
-
-		void Reset()
-		{
-			pSlotRef = nullptr;
-		}
+		u32 aliveIndex = PENDING; // Index into the live list, or PENDING until the next update takes it in.
+		Slot* pNextFree = nullptr;
 	};
 
 public:
-	CCompBatch(u32 allocSize, u32 defragSteps);
+	CCompBatch(u32 allocSize);
 	~CCompBatch();
 	CCompBatch(const CCompBatch&) = delete;
 	CCompBatch(CCompBatch&&) = delete;
@@ -69,24 +66,29 @@ public:
 	void Pull(CRef* pRef, const class CVObject* pObject);
 	void Free(CRef* pRef);
 
+	// Accessors.
+	inline u32 GetAliveCount() const { return static_cast<u32>(m_aliveList.size()); }
+
 private:
-	void UpdateElements(std::function<void(T&)> func);
+	void TakePending();
 
 	void Allocate(u32 allocSize);
-	void Defragment(u32 steps);
+	void ChainFree(Slot* pSlotList, u32 count);
 
 private:
-	mutable std::mutex m_mutex;
+	mutable std::mutex m_mutex; // Held by updates and frees.
+	mutable std::mutex m_queueMutex; // Held briefly for the free chain, the pages, and pending pulls.
 
 	u8 m_frame;
 
 	u32 m_allocSize;
-	u32 m_size;
-	u32 m_defragSteps;
-	u32 m_defragIndex;
+	u32 m_capacity;
+
+	std::vector<Slot*> m_aliveList;
+	std::vector<Slot*> m_pendingList;
 
-	Slot* m_pSlotList;
-	std::unordered_set<u32> m_freeSet;
+	Slot* m_pFreeList;
+	std::vector<std::pair<Slot*, u32>> m_pageList;
 };
 
 #include "CCompBatch.hpp"
@@ -11,15 +11,13 @@
 #include "CCompBatch.h"
 
 template<typename T>
-CCompBatch<T>::CCompBatch(u32 allocSize, u32 defragSteps) :
+CCompBatch<T>::CCompBatch(u32 allocSize) :
 	m_frame(0),
-	m_allocSize(0),
-	m_size(0),
-	m_defragSteps(defragSteps),
-	m_defragIndex(0),
-	m_pSlotList(nullptr)
+	m_allocSize(std::max(allocSize, 1U)),
+	m_capacity(0),
+	m_pFreeList(nullptr)
 {
-	Allocate(allocSize);
+	Allocate(m_allocSize);
 }
 
 template<typename T>
@@ -30,31 +28,46 @@ void CCompBatch<T>::Update()
 {
 	std::lock_guard<std::mutex> lk(m_mutex);
 
-	Defragment(m_defragSteps);
+	TakePending();
+
+	for(Slot* pSlot : m_aliveList)
+	{
+		pSlot->elem.TryUpdate(m_frame);
+	}
 
-	UpdateElements([this](T& elem) { elem.TryUpdate(m_frame); });
 	m_frame ^= 0x1;
 }
 
 template<typename T>
-void CCompBatch<T>::UpdateElements(std::function<void(T&)> func)
+void CCompBatch<T>::TakePending()
 {
-	for(u32 i = 0; i < m_size; ++i)
+	std::lock_guard<std::mutex> lkQueue(m_queueMutex);
+
+	for(Slot* pSlot : m_pendingList)
 	{
-		if(m_pSlotList[i].pSlotRef == nullptr) { continue; }
-		func(m_pSlotList[i].elem);
+		pSlot->aliveIndex = static_cast<u32>(m_aliveList.size());
+		m_aliveList.push_back(pSlot);
 	}
+
+	m_pendingList.clear();
 }
 
 template<typename T>
 void CCompBatch<T>::Release()
 {
 	std::lock_guard<std::mutex> lk(m_mutex);
+	std::lock_guard<std::mutex> lkQueue(m_queueMutex);
 
-	delete[] m_pSlotList;
-	m_pSlotList = nullptr;
-	m_size = m_allocSize = 0;
-	m_freeSet.clear();
+	for(auto& page : m_pageList)
+	{
+		delete[] page.first;
+	}
+
+	m_pageList.clear();
+	m_aliveList.clear();
+	m_pendingList.clear();
+	m_pFreeList = nullptr;
+	m_capacity = 0;
 	m_frame = 0;
 }
 
@@ -62,30 +75,48 @@ template<typename T>
 void CCompBatch<T>::Clear()
 {
 	std::lock_guard<std::mutex> lk(m_mutex);
+	std::lock_guard<std::mutex> lkQueue(m_queueMutex);
+
+	m_aliveList.clear();
+	m_pendingList.clear();
+	m_pFreeList = nullptr;
+
+	for(auto& page : m_pageList)
+	{
+		ChainFree(page.first, page.second);
+	}
 
-	m_size = 0;
-	m_freeSet.clear();
 	m_frame = 0;
 }
 
 template<typename T>
 void CCompBatch<T>::Pull(CRef* pRef, const class CVObject* pObject)
 {
-	std::lock_guard<std::mutex> lk(m_mutex);
+	Slot* pSlot;
 
-	if(m_freeSet.empty())
 	{
-		Allocate(m_allocSize << 1);
+		std::lock_guard<std::mutex> lkQueue(m_queueMutex);
+
+		if(m_pFreeList == nullptr)
+		{
+			Allocate(m_capacity);
+		}
+
+		pSlot = m_pFreeList;
+		m_pFreeList = pSlot->pNextFree;
+		pSlot->pNextFree = nullptr;
 	}
 
-	{
-		u32 index = *m_freeSet.begin();
-		m_freeSet.erase(index);
+	// The slot is off the free chain and not yet pending, so nothing else can reach it until it's queued.
+	pSlot->aliveIndex = Slot::PENDING;
+	pRef->pSlot = pSlot;
+	pRef->pRef = &pSlot->elem;
+	pRef->pRef->Reset();
+	pRef->pRef->SetObject(pObject, pRef);
 
-		m_size = std::max(m_size, index + 1);
-		m_pSlotList[index].UpdateRef(index, pRef);
-		pRef->pRef->Reset();
-		pRef->pRef->SetObject(pObject, pRef);
+	{
+		std::lock_guard<std::mutex> lkQueue(m_queueMutex);
+		m_pendingList.push_back(pSlot);
 	}
 }
 
@@ -96,78 +127,53 @@ void CCompBatch<T>::Free(CRef* pRef)
 
 	std::lock_guard<std::mutex> lk(m_mutex);
 
-	m_freeSet.insert(pRef->index);
+	Slot* pSlot = pRef->pSlot;
 	pRef->pRef->SetObject(nullptr, nullptr);
 	pRef->pRef = nullptr;
-	m_defragIndex = std::min(m_defragIndex, pRef->index);
-
-	m_pSlotList[pRef->index].Reset();
-}
+	pRef->pSlot = nullptr;
 
-template<typename T>
-void CCompBatch<T>::Allocate(u32 allocSize)
-{
-	Slot* pSlotList = new Slot[allocSize];
+	std::lock_guard<std::mutex> lkQueue(m_queueMutex);
 
-	if(m_pSlotList != nullptr)
+	if(pSlot->aliveIndex == Slot::PENDING)
 	{
-		u32 j = 0;
-		for(u32 i = 0; i < m_size; ++i)
-		{
-			if(m_pSlotList[i].pSlotRef == nullptr) { continue; }
-			pSlotList[j].elem = std::move(m_pSlotList[i].elem);
-			pSlotList[j].UpdateRef(j, m_pSlotList[i].pSlotRef);
-			++j;
-		}
-
-		m_size = j;
-		delete[] m_pSlotList;
-		m_freeSet.clear();
+		auto elem = std::find(m_pendingList.begin(), m_pendingList.end(), pSlot);
+		*elem = m_pendingList.back();
+		m_pendingList.pop_back();
 	}
 	else
 	{
-		m_size = 0;
+		Slot* pLast = m_aliveList.back();
+		m_aliveList[pSlot->aliveIndex] = pLast;
+		pLast->aliveIndex = pSlot->aliveIndex;
+		m_aliveList.pop_back();
 	}
 
-	m_pSlotList = pSlotList;
-	m_allocSize = allocSize;
+	pSlot->aliveIndex = Slot::PENDING;
+	pSlot->pNextFree = m_pFreeList;
+	m_pFreeList = pSlot;
+}
 
-	for(u32 i = m_size; i < m_allocSize; ++i)
-	{
-		m_freeSet.insert(i);
-	}
+// Adds a page, doubling capacity each time. Called with the queue lock held, or during construction.
+template<typename T>
+void CCompBatch<T>::Allocate(u32 allocSize)
+{
+	allocSize = std::max(allocSize, m_allocSize);
+
+	Slot* pSlotList = new Slot[allocSize];
+	m_pageList.push_back({ pSlotList, allocSize });
+	m_capacity += allocSize;
+
+	ChainFree(pSlotList, allocSize);
 }
 
+// Pushes a run of slots onto the free chain so they're handed out in order.
 template<typename T>
-void CCompBatch<T>::Defragment(u32 steps)
+void CCompBatch<T>::ChainFree(Slot* pSlotList, u32 count)
 {
-	for(u32 i = m_defragIndex; i < m_size; ++i)
+	for(u32 i = count; i-- > 0;)
 	{
-		if(m_pSlotList[i].pSlotRef == nullptr) { continue; }
-		if(m_defragIndex < i)
-		{
-			m_freeSet.erase(m_defragIndex);
-			m_freeSet.insert(i);
-
-			m_pSlotList[m_defragIndex].elem = std::move(m_pSlotList[i].elem);
-			m_pSlotList[m_defragIndex].UpdateRef(m_defragIndex, m_pSlotList[i].pSlotRef);
-			m_pSlotList[i].Reset();
-
-			while(m_defragIndex < i && m_pSlotList[m_defragIndex].pSlotRef) 
-			{
-				++m_defragIndex;
-			}
-
-			if(steps != 0 && --steps == 0)
-			{
-				return;
-			}
-		}
-		else
-		{
-			++m_defragIndex;
-		}
+		pSlotList[i].aliveIndex = Slot::PENDING;
+		pSlotList[i].pNextFree = m_pFreeList;
+		m_pFreeList = &pSlotList[i];
 	}
-
-	m_size = m_defragIndex;
 }
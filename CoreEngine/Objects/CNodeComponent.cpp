@@ -23,20 +23,20 @@ CNodeComponent::~CNodeComponent()
 
 void* CNodeComponent::AddToObject(CNodeObject* pObject)
 {
-	return AddToObject(pObject->GetHash());
+	return AddToObject(pObject->GetHandle());
 }
 
 void* CNodeComponent::GetFromObject(const CNodeObject* pObject)
 {
-	return GetFromObject(pObject->GetHash());
+	return GetFromObject(pObject->GetHandle());
 }
 
 bool CNodeComponent::TryToGetFromObject(const CNodeObject* pObject, void** ppData)
 {
-	return TryToGetFromObject(pObject->GetHash(), ppData);
+	return TryToGetFromObject(pObject->GetHandle(), ppData);
 }
 
 void CNodeComponent::RemoveFromObject(CNodeObject* pObject)
 {
-	RemoveFromObject(pObject->GetHash());
+	RemoveFromObject(pObject->GetHandle());
 }
@@ -11,11 +11,36 @@
 #ifndef CNODECOMPONENT_H
 #define CNODECOMPONENT_H
 
+#include "CObjectTable.h"
 #include "../Globals/CGlobals.h"
 #include "../Math/CMathRect.h"
+#include <algorithm>
+#include <vector>
 
 class CNodeObject;
 
+enum NODE_PHASE : u8
+{
+	NODE_PHASE_UPDATE,
+	NODE_PHASE_LATE_UPDATE,
+	NODE_PHASE_COUNT,
+};
+
+// The other components whose data a component touches during a phase, by HASH. A component's own data always counts as written.
+struct NodeAccess
+{
+	bool bDeclared = false;
+	std::vector<u32> readList;
+	std::vector<u32> writeList;
+
+	inline void Declare() { bDeclared = true; }
+	inline void Read(u32 hash) { bDeclared = true; readList.push_back(hash); }
+	inline void Write(u32 hash) { bDeclared = true; writeList.push_back(hash); }
+	
+	inline bool Reads(u32 hash) const { return Writes(hash) || std::find(readList.begin(), readList.end(), hash) != readList.end(); }
+	inline bool Writes(u32 hash) const { return std::find(writeList.begin(), writeList.end(), hash) != writeList.end(); }
+};
+
 class CNodeComponent
 {
 public:
@@ -39,15 +64,21 @@ protected:
 	virtual void OnMove(const Math::Rect& rect) { }
 	virtual void OnResize(const Math::Rect& rect) { }
 
+	// Used by the registry's phase scheduler. Components that leave their access undeclared update alone, in registration order.
+	virtual void DeclareAccess(NODE_PHASE phase, NodeAccess& access) const { }
+
+	// A digest of this component's data, so the scheduler's debug mode can catch writes that weren't declared. Zero if it can't be taken.
+	virtual u64 GetDataDigest() const { return 0; }
+
 	virtual void* AddToObject(CNodeObject* pObject);
 	virtual void* GetFromObject(const CNodeObject* pObject);
 	virtual bool TryToGetFromObject(const CNodeObject* pObject, void** ppData);
 	virtual void RemoveFromObject(CNodeObject* pObject);
 
-	virtual void* AddToObject(u64 objHash) = 0;
-	virtual void* GetFromObject(u64 objHash) = 0;
-	virtual bool TryToGetFromObject(u64 objHash, void** ppData) = 0;
-	virtual void RemoveFromObject(u64 objHash) = 0;
+	virtual void* AddToObject(ObjectHandle handle) = 0;
+	virtual void* GetFromObject(ObjectHandle handle) = 0;
+	virtual bool TryToGetFromObject(ObjectHandle handle, void** ppData) = 0;
+	virtual void RemoveFromObject(ObjectHandle handle) = 0;
 
 private:
 	u32 m_hash;
@@ -16,12 +16,14 @@ CNodeObject::CNodeObject(u64 hash, u32 viewHash, u32 layer, u32 tagHash) :
 	m_hash(hash),
 	m_viewHash(viewHash),
 	m_layer(layer),
-	m_tagHash(tagHash)
+	m_tagHash(tagHash),
+	m_handle(CObjectTable::Instance().Issue(hash))
 {
 }
 
 CNodeObject::~CNodeObject()
 {
+	CObjectTable::Instance().Retire(m_handle);
 }
 
 void CNodeObject::Save(std::ofstream& file) const
@@ -11,6 +11,7 @@
 #ifndef CNODEOBJECT_H
 #define CNODEOBJECT_H
 
+#include "CObjectTable.h"
 #include "../Globals/CGlobals.h"
 #include "../Application/CCoreManager.h"
 #include <fstream>
@@ -64,12 +65,14 @@ public:
 	inline u32 GetLayer() const { return m_layer; }
 	inline u32 GetTagHash() const { return m_tagHash; }
 	inline u64 GetHash() const { return m_hash; }
+	inline ObjectHandle GetHandle() const { return m_handle; }
 
 protected:
 	u32 m_viewHash;
 	u32 m_layer;
 	u32 m_tagHash;
 	u64 m_hash;
+	ObjectHandle m_handle;
 };
 
 #endif
@@ -0,0 +1,81 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Objects/CNodePool.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CNODEPOOL_H
+#define CNODEPOOL_H
+
+#include "CObjectTable.h"
+#include "../Globals/CGlobals.h"
+#include <vector>
+
+// Sparse set storage for node component data. Elements live packed in a dense array, so iterating over them touches contiguous memory, and
+//  each element is reached through the index of its object's handle, which addresses a sparse array of dense slots. Handles are checked
+//  against the generation they were added with, so a stale one finds nothing. Object hashes are only resolved, through the object table,
+//  by the hash overloads, and components should hold ids for anything they resolve each frame (parents, queues).
+// Removal moves the last element into the hole, so pointers and dense order are only valid until the next add or remove. Ids stay valid
+//  until their element is removed. Id 0 (NONE) is never handed out.
+template<typename T>
+class CNodePool
+{
+public:
+	static constexpr u32 NONE = 0;
+
+public:
+	CNodePool();
+	~CNodePool();
+	CNodePool(const CNodePool&) = delete;
+	CNodePool(CNodePool&&) = delete;
+	CNodePool& operator = (const CNodePool&) = delete;
+	CNodePool& operator = (CNodePool&&) = delete;
+
+	void Reserve(u32 count);
+	void Clear();
+
+	// Adds an element for the handle, constructed from args, or returns the id of the one already there. The id is always the handle's
+	//  index, so elements can store their own id up front. An element left behind by a destroyed object in the same slot is replaced.
+	template<typename... Args>
+	u32 Add(ObjectHandle handle, Args&&... args);
+	template<typename... Args>
+	u32 Add(u64 key, Args&&... args);
+	void Remove(u32 id);
+
+	// Returns NONE if the handle has no element, or is stale.
+	u32 Find(ObjectHandle handle) const;
+	u32 Find(u64 key) const;
+
+	// Id access.
+	inline bool Contains(u32 id) const { return id < m_sparseList.size() && m_sparseList[id] != INVALID; }
+	inline T& operator [] (u32 id) { return m_denseList[m_sparseList[id]]; }
+	inline const T& operator [] (u32 id) const { return m_denseList[m_sparseList[id]]; }
+	inline ObjectHandle GetHandle(u32 id) const { return m_handleList[m_sparseList[id]]; }
+
+	// Dense access.
+	inline u32 Size() const { return static_cast<u32>(m_denseList.size()); }
+	inline bool Empty() const { return m_denseList.empty(); }
+	inline u32 GetId(u32 index) const { return m_handleList[index].index; }
+
+	inline typename std::vector<T>::iterator begin() { return m_denseList.begin(); }
+	inline typename std::vector<T>::iterator end() { return m_denseList.end(); }
+	inline typename std::vector<T>::const_iterator begin() const { return m_denseList.begin(); }
+	inline typename std::vector<T>::const_iterator end() const { return m_denseList.end(); }
+
+private:
+	static constexpr u32 INVALID = 0xFFFFFFFF;
+
+private:
+	std::vector<T> m_denseList;
+	std::vector<ObjectHandle> m_handleList; // Dense index to handle.
+
+	std::vector<u32> m_sparseList; // Id to dense index.
+};
+
+#include "CNodePool.hpp"
+
+#endif
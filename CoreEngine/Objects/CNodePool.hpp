@@ -0,0 +1,100 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Objects/CNodePool.hpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CNodePool.h"
+
+template<typename T>
+CNodePool<T>::CNodePool() :
+	m_sparseList(1, INVALID)
+{
+}
+
+template<typename T>
+CNodePool<T>::~CNodePool() { }
+
+template<typename T>
+void CNodePool<T>::Reserve(u32 count)
+{
+	m_denseList.reserve(count);
+	m_handleList.reserve(count);
+}
+
+template<typename T>
+void CNodePool<T>::Clear()
+{
+	m_denseList.clear();
+	m_handleList.clear();
+	m_sparseList.assign(1, INVALID);
+}
+
+template<typename T>
+template<typename... Args>
+u32 CNodePool<T>::Add(ObjectHandle handle, Args&&... args)
+{
+	if(handle.IsNull()) return NONE;
+
+	const u32 id = handle.index;
+	if(Contains(id))
+	{
+		if(m_handleList[m_sparseList[id]] == handle) return id;
+		Remove(id);
+	}
+
+	if(m_sparseList.size() <= id)
+	{
+		m_sparseList.resize(id + 1, INVALID);
+	}
+
+	m_sparseList[id] = static_cast<u32>(m_denseList.size());
+	m_denseList.emplace_back(std::forward<Args>(args)...);
+	m_handleList.push_back(handle);
+
+	return id;
+}
+
+template<typename T>
+template<typename... Args>
+u32 CNodePool<T>::Add(u64 key, Args&&... args)
+{
+	return Add(CObjectTable::Instance().Find(key), std::forward<Args>(args)...);
+}
+
+template<typename T>
+void CNodePool<T>::Remove(u32 id)
+{
+	if(!Contains(id)) return;
+
+	const u32 index = m_sparseList[id];
+	const u32 last = static_cast<u32>(m_denseList.size()) - 1;
+
+	if(index != last)
+	{
+		m_denseList[index] = std::move(m_denseList[last]);
+		m_handleList[index] = m_handleList[last];
+		m_sparseList[m_handleList[index].index] = index;
+	}
+
+	m_denseList.pop_back();
+	m_handleList.pop_back();
+
+	m_sparseList[id] = INVALID;
+}
+
+template<typename T>
+u32 CNodePool<T>::Find(ObjectHandle handle) const
+{
+	return Contains(handle.index) && m_handleList[m_sparseList[handle.index]] == handle ? handle.index : NONE;
+}
+
+template<typename T>
+u32 CNodePool<T>::Find(u64 key) const
+{
+	return Find(CObjectTable::Instance().Find(key));
+}
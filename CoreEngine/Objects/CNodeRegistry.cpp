@@ -12,7 +12,17 @@
 #include "CNodeObject.h"
 #include <functional>
 
-CNodeRegistry::CNodeRegistry()
+namespace
+{
+	// The component being run under debug mode on this thread, if any.
+	thread_local const void* t_pChecked = nullptr;
+	thread_local NODE_PHASE t_checkedPhase = NODE_PHASE_UPDATE;
+};
+
+CNodeRegistry::CNodeRegistry() :
+	m_bScheduled(false),
+	m_bScheduleDirty(true),
+	m_bAccessDebug(false)
 {
 }
 
@@ -38,6 +48,12 @@ void CNodeRegistry::PostInitialize()
 
 void CNodeRegistry::Update()
 {
+	if(m_bScheduled)
+	{
+		RunPhase(NODE_PHASE_UPDATE);
+		return;
+	}
+
 	for(auto elem : m_updateList)
 	{
 		elem->Update();
@@ -46,6 +62,12 @@ void CNodeRegistry::Update()
 
 void CNodeRegistry::LateUpdate()
 {
+	if(m_bScheduled)
+	{
+		RunPhase(NODE_PHASE_LATE_UPDATE);
+		return;
+	}
+
 	for(auto elem : m_lateUpdateList)
 	{
 		elem->LateUpdate();
@@ -83,41 +105,235 @@ void CNodeRegistry::OnResize(const Math::Rect& rect)
 // pObject
 void* CNodeRegistry::AddComponentToObject(u32 compHash, CNodeObject* pObject)
 {
+	CheckAccess(compHash, true);
 	return m_compMap.find(compHash)->second->AddToObject(pObject);
 }
 
 void* CNodeRegistry::GetComponentFromObject(u32 compHash, const CNodeObject* pObject)
 {
+	CheckAccess(compHash, false);
 	return m_compMap.find(compHash)->second->GetFromObject(pObject);
 }
 
 bool CNodeRegistry::TryToGetComponentFromObject(u32 compHash, const CNodeObject* pObject, void** ppData)
 {
+	CheckAccess(compHash, false);
 	return m_compMap.find(compHash)->second->TryToGetFromObject(pObject, ppData);
 }
 
 void CNodeRegistry::RemoveComponentFromObject(u32 compHash, CNodeObject* pObject)
 {
+	CheckAccess(compHash, true);
 	m_compMap.find(compHash)->second->RemoveFromObject(pObject);
 }
 
+// pObject::HANDLE
+void* CNodeRegistry::AddComponentToObject(u32 compHash, ObjectHandle handle)
+{
+	CheckAccess(compHash, true);
+	return m_compMap.find(compHash)->second->AddToObject(handle);
+}
+
+void* CNodeRegistry::GetComponentFromObject(u32 compHash, ObjectHandle handle)
+{
+	CheckAccess(compHash, false);
+	return m_compMap.find(compHash)->second->GetFromObject(handle);
+}
+
+bool CNodeRegistry::TryToGetComponentFromObject(u32 compHash, ObjectHandle handle, void** ppData)
+{
+	CheckAccess(compHash, false);
+	return m_compMap.find(compHash)->second->TryToGetFromObject(handle, ppData);
+}
+
+void CNodeRegistry::RemoveComponentFromObject(u32 compHash, ObjectHandle handle)
+{
+	CheckAccess(compHash, true);
+	m_compMap.find(compHash)->second->RemoveFromObject(handle);
+}
+
 // pObject::HASH
 void* CNodeRegistry::AddComponentToObject(u32 compHash, u64 objHash)
 {
-	return m_compMap.find(compHash)->second->AddToObject(objHash);
+	return AddComponentToObject(compHash, CObjectTable::Instance().Find(objHash));
 }
 
 void* CNodeRegistry::GetComponentFromObject(u32 compHash, u64 objHash)
 {
-	return m_compMap.find(compHash)->second->GetFromObject(objHash);
+	return GetComponentFromObject(compHash, CObjectTable::Instance().Find(objHash));
 }
 
 bool CNodeRegistry::TryToGetComponentFromObject(u32 compHash, u64 objHash, void** ppData)
 {
-	return m_compMap.find(compHash)->second->TryToGetFromObject(objHash, ppData);
+	return TryToGetComponentFromObject(compHash, CObjectTable::Instance().Find(objHash), ppData);
 }
 
 void CNodeRegistry::RemoveComponentFromObject(u32 compHash, u64 objHash)
 {
-	m_compMap.find(compHash)->second->RemoveFromObject(objHash);
+	RemoveComponentFromObject(compHash, CObjectTable::Instance().Find(objHash));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Schedule methods.
+//-------------------------------------------------------------------------------------------------
+
+// Each component lands in the wave after the latest earlier component it conflicts with, so conflicting components keep their
+//  registration order, and undeclared ones act as barriers.
+void CNodeRegistry::BuildSchedule(NODE_PHASE phase, const std::vector<CNodeComponent*>& compList)
+{
+	auto& waveList = m_scheduleList[phase];
+	waveList.clear();
+
+	std::vector<ScheduledComp> scheduledList(compList.size());
+	std::vector<u32> indexList(compList.size());
+
+	for(size_t i = 0; i < compList.size(); ++i)
+	{
+		ScheduledComp& scheduled = scheduledList[i];
+		scheduled.pComp = compList[i];
+		scheduled.pComp->DeclareAccess(phase, scheduled.access);
+		if(scheduled.access.bDeclared)
+		{
+			scheduled.access.writeList.push_back(scheduled.pComp->m_hash);
+		}
+
+		u32 wave = 0;
+		for(size_t j = 0; j < i; ++j)
+		{
+			if(Conflicts(scheduledList[i], scheduledList[j]))
+			{
+				wave = std::max(wave, indexList[j] + 1);
+			}
+		}
+
+		indexList[i] = wave;
+		if(waveList.size() <= wave)
+		{
+			waveList.resize(wave + 1);
+		}
+	}
+
+	for(size_t i = 0; i < compList.size(); ++i)
+	{
+		waveList[indexList[i]].push_back(std::move(scheduledList[i]));
+	}
+}
+
+void CNodeRegistry::RunPhase(NODE_PHASE phase)
+{
+	if(m_bScheduleDirty)
+	{
+		BuildSchedule(NODE_PHASE_UPDATE, m_updateList);
+		BuildSchedule(NODE_PHASE_LATE_UPDATE, m_lateUpdateList);
+		m_bScheduleDirty = false;
+	}
+
+	for(const auto& wave : m_scheduleList[phase])
+	{
+		if(m_bAccessDebug)
+		{
+			for(const ScheduledComp& scheduled : wave)
+			{
+				RunChecked(phase, scheduled);
+			}
+
+			continue;
+		}
+
+		auto RunRange = [&wave, phase](u32 start, u32 end){
+			for(u32 i = start; i < end; ++i)
+			{
+				Run(wave[i].pComp, phase);
+			}
+		};
+
+		if(m_parallelFor && wave.size() > 1)
+		{
+			m_parallelFor(static_cast<u32>(wave.size()), 1, RunRange);
+		}
+		else
+		{
+			RunRange(0, static_cast<u32>(wave.size()));
+		}
+	}
+}
+
+// Digests every component the running one hasn't declared writing, before and after it runs. Undeclared components may touch anything.
+void CNodeRegistry::RunChecked(NODE_PHASE phase, const ScheduledComp& scheduled)
+{
+	if(!scheduled.access.bDeclared)
+	{
+		Run(scheduled.pComp, phase);
+		return;
+	}
+
+	std::vector<std::pair<const CNodeComponent*, u64>> digestList;
+	for(const CNodeComponent* pComp : m_compList)
+	{
+		if(scheduled.access.Writes(pComp->m_hash)) continue;
+
+		const u64 digest = pComp->GetDataDigest();
+		if(digest) digestList.push_back({ pComp, digest });
+	}
+
+	t_pChecked = &scheduled;
+	t_checkedPhase = phase;
+	Run(scheduled.pComp, phase);
+	t_pChecked = nullptr;
+
+	for(const auto& digest : digestList)
+	{
+		if(digest.first->GetDataDigest() == digest.second) continue;
+
+		t_pChecked = &scheduled;
+		t_checkedPhase = phase;
+		CheckAccess(digest.first->m_hash, true);
+		t_pChecked = nullptr;
+	}
+}
+
+void CNodeRegistry::CheckAccess(u32 targetHash, bool bWrite)
+{
+	if(t_pChecked == nullptr) return;
+
+	const ScheduledComp& scheduled = *static_cast<const ScheduledComp*>(t_pChecked);
+	if(bWrite ? scheduled.access.Writes(targetHash) : scheduled.access.Reads(targetHash)) return;
+
+	const AccessViolation violation = { scheduled.pComp->m_hash, targetHash, t_checkedPhase, bWrite };
+	for(const AccessViolation& elem : m_violationList)
+	{
+		if(elem.compHash == violation.compHash && elem.targetHash == violation.targetHash && elem.phase == violation.phase && elem.bWrite == violation.bWrite) return;
+	}
+
+	m_violationList.push_back(violation);
+}
+
+void CNodeRegistry::Run(CNodeComponent* pComp, NODE_PHASE phase)
+{
+	if(phase == NODE_PHASE_UPDATE)
+	{
+		pComp->Update();
+	}
+	else
+	{
+		pComp->LateUpdate();
+	}
+}
+
+// Two components conflict if either writes what the other touches. Undeclared components conflict with everything.
+bool CNodeRegistry::Conflicts(const ScheduledComp& a, const ScheduledComp& b)
+{
+	if(!a.access.bDeclared || !b.access.bDeclared) return true;
+
+	for(u32 hash : a.access.writeList)
+	{
+		if(b.access.Reads(hash)) return true;
+	}
+
+	for(u32 hash : b.access.writeList)
+	{
+		if(a.access.Reads(hash)) return true;
+	}
+
+	return false;
 }
@@ -14,11 +14,25 @@
 #include "CNodeComponent.h"
 #include "../Globals/CGlobals.h"
 #include "../Math/CMathRect.h"
+#include <functional>
 #include <vector>
 #include <unordered_map>
 
 class CNodeRegistry
 {
+public:
+	// Runs func over batches of [0, count), and returns once all of them are done. Supplied by the application's job system.
+	typedef std::function<void(u32 count, u32 batchSize, std::function<void(u32, u32)> func)> ParallelForFunc;
+
+	// A component touched another's data during a phase without declaring it.
+	struct AccessViolation
+	{
+		u32 compHash;
+		u32 targetHash;
+		NODE_PHASE phase;
+		bool bWrite;
+	};
+
 public:
 	CNodeRegistry();
 	~CNodeRegistry();
@@ -51,6 +65,8 @@ public:
 			// Have separate lists for per-frame method calls only if they are used.
 			if(typeid(&CNodeComponent::Update) != typeid(&T::Update)) m_updateList.push_back(pComp);
 			if(typeid(&CNodeComponent::LateUpdate) != typeid(&T::LateUpdate)) m_lateUpdateList.push_back(pComp);
+
+			m_bScheduleDirty = true;
 		}
 	}
 	
@@ -68,6 +84,8 @@ public:
 
 			//delete elem->second;
 			m_compMap.erase(elem);
+
+			m_bScheduleDirty = true;
 		}
 	}
 	
@@ -84,11 +102,49 @@ public:
 	bool TryToGetComponentFromObject(u32 compHash, const class CNodeObject* pObject, void** ppData);
 	void RemoveComponentFromObject(u32 compHash, class CNodeObject* pObject);
 	
+	void* AddComponentToObject(u32 compHash, ObjectHandle handle);
+	void* GetComponentFromObject(u32 compHash, ObjectHandle handle);
+	bool TryToGetComponentFromObject(u32 compHash, ObjectHandle handle, void** ppData);
+	void RemoveComponentFromObject(u32 compHash, ObjectHandle handle);
+
+	// By object hash, resolved through the object table. Meant for loading and editor lookups; prefer handles anywhere else.
 	void* AddComponentToObject(u32 compHash, u64 objHash);
 	void* GetComponentFromObject(u32 compHash, u64 objHash);
 	bool TryToGetComponentFromObject(u32 compHash, u64 objHash, void** ppData);
 	void RemoveComponentFromObject(u32 compHash, u64 objHash);
+
+	//-----------------------------------------------------------------------------------------------
+
+	// With scheduling on, each phase is split into waves of components whose declared access doesn't conflict, kept in registration
+	//  order, and each wave runs across the parallel for. Off by default, which runs every component in turn as before.
+	inline void SetScheduled(bool bScheduled) { m_bScheduled = bScheduled; }
+	inline void SetParallelFor(ParallelForFunc parallelFor) { m_parallelFor = parallelFor; }
+
+	// Debug mode runs scheduled phases on the calling thread, and records a violation whenever a component reaches another component
+	//  through this registry without declaring it, or changes the digest of one it didn't declare writing.
+	inline void SetAccessDebug(bool bAccessDebug) { m_bAccessDebug = bAccessDebug; }
+	inline const std::vector<AccessViolation>& GetAccessViolations() const { return m_violationList; }
+	inline void ClearAccessViolations() { m_violationList.clear(); }
+
+	inline bool IsScheduled() const { return m_bScheduled; }
+	inline bool IsAccessDebug() const { return m_bAccessDebug; }
+	inline u32 GetWaveCount(NODE_PHASE phase) const { return static_cast<u32>(m_scheduleList[phase].size()); }
 	
+private:
+	struct ScheduledComp
+	{
+		CNodeComponent* pComp;
+		NodeAccess access;
+	};
+
+	void BuildSchedule(NODE_PHASE phase, const std::vector<CNodeComponent*>& compList);
+	void RunPhase(NODE_PHASE phase);
+	void RunChecked(NODE_PHASE phase, const ScheduledComp& scheduled);
+	void CheckAccess(u32 targetHash, bool bWrite);
+
+	static void Run(CNodeComponent* pComp, NODE_PHASE phase);
+	static bool Conflicts(const ScheduledComp& a, const ScheduledComp& b);
+
 private:
 	inline void RemoveCompFromList(std::vector<CNodeComponent*>& list, CNodeComponent* pTarget)
 	{
@@ -109,6 +165,15 @@ private:
 	std::vector<CNodeComponent*> m_updateList;
 	std::vector<CNodeComponent*> m_lateUpdateList;
 	std::unordered_map<u32, CNodeComponent*> m_compMap;
+
+	bool m_bScheduled;
+	bool m_bScheduleDirty;
+	bool m_bAccessDebug;
+
+	std::vector<std::vector<ScheduledComp>> m_scheduleList[NODE_PHASE_COUNT]; // Waves per phase.
+	std::vector<AccessViolation> m_violationList;
+
+	ParallelForFunc m_parallelFor;
 };
 
 #endif
@@ -0,0 +1,105 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Objects/CObjectTable.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CObjectTable.h"
+#include <cassert>
+
+CObjectTable::CObjectTable() :
+	m_slotList(1, { 0, 0, false })
+{
+}
+
+CObjectTable::~CObjectTable() { }
+
+ObjectHandle CObjectTable::Issue(u64 hash)
+{
+	std::lock_guard<std::shared_mutex> lk(m_mutex);
+
+	ObjectHandle handle;
+	if(m_freeList.empty())
+	{
+		handle.index = static_cast<u32>(m_slotList.size());
+		m_slotList.push_back({ 0, 1, false });
+	}
+	else
+	{
+		handle.index = m_freeList.back();
+		m_freeList.pop_back();
+	}
+
+	Slot& slot = m_slotList[handle.index];
+	slot.hash = hash;
+	slot.bLive = true;
+	handle.generation = slot.generation;
+
+	// Object hashes only need to be unique among live objects now.
+	const bool bInserted = m_hashMap.insert({ hash, handle.index }).second;
+	assert(bInserted);
+
+	return handle;
+}
+
+void CObjectTable::Retire(ObjectHandle handle)
+{
+	std::lock_guard<std::shared_mutex> lk(m_mutex);
+
+	if(handle.index >= m_slotList.size()) return;
+
+	Slot& slot = m_slotList[handle.index];
+	if(!slot.bLive || slot.generation != handle.generation) return;
+
+	auto elem = m_hashMap.find(slot.hash);
+	if(elem != m_hashMap.end() && elem->second == handle.index)
+	{
+		m_hashMap.erase(elem);
+	}
+
+	slot.bLive = false;
+	if(++slot.generation == 0) slot.generation = 1;
+	m_freeList.push_back(handle.index);
+}
+
+bool CObjectTable::IsValid(ObjectHandle handle) const
+{
+	std::shared_lock<std::shared_mutex> lk(m_mutex);
+	return handle.index < m_slotList.size() && m_slotList[handle.index].bLive && m_slotList[handle.index].generation == handle.generation;
+}
+
+u64 CObjectTable::GetHash(ObjectHandle handle) const
+{
+	std::shared_lock<std::shared_mutex> lk(m_mutex);
+
+	if(handle.index >= m_slotList.size()) return 0;
+
+	const Slot& slot = m_slotList[handle.index];
+	return slot.bLive && slot.generation == handle.generation ? slot.hash : 0;
+}
+
+ObjectHandle CObjectTable::Find(u64 hash) const
+{
+	std::shared_lock<std::shared_mutex> lk(m_mutex);
+
+	auto elem = m_hashMap.find(hash);
+	if(elem == m_hashMap.end()) return { };
+
+	return { elem->second, m_slotList[elem->second].generation };
+}
+
+u32 CObjectTable::GetCapacity() const
+{
+	std::shared_lock<std::shared_mutex> lk(m_mutex);
+	return static_cast<u32>(m_slotList.size());
+}
+
+u32 CObjectTable::GetLiveCount() const
+{
+	std::shared_lock<std::shared_mutex> lk(m_mutex);
+	return static_cast<u32>(m_slotList.size() - m_freeList.size()) - 1;
+}
@@ -0,0 +1,83 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Objects/CObjectTable.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef COBJECTTABLE_H
+#define COBJECTTABLE_H
+
+#include "../Globals/CGlobals.h"
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// A slot in the object table and the generation it was issued at. The index can be used to address arrays directly, and a handle whose
+//  generation no longer matches its slot belongs to an object that has since been destroyed. The null handle has generation 0.
+struct ObjectHandle
+{
+	u32 index = 0;
+	u32 generation = 0;
+
+	inline bool IsNull() const { return generation == 0; }
+
+	inline bool operator == (const ObjectHandle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+	inline bool operator != (const ObjectHandle& rhs) const { return !(*this == rhs); }
+};
+
+// Issues a handle to every live object. Slots are recycled once retired, with their generation bumped, so a stale handle is caught with
+//  one compare. Object hashes are only kept to find a handle from a name, for serialization and editor lookups.
+class CObjectTable
+{
+public:
+	static CObjectTable& Instance()
+	{
+		static CObjectTable instance;
+		return instance;
+	}
+
+private:
+	CObjectTable();
+	~CObjectTable();
+	CObjectTable(const CObjectTable&) = delete;
+	CObjectTable(CObjectTable&&) = delete;
+	CObjectTable& operator = (const CObjectTable&) = delete;
+	CObjectTable& operator = (CObjectTable&&) = delete;
+
+public:
+	ObjectHandle Issue(u64 hash);
+	void Retire(ObjectHandle handle);
+
+	bool IsValid(ObjectHandle handle) const;
+
+	// Returns 0 for a stale handle.
+	u64 GetHash(ObjectHandle handle) const;
+
+	// Returns the null handle if no live object has the hash.
+	ObjectHandle Find(u64 hash) const;
+
+	// One past the highest index handed out so far, for sizing arrays indexed by handle.
+	u32 GetCapacity() const;
+	u32 GetLiveCount() const;
+
+private:
+	struct Slot
+	{
+		u64 hash;
+		u32 generation;
+		bool bLive;
+	};
+
+private:
+	mutable std::shared_mutex m_mutex;
+
+	std::vector<Slot> m_slotList; // Slot 0 is never handed out.
+	std::vector<u32> m_freeList;
+	std::unordered_map<u64, u32> m_hashMap;
+};
+
+#endif
@@ -11,21 +11,15 @@
 #include "CVObject.h"
 #include "../Logic/CTransform.h"
 
-#ifdef _DEBUG
-	std::unordered_set<u64> CVObject::m_idSet;
-#endif
-
 CVObject::CVObject(const std::wstring& name, u32 viewHash, u32 layer, u32 tagHash) : 
 	m_layer(layer),
 	m_tagHash(tagHash),
 	m_hash(Math::FNV1a_64(name.c_str(), name.size())),
 	m_viewHash(viewHash),
+	m_handle(CObjectTable::Instance().Issue(m_hash)),
 	m_bHasPhysics(false),
 	m_pTransform(nullptr)
 {
-#ifdef _DEBUG
-	assert(m_idSet.insert(m_hash).second);
-#endif
 }
 
 CVObject::CVObject(u64 hash, u32 viewHash, u32 layer, u32 tagHash) : 
@@ -33,15 +27,16 @@ CVObject::CVObject(u64 hash, u32 viewHash, u32 layer, u32 tagHash) :
 	m_tagHash(tagHash),
 	m_hash(hash),
 	m_viewHash(viewHash),
+	m_handle(CObjectTable::Instance().Issue(m_hash)),
 	m_bHasPhysics(false),
 	m_pTransform(nullptr)
 {
-#ifdef _DEBUG
-	assert(m_idSet.insert(m_hash).second);
-#endif
 }
 
-CVObject::~CVObject() { }
+CVObject::~CVObject()
+{
+	CObjectTable::Instance().Retire(m_handle);
+}
 
 void CVObject::AddComponent(CVComponent* pComponent) 
 {
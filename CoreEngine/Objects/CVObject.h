@@ -12,6 +12,7 @@
 #define CVOBJECT_H
 
 #include "CVComponent.h"
+#include "CObjectTable.h"
 #include "../Globals/CGlobals.h"
 #include "../Math/CMathFNV.h"
 #include "../Math/CMathRect.h"
@@ -19,10 +20,6 @@
 #include <fstream>
 #include <string>
 #include <shared_mutex>
-#ifdef _DEBUG
-#include <unordered_set>
-#include <cassert>
-#endif
 
 namespace Logic
 {
@@ -82,6 +79,7 @@ public:
 	inline u32 GetLayer() const { return m_layer; }
 	inline u32 GetTagHash() const { return m_tagHash; }
 	inline u64 GetHash() const { return m_hash; }
+	inline ObjectHandle GetHandle() const { return m_handle; }
 
 	inline u32 GetViewHash() const { return m_viewHash; }
 	inline bool HasPhysics() const { return m_bHasPhysics; }
@@ -108,13 +106,11 @@ private:
 	u32 m_tagHash;
 	u32 m_viewHash;
 	u64 m_hash;
+	ObjectHandle m_handle;
 
 	bool m_bHasPhysics;
 
 	Logic::CTransform* m_pTransform;
-#ifdef _DEBUG
-	static std::unordered_set<u64> m_idSet;
-#endif
 
 	std::vector<CVComponent*> m_componentList;
 };
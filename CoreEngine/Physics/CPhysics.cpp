@@ -11,13 +11,19 @@
 #include "CPhysics.h"
 #include "CVolume.h"
 #include "../Utilities/CTimer.h"
+#include "../Utilities/CFrameAllocator.h"
+#include "../Utilities/CAllocTracker.h"
+#include "../Utilities/CProfiler.h"
+#include "../Utilities/CMetrics.h"
+#include <chrono>
 #include <thread>
 
 namespace Physics
 {
 	CPhysics::CPhysics() :
 		m_exitFlag(false),
-		m_physicsUpdateBatch(4, 4)
+		m_physicsUpdateBatch(4),
+		m_pStepMetric(Util::CMetrics::Instance().GetHistogram("physics.stepMicros"))
 	{}
 
 	CPhysics::~CPhysics()
@@ -58,11 +64,12 @@ namespace Physics
 
 	void CPhysics::MarkObjectAsDirty(const CVObject* pObject, const Math::SIMDMatrix& world)
 	{
+		const ObjectHandle handle = pObject->GetHandle();
+
 		std::lock_guard<std::mutex> lk(m_mutex);
-		auto elem = m_volumeMap.find(pObject->GetHash());
-		if(elem != m_volumeMap.end())
+		if(handle.index < m_volumeList.size() && m_volumeList[handle.index].first == handle)
 		{
-			std::pair<Physics::CVolume*, Math::SIMDMatrix> pair = { elem->second, world };
+			std::pair<Physics::CVolume*, Math::SIMDMatrix> pair = { m_volumeList[handle.index].second, world };
 			m_dirtyQueue.PushBack(pair);
 		}
 	}
@@ -73,15 +80,27 @@ namespace Physics
 
 	void CPhysics::RegisterVolume(CVolume* pVolume)
 	{
+		const ObjectHandle handle = pVolume->GetVObject()->GetHandle();
+
 		std::lock_guard<std::mutex> lk(m_mutex);
-		m_volumeMap.insert({ pVolume->GetVObject()->GetHash(), pVolume });
+		if(m_volumeList.size() <= handle.index)
+		{
+			m_volumeList.resize(CObjectTable::Instance().GetCapacity(), { ObjectHandle(), nullptr });
+		}
+
+		m_volumeList[handle.index] = { handle, pVolume };
 		m_insertionQueue.PushBack(pVolume);
 	}
 
 	void CPhysics::DeregisterVolume(CVolume* pVolume)
 	{
+		const ObjectHandle handle = pVolume->GetVObject()->GetHandle();
+
 		std::lock_guard<std::mutex> lk(m_mutex);
-		m_volumeMap.erase(pVolume->GetVObject()->GetHash());
+		if(handle.index < m_volumeList.size() && m_volumeList[handle.index].first == handle)
+		{
+			m_volumeList[handle.index] = { ObjectHandle(), nullptr };
+		}
 		m_deletionQueue.PushBack(pVolume);
 	}
 
@@ -91,37 +110,52 @@ namespace Physics
 
 	void CPhysics::PhysicsThread(std::promise<void> p)
 	{
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_PHYSICS);
+		PROFILE_THREAD("Physics");
+
 		Util::CTimer::Instance().SetTargetFrameRate(m_data.targetFPS);
 
 		while(!m_exitFlag)
 		{
+			Util::CAllocTracker::Instance().EndFrame();
+			Util::CFrameAllocator::Instance().Reset();
+			PROFILE_FRAME();
 			Util::CTimer::Instance().Tick();
-			
-			// Process external collider updates.
-			ProcessColliderUpdates();
-			
-			// Physics updates.
-			// Update game-driven rigidbodies.
-			m_physicsUpdateBatch.Update();
-
-			// Update phantoms.
-			// Update forces, apply impulses and adjust constraints.
-			m_physicsWorld.UpdateForceFields();
-			m_physicsWorld.UpdateRigidbodies();
-			
-			// Step the simulation.
-			m_physicsWorld.Solve(m_data.idleIterations, m_data.rayCastIterations);
-
-			// Update physics-driven game objects.
-			// Query phantoms.
-
-			// Perform collision cast queries.
-			ProcessQueries();
+
+			Step();
 		}
 
 		p.set_value();
 	}
 
+	void CPhysics::Step()
+	{
+		const auto stepStart = std::chrono::steady_clock::now();
+		
+		// Process external collider updates.
+		ProcessColliderUpdates();
+		
+		// Physics updates.
+		// Update game-driven rigidbodies.
+		m_physicsUpdateBatch.Update();
+
+		// Update phantoms.
+		// Update forces, apply impulses and adjust constraints.
+		m_physicsWorld.UpdateForceFields();
+		m_physicsWorld.UpdateRigidbodies();
+		
+		// Step the simulation.
+		m_physicsWorld.Solve(m_data.idleIterations, m_data.rayCastIterations);
+
+		// Update physics-driven game objects.
+		// Query phantoms.
+
+		// Perform collision cast queries.
+		ProcessQueries();
+
+		m_pStepMetric->Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - stepStart).count());
+	}
+
 	//-----------------------------------------------------------------------------------------------
 	// Processor and query methods.
 	//-----------------------------------------------------------------------------------------------
@@ -17,9 +17,10 @@
 #include "../Globals/CGlobals.h"
 #include "../Objects/CVObject.h"
 #include "../Utilities/CTSDeque.h"
+#include "../Utilities/CMetrics.h"
 #include <future>
 #include <mutex>
-#include <unordered_map>
+#include <vector>
 
 namespace Physics
 {
@@ -57,6 +58,10 @@ namespace Physics
 		void Halt();
 		void Release();
 
+		// Advances the simulation once on the calling thread, at the calling thread's timer delta. Only for when the physics thread
+		//  isn't running, such as the headless runner stepping physics in lockstep with its frames.
+		void Step();
+
 		void CastRay(const QueryRay& query);
 
 		void MarkObjectAsDirty(const CVObject* pObject, const Math::SIMDMatrix& world);
@@ -87,7 +92,7 @@ namespace Physics
 		Data m_data;
 
 		CPhysicsUpdateBatch m_physicsUpdateBatch;
-		std::unordered_map<u64, class CVolume*> m_volumeMap;
+		std::vector<std::pair<ObjectHandle, class CVolume*>> m_volumeList; // Indexed by object handle.
 		Util::CTSDeque<class CVolume*> m_insertionQueue;
 		Util::CTSDeque<class CVolume*> m_deletionQueue;
 		Util::CTSDeque<std::pair<class CVolume*, Math::SIMDMatrix>> m_dirtyQueue;
@@ -97,6 +102,8 @@ namespace Physics
 		std::future<void> m_futureExit;
 
 		CPhysicsWorld m_physicsWorld;
+
+		Util::CMetrics::Histogram* m_pStepMetric; // Microseconds per step.
 	};
 };
 
@@ -14,6 +14,7 @@
 #include "../Math/CSIMDRay.h"
 #include "../Globals/CGlobals.h"
 #include <functional>
+#include <memory_resource>
 #include <vector>
 
 namespace Physics
@@ -73,7 +74,7 @@ namespace Physics
 	struct QueryRay
 	{
 		Math::CSIMDRay ray;
-		std::function<void(const std::vector<RaycastInfo>&)> callback;
+		std::function<void(const std::pmr::vector<RaycastInfo>&)> callback; // The list is frame scratch, and mustn't be kept.
 	};
 };
 
@@ -13,11 +13,19 @@
 #include "CRigidbody.h"
 #include "CForceField.h"
 #include "../Objects/CVObject.h"
+#include "../Utilities/CFrameAllocator.h"
+#include "../Utilities/CProfiler.h"
+#include "../Utilities/CMetrics.h"
 #include <Windows.h>
 
 namespace Physics
 {
-	CPhysicsWorld::CPhysicsWorld() { }
+	CPhysicsWorld::CPhysicsWorld() :
+		m_pVolumeMetric(Util::CMetrics::Instance().GetGauge("physics.volumes")),
+		m_pPairMetric(Util::CMetrics::Instance().GetCounter("physics.pairsTested")),
+		m_pRayMetric(Util::CMetrics::Instance().GetCounter("physics.rayQueries"))
+	{
+	}
 
 	CPhysicsWorld::~CPhysicsWorld() { }
 		
@@ -32,6 +40,7 @@ namespace Physics
 		if(pVolume->IsCollider()) m_colliderMap.insert({ pVolume->GetVObject()->GetHash(), pVolume });
 		if(pVolume->GetRigidbody()) m_rigidbodyMap.insert({ pVolume->GetVObject()->GetHash(), pVolume });
 		if(pVolume->GetForceField()) m_forceFieldMap.insert({ pVolume->GetVObject()->GetHash(), pVolume });
+		m_pVolumeMetric->Set(m_volumeMap.size());
 	}
 
 	void CPhysicsWorld::RemoveVolume(CVolume* pVolume)
@@ -41,6 +50,7 @@ namespace Physics
 		if(pVolume->IsCollider()) m_colliderMap.erase(pVolume->GetVObject()->GetHash());
 		if(pVolume->GetRigidbody()) m_rigidbodyMap.erase(pVolume->GetVObject()->GetHash());
 		if(pVolume->GetForceField()) m_forceFieldMap.erase(pVolume->GetVObject()->GetHash());
+		m_pVolumeMetric->Set(m_volumeMap.size());
 	}
 	
 	//-----------------------------------------------------------------------------------------------
@@ -79,8 +89,11 @@ namespace Physics
 	
 	void CPhysicsWorld::Solve(u32 idleIterations, u32 rayCastIterations)
 	{
+		PROFILE_ZONE("CPhysicsWorld::Solve");
+
 		bool bAnyResponse;
 		u32 i, j;
+		u64 pairCount = 0;
 
 		// Idle solver iterations.
 		for(i = 0; i < idleIterations; ++i)
@@ -92,6 +105,7 @@ namespace Physics
 				{
 					if(collider.second != rigidbody.second)
 					{
+						++pairCount;
 						bAnyResponse |= collider.second->IdleSolver(rigidbody.second);
 					}
 				}
@@ -119,6 +133,7 @@ namespace Physics
 					{
 						if(collider.second != rigidbody.second)
 						{
+							++pairCount;
 							collider.second->MotionSolver(rigidbody.second);
 						}
 					}
@@ -144,6 +159,7 @@ namespace Physics
 					{
 						if(collider.second != rigidbody.second)
 						{
+							++pairCount;
 							collider.second->MotionSolver(rigidbody.second);
 						}
 					}
@@ -169,6 +185,7 @@ namespace Physics
 					{
 						if(collider.second != rigidbody.second)
 						{
+							++pairCount;
 							bSolved &= !collider.second->IdleSolver(rigidbody.second);
 						}
 					}
@@ -177,6 +194,8 @@ namespace Physics
 				rigidbody.second->GetRigidbody()->ApplyIdleSolver();
 			});
 		}
+
+		m_pPairMetric->Add(pairCount);
 	}
 
 	//-----------------------------------------------------------------------------------------------
@@ -185,7 +204,9 @@ namespace Physics
 
 	void CPhysicsWorld::CastRay(const QueryRay& queryRay)
 	{
-		std::vector<RaycastInfo> res;
+		m_pRayMetric->Add();
+
+		Util::FrameVector<RaycastInfo> res(&Util::CFrameAllocator::Instance());
 		RaycastInfo info;
 		for(auto elem : m_rayCastMap)
 		{
@@ -14,6 +14,7 @@
 #include "CPhysicsData.h"
 #include "../Math/CSIMDMatrix.h"
 #include "../Utilities/CTSDeque.h"
+#include "../Utilities/CMetrics.h"
 #include <unordered_map>
 
 namespace Physics
@@ -44,6 +45,10 @@ namespace Physics
 		std::unordered_map<u64, class CVolume*> m_rigidbodyMap;
 		std::unordered_map<u64, class CVolume*> m_forceFieldMap;
 		std::unordered_map<u64, class CVolume*> m_rayCastMap;
+
+		Util::CMetrics::Gauge* m_pVolumeMetric;
+		Util::CMetrics::Counter* m_pPairMetric;
+		Util::CMetrics::Counter* m_pRayMetric;
 	};
 };
 
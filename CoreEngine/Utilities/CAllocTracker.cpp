@@ -0,0 +1,352 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Utilities/CAllocTracker.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CAllocTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+
+#ifndef PRODUCTION_BUILD
+namespace
+{
+	// Every block carries its size and tag, so it can be uncounted from whichever thread frees it. Sixteen bytes keeps malloc's alignment.
+	struct BlockHeader
+	{
+		u64 size;
+		u32 tag;
+		u32 padding;
+	};
+
+	static_assert(sizeof(BlockHeader) == 16, "Block header must keep 16 byte alignment.");
+
+	constexpr u32 TAG_UNTRACKED = 0xFFFFFFFF;
+
+	struct TagCounters
+	{
+		std::atomic<u64> liveBytes;
+		std::atomic<u64> peakBytes;
+		std::atomic<u64> allocCount;
+		std::atomic<u64> freeCount;
+		std::atomic<u64> allocBytes;
+	};
+
+	// Plain thread locals and constant initialized globals, so they're usable from operator new before anything else is constructed.
+	thread_local u64 t_allocCount = 0;
+	thread_local u64 t_freeCount = 0;
+	thread_local u64 t_allocBytes = 0;
+	thread_local Util::ALLOC_TAG t_tag = Util::ALLOC_TAG_NONE;
+
+	std::atomic<bool> g_bTagging(false);
+	TagCounters g_tagList[Util::ALLOC_TAG_COUNT];
+
+	// Tag frames. Only touched outside of operator new.
+	std::mutex g_frameMutex;
+	u64 g_frameIndex = 0;
+	u64 g_frameStartCount[Util::ALLOC_TAG_COUNT];
+	u64 g_frameStartBytes[Util::ALLOC_TAG_COUNT];
+	u64 g_frameAllocCount[Util::ALLOC_TAG_COUNT];
+	u64 g_frameAllocBytes[Util::ALLOC_TAG_COUNT];
+
+	void* Allocate(size_t sz) noexcept
+	{
+		++t_allocCount;
+		t_allocBytes += sz;
+
+		BlockHeader* pHeader = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + sz));
+		if(pHeader == nullptr) return nullptr;
+
+		pHeader->size = sz;
+		pHeader->tag = TAG_UNTRACKED;
+
+		if(g_bTagging.load(std::memory_order_relaxed))
+		{
+			pHeader->tag = t_tag;
+
+			TagCounters& counters = g_tagList[t_tag];
+			counters.allocCount.fetch_add(1, std::memory_order_relaxed);
+			counters.allocBytes.fetch_add(sz, std::memory_order_relaxed);
+
+			const u64 live = counters.liveBytes.fetch_add(sz, std::memory_order_relaxed) + sz;
+			u64 peak = counters.peakBytes.load(std::memory_order_relaxed);
+			while(live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+		}
+
+		return pHeader + 1;
+	}
+
+	void Free(void* p) noexcept
+	{
+		if(p == nullptr) return;
+
+		++t_freeCount;
+
+		BlockHeader* pHeader = static_cast<BlockHeader*>(p) - 1;
+		if(pHeader->tag != TAG_UNTRACKED)
+		{
+			TagCounters& counters = g_tagList[pHeader->tag];
+			counters.freeCount.fetch_add(1, std::memory_order_relaxed);
+			counters.liveBytes.fetch_sub(pHeader->size, std::memory_order_relaxed);
+		}
+
+		std::free(pHeader);
+	}
+};
+
+void* operator new(size_t sz)
+{
+	void* p = Allocate(sz);
+	if(p == nullptr) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t sz)
+{
+	return operator new(sz);
+}
+
+void* operator new(size_t sz, const std::nothrow_t&) noexcept
+{
+	return Allocate(sz);
+}
+
+void* operator new[](size_t sz, const std::nothrow_t&) noexcept
+{
+	return Allocate(sz);
+}
+
+void operator delete(void* p) noexcept
+{
+	Free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	Free(p);
+}
+
+void operator delete(void* p, size_t sz) noexcept
+{
+	Free(p);
+}
+
+void operator delete[](void* p, size_t sz) noexcept
+{
+	Free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	Free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	Free(p);
+}
+#endif
+
+namespace Util
+{
+	namespace
+	{
+		const char* TAG_NAME_LIST[ALLOC_TAG_COUNT] = {
+			"Untagged",
+			"Chunk",
+			"Mesh",
+			"Physics",
+			"UI",
+			"Audio",
+			"Resources",
+		};
+	};
+
+	//-----------------------------------------------------------------------------------------------
+	// CAllocTracker::Scope methods.
+	//-----------------------------------------------------------------------------------------------
+
+#ifndef PRODUCTION_BUILD
+	CAllocTracker::Scope::Scope(ALLOC_TAG tag) :
+		m_prevTag(t_tag)
+	{
+		t_tag = tag;
+	}
+
+	CAllocTracker::Scope::~Scope()
+	{
+		t_tag = m_prevTag;
+	}
+#else
+	CAllocTracker::Scope::Scope(ALLOC_TAG tag) :
+		m_prevTag(tag)
+	{
+	}
+
+	CAllocTracker::Scope::~Scope() { }
+#endif
+
+	//-----------------------------------------------------------------------------------------------
+	// CAllocTracker methods.
+	//-----------------------------------------------------------------------------------------------
+
+	CAllocTracker::CAllocTracker() :
+		m_frameStart(GetTotal()),
+		m_lastFrame { }
+	{
+	}
+
+	CAllocTracker::~CAllocTracker() { }
+
+	void CAllocTracker::EndFrame()
+	{
+		m_lastFrame = GetFrame();
+		m_frameStart = GetTotal();
+	}
+
+	CAllocTracker::Counts CAllocTracker::GetTotal()
+	{
+#ifndef PRODUCTION_BUILD
+		return { t_allocCount, t_freeCount, t_allocBytes };
+#else
+		return { };
+#endif
+	}
+
+	CAllocTracker::Counts CAllocTracker::GetFrame() const
+	{
+		const Counts total = GetTotal();
+		return { total.allocCount - m_frameStart.allocCount, total.freeCount - m_frameStart.freeCount, total.allocBytes - m_frameStart.allocBytes };
+	}
+
+	bool CAllocTracker::IsEnabled()
+	{
+#ifndef PRODUCTION_BUILD
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Tag methods.
+	//-----------------------------------------------------------------------------------------------
+
+	void CAllocTracker::SetTagging(bool bTagging)
+	{
+#ifndef PRODUCTION_BUILD
+		g_bTagging = bTagging;
+#endif
+	}
+
+	bool CAllocTracker::IsTagging()
+	{
+#ifndef PRODUCTION_BUILD
+		return g_bTagging;
+#else
+		return false;
+#endif
+	}
+
+	void CAllocTracker::EndTagFrame()
+	{
+#ifndef PRODUCTION_BUILD
+		std::lock_guard<std::mutex> lk(g_frameMutex);
+
+		for(u32 tag = 0; tag < ALLOC_TAG_COUNT; ++tag)
+		{
+			const u64 count = g_tagList[tag].allocCount.load(std::memory_order_relaxed);
+			const u64 bytes = g_tagList[tag].allocBytes.load(std::memory_order_relaxed);
+
+			g_frameAllocCount[tag] = count - g_frameStartCount[tag];
+			g_frameAllocBytes[tag] = bytes - g_frameStartBytes[tag];
+			g_frameStartCount[tag] = count;
+			g_frameStartBytes[tag] = bytes;
+		}
+
+		++g_frameIndex;
+#endif
+	}
+
+	void CAllocTracker::ResetPeaks()
+	{
+#ifndef PRODUCTION_BUILD
+		for(TagCounters& counters : g_tagList)
+		{
+			counters.peakBytes = counters.liveBytes.load();
+		}
+#endif
+	}
+
+	CAllocTracker::TagStats CAllocTracker::GetTagStats(ALLOC_TAG tag)
+	{
+		TagStats stats { };
+
+#ifndef PRODUCTION_BUILD
+		const TagCounters& counters = g_tagList[tag];
+		stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+		stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		stats.allocCount = counters.allocCount.load(std::memory_order_relaxed);
+		stats.freeCount = counters.freeCount.load(std::memory_order_relaxed);
+		stats.allocBytes = counters.allocBytes.load(std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> lk(g_frameMutex);
+		stats.frameAllocCount = g_frameAllocCount[tag];
+		stats.frameAllocBytes = g_frameAllocBytes[tag];
+#endif
+
+		return stats;
+	}
+
+	const char* CAllocTracker::GetTagName(ALLOC_TAG tag)
+	{
+		return tag < ALLOC_TAG_COUNT ? TAG_NAME_LIST[tag] : "Unknown";
+	}
+
+	bool CAllocTracker::CheckBudget(const TagBudget& budget)
+	{
+		const TagStats stats = GetTagStats(budget.tag);
+		if(budget.peakBytesMax && stats.peakBytes > budget.peakBytesMax) return false;
+		if(budget.frameAllocCountMax && stats.frameAllocCount > budget.frameAllocCountMax) return false;
+		return true;
+	}
+
+	bool CAllocTracker::DumpCSV(const std::wstring& path, bool bAppend)
+	{
+#ifndef PRODUCTION_BUILD
+		const bool bHeader = !bAppend || !std::ifstream(path).good();
+
+		std::ofstream file(path, bAppend ? std::ios::app : std::ios::trunc);
+		if(!file.is_open()) return false;
+
+		if(bHeader)
+		{
+			file << "frame,tag,liveBytes,peakBytes,allocCount,freeCount,allocBytes,frameAllocCount,frameAllocBytes\n";
+		}
+
+		u64 frameIndex;
+		{
+			std::lock_guard<std::mutex> lk(g_frameMutex);
+			frameIndex = g_frameIndex;
+		}
+
+		for(u32 tag = 0; tag < ALLOC_TAG_COUNT; ++tag)
+		{
+			const TagStats stats = GetTagStats(static_cast<ALLOC_TAG>(tag));
+			file << frameIndex << ',' << TAG_NAME_LIST[tag] << ',' << stats.liveBytes << ',' << stats.peakBytes << ',' << stats.allocCount << ',' <<
+				stats.freeCount << ',' << stats.allocBytes << ',' << stats.frameAllocCount << ',' << stats.frameAllocBytes << '\n';
+		}
+
+		return file.good();
+#else
+		return false;
+#endif
+	}
+};
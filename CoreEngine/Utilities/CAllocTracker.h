@@ -0,0 +1,137 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Utilities/CAllocTracker.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CALLOCTRACKER_H
+#define CALLOCTRACKER_H
+
+#include "../Globals/CGlobals.h"
+#include <string>
+
+namespace Util
+{
+	// Subsystems heap allocations are charged to, while a scope for them is open on the allocating thread.
+	enum ALLOC_TAG : u8
+	{
+		ALLOC_TAG_NONE,
+		ALLOC_TAG_CHUNK,
+		ALLOC_TAG_MESH,
+		ALLOC_TAG_PHYSICS,
+		ALLOC_TAG_UI,
+		ALLOC_TAG_AUDIO,
+		ALLOC_TAG_RESOURCES,
+		ALLOC_TAG_COUNT,
+	};
+
+	// Counts the heap allocations made by the calling thread, through the global operator new. Each thread closes its frames where it resets
+	//  its frame allocator, so the counts of the last one can be read back.
+	// With tagging switched on, every allocation is also charged to the tag of the innermost open scope on its thread, and each block
+	//  remembers its tag, so live and peak bytes stay right when it's freed elsewhere. Tag frames are closed by the main loop.
+	// Everything is compiled out of production builds, where every count reads as zero.
+	class CAllocTracker
+	{
+	public:
+		struct Counts
+		{
+			u64 allocCount;
+			u64 freeCount;
+			u64 allocBytes;
+		};
+
+		struct TagStats
+		{
+			u64 liveBytes;
+			u64 peakBytes; // Since tagging was switched on, or the peaks were last reset.
+			u64 allocCount;
+			u64 freeCount;
+			u64 allocBytes;
+			u64 frameAllocCount; // In the last closed frame.
+			u64 frameAllocBytes;
+		};
+
+		// Limits for CheckBudget. Zero means no limit.
+		struct TagBudget
+		{
+			ALLOC_TAG tag;
+			u64 peakBytesMax;
+			u64 frameAllocCountMax;
+		};
+
+		// Charges allocations on this thread to a tag until it goes out of scope.
+		class Scope
+		{
+		public:
+			Scope(ALLOC_TAG tag);
+			~Scope();
+			Scope(const Scope&) = delete;
+			Scope(Scope&&) = delete;
+			Scope& operator = (const Scope&) = delete;
+			Scope& operator = (Scope&&) = delete;
+
+		private:
+			ALLOC_TAG m_prevTag;
+		};
+
+	public:
+		static CAllocTracker& Instance()
+		{
+			static thread_local CAllocTracker instance;
+			return instance;
+		}
+
+	private:
+		CAllocTracker();
+		~CAllocTracker();
+		CAllocTracker(const CAllocTracker&) = delete;
+		CAllocTracker(CAllocTracker&&) = delete;
+		CAllocTracker& operator = (const CAllocTracker&) = delete;
+		CAllocTracker& operator = (CAllocTracker&&) = delete;
+
+	public:
+		void EndFrame();
+
+		// Since the thread started.
+		static Counts GetTotal();
+
+		// Since the last frame ended.
+		Counts GetFrame() const;
+
+		// Accessors.
+		inline const Counts& GetLastFrame() const { return m_lastFrame; }
+
+		static bool IsEnabled();
+
+		//-----------------------------------------------------------------------------------------------
+		// Tags.
+		//-----------------------------------------------------------------------------------------------
+
+		// Only blocks allocated while tagging is on are counted when they're freed.
+		static void SetTagging(bool bTagging);
+		static bool IsTagging();
+
+		static void EndTagFrame();
+		static void ResetPeaks();
+
+		static TagStats GetTagStats(ALLOC_TAG tag);
+		static const char* GetTagName(ALLOC_TAG tag);
+
+		// Returns false if the tag's peak or last frame's allocation count is over budget.
+		static bool CheckBudget(const TagBudget& budget);
+
+		// Writes a row per tag, headed by the tag frame it was taken on. Appending to an existing file skips the header, so a file can
+		//  collect a row set every frame.
+		static bool DumpCSV(const std::wstring& path, bool bAppend = false);
+
+	private:
+		Counts m_frameStart;
+		Counts m_lastFrame;
+	};
+};
+
+#endif
@@ -122,6 +122,18 @@ namespace Util
 
 		return false;
 	}
+
+	bool CFileSystem::RemoveFile(const wchar_t* filename)
+	{
+#ifdef PLATFORM_WINDOWS
+		if(DeleteFileW(filename))
+		{
+			return true;
+		}
+#endif
+
+		return false;
+	}
 	
 	void CFileSystem::SplitDirectoryFilenameExtension(const wchar_t* path, std::wstring& dir, std::wstring& filename, std::wstring& extension)
 	{
@@ -45,6 +45,7 @@ namespace Util
 		bool CopyFileTo(const wchar_t* srcFile, const wchar_t* dstFile, bool bAllowOverwrite);
 
 		bool RenameFile(const wchar_t* filenameOld, const wchar_t* filenameNew);
+		bool RemoveFile(const wchar_t* filename);
 		void SplitDirectoryFilenameExtension(const wchar_t* path, std::wstring& dir, std::wstring& filename, std::wstring& extension);
 
 		// Accessors.
@@ -0,0 +1,86 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Utilities/CFrameAllocator.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CFrameAllocator.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace Util
+{
+	CFrameAllocator::CFrameAllocator() :
+		m_pBlock(static_cast<u8*>(::operator new(BLOCK_SIZE))),
+		m_offset(0),
+		m_spillBytes(0),
+		m_stats { 0, 0, 0, BLOCK_SIZE },
+		m_lastFrame(m_stats)
+	{
+	}
+
+	CFrameAllocator::~CFrameAllocator()
+	{
+		for(auto& spill : m_spillList)
+		{
+			::operator delete(spill.first, std::align_val_t(spill.second));
+		}
+
+		::operator delete(m_pBlock);
+	}
+
+	void CFrameAllocator::Reset()
+	{
+		m_lastFrame = m_stats;
+
+		for(auto& spill : m_spillList)
+		{
+			::operator delete(spill.first, std::align_val_t(spill.second));
+		}
+
+		// Grow the block to fit what the frame used, so the next one like it doesn't spill.
+		if(!m_spillList.empty() && m_stats.capacity < BLOCK_SIZE_MAX)
+		{
+			const size_t capacity = std::min(BLOCK_SIZE_MAX, (m_stats.capacity + m_spillBytes + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE);
+
+			::operator delete(m_pBlock);
+			m_pBlock = static_cast<u8*>(::operator new(capacity));
+			m_stats.capacity = capacity;
+		}
+
+		m_spillList.clear();
+		m_spillBytes = 0;
+		m_offset = 0;
+
+		m_stats.allocCount = 0;
+		m_stats.spillCount = 0;
+		m_stats.usedBytes = 0;
+	}
+
+	void* CFrameAllocator::do_allocate(size_t bytes, size_t alignment)
+	{
+		++m_stats.allocCount;
+		m_stats.usedBytes += bytes;
+
+		const uintptr_t base = reinterpret_cast<uintptr_t>(m_pBlock);
+		const size_t offset = static_cast<size_t>(((base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+		if(offset + bytes <= m_stats.capacity)
+		{
+			m_offset = offset + bytes;
+			return m_pBlock + offset;
+		}
+
+		++m_stats.spillCount;
+		m_spillBytes += bytes + alignment;
+
+		alignment = std::max(alignment, alignof(std::max_align_t));
+		void* p = ::operator new(bytes, std::align_val_t(alignment));
+		m_spillList.push_back({ static_cast<u8*>(p), alignment });
+		return p;
+	}
+};
@@ -0,0 +1,83 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Utilities/CFrameAllocator.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CFRAMEALLOCATOR_H
+#define CFRAMEALLOCATOR_H
+
+#include "../Globals/CGlobals.h"
+#include <memory_resource>
+#include <vector>
+
+namespace Util
+{
+	// Scratch memory for the calling thread's current frame. Allocation bumps an offset into one block and freeing does nothing, so
+	//  containers built on it cost no heap traffic, and everything is thrown away at once when the thread's frame ends. Anything allocated
+	//  here must be gone by then: the main loop, the physics thread and each job reset their own arena when they finish a frame or a job.
+	// A frame that outgrows the block spills into extra blocks, which are folded into a larger block at the next reset.
+	class CFrameAllocator : public std::pmr::memory_resource
+	{
+	public:
+		struct Stats
+		{
+			u32 allocCount;
+			u32 spillCount; // Allocations that didn't fit the block.
+			size_t usedBytes;
+			size_t capacity;
+		};
+
+	public:
+		static CFrameAllocator& Instance()
+		{
+			static thread_local CFrameAllocator instance;
+			return instance;
+		}
+
+	private:
+		CFrameAllocator();
+		~CFrameAllocator();
+		CFrameAllocator(const CFrameAllocator&) = delete;
+		CFrameAllocator(CFrameAllocator&&) = delete;
+		CFrameAllocator& operator = (const CFrameAllocator&) = delete;
+		CFrameAllocator& operator = (CFrameAllocator&&) = delete;
+
+	public:
+		// Releases everything allocated since the last reset.
+		void Reset();
+
+		// Accessors.
+		inline const Stats& GetStats() const { return m_stats; } // Since the last reset.
+		inline const Stats& GetLastFrame() const { return m_lastFrame; }
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) final;
+		void do_deallocate(void* p, size_t bytes, size_t alignment) final { }
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept final { return this == &other; }
+
+	private:
+		static constexpr size_t BLOCK_SIZE = 256 * 1024;
+		static constexpr size_t BLOCK_SIZE_MAX = 16 * 1024 * 1024; // The most a reset will keep.
+
+	private:
+		u8* m_pBlock;
+		size_t m_offset;
+
+		std::vector<std::pair<u8*, size_t>> m_spillList;
+		size_t m_spillBytes;
+
+		Stats m_stats;
+		Stats m_lastFrame;
+	};
+
+	// A vector on the calling thread's frame arena.
+	template<typename T>
+	using FrameVector = std::pmr::vector<T>;
+};
+
+#endif
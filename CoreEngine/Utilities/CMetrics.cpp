@@ -0,0 +1,224 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Utilities/CMetrics.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CMetrics.h"
+#include "CDebugError.h"
+#include <algorithm>
+
+namespace Util
+{
+	namespace
+	{
+		const char* TYPE_NAME_LIST[] = {
+			"counter",
+			"gauge",
+			"histogram",
+		};
+
+		// The largest value that lands in a bucket.
+		inline u64 BucketMax(u32 bucket)
+		{
+			return bucket >= 64 ? ~0ULL : (1ULL << bucket) - 1;
+		}
+	};
+
+	CMetrics::CMetrics() :
+		m_period(1.0f),
+		m_startTime(std::chrono::steady_clock::now()),
+		m_lastSnapshotTime(m_startTime),
+		m_lastSnapshot { }
+	{
+	}
+
+	CMetrics::~CMetrics()
+	{
+	}
+
+	void CMetrics::Update()
+	{
+		const auto now = std::chrono::steady_clock::now();
+		if(std::chrono::duration<float>(now - m_lastSnapshotTime).count() < m_period) return;
+
+		m_lastSnapshotTime = now;
+
+		Snapshot snapshot = TakeSnapshot();
+		WriteSink(snapshot);
+
+		std::lock_guard<std::mutex> lk(m_mutex);
+		m_lastSnapshot = std::move(snapshot);
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Registration methods.
+	//-----------------------------------------------------------------------------------------------
+
+	CMetrics::Counter* CMetrics::GetCounter(const std::string& name)
+	{
+		return FindOrAdd(name, Type::Counter).pCounter.get();
+	}
+
+	CMetrics::Gauge* CMetrics::GetGauge(const std::string& name)
+	{
+		return FindOrAdd(name, Type::Gauge).pGauge.get();
+	}
+
+	CMetrics::Histogram* CMetrics::GetHistogram(const std::string& name)
+	{
+		return FindOrAdd(name, Type::Histogram).pHistogram.get();
+	}
+
+	CMetrics::Entry& CMetrics::FindOrAdd(const std::string& name, Type type)
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+
+		auto elem = m_entryMap.find(name);
+		if(elem != m_entryMap.end())
+		{
+			ASSERT(elem->second->type == type);
+			return *elem->second;
+		}
+
+		std::unique_ptr<Entry> pEntry = std::make_unique<Entry>();
+		pEntry->name = name;
+		pEntry->type = type;
+		pEntry->lastValue = 0;
+
+		switch(type)
+		{
+			case Type::Counter:
+				pEntry->pCounter = std::make_unique<Counter>();
+				break;
+			case Type::Gauge:
+				pEntry->pGauge = std::make_unique<Gauge>();
+				break;
+			case Type::Histogram:
+				pEntry->pHistogram = std::make_unique<Histogram>();
+				break;
+		}
+
+		Entry& entry = *pEntry;
+		m_entryMap.insert({ name, pEntry.get() });
+		m_entryList.push_back(std::move(pEntry));
+
+		return entry;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Snapshot methods.
+	//-----------------------------------------------------------------------------------------------
+
+	CMetrics::Snapshot CMetrics::TakeSnapshot()
+	{
+		Snapshot snapshot { };
+		snapshot.time = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_startTime).count();
+
+		std::lock_guard<std::mutex> lk(m_mutex);
+		snapshot.sampleList.reserve(m_entryList.size());
+
+		for(const auto& pEntry : m_entryList)
+		{
+			Sample sample { };
+			sample.name = pEntry->name;
+			sample.type = pEntry->type;
+
+			switch(pEntry->type)
+			{
+				case Type::Counter:
+				{
+					const u64 value = pEntry->pCounter->Get();
+					sample.value = static_cast<s64>(value);
+					sample.delta = static_cast<s64>(value - pEntry->lastValue);
+					pEntry->lastValue = value;
+				} break;
+				case Type::Gauge:
+				{
+					sample.value = pEntry->pGauge->Get();
+				} break;
+				case Type::Histogram:
+				{ // Values recorded while the buckets are drained land in either this snapshot or the next.
+					Histogram& histogram = *pEntry->pHistogram;
+
+					u64 bucketList[Histogram::BUCKET_COUNT];
+					u64 count = 0;
+					for(u32 i = 0; i < Histogram::BUCKET_COUNT; ++i)
+					{
+						bucketList[i] = histogram.m_bucketList[i].exchange(0, std::memory_order_relaxed);
+						count += bucketList[i];
+					}
+
+					const u64 sum = histogram.m_sum.exchange(0, std::memory_order_relaxed);
+					sample.max = histogram.m_max.exchange(0, std::memory_order_relaxed);
+					sample.value = static_cast<s64>(count);
+					if(count == 0) break;
+
+					sample.mean = static_cast<double>(sum) / count;
+
+					u64 seen = 0;
+					for(u32 i = 0; i < Histogram::BUCKET_COUNT; ++i)
+					{
+						seen += bucketList[i];
+						if(sample.p50 == 0 && seen * 2 >= count) sample.p50 = std::min(BucketMax(i), sample.max);
+						if(seen * 20 >= count * 19)
+						{
+							sample.p95 = std::min(BucketMax(i), sample.max);
+							break;
+						}
+					}
+				} break;
+			}
+
+			snapshot.sampleList.push_back(std::move(sample));
+		}
+
+		return snapshot;
+	}
+
+	CMetrics::Snapshot CMetrics::GetLastSnapshot() const
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		return m_lastSnapshot;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Sink methods.
+	//-----------------------------------------------------------------------------------------------
+
+	bool CMetrics::OpenSink(const std::wstring& path)
+	{
+		CloseSink();
+
+		m_sink.open(path, std::ios::trunc);
+		if(!m_sink.is_open()) return false;
+
+		m_sink << "time,name,type,value,delta,mean,p50,p95,max\n";
+		return true;
+	}
+
+	void CMetrics::CloseSink()
+	{
+		if(m_sink.is_open())
+		{
+			m_sink.close();
+		}
+	}
+
+	void CMetrics::WriteSink(const Snapshot& snapshot)
+	{
+		if(!m_sink.is_open()) return;
+
+		for(const Sample& sample : snapshot.sampleList)
+		{
+			m_sink << snapshot.time << ',' << sample.name << ',' << TYPE_NAME_LIST[static_cast<u32>(sample.type)] << ',' << sample.value << ',' <<
+				sample.delta << ',' << sample.mean << ',' << sample.p50 << ',' << sample.p95 << ',' << sample.max << '\n';
+		}
+
+		m_sink.flush();
+	}
+};
@@ -0,0 +1,173 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Utilities/CMetrics.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CMETRICS_H
+#define CMETRICS_H
+
+#include "../Globals/CGlobals.h"
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Util
+{
+	// A registry of named runtime metrics that subsystems publish into. Metrics are created on first lookup and live as long as the
+	//  registry, so publishers look one up once and keep the pointer, and publishing is a single relaxed atomic.
+	// Unlike the profiler and allocation tracker, metrics stay in production builds.
+	class CMetrics
+	{
+	public:
+		enum class Type : u8
+		{
+			Counter,
+			Gauge,
+			Histogram,
+		};
+
+		// Only ever increases, such as rays cast. Snapshots report the increase since the previous snapshot alongside the total.
+		class Counter
+		{
+		public:
+			inline void Add(u64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+			inline u64 Get() const { return m_value.load(std::memory_order_relaxed); }
+
+		private:
+			std::atomic<u64> m_value { 0 };
+		};
+
+		// A level that rises and falls, such as voices in use.
+		class Gauge
+		{
+		public:
+			inline void Set(s64 value) { m_value.store(value, std::memory_order_relaxed); }
+			inline void Add(s64 n) { m_value.fetch_add(n, std::memory_order_relaxed); }
+			inline s64 Get() const { return m_value.load(std::memory_order_relaxed); }
+
+		private:
+			std::atomic<s64> m_value { 0 };
+		};
+
+		// A distribution, bucketed by powers of two. Each snapshot takes the values recorded since the previous one.
+		class Histogram
+		{
+		public:
+			static const u32 BUCKET_COUNT = 65; // By bit width.
+
+		public:
+			inline void Record(u64 value)
+			{
+				m_bucketList[std::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+				m_sum.fetch_add(value, std::memory_order_relaxed);
+
+				u64 max = m_max.load(std::memory_order_relaxed);
+				while(value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) { }
+			}
+
+		private:
+			friend class CMetrics;
+
+			std::atomic<u64> m_bucketList[BUCKET_COUNT] { };
+			std::atomic<u64> m_sum { 0 };
+			std::atomic<u64> m_max { 0 };
+		};
+
+		struct Sample
+		{
+			std::string name;
+			Type type;
+			s64 value; // Counter total, gauge level, or histogram values recorded.
+			s64 delta; // Counter increase.
+			double mean; // Histograms only. Percentiles are bucket upper bounds.
+			u64 p50;
+			u64 p95;
+			u64 max;
+		};
+
+		struct Snapshot
+		{
+			float time; // Seconds since the registry was created.
+			std::vector<Sample> sampleList;
+		};
+
+	private:
+		struct Entry
+		{
+			std::string name;
+			Type type;
+			std::unique_ptr<Counter> pCounter;
+			std::unique_ptr<Gauge> pGauge;
+			std::unique_ptr<Histogram> pHistogram;
+			u64 lastValue;
+		};
+
+	public:
+		static CMetrics& Instance()
+		{
+			static CMetrics instance;
+			return instance;
+		}
+
+	private:
+		CMetrics();
+		~CMetrics();
+		CMetrics(const CMetrics&) = delete;
+		CMetrics(CMetrics&&) = delete;
+		CMetrics& operator = (const CMetrics&) = delete;
+		CMetrics& operator = (CMetrics&&) = delete;
+
+	public:
+		// Called once a frame by the main loop. Takes a snapshot whenever the period has passed, and writes it to the sink if one is open.
+		void Update();
+
+		Counter* GetCounter(const std::string& name);
+		Gauge* GetGauge(const std::string& name);
+		Histogram* GetHistogram(const std::string& name);
+
+		// Restarts counter deltas and histograms, so periodic snapshots should be left to Update while it's running.
+		Snapshot TakeSnapshot();
+
+		// Appends every snapshot Update takes to a CSV file, a row per metric.
+		bool OpenSink(const std::wstring& path);
+		void CloseSink();
+
+		// Accessors.
+		inline float GetSnapshotPeriod() const { return m_period; }
+
+		// Modifiers.
+		inline void SetSnapshotPeriod(float period) { m_period = period; }
+
+		// The last snapshot taken by Update.
+		Snapshot GetLastSnapshot() const;
+
+	private:
+		Entry& FindOrAdd(const std::string& name, Type type);
+		void WriteSink(const Snapshot& snapshot);
+
+	private:
+		float m_period;
+		std::chrono::steady_clock::time_point m_startTime;
+		std::chrono::steady_clock::time_point m_lastSnapshotTime;
+
+		mutable std::mutex m_mutex;
+		std::vector<std::unique_ptr<Entry>> m_entryList; // In registration order.
+		std::unordered_map<std::string, Entry*> m_entryMap;
+
+		Snapshot m_lastSnapshot;
+		std::ofstream m_sink;
+	};
+};
+
+#endif
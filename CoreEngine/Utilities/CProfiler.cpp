@@ -0,0 +1,245 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Utilities/CProfiler.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CProfiler.h"
+
+#ifdef PROFILER_ENABLED
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	const u32 DEPTH_FRAME = 0xFFFFFFFF;
+
+	struct Event
+	{
+		const char* name;
+		u64 start;
+		u64 end;
+		u32 depth; // DEPTH_FRAME for frame markers.
+	};
+
+	// Written only by its thread. Readers take the write index, copy, then take it again to find what was overwritten under them.
+	struct ThreadRing
+	{
+		u32 tid;
+		std::string name;
+		std::atomic<u64> writeIndex;
+		Event eventList[Util::CProfiler::RING_SIZE];
+	};
+
+	std::atomic<bool> g_bCapturing(false);
+	std::atomic<u64> g_captureStart(0);
+
+	// Rings outlive their threads, so a capture can still be exported after a thread exits.
+	std::mutex g_ringMutex;
+	std::vector<std::unique_ptr<ThreadRing>> g_ringList;
+
+	thread_local ThreadRing* t_pRing = nullptr;
+	thread_local u32 t_depth = 0;
+	thread_local u64 t_frameStart = 0;
+
+	inline u64 Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	ThreadRing* GetRing()
+	{
+		if(t_pRing == nullptr)
+		{
+			std::unique_ptr<ThreadRing> pRing = std::make_unique<ThreadRing>();
+			pRing->writeIndex = 0;
+
+			std::lock_guard<std::mutex> lk(g_ringMutex);
+			pRing->tid = static_cast<u32>(g_ringList.size()) + 1;
+			t_pRing = pRing.get();
+			g_ringList.push_back(std::move(pRing));
+		}
+
+		return t_pRing;
+	}
+
+	void Record(const char* name, u64 start, u64 end, u32 depth)
+	{
+		ThreadRing* pRing = GetRing();
+		const u64 index = pRing->writeIndex.load(std::memory_order_relaxed);
+
+		Event& e = pRing->eventList[index & (Util::CProfiler::RING_SIZE - 1)];
+		e.name = name;
+		e.start = start;
+		e.end = end;
+		e.depth = depth;
+
+		pRing->writeIndex.store(index + 1, std::memory_order_release);
+	}
+
+	void WriteString(std::ofstream& file, const char* str)
+	{
+		file << '"';
+		for(; *str; ++str)
+		{
+			if(*str == '"' || *str == '\\') file << '\\';
+			file << *str;
+		}
+		file << '"';
+	}
+};
+#endif
+
+namespace Util
+{
+	//-----------------------------------------------------------------------------------------------
+	// CProfiler::Zone methods.
+	//-----------------------------------------------------------------------------------------------
+
+#ifdef PROFILER_ENABLED
+	CProfiler::Zone::Zone(const char* name) :
+		m_name(name),
+		m_start(0)
+	{
+		if(!g_bCapturing.load(std::memory_order_relaxed)) return;
+
+		m_start = Now();
+		++t_depth;
+	}
+
+	CProfiler::Zone::~Zone()
+	{
+		if(m_start == 0) return;
+
+		--t_depth;
+		Record(m_name, m_start, Now(), t_depth);
+	}
+#else
+	CProfiler::Zone::Zone(const char* name) :
+		m_name(name),
+		m_start(0)
+	{
+	}
+
+	CProfiler::Zone::~Zone() { }
+#endif
+
+	//-----------------------------------------------------------------------------------------------
+	// CProfiler methods.
+	//-----------------------------------------------------------------------------------------------
+
+	void CProfiler::StartCapture()
+	{
+#ifdef PROFILER_ENABLED
+		g_captureStart = Now();
+		g_bCapturing = true;
+#endif
+	}
+
+	void CProfiler::StopCapture()
+	{
+#ifdef PROFILER_ENABLED
+		g_bCapturing = false;
+#endif
+	}
+
+	bool CProfiler::IsCapturing()
+	{
+#ifdef PROFILER_ENABLED
+		return g_bCapturing;
+#else
+		return false;
+#endif
+	}
+
+	void CProfiler::MarkFrame()
+	{
+#ifdef PROFILER_ENABLED
+		const u64 now = Now();
+		if(g_bCapturing.load(std::memory_order_relaxed) && t_frameStart)
+		{
+			Record("Frame", t_frameStart, now, DEPTH_FRAME);
+		}
+
+		t_frameStart = now;
+#endif
+	}
+
+	void CProfiler::SetThreadName(const char* name)
+	{
+#ifdef PROFILER_ENABLED
+		ThreadRing* pRing = GetRing();
+
+		std::lock_guard<std::mutex> lk(g_ringMutex);
+		pRing->name = name;
+#endif
+	}
+
+	bool CProfiler::ExportChromeTrace(const std::wstring& path)
+	{
+#ifdef PROFILER_ENABLED
+		std::ofstream file(path, std::ios::trunc);
+		if(!file.is_open()) return false;
+
+		file << std::fixed;
+		file.precision(3);
+
+		const u64 captureStart = g_captureStart;
+		std::vector<Event> eventList;
+		bool bFirst = true;
+
+		file << "{\"traceEvents\":[\n";
+
+		std::lock_guard<std::mutex> lk(g_ringMutex);
+		for(const auto& pRing : g_ringList)
+		{
+			const u64 end = pRing->writeIndex.load(std::memory_order_acquire);
+			const u64 begin = end > RING_SIZE ? end - RING_SIZE : 0;
+
+			eventList.clear();
+			for(u64 i = begin; i < end; ++i)
+			{
+				eventList.push_back(pRing->eventList[i & (RING_SIZE - 1)]);
+			}
+
+			// Anything the thread has wrapped over since the copy started is torn, including the slot of the event it may be writing now.
+			const u64 endAfter = pRing->writeIndex.load(std::memory_order_acquire);
+			const u64 validBegin = endAfter + 1 > RING_SIZE ? endAfter + 1 - RING_SIZE : 0;
+			const size_t skipCount = validBegin > begin ? static_cast<size_t>(std::min(validBegin - begin, end - begin)) : 0;
+
+			if(!bFirst) file << ",\n";
+			bFirst = false;
+
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << pRing->tid << ",\"args\":{\"name\":";
+			WriteString(file, pRing->name.empty() ? ("Thread " + std::to_string(pRing->tid)).c_str() : pRing->name.c_str());
+			file << "}}";
+
+			for(size_t i = skipCount; i < eventList.size(); ++i)
+			{
+				const Event& e = eventList[i];
+				if(e.start < captureStart) continue;
+
+				file << ",\n{\"name\":";
+				WriteString(file, e.name);
+				file << ",\"cat\":\"" << (e.depth == DEPTH_FRAME ? "frame" : "zone") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << pRing->tid <<
+					",\"ts\":" << (e.start - captureStart) / 1000.0 << ",\"dur\":" << (e.end - e.start) / 1000.0 << "}";
+			}
+		}
+
+		file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+		return file.good();
+#else
+		return false;
+#endif
+	}
+};
@@ -0,0 +1,83 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Engine
+//
+// File: Utilities/CProfiler.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CPROFILER_H
+#define CPROFILER_H
+
+#include "../Globals/CGlobals.h"
+#include <string>
+
+// Zones are compiled into every build but production, unless PROFILER_DISABLED is defined.
+#if !defined(PRODUCTION_BUILD) && !defined(PROFILER_DISABLED)
+#define PROFILER_ENABLED
+#endif
+
+#ifdef PROFILER_ENABLED
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// Times the rest of the enclosing scope. The name must outlive the capture, so pass a literal.
+#define PROFILE_ZONE(name) Util::CProfiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+#define PROFILE_FRAME() Util::CProfiler::MarkFrame()
+#define PROFILE_THREAD(name) Util::CProfiler::SetThreadName(name)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_FRAME()
+#define PROFILE_THREAD(name)
+#endif
+
+namespace Util
+{
+	// An instrumented CPU profiler. Zones record into a ring owned by their thread, so recording never locks; the rings are only walked
+	//  on export, which drops anything overwritten while it reads. Zones nest, and each thread's frames are marked where it loops.
+	// Nothing is recorded unless a capture is running.
+	class CProfiler
+	{
+	public:
+		// Events per thread ring. Older events are overwritten once a thread fills its ring.
+		static const u32 RING_SIZE = 1 << 15;
+
+		class Zone
+		{
+		public:
+			Zone(const char* name);
+			~Zone();
+			Zone(const Zone&) = delete;
+			Zone(Zone&&) = delete;
+			Zone& operator = (const Zone&) = delete;
+			Zone& operator = (Zone&&) = delete;
+
+		private:
+			const char* m_name;
+			u64 m_start;
+		};
+
+	private:
+		CProfiler() = delete;
+
+	public:
+		static void StartCapture();
+		static void StopCapture();
+		static bool IsCapturing();
+
+		// Closes the calling thread's frame and opens the next.
+		static void MarkFrame();
+
+		// Labels the calling thread in exports.
+		static void SetThreadName(const char* name);
+
+		// Writes the capture so far as Chrome trace JSON, which Perfetto also loads. Safe to call while capturing.
+		static bool ExportChromeTrace(const std::wstring& path);
+	};
+};
+
+#endif
@@ -16,6 +16,7 @@ namespace Util
 	CTimer::CTimer()
 	{
 		m_maxTimeStep = 1.0f / 3.0f;
+		m_fixedDelta = 0.0f;
 		m_delta = 0.0f;
 		m_smoothDelta = 0.0f;
 
@@ -44,7 +45,11 @@ namespace Util
 		std::chrono::duration<float> timeCounter = currentTime - m_lastTime;
 		float timeElapsed = timeCounter.count() * m_timeScale;
 
-		if(m_targetFrameRate > 0.0f)
+		if(m_fixedDelta > 0.0f)
+		{
+			timeElapsed = m_fixedDelta * m_timeScale;
+		}
+		else if(m_targetFrameRate > 0.0f)
 		{
 			// Wait for target frame rate to be reached before moving on (only if 'm_targetFrameRate' > 0.0f).
 			if(timeElapsed < m_targetFrameDelay)
@@ -51,6 +51,10 @@ namespace Util
 		inline float GetMaxTimeStep() const { return m_maxTimeStep; }
 		inline void SetMaxTimeStep(float maxStep) { m_maxTimeStep = maxStep; }
 
+		// While above zero, every tick advances by exactly this much, however long the frame took, and never waits on the target frame rate.
+		inline float GetFixedDelta() const { return m_fixedDelta; }
+		inline void SetFixedDelta(float fixedDelta) { m_fixedDelta = fixedDelta; }
+
 		inline float GetTargetFrameRate() const { return m_targetFrameRate; }
 		inline void SetTargetFrameRate(float targetFPS)
 		{
@@ -69,6 +73,7 @@ namespace Util
 	private:
 		float m_timeScale;
 		float m_maxTimeStep;
+		float m_fixedDelta;
 		float m_delta;
 		float m_smoothDelta;
 
@@ -35,9 +35,7 @@ namespace Actor
 
 	void CSpawner::Spawn(CPawn* pawn)
 	{
-		auto elem = m_dataMap.begin();
-
-		auto& transform = *reinterpret_cast<Logic::CNodeTransform::Data*>(App::CCoreManager::Instance().NodeRegistry().GetComponentFromObject(Logic::CNodeTransform::HASH, elem->second.GetThis()));
+		auto& transform = *reinterpret_cast<Logic::CNodeTransform::Data*>(App::CCoreManager::Instance().NodeRegistry().GetComponentFromObject(Logic::CNodeTransform::HASH, m_pool.begin()->GetThis()));
 		pawn->SetPosition(transform.GetPosition() + Math::SIMD_VEC_UP * 2.0f);
 		pawn->SetEulerAngles(*(Math::Vector3*)transform.GetEuler().ToFloat());
 	}
@@ -46,26 +44,26 @@ namespace Actor
 	// Object methods.
 	//---------------------------------------------
 
-	void* CSpawner::AddToObject(u64 objHash)
+	void* CSpawner::AddToObject(ObjectHandle handle)
 	{
-		return &m_dataMap.insert({ objHash, Data(objHash) }).first->second;
+		return &m_pool[m_pool.Add(handle, handle)];
 	}
 	
-	void* CSpawner::GetFromObject(u64 objHash)
+	void* CSpawner::GetFromObject(ObjectHandle handle)
 	{
-		return &m_dataMap.find(objHash)->second;
+		return &m_pool[m_pool.Find(handle)];
 	}
 
-	bool CSpawner::TryToGetFromObject(u64 objHash, void** ppData)
+	bool CSpawner::TryToGetFromObject(ObjectHandle handle, void** ppData)
 	{
-		auto elem = m_dataMap.find(objHash);
-		if(elem == m_dataMap.end()) return false;
-		*ppData = &elem->second;
+		const u32 id = m_pool.Find(handle);
+		if(id == CNodePool<Data>::NONE) return false;
+		*ppData = &m_pool[id];
 		return true;
 	}
 
-	void CSpawner::RemoveFromObject(u64 objHash)
+	void CSpawner::RemoveFromObject(ObjectHandle handle)
 	{
-		m_dataMap.erase(objHash);
+		m_pool.Remove(m_pool.Find(handle));
 	}
 };
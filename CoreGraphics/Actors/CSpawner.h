@@ -12,9 +12,9 @@
 #define CSPAWNER_H
 
 #include <Objects/CNodeComponent.h>
+#include <Objects/CNodePool.h>
 #include <Objects/CVObject.h>
 #include <Math/CMathFNV.h>
-#include <unordered_map>
 
 
 namespace Actor
@@ -28,7 +28,7 @@ namespace Actor
 		struct Data
 		{
 		public:
-			Data(u64 thisHash) : m_this(thisHash) { }
+			Data(ObjectHandle thisHandle) : m_this(thisHandle) { }
 			~Data() { }
 			Data(const Data&) = default;
 			Data(Data&&) = default;
@@ -36,10 +36,10 @@ namespace Actor
 			Data& operator = (Data&&) = default;
 
 			// Accessors.
-			inline u64 GetThis() const { return m_this; }
+			inline ObjectHandle GetThis() const { return m_this; }
 
 		private:
-			u64 m_this;
+			ObjectHandle m_this;
 		};
 
 	private:
@@ -57,13 +57,13 @@ namespace Actor
 		void Spawn(class CPawn* pawn);
 
 	private:
-		void* AddToObject(u64 objHash) final;
-		void* GetFromObject(u64 objHash) final;
-		bool TryToGetFromObject(u64 objHash, void** ppData) final;
-		void RemoveFromObject(u64 objHash) final;
+		void* AddToObject(ObjectHandle handle) final;
+		void* GetFromObject(ObjectHandle handle) final;
+		bool TryToGetFromObject(ObjectHandle handle, void** ppData) final;
+		void RemoveFromObject(ObjectHandle handle) final;
 
 	private:
-		std::unordered_map<u64, Data> m_dataMap;
+		CNodePool<Data> m_pool;
 	};
 };
 
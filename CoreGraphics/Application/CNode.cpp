@@ -42,6 +42,7 @@ namespace App
 			data.chunkWidth = 32;
 			data.chunkHeight = 32;
 			data.chunkLength = 32;
+			data.lodLevelMax = Universe::CHUNK_LOD_LEVEL_LIMIT;
 			data.pChunkGen = &m_chunkGenNull;
 			m_chunkNode.SetData(data);
 			m_chunkNode.Initialize();
@@ -20,6 +20,7 @@
 #include <Utilities/CMemoryFree.h>
 #include <Utilities/CDebugError.h>
 #include <Utilities/CFileUtil.h>
+#include <Utilities/CProfiler.h>
 
 namespace App
 {
@@ -69,6 +70,7 @@ namespace App
 
 	void CPlatform::LoadAssets()
 	{
+		PROFILE_THREAD("Main");
 		m_pApp->Create();
 		CSceneManager::Instance().Initialize();
 	}
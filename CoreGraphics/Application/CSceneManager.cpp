@@ -19,6 +19,7 @@
 #include "../Graphics/CGraphicsAPI.h"
 #include "../UI/CUISelect.h"
 #include <Application/CCoreManager.h>
+#include <Logic/CNodeTransform.h>
 #include <Physics/CPhysics.h>
 
 namespace App
@@ -36,6 +37,12 @@ namespace App
 	void CSceneManager::Initialize()
 	{
 		Util::CJobSystem::Instance().Initialize();
+		Logic::CNodeTransform::Get().SetParallelFor([](u32 count, u32 batchSize, std::function<void(u32, u32)> func){
+			Util::CJobSystem::Instance().ParallelFor(count, batchSize, func);
+		});
+		App::CCoreManager::Instance().NodeRegistry().SetParallelFor([](u32 count, u32 batchSize, std::function<void(u32, u32)> func){
+			Util::CJobSystem::Instance().ParallelFor(count, batchSize, func);
+		});
 		
 		m_audioMixer.Intialize();
 		Resources::CManager::Instance().Initialize();
@@ -13,32 +13,25 @@
 #include "CAudioSource.h"
 #include "CAudioClip.h"
 #include "CAudioVoice.h"
+#include "CAudio.h"
+#include "../Factory/CFactory.h"
+#include <Utilities/CAllocTracker.h>
 #include <Utilities/CMemoryFree.h>
 #include <Utilities/CDebugError.h>
 
-#ifdef PLATFORM_WINDOWS
-#include "CWinAudio.h"
-#endif
-#ifdef PLATFORM_LINUX
-#endif
-
 namespace Audio
 {
 	CAudioMixer::CAudioMixer() :
-		m_pAudio(nullptr) {
+		m_pAudio(nullptr),
+		m_pVoiceMetric(Util::CMetrics::Instance().GetGauge("audio.voicesInUse")),
+		m_pVoiceCreateMetric(Util::CMetrics::Instance().GetCounter("audio.voicesCreated")) {
 	}
 
 	CAudioMixer::~CAudioMixer() { }
 
 	void CAudioMixer::Intialize()
 	{
-#ifdef PLATFORM_WINDOWS
-		m_pAudio = new CWinAudio();
-#endif
-#ifdef PLATFORM_LINUX
-		m_pAudio = new CLinuxAudio();
-#endif
-
+		m_pAudio = CFactory::Instance().CreateAudio();
 		m_pAudio->Initialize();
 	}
 
@@ -48,12 +41,15 @@ namespace Audio
 
 	void CAudioMixer::Update()
 	{
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_AUDIO);
+
 		{ // Pop through reset queue.
 			CAudioVoice* pVoice;
 			while(m_resetDeque.TryPopFront(pVoice))
 			{
 				pVoice->Reset();
 				QueueVoice(pVoice->GetHash(), pVoice);
+				m_pVoiceMetric->Add(-1);
 			}
 		}
 
@@ -73,9 +69,11 @@ namespace Audio
 				{
 					pVoice = m_pAudio->CreateVoice();
 					pVoice->Initialize(pair.first->GetClip()->GetInfo());
+					m_pVoiceCreateMetric->Add();
 				}
 
 				pVoice->Submit(pair.first, pair.second);
+				m_pVoiceMetric->Add(1);
 			}
 		}
 	}
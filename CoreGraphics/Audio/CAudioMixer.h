@@ -12,6 +12,7 @@
 #define CAUDIOMIXER_H
 
 #include <Utilities/CTSDeque.h>
+#include <Utilities/CMetrics.h>
 #include <Globals/CGlobals.h>
 #include <unordered_map>
 #include <queue>
@@ -63,6 +64,9 @@ namespace Audio
 		std::unordered_map<u64, std::queue<class CAudioVoice*>> m_voicePoolMap;
 
 		class CAudio* m_pAudio;
+
+		Util::CMetrics::Gauge* m_pVoiceMetric;
+		Util::CMetrics::Counter* m_pVoiceCreateMetric;
 	};
 };
 
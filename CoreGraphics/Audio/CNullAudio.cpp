@@ -0,0 +1,46 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Audio/CNullAudio.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CNullAudio.h"
+#include "CNullAudioGroup.h"
+#include "CNullAudioVoice.h"
+
+namespace Audio
+{
+	CNullAudio::CNullAudio()
+	{
+	}
+
+	CNullAudio::~CNullAudio()
+	{
+	}
+
+	void CNullAudio::Initialize()
+	{
+	}
+
+	void CNullAudio::Release()
+	{
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Creation methods.
+	//-----------------------------------------------------------------------------------------------
+
+	CAudioGroup* CNullAudio::CreateGroup()
+	{
+		return new CNullAudioGroup(this);
+	}
+
+	CAudioVoice* CNullAudio::CreateVoice()
+	{
+		return new CNullAudioVoice(this);
+	}
+};
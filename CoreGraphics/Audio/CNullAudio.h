@@ -0,0 +1,37 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Audio/CNullAudio.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CNULLAUDIO_H
+#define CNULLAUDIO_H
+
+#include "CAudio.h"
+
+namespace Audio
+{
+	// An audio back end without a device, for headless runs. Voices finish as soon as they're submitted, so the mixer's pools still turn over.
+	class CNullAudio : public CAudio
+	{
+	public:
+		CNullAudio();
+		~CNullAudio();
+		CNullAudio(const CNullAudio&) = delete;
+		CNullAudio(CNullAudio&&) = delete;
+		CNullAudio& operator = (const CNullAudio&) = delete;
+		CNullAudio& operator = (CNullAudio&&) = delete;
+
+		void Initialize() final;
+		void Release() final;
+
+		class CAudioGroup* CreateGroup() final;
+		class CAudioVoice* CreateVoice() final;
+	};
+};
+
+#endif
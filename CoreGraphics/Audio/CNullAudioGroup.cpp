@@ -0,0 +1,31 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Audio/CNullAudioGroup.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CNullAudioGroup.h"
+
+namespace Audio
+{
+	CNullAudioGroup::CNullAudioGroup(class CAudio* pAudio) :
+		CAudioGroup(pAudio)
+	{
+	}
+
+	CNullAudioGroup::~CNullAudioGroup()
+	{
+	}
+	
+	void CNullAudioGroup::Initialize()
+	{
+	}
+
+	void CNullAudioGroup::Release()
+	{
+	}
+};
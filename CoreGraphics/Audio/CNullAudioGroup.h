@@ -0,0 +1,33 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Audio/CNullAudioGroup.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CNULLAUDIOGROUP_H
+#define CNULLAUDIOGROUP_H
+
+#include "CAudioGroup.h"
+
+namespace Audio
+{
+	class CNullAudioGroup : public CAudioGroup
+	{
+	public:
+		CNullAudioGroup(class CAudio* pAudio);
+		virtual ~CNullAudioGroup();
+		CNullAudioGroup(const CNullAudioGroup&) = delete;
+		CNullAudioGroup(CNullAudioGroup&&) = delete;
+		CNullAudioGroup& operator = (const CNullAudioGroup&) = delete;
+		CNullAudioGroup& operator = (CNullAudioGroup&&) = delete;
+		
+		void Initialize() final;
+		void Release() final;
+	};
+};
+
+#endif
@@ -0,0 +1,51 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Audio/CNullAudioVoice.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CNullAudioVoice.h"
+#include "CAudioSource.h"
+#include "CAudioClip.h"
+#include "../Application/CSceneManager.h"
+
+namespace Audio
+{
+	CNullAudioVoice::CNullAudioVoice(class CAudio* pAudio) :
+		CAudioVoice(pAudio),
+		m_info{ }
+	{
+	}
+
+	CNullAudioVoice::~CNullAudioVoice()
+	{
+	}
+
+	void CNullAudioVoice::Initialize(const AudioInfo& info)
+	{
+		m_info = info;
+	}
+
+	void CNullAudioVoice::Reset()
+	{
+	}
+
+	// Nothing is played, so the voice is handed straight back to the mixer's pool.
+	void CNullAudioVoice::Submit(CAudioSource* pSource, float volumeMul)
+	{
+		m_info = pSource->GetClip()->GetInfo();
+		App::CSceneManager::Instance().AudioMixer().ResetVoice(this);
+	}
+
+	void CNullAudioVoice::SourceCallback(AUDIO_ACTION action)
+	{
+	}
+
+	void CNullAudioVoice::Release()
+	{
+	}
+};
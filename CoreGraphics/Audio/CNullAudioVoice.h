@@ -0,0 +1,42 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Audio/CNullAudioVoice.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CNULLAUDIOVOICE_H
+#define CNULLAUDIOVOICE_H
+
+#include "CAudioVoice.h"
+
+namespace Audio
+{
+	class CNullAudioVoice : public CAudioVoice
+	{
+	public:
+		CNullAudioVoice(class CAudio* pAudio);
+		~CNullAudioVoice();
+		CNullAudioVoice(const CNullAudioVoice&) = delete;
+		CNullAudioVoice(CNullAudioVoice&&) = delete;
+		CNullAudioVoice& operator = (const CNullAudioVoice&) = delete;
+		CNullAudioVoice& operator = (CNullAudioVoice&&) = delete;
+
+		void Initialize(const AudioInfo& info) final;
+		void Reset() final;
+		void Submit(class CAudioSource* pSource, float volumeMul = 1.0f) final;
+		void SourceCallback(AUDIO_ACTION action) final;
+		void Release() final;
+
+		// Accessors.
+		inline u64 GetHash() const final { return m_info.hash; }
+
+	private:
+		AudioInfo m_info;
+	};
+};
+
+#endif
@@ -10,10 +10,15 @@
 
 #include "CFactory.h"
 
+#include "../Graphics/CNullWorker.h"
+#include "../Graphics/CNullMeshRenderer_.h"
+#include "../Audio/CNullAudio.h"
+
 #ifdef PLATFORM_WINDOWS
 #include "../Application/CWinPlatform.h"
 #include "../Application/CWinPanel.h"
 #include "../Application/CWinDeviceList.h"
+#include "../Audio/CWinAudio.h"
 #endif
 #ifdef PLATFORM_LINUX
 #endif
@@ -35,6 +40,7 @@
 #include <Utilities/CMemoryFree.h>
 
 CFactory::CFactory() :
+	m_bHeadless(false),
 	m_pPlatform(nullptr),
 	m_pGraphics(nullptr),
 	m_pShaderCompiler(nullptr)
@@ -48,7 +54,7 @@ void CFactory::Release()
 	m_rootSigRegistrar.Release();
 
 	SAFE_DELETE(m_pShaderCompiler);
-	m_pGraphics->Sync();
+	if(m_pGraphics) { m_pGraphics->Sync(); }
 	SAFE_RELEASE_DELETE(m_pPlatform);
 	SAFE_RELEASE_DELETE(m_pGraphics);
 }
@@ -185,6 +191,8 @@ Graphics::CTexture* CFactory::CreateTexture()
 
 Graphics::CMeshRenderer_* CFactory::CreateMeshRenderer(const CVObject* pObject)
 {
+	if(m_bHeadless) { return new Graphics::CNullMeshRenderer_(pObject); }
+
 #ifdef GRAPHICS_DX12
 	return new Graphics::CDX12MeshRenderer_(pObject);
 #endif
@@ -210,6 +218,8 @@ Graphics::CCompute* CFactory::CreateCompute(const CVObject* pObject)
 
 Graphics::CGraphicsWorker* CFactory::CreateGraphicsWorker()
 {
+	if(m_bHeadless) { return new Graphics::CNullWorker(); }
+
 #ifdef GRAPHICS_DX12
 	return new Graphics::CDX12Worker();
 #endif
@@ -219,3 +229,21 @@ Graphics::CGraphicsWorker* CFactory::CreateGraphicsWorker()
 
 	return nullptr;
 }
+
+//
+// Back end creators.
+//
+
+Audio::CAudio* CFactory::CreateAudio()
+{
+	if(m_bHeadless) { return new Audio::CNullAudio(); }
+
+#ifdef PLATFORM_WINDOWS
+	return new Audio::CWinAudio();
+#endif
+#ifdef PLATFORM_LINUX
+	return new Audio::CLinuxAudio();
+#endif
+
+	return nullptr;
+}
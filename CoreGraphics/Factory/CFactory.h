@@ -36,6 +36,11 @@ namespace Graphics
 	class CCompute;
 };
 
+namespace Audio
+{
+	class CAudio;
+};
+
 class CFactory
 {
 private:
@@ -70,13 +75,24 @@ public:
 	Graphics::CCompute* CreateCompute(const CVObject* pObject);
 	Graphics::CGraphicsWorker* CreateGraphicsWorker();
 
+	Audio::CAudio* CreateAudio();
+
 	// Accessors.
 	inline Graphics::CRootSignature* GetRootSignature(const Graphics::CRootSignature::Data& data)
 	{
 		return m_rootSigRegistrar.Get(data);
 	}
 
+	inline bool IsHeadless() const { return m_bHeadless; }
+
+	// Modifiers.
+	// While headless, mesh renderers, graphics workers and audio are created without a device, so chunks, physics and jobs can run
+	//  without a window. Nothing else has a null version, so it has to be set before anything is created, and only suits code that never draws.
+	inline void SetHeadless(bool bHeadless) { m_bHeadless = bHeadless; }
+
 private:
+	bool m_bHeadless;
+
 	Graphics::CRootSigRegistrar m_rootSigRegistrar;
 
 	App::CPlatform* m_pPlatform;
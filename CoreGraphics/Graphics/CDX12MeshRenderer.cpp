@@ -31,8 +31,8 @@ namespace Graphics
 	// CDX12MeshRenderer::Data
 	//-----------------------------------------------------------------------------------------------
 
-	CDX12MeshRenderer::DX12Data::DX12Data(u64 thisHash) : 
-		Data(thisHash),
+	CDX12MeshRenderer::DX12Data::DX12Data(ObjectHandle thisHandle) : 
+		Data(thisHandle),
 		m_pInstanceData(nullptr),
 		m_pVertexBuffer(nullptr),
 		m_pVertexBufferUpload(nullptr),
@@ -319,7 +319,7 @@ namespace Graphics
 		{
 			for(auto& elem : dataMap.second)
 			{
-				elem.second.Initialize();
+				elem.Initialize();
 			}
 		}
 	}
@@ -330,7 +330,7 @@ namespace Graphics
 		{
 			for(auto& elem : dataMap.second)
 			{
-				elem.second.PostInitialize();
+				elem.PostInitialize();
 			}
 		}
 	}
@@ -342,7 +342,7 @@ namespace Graphics
 
 		for(auto& elem : dataMap->second)
 		{
-			elem.second.Render();
+			elem.Render();
 		}
 	}
 
@@ -352,7 +352,7 @@ namespace Graphics
 		{
 			for(auto& elem : dataMap.second)
 			{
-				elem.second.Release();
+				elem.Release();
 			}
 		}
 	}
@@ -363,7 +363,7 @@ namespace Graphics
 
 	void* CDX12MeshRenderer::AddToObject(CNodeObject* pObject)
 	{
-		m_pDataMap = &m_fullMap.insert({ pObject->GetViewHash(), { } }).first->second;
+		m_pDataMap = &m_fullMap.try_emplace(pObject->GetViewHash()).first->second;
 		return CNodeComponent::AddToObject(pObject);
 	}
 
@@ -386,27 +386,27 @@ namespace Graphics
 	}
 	
 
-	void* CDX12MeshRenderer::AddToObject(u64 objHash)
+	void* CDX12MeshRenderer::AddToObject(ObjectHandle handle)
 	{
-		return &m_pDataMap->insert({ objHash, DX12Data(objHash) }).first->second;
+		return &(*m_pDataMap)[m_pDataMap->Add(handle, handle)];
 	}
 	
-	void* CDX12MeshRenderer::GetFromObject(u64 objHash)
+	void* CDX12MeshRenderer::GetFromObject(ObjectHandle handle)
 	{
-		return &m_pDataMap->find(objHash)->second;
+		return &(*m_pDataMap)[m_pDataMap->Find(handle)];
 	}
 
-	bool CDX12MeshRenderer::TryToGetFromObject(u64 objHash, void** ppData)
+	bool CDX12MeshRenderer::TryToGetFromObject(ObjectHandle handle, void** ppData)
 	{
-		auto elem = m_pDataMap->find(objHash);
-		if(elem == m_pDataMap->end()) return false;
-		*ppData = &elem->second;
+		const u32 id = m_pDataMap->Find(handle);
+		if(id == CNodePool<DX12Data>::NONE) return false;
+		*ppData = &(*m_pDataMap)[id];
 		return true;
 	}
 
-	void CDX12MeshRenderer::RemoveFromObject(u64 objHash)
+	void CDX12MeshRenderer::RemoveFromObject(ObjectHandle handle)
 	{
-		m_pDataMap->erase(objHash);
+		m_pDataMap->Remove(m_pDataMap->Find(handle));
 	}
 };
 
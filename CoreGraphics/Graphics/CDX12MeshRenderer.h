@@ -12,6 +12,7 @@
 #define CDX12MESHRENDERER_H
 
 #include "CMeshRenderer.h"
+#include <Objects/CNodePool.h>
 #include <d3d12.h>
 
 namespace Graphics
@@ -25,7 +26,7 @@ namespace Graphics
 			friend class CDX12MeshRenderer;
 
 		public:
-			DX12Data(u64 thisHash);
+			DX12Data(ObjectHandle thisHandle);
 			~DX12Data();
 			DX12Data(const DX12Data&) = default;
 			DX12Data(DX12Data&&) = default;
@@ -82,14 +83,14 @@ namespace Graphics
 		bool TryToGetFromObject(const CNodeObject* pObject, void** ppData) final;
 		void RemoveFromObject(CNodeObject* pObject) final;
 
-		void* AddToObject(u64 objHash) final;
-		void* GetFromObject(u64 objHash) final;
-		bool TryToGetFromObject(u64 objHash, void** ppData) final;
-		void RemoveFromObject(u64 objHash) final;
+		void* AddToObject(ObjectHandle handle) final;
+		void* GetFromObject(ObjectHandle handle) final;
+		bool TryToGetFromObject(ObjectHandle handle, void** ppData) final;
+		void RemoveFromObject(ObjectHandle handle) final;
 
 	private:
-		std::unordered_map<u32, std::unordered_map<u64, DX12Data>> m_fullMap;
-		std::unordered_map<u64, DX12Data>* m_pDataMap;
+		std::unordered_map<u32, CNodePool<DX12Data>> m_fullMap;
+		CNodePool<DX12Data>* m_pDataMap;
 	};
 };
 
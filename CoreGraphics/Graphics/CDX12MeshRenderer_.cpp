@@ -123,7 +123,7 @@ namespace Graphics
 
 			if(!m_data.bDynamicInstances || !m_data.bDynamicInstanceCount)
 			{ // Bundle based drawing is only supported for renderers without a dynamically counted instance buffer.
-				SetupDraw(m_pBundleList[i]);
+				SetupDraw(m_pBundleList[i], i);
 			}
 
 			ASSERT_HR_R(m_pBundleList[i]->Close());
@@ -160,7 +160,31 @@ namespace Graphics
 
 		if(bPreFrameUpdate)
 		{ // Dynamic instance buffers require pre-frame draw configuration.
-			SetupDraw(m_pDX12Graphics->GetRealtimeCommandList());
+			SetupDraw(m_pDX12Graphics->GetRealtimeCommandList(), materialIndex);
+		}
+	}
+
+	// Recorded straight into the realtime command list, since the ranges change every frame.
+	void CDX12MeshRenderer_::RenderRangesWithMaterial(size_t materialIndex, const IndexRange* pRangeList, size_t rangeCount)
+	{
+		if(m_data.pMeshData->GetInstanceSizeMax() || m_data.pMeshData->GetIndexSize() == 0)
+		{
+			RenderWithMaterial(materialIndex);
+			return;
+		}
+
+		if(rangeCount == 0) return;
+
+		CMeshRenderer_::RenderRangesWithMaterial(materialIndex, pRangeList, rangeCount);
+
+		ID3D12GraphicsCommandList* pCommandList = m_pDX12Graphics->GetRealtimeCommandList();
+		pCommandList->IASetPrimitiveTopology(ConvertPrimitiveTopologyToD3D12(m_data.pMeshData->GetTopology()));
+		pCommandList->IASetVertexBuffers(0, 1, &m_vertexBufferView);
+		pCommandList->IASetIndexBuffer(&m_indexBufferView);
+
+		for(size_t i = 0; i < rangeCount; ++i)
+		{
+			pCommandList->DrawIndexedInstanced(pRangeList[i].count, 1, pRangeList[i].start, 0, 0);
 		}
 	}
 
@@ -239,7 +263,7 @@ namespace Graphics
 	}
 
 	// Method for setting up draw in a commandlist, which can also be a bundle.
-	void CDX12MeshRenderer_::SetupDraw(ID3D12GraphicsCommandList* pCommandList)
+	void CDX12MeshRenderer_::SetupDraw(ID3D12GraphicsCommandList* pCommandList, size_t materialIndex)
 	{
 		// Vertex buffer setup.
 		if(m_data.pMeshData->GetVertexSize())
@@ -263,17 +287,25 @@ namespace Graphics
 		if(m_data.pMeshData->GetIndexSize())
 		{ // Setup up vertex/index draw.
 			pCommandList->IASetIndexBuffer(&m_indexBufferView);
+
+			u32 indexStart = 0;
+			u32 indexCount = m_data.pMeshData->GetIndexCount();
+			if(materialIndex < m_data.indexRangeList.size())
+			{
+				indexStart = m_data.indexRangeList[materialIndex].start;
+				indexCount = m_data.indexRangeList[materialIndex].count;
+			}
 			
 			if(m_data.pMeshData->GetInstanceSizeMax())
 			{
 				if(m_instanceBufferView.SizeInBytes)
 				{
-					pCommandList->DrawIndexedInstanced(m_data.pMeshData->GetIndexCount(), m_data.pMeshData->GetInstanceCount(), 0, 0, 0);
+					pCommandList->DrawIndexedInstanced(indexCount, m_data.pMeshData->GetInstanceCount(), indexStart, 0, 0);
 				}
 			}
 			else
 			{
-				pCommandList->DrawIndexedInstanced(m_data.pMeshData->GetIndexCount(), 1, 0, 0, 0);
+				pCommandList->DrawIndexedInstanced(indexCount, 1, indexStart, 0, 0);
 			}
 		}
 		else
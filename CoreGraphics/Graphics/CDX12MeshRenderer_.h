@@ -30,10 +30,11 @@ namespace Graphics
 	private:
 		void Initialize() final;
 		void RenderWithMaterial(size_t materialIndex) final;
+		void RenderRangesWithMaterial(size_t materialIndex, const IndexRange* pRangeList, size_t rangeCount) final;
 		void Release() final;
 
 		void CreateResource(ID3D12Resource** ppBuffer, ID3D12Resource** ppBufferUpload, D3D12_RESOURCE_STATES nextState, u32 size, u32 stride, const u8* pSrcData, u8** pDstData);
-		void SetupDraw(ID3D12GraphicsCommandList* pCommandList);
+		void SetupDraw(ID3D12GraphicsCommandList* pCommandList, size_t materialIndex);
 
 	private:
 		D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView;
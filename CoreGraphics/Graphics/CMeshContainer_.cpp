@@ -48,6 +48,15 @@ namespace Graphics
 		}
 	}
 
+	void CMeshContainer_::RenderRangesWithMaterial(size_t materialIndex, const CMeshRenderer_::IndexRange* pRangeList, size_t rangeCount)
+	{
+		if(m_data.onPreRender) { m_data.onPreRender(m_pMaterialList[materialIndex]); }
+		if(m_data.pMeshRenderer)
+		{
+			m_data.pMeshRenderer->RenderRangesWithMaterial(materialIndex, pRangeList, rangeCount);
+		}
+	}
+
 	void CMeshContainer_::Release()
 	{
 		if(!m_data.bSkipRegistration)
@@ -60,6 +60,7 @@ namespace Graphics
 
 	public:
 		void RenderWithMaterial(size_t materialIndex) final;
+		void RenderRangesWithMaterial(size_t materialIndex, const CMeshRenderer_::IndexRange* pRangeList, size_t rangeCount);
 
 	private:
 		Data m_data;
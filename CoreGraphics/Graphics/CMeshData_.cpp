@@ -40,6 +40,20 @@ namespace Graphics
 		m_pIndexList = m_pInstanceList + m_instanceSize;
 	}
 
+	// Points the mesh data at lists owned by the caller instead of allocating its own. The lists must stay alive for as long as the mesh data is read,
+	//  and are left untouched by Release.
+	void CMeshData_::InitializeBorrowed(u8* pVertexList, u8* pInstanceList, u8* pIndexList)
+	{
+		m_vertexSize = m_data.vertexCount * m_data.vertexStride;
+		m_instanceSize = m_data.instanceMax * m_data.instanceStride;
+		m_indexSize = m_data.indexCount * m_data.indexStride;
+
+		m_pBuffer = nullptr;
+		m_pVertexList = pVertexList;
+		m_pInstanceList = pInstanceList;
+		m_pIndexList = pIndexList;
+	}
+
 	void CMeshData_::Release()
 	{
 		delete[] m_pBuffer;
@@ -44,6 +44,7 @@ namespace Graphics
 		CMeshData_& operator = (CMeshData_&&) = default;
 
 		void Initialize() final;
+		void InitializeBorrowed(u8* pVertexList, u8* pInstanceList, u8* pIndexList);
 		void Release() final;
 
 		void ProcessVertexList(std::function<void(u32, u8*)> processor);
@@ -19,13 +19,13 @@ namespace Graphics
 	// CMeshFilter::Data methods.
 	//-----------------------------------------------------------------------------------------------
 	
-	CMeshFilter::Data::Data(u64 thisHash) :
+	CMeshFilter::Data::Data(ObjectHandle thisHandle) :
 		m_bInstanceDirty(false),
 		m_instanceMax(0),
 		m_instanceStride(0),
 		m_instanceSize(0),
 		m_instanceCount(0),
-		m_this(thisHash),
+		m_this(thisHandle),
 		m_pInstanceList(nullptr),
 		m_pMesh(nullptr)
 	{
@@ -64,17 +64,17 @@ namespace Graphics
 	
 	void CMeshFilter::Initialize()
 	{
-		for(auto& elem : m_dataMap)
+		for(Data& data : m_pool)
 		{
-			elem.second.Initialize();
+			data.Initialize();
 		}
 	}
 
 	void CMeshFilter::Release()
 	{
-		for(auto& elem : m_dataMap)
+		for(Data& data : m_pool)
 		{
-			elem.second.Release();
+			data.Release();
 		}
 	}
 	
@@ -87,26 +87,26 @@ namespace Graphics
 	// Object methods.
 	//---------------------------------------------
 
-	void* CMeshFilter::AddToObject(u64 objHash)
+	void* CMeshFilter::AddToObject(ObjectHandle handle)
 	{
-		return &m_dataMap.insert({ objHash, Data(objHash) }).first->second;
+		return &m_pool[m_pool.Add(handle, handle)];
 	}
 
-	void CMeshFilter::RemoveFromObject(u64 objHash)
+	void CMeshFilter::RemoveFromObject(ObjectHandle handle)
 	{
-		m_dataMap.erase(objHash);
+		m_pool.Remove(m_pool.Find(handle));
 	}
 	
-	void* CMeshFilter::GetFromObject(u64 objHash)
+	void* CMeshFilter::GetFromObject(ObjectHandle handle)
 	{
-		return &m_dataMap.find(objHash)->second;
+		return &m_pool[m_pool.Find(handle)];
 	}
 
-	bool CMeshFilter::TryToGetFromObject(u64 objHash, void** ppData)
+	bool CMeshFilter::TryToGetFromObject(ObjectHandle handle, void** ppData)
 	{
-		auto elem = m_dataMap.find(objHash);
-		if(elem == m_dataMap.end()) return false;
-		*ppData = &elem->second;
+		const u32 id = m_pool.Find(handle);
+		if(id == CNodePool<Data>::NONE) return false;
+		*ppData = &m_pool[id];
 		return true;
 	}
 };
@@ -13,8 +13,8 @@
 
 #include "CGraphicsData.h"
 #include <Objects/CNodeComponent.h>
+#include <Objects/CNodePool.h>
 #include <Math/CMathFNV.h>
-#include <unordered_map>
 
 namespace Graphics
 {
@@ -30,7 +30,7 @@ namespace Graphics
 			friend class CMeshFilter;
 
 		public:
-			Data(u64 thisHash);
+			Data(ObjectHandle thisHandle);
 			~Data();
 			Data(const Data&) = default;
 			Data(Data&&) = default;
@@ -74,7 +74,7 @@ namespace Graphics
 			u32 m_instanceSize;
 			u32 m_instanceCount;
 
-			u64 m_this;
+			ObjectHandle m_this;
 
 			u8* m_pInstanceList;
 			const class CMesh* m_pMesh;
@@ -96,13 +96,13 @@ namespace Graphics
 		void Initialize() final;
 		void Release() final;
 
-		void* AddToObject(u64 objHash) final;
-		void* GetFromObject(u64 objHash) final;
-		bool TryToGetFromObject(u64 objHash, void** ppData) final;
-		void RemoveFromObject(u64 objHash) final;
+		void* AddToObject(ObjectHandle handle) final;
+		void* GetFromObject(ObjectHandle handle) final;
+		bool TryToGetFromObject(ObjectHandle handle, void** ppData) final;
+		void RemoveFromObject(ObjectHandle handle) final;
 
 	private:
-		std::unordered_map<u64, Data> m_dataMap;
+		CNodePool<Data> m_pool;
 	};
 };
 
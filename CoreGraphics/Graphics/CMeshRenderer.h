@@ -28,7 +28,7 @@ namespace Graphics
 		struct Data
 		{
 		public:
-			Data(u64 thisHash) : m_this(thisHash) { }
+			Data(ObjectHandle thisHandle) : m_this(thisHandle) { }
 			virtual ~Data() { }
 			Data(const Data&) = default;
 			Data(Data&&) = default;
@@ -56,7 +56,7 @@ namespace Graphics
 
 		protected:
 			// Accessors.
-			inline u64 GetThis() const { return m_this; }
+			inline ObjectHandle GetThis() const { return m_this; }
 
 			inline bool IsUsingDynamicInstanceData() const { return bDynamicInstanceData; }
 			inline bool IsUsingDynamicInstanceCount() const { return bDynamicInstanceCount; }
@@ -71,7 +71,7 @@ namespace Graphics
 			bool bDynamicInstanceCount = false;
 
 			u32 m_viewHash;
-			u64 m_this;
+			ObjectHandle m_this;
 			
 			std::function<void(class CMaterial*)> m_onPreRender;
 			
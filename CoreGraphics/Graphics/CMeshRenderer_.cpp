@@ -42,6 +42,11 @@ namespace Graphics
 		m_pMaterialList[materialIndex]->Bind();
 	}
 
+	void CMeshRenderer_::RenderRangesWithMaterial(size_t materialIndex, const IndexRange* pRangeList, size_t rangeCount)
+	{
+		CMeshRenderer_::RenderWithMaterial(materialIndex);
+	}
+
 	void CMeshRenderer_::Release()
 	{
 		if(!m_data.bSkipRegistration)
@@ -28,6 +28,12 @@ namespace Graphics
 		friend class CMeshForceRender_;
 
 	public:
+		struct IndexRange
+		{
+			u32 start;
+			u32 count;
+		};
+
 		struct Data
 		{
 			bool bSkipRegistration;
@@ -35,6 +41,7 @@ namespace Graphics
 			bool bDynamicInstanceCount;
 			std::function<void(class CMaterial*)> onPreRender;
 			class CMeshData_* pMeshData;
+			std::vector<IndexRange> indexRangeList; // Optional. Material i only draws indexRangeList[i] of the index buffer, instead of all of it.
 		};
 
 	protected:
@@ -67,6 +74,9 @@ namespace Graphics
 		virtual void Render() final;
 		void RenderWithMaterial(size_t materialIndex) override;
 
+		// Draws only the given ranges of the index buffer, outside of any prerecorded bundle. Only supported for renderers without instances.
+		virtual void RenderRangesWithMaterial(size_t materialIndex, const IndexRange* pRangeList, size_t rangeCount);
+
 	protected:
 		Data m_data;
 		std::vector<class CMaterial*> m_pMaterialList;
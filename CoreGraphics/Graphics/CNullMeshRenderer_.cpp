@@ -0,0 +1,31 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Graphics/CNullMeshRenderer_.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CNullMeshRenderer_.h"
+
+namespace Graphics
+{
+	CNullMeshRenderer_::CNullMeshRenderer_(const CVObject* pObject) :
+		CMeshRenderer_(pObject)
+	{
+	}
+
+	CNullMeshRenderer_::~CNullMeshRenderer_()
+	{
+	}
+
+	void CNullMeshRenderer_::RenderWithMaterial(size_t materialIndex)
+	{
+	}
+
+	void CNullMeshRenderer_::RenderRangesWithMaterial(size_t materialIndex, const IndexRange* pRangeList, size_t rangeCount)
+	{
+	}
+};
@@ -0,0 +1,35 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Graphics/CNullMeshRenderer_.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CNULLMESHRENDERER__H
+#define CNULLMESHRENDERER__H
+
+#include "CMeshRenderer_.h"
+
+namespace Graphics
+{
+	// A mesh renderer without a device, for headless runs. Meshes are still built, and their data kept, but nothing is uploaded or drawn.
+	class CNullMeshRenderer_ : public CMeshRenderer_
+	{
+	public:
+		CNullMeshRenderer_(const CVObject* pObject);
+		~CNullMeshRenderer_();
+		CNullMeshRenderer_(const CNullMeshRenderer_&) = delete;
+		CNullMeshRenderer_(CNullMeshRenderer_&&) = delete;
+		CNullMeshRenderer_& operator = (const CNullMeshRenderer_&) = delete;
+		CNullMeshRenderer_& operator = (CNullMeshRenderer_&&) = delete;
+
+	protected:
+		void RenderWithMaterial(size_t materialIndex) final;
+		void RenderRangesWithMaterial(size_t materialIndex, const IndexRange* pRangeList, size_t rangeCount) final;
+	};
+};
+
+#endif
@@ -0,0 +1,47 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Graphics/CNullWorker.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CNullWorker.h"
+
+namespace Graphics
+{
+	CNullWorker::CNullWorker()
+	{
+	}
+
+	CNullWorker::~CNullWorker()
+	{
+	}
+
+	void CNullWorker::Initialize(bool bRecord)
+	{
+	}
+
+	void CNullWorker::Release()
+	{
+	}
+
+	void CNullWorker::Record()
+	{
+	}
+
+	void CNullWorker::Execute()
+	{
+	}
+
+	void CNullWorker::LoadAssets(std::function<void()> func)
+	{
+		func();
+	}
+
+	void CNullWorker::Sync()
+	{
+	}
+};
@@ -0,0 +1,40 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Graphics/CNullWorker.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CNULLWORKER_H
+#define CNULLWORKER_H
+
+#include "CGraphicsWorker.h"
+
+namespace Graphics
+{
+	// A graphics worker without a device, for headless runs. Asset loads run their function directly, as there's nothing to record into.
+	class CNullWorker : public CGraphicsWorker
+	{
+	public:
+		CNullWorker();
+		~CNullWorker();
+		CNullWorker(const CNullWorker&) = delete;
+		CNullWorker(CNullWorker&&) = delete;
+		CNullWorker& operator = (const CNullWorker&) = delete;
+		CNullWorker& operator = (CNullWorker&&) = delete;
+		
+		void Initialize(bool bRecord) final;
+		void Release() final;
+		
+		void Record() final;
+		void Execute() final;
+
+		void LoadAssets(std::function<void()> func) final;
+		void Sync() final;
+	};
+};
+
+#endif
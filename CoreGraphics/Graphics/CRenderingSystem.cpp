@@ -19,6 +19,7 @@
 #include "../Application/CSceneManager.h"
 #include "../Utilities/CDebug.h"
 #include <Objects/CVObject.h>
+#include <Utilities/CProfiler.h>
 
 namespace Graphics
 {
@@ -47,6 +48,8 @@ namespace Graphics
 
 	void CRenderingSystem::RenderAll()
 	{
+		PROFILE_ZONE("CRenderingSystem::RenderAll");
+
 		while(!m_renderQueue.empty())
 		{
 			const RenderData& data = m_renderQueue.front();
@@ -100,6 +103,11 @@ namespace Graphics
 		}
 		
 		const Math::SIMDVector camPos = App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetTransform()->GetPosition();
+
+		// Translucent chunk sections bind their own root signature.
+		App::CSceneManager::Instance().UniverseManager().ChunkManager().RenderTranslucent(viewHash, camPos);
+		rootSig = nullptr;
+
 		SortBackToFront(camPos, m_depthlessList[viewHash]);
 		
 		for(RendererData_& renderData : m_depthlessList[viewHash])
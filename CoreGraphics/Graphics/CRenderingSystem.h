@@ -71,6 +71,15 @@ namespace Graphics
 
 		inline void AddOverlayRenderer(u32 viewHash, std::function<void()> func) { m_overlayList[viewHash].push_back(func); }
 
+		// For draws that aren't registered renderers, and so have no transform to sort by. getPosition returns each element's SIMDVector position.
+		template<typename T, typename F>
+		static void SortBackToFront(const Math::SIMDVector& camPos, std::vector<T>& list, F getPosition)
+		{
+			std::sort(list.begin(), list.end(), [&camPos, &getPosition](const T& a, const T& b){
+				return _mm_cvtss_f32((getPosition(a) - camPos).LengthSq()) > _mm_cvtss_f32((getPosition(b) - camPos).LengthSq());
+			});
+		}
+
 	private:
 		void RenderWorld(u32 viewHash);
 		void RenderUI(u32 viewHash);
@@ -11,6 +11,7 @@
 #include "CVolumeChunk.h"
 #include "../Universe/CChunkNode.h"
 #include "../Universe/CChunkData.h"
+#include <Utilities/CFrameAllocator.h>
 
 namespace Physics
 {
@@ -45,7 +46,7 @@ namespace Physics
 			Math::Vector3 pt;
 		};
 
-		std::vector<HitInfo> infoList;
+		Util::FrameVector<HitInfo> infoList(&Util::CFrameAllocator::Instance());
 		float dialation = m_blockSizeHalfPadded;
 		
 		info.distance = dir.Length();
@@ -83,7 +84,7 @@ namespace Physics
 			Math::Vector3 pt;
 		};
 
-		std::vector<HitInfo> infoList;
+		Util::FrameVector<HitInfo> infoList(&Util::CFrameAllocator::Instance());
 		float dialation = m_blockSizeHalfPadded;//GetSkinDepth() + pOther->GetSkinDepth();
 
 		if(OctreeIntersectionTest(origin, mn, mx, -pOther->GetMaxExtents() - dialation, -pOther->GetMinExtents() + dialation,
@@ -190,7 +191,7 @@ namespace Physics
 	
 	bool CVolumeChunk::OctreeRayTest(const Math::Vector3& origin, const Math::Vector3& dir, 
 		const Math::Vector3& mn, const Math::Vector3& mx, const Math::Vector3& mnOffset, const Math::Vector3& mxOffset, float distMax,
-		RaycastInfo& info, bool bGenerateNormal, std::function<bool(float, float)> comp, std::function<void(const RaycastInfo&, const Math::Vector3&)> onFound) const
+		RaycastInfo& info, bool bGenerateNormal, const std::function<bool(float, float)>& comp, const std::function<void(const RaycastInfo&, const Math::Vector3&)>& onFound) const
 	{
 		const Math::Vector3 sz = mx - mn;
 		const float compMax = distMax < 0.0f ? info.distance : distMax;
@@ -356,7 +357,7 @@ namespace Physics
 	}
 
 	bool CVolumeChunk::OctreeIntersectionTest(const Math::Vector3& origin, const Math::Vector3& mn, const Math::Vector3& mx, 
-		const Math::Vector3& mnOffset, const Math::Vector3& mxOffset, std::function<void(std::pair<Math::VectorInt3, u32>&, const Math::Vector3&)> onFound) const
+		const Math::Vector3& mnOffset, const Math::Vector3& mxOffset, const std::function<void(std::pair<Math::VectorInt3, u32>&, const Math::Vector3&)>& onFound) const
 	{
 		const Math::Vector3 sz = mx - mn;
 		bool bVoxel = (sz.x <= m_blockSizeEps && sz.y <= m_blockSizeEps && sz.z <= m_blockSizeEps);
@@ -51,10 +51,10 @@ namespace Physics
 	protected:
 		bool OctreeRayTest(const Math::Vector3& origin, const Math::Vector3& dir, const Math::Vector3& mn, const Math::Vector3& mx, 
 			const Math::Vector3& mnOffset, const Math::Vector3& mxOffset, float distMax, RaycastInfo& info, bool bGenerateNormal, 
-			std::function<bool(float, float)> comp, std::function<void(const RaycastInfo&, const Math::Vector3&)> onFound) const;
+			const std::function<bool(float, float)>& comp, const std::function<void(const RaycastInfo&, const Math::Vector3&)>& onFound) const;
 		
 		bool OctreeIntersectionTest(const Math::Vector3& origin, const Math::Vector3& mn, const Math::Vector3& mx, 
-			const Math::Vector3& mnOffset, const Math::Vector3& mxOffset, std::function<void(std::pair<Math::VectorInt3, u32>&, const Math::Vector3&)> onFound) const;
+			const Math::Vector3& mnOffset, const Math::Vector3& mxOffset, const std::function<void(std::pair<Math::VectorInt3, u32>&, const Math::Vector3&)>& onFound) const;
 
 		// Accessors.
 		virtual inline const mData& GetData() const final { return m_data; }
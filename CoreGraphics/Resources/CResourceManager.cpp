@@ -20,6 +20,7 @@
 #include <Application/CLocalization.h>
 #include <Utilities/CFileSystem.h>
 #include <Math/CMathFNV.h>
+#include <Utilities/CAllocTracker.h>
 #include <Utilities/CDebugError.h>
 #include <Utilities/CMemoryFree.h>
 #include <Utilities/CFileUtil.h>
@@ -48,6 +49,8 @@ namespace Resources
 
 	void CManager::Initialize()
 	{
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_RESOURCES);
+
 		CResourceFile::Data resData { };
 		resData.resData.filename = m_data.filename;
 #ifndef PRODUCTION_BUILD
@@ -99,6 +102,8 @@ namespace Resources
 
 	void CManager::PostInitialize()
 	{
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_RESOURCES);
+
 		for(auto texture : m_textureMap)
 		{
 			texture.second->PostInitialize();
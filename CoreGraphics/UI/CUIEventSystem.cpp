@@ -19,6 +19,7 @@
 #include "../Application/CKeybinds.h"
 #include "../Factory/CFactory.h"
 #include "../Graphics/CGraphicsAPI.h"
+#include <Utilities/CAllocTracker.h>
 
 namespace UI
 {
@@ -38,6 +39,8 @@ namespace UI
 
 	void CUIEventSystem::Update()
 	{
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_UI);
+
 		Math::Vector2 cursor = App::CInput::Instance().GetDeviceList()->GetMouse()->GetMousePosition() -
 			Math::Vector2(CFactory::Instance().GetGraphicsAPI()->GetWidth(), CFactory::Instance().GetGraphicsAPI()->GetHeight()) * 0.5f;
 		cursor.y = -cursor.y;
@@ -0,0 +1,37 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CBlockRegistry.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CBlockRegistry.h"
+#include <algorithm>
+
+namespace Universe
+{
+	CBlockRegistry::CBlockRegistry()
+	{
+	}
+
+	CBlockRegistry::~CBlockRegistry()
+	{
+	}
+
+	void CBlockRegistry::Register(BlockId id, const Properties& properties)
+	{
+		m_propertiesList[id] = properties;
+		m_propertiesList[id].emission = std::min(properties.emission, EMISSION_MAX);
+	}
+
+	void CBlockRegistry::Reset()
+	{
+		for(Properties& properties : m_propertiesList)
+		{
+			properties = { };
+		}
+	}
+};
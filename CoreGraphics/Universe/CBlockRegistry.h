@@ -0,0 +1,78 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CBlockRegistry.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CBLOCKREGISTRY_H
+#define CBLOCKREGISTRY_H
+
+#include "CChunkData.h"
+#include <Math/CMathFNV.h>
+#include <Globals/CGlobals.h>
+
+namespace Universe
+{
+	enum BLOCK_MATERIAL : u8
+	{
+		BLOCK_MATERIAL_OPAQUE, // Hides any face it touches.
+		BLOCK_MATERIAL_CUTOUT, // Drawn with the opaque pass, but alpha tested, so faces behind it stay visible.
+		BLOCK_MATERIAL_TRANSLUCENT, // Drawn back to front in the translucent pass.
+	};
+
+	// Per block id material properties used by the mesher. Every id defaults to opaque, non-emissive.
+	// Meant to be filled in at startup. Mesh builds read it from worker threads without locking, so changing it afterwards requires a rebuild.
+	class CBlockRegistry
+	{
+	public:
+		static constexpr u8 EMISSION_MAX = 15;
+
+		struct Properties
+		{
+			BLOCK_MATERIAL material = BLOCK_MATERIAL_OPAQUE;
+			u8 emission = 0; // Block light level emitted, up to EMISSION_MAX.
+		};
+
+	private:
+		CBlockRegistry();
+		~CBlockRegistry();
+		CBlockRegistry(const CBlockRegistry&) = delete;
+		CBlockRegistry(CBlockRegistry&&) = delete;
+		CBlockRegistry& operator = (const CBlockRegistry&) = delete;
+		CBlockRegistry& operator = (CBlockRegistry&&) = delete;
+
+	public:
+		static CBlockRegistry& Instance()
+		{
+			static CBlockRegistry instance;
+			return instance;
+		}
+
+		void Register(BlockId id, const Properties& properties);
+		void Reset();
+
+		// Accessors.
+		inline const Properties& Get(BlockId id) const { return m_propertiesList[id]; }
+
+		inline bool IsOpaque(BlockId id) const { return m_propertiesList[id].material == BLOCK_MATERIAL_OPAQUE; }
+		inline bool IsCutout(BlockId id) const { return m_propertiesList[id].material == BLOCK_MATERIAL_CUTOUT; }
+		inline bool IsTranslucent(BlockId id) const { return m_propertiesList[id].material == BLOCK_MATERIAL_TRANSLUCENT; }
+		inline u8 GetEmission(BlockId id) const { return m_propertiesList[id].emission; }
+
+		// Whether a face of block id is hidden by the filled block adjId it touches. Opaque blocks hide everything, while blocks that can be
+		//  seen through only hide faces between blocks of their own id, so glass against water still shows both faces.
+		inline bool IsFaceHidden(BlockId id, BlockId adjId) const { return IsOpaque(adjId) || id == adjId; }
+
+		// Hash of every id's properties, so anything built from them can tell when they've changed.
+		inline u64 GetHash() const { return Math::FNV1a_64(Math::FNV1a_64_OFFSET, m_propertiesList, sizeof(m_propertiesList)); }
+
+	private:
+		Properties m_propertiesList[256];
+	};
+};
+
+#endif
@@ -9,6 +9,8 @@
 //-------------------------------------------------------------------------------------------------
 
 #include "CChunk.h"
+#include "CChunkMeshScratch.h"
+#include "CBlockRegistry.h"
 #include "../Application/CSceneManager.h"
 #include "../Graphics/CMeshRenderer_.h"
 #include "../Graphics/CMaterial.h"
@@ -18,34 +20,44 @@
 #include "../Utilities/CJobSystem.h"
 #include <Application/CCommandManager.h>
 #include <Math/CMathFNV.h>
+#include <Utilities/CAllocTracker.h>
 #include <Utilities/CMemoryFree.h>
+#include <Utilities/CMetrics.h>
+#include <Utilities/CProfiler.h>
 #include <algorithm>
-#include <unordered_set>
+#include <chrono>
 #include <unordered_map>
-#include <queue>
 
 namespace Universe
 {
+	namespace
+	{
+		// Vertex and index bytes held by the mesh renderers of every chunk.
+		Util::CMetrics::Gauge* MeshBytesMetric()
+		{
+			static Util::CMetrics::Gauge* pGauge = Util::CMetrics::Instance().GetGauge("chunks.meshBytes");
+			return pGauge;
+		}
+	};
+
 	CChunk::CChunk(const CVObject* pObject) :
 		CVComponent(pObject),
 #if _DEBUG
 		m_bInitialized(false),
 #endif
-		m_bDirty(false),
-		m_bAwaitingRebuild(false),
 		m_bUpdateQueued(false),
-		m_meshIndex(0),
+		m_bLightDirty(true),
 		m_lodLevel(0),
 		m_lodLevelMax(0),
 		m_lodLevelOffset(0),
 		m_chunkSize(0),
 		m_blockListSize(0),
-		m_meshData{ pObject, pObject },
+		m_sectionHeight(1),
+		m_solidFaceMask(0),
 		m_meshContainer(pObject),
 		//m_meshContainerWire(pObject),
-		m_pMeshRendererList{ nullptr, nullptr },
-		//m_pMeshRendererListWire{ nullptr, nullptr },
 		m_pMaterial(nullptr),
+		m_pMaterialTranslucent(nullptr),
 		m_pMaterialWire(nullptr),
 		m_pBlockList(nullptr)
 	{
@@ -59,19 +71,24 @@ namespace Universe
 	void CChunk::Setup()
 	{
 		m_pMaterial = reinterpret_cast<Graphics::CMaterial*>(Resources::CManager::Instance().GetResource(Resources::RESOURCE_TYPE_MATERIAL, m_data.matHash));
+		m_pMaterialTranslucent = reinterpret_cast<Graphics::CMaterial*>(Resources::CManager::Instance().GetResource(Resources::RESOURCE_TYPE_MATERIAL, m_data.matTranslucentHash));
 		//m_pMaterialWire = reinterpret_cast<Graphics::CMaterial*>(Resources::CManager::Instance().GetResource(Resources::RESOURCE_TYPE_MATERIAL, m_data.matWireHash));
 
 		{ // Create mesh container.
 			Graphics::CMeshContainer_::Data data { };
 			data.bSkipRegistration = true;
-			//data.onPreRender = std::bind(&CChunk::PreRender, this, std::placeholders::_1);
+			data.onPreRender = std::bind(&CChunk::PreRender, this, std::placeholders::_1);
 			data.pMeshRenderer = nullptr;
 			m_meshContainer.SetData(data);
 			m_meshContainer.AddMaterial(m_pMaterial);
+			m_meshContainer.AddMaterial(m_pMaterialTranslucent);
 			//m_meshContainer.AddMaterial(m_pMaterialWire);
 			m_meshContainer.Initialize();
 		}
 
+		// Vertex positions are packed with 6 bits per axis, so the vertex grid can't exceed that.
+		assert(m_data.width <= PackedChunkVertex::COORD_MAX && m_data.height <= PackedChunkVertex::COORD_MAX && m_data.length <= PackedChunkVertex::COORD_MAX);
+
 		// Calculte the maximum lod level.
 		auto LeastSignificantSetBit = [](u32 val){
 			u32 bit = 1;
@@ -85,7 +102,48 @@ namespace Universe
 			return bit;
 		};
 
-		m_lodLevelMax = 0;//std::min(std::min(LeastSignificantSetBit(m_data.width), LeastSignificantSetBit(m_data.height)), LeastSignificantSetBit(m_data.length));
+		m_lodLevelMax = static_cast<u8>(std::min({ LeastSignificantSetBit(m_data.width), LeastSignificantSetBit(m_data.height), LeastSignificantSetBit(m_data.length),
+			static_cast<u32>(std::min(m_data.lodLevelMax, CHUNK_LOD_LEVEL_LIMIT)) + 1 }) - 1);
+		m_chunkSize = m_data.width * m_data.height * m_data.length;
+
+		{ // Setup the LOD builder.
+			CChunkLOD::Data data { };
+			data.width = m_data.width;
+			data.height = m_data.height;
+			data.length = m_data.length;
+			data.lodLevelMax = m_lodLevelMax;
+			m_lod.SetData(data);
+			m_lod.Initialize();
+		}
+
+		{ // Setup the border slices.
+			CChunkBorder::Data data { };
+			data.width = m_data.width;
+			data.height = m_data.height;
+			data.length = m_data.length;
+			m_border.SetData(data);
+		}
+
+		{ // Setup the light volume.
+			CChunkLight::Data data { };
+			data.width = m_data.width;
+			data.height = m_data.height;
+			data.length = m_data.length;
+			m_light.SetData(data);
+			m_light.Initialize();
+		}
+
+		if(m_pSectionList.empty())
+		{ // Split the mesh into horizontal sections.
+			m_sectionHeight = (m_data.height + CHUNK_SECTION_LIMIT - 1) / CHUNK_SECTION_LIMIT;
+			for(u32 j = 0; j < m_data.height; j += m_sectionHeight)
+			{
+				Section* pSection = new Section(m_pObject);
+				pSection->blockMin = j;
+				pSection->blockMax = std::min(j + m_sectionHeight, m_data.height);
+				m_pSectionList.push_back(pSection);
+			}
+		}
 	}
 	
 	void CChunk::Initialize()
@@ -93,6 +151,8 @@ namespace Universe
 #if _DEBUG
 		m_bInitialized = true;
 #endif
+
+		Setup();
 		
 		{ // Build initial chunk ids.
 			AllocateBlockList();
@@ -110,22 +170,45 @@ namespace Universe
 					}
 				}
 			}
+
+			m_lod.Build(m_pBlockList);
+			m_border.Publish(m_pBlockList + m_lodLevelOffset);
 		}
 
-		Setup();
+		m_bLightDirty = true;
 		RebuildMesh();
 	}
 	
-	void CChunk::LateUpdate()
+	// Called by the rebuild scheduler in priority order. Finished builds are always swapped in, while block edits and new builds are only
+	//  taken on while the frame's budget allows.
+	void CChunk::ProcessUpdates(CChunkRebuildScheduler::Budget& budget)
 	{
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_CHUNK);
+
 		m_bUpdateQueued = false;
 
-		if(m_meshFuture[0].Ready() && m_meshFuture[1].Ready())
+		bool bBuilding = false;
+		for(u32 s = 0; s < m_pSectionList.size(); ++s)
 		{
-			if(m_bDirty)
+			Section* pSection = m_pSectionList[s];
+			if(!pSection->Ready())
+			{
+				bBuilding = true;
+				continue;
+			}
+
+			if(pSection->bDirty && pSection->bCancel && pSection->pMeshRendererList[pSection->meshIndex] == nullptr)
+			{ // The abandoned build left no renderer, so the current one is kept and the section is built again.
+				// A build that finished before it was cancelled is swapped in as usual, and replaced by the rebuild already requested.
+				pSection->meshIndex = (pSection->meshIndex + 1) & 0x1;
+				pSection->bDirty = false;
+				pSection->bAwaitingRebuild = true;
+				++budget.cancelCount;
+			}
+			else if(pSection->bDirty)
 			{
-				const u8 nextIndex = (m_meshIndex + 1) & 0x1;
-				auto pMesh = m_pMeshRendererList[nextIndex];
+				const u8 nextIndex = (pSection->meshIndex + 1) & 0x1;
+				auto pMesh = pSection->pMeshRendererList[nextIndex];
 				//auto pMeshWire = m_pMeshRendererListWire[nextIndex];
 				if(pMesh)
 				{
@@ -136,88 +219,263 @@ namespace Universe
 						//delete pMeshWire;
 					});
 
-					m_pMeshRendererList[nextIndex] = nullptr;
+					pSection->pMeshRendererList[nextIndex] = nullptr;
+					MeshBytesMetric()->Add(-static_cast<s64>(pSection->meshBytesList[nextIndex]));
+					pSection->meshBytesList[nextIndex] = 0;
 					//m_pMeshRendererListWire[nextIndex] = nullptr;
 				}
 
-				m_meshContainer.SetMeshRenderer(m_pMeshRendererList[m_meshIndex]);
-				//m_meshContainerWire.SetMeshRenderer(m_pMeshRendererListWire[m_meshIndex]);
-				m_bDirty = false;
+				pSection->pMeshRenderer = pSection->pMeshRendererList[pSection->meshIndex];
+				pSection->translucentCount = pSection->translucentCountList[pSection->meshIndex];
+				pSection->pMeshletList = &pSection->meshletList[pSection->meshIndex];
+				pSection->rangeList.clear();
+				pSection->bDirty = false;
+			}
+		}
+
+		if(bBuilding && !m_blockUpdateMap.empty())
+		{ // Builds covering rows with pending edits would be replaced as soon as they finish, so they're abandoned instead.
+			const u32 lodStep = 1 << m_lodLevel;
+
+			u8 staleMask = 0;
+			for(const auto& elem : m_blockUpdateMap)
+			{
+				const u32 j = elem.first % m_data.height;
+				const u32 jMin = j & ~(lodStep - 1);
+				staleMask |= internalGetSectionMask(jMin, std::min(jMin + lodStep, m_data.height) - 1);
+			}
 
-				if(m_bAwaitingRebuild)
+			for(u32 s = 0; s < m_pSectionList.size(); ++s)
+			{
+				if((staleMask & (1 << s)) && m_pSectionList[s]->bDirty)
 				{
-					m_bAwaitingRebuild = false;
-					if(m_blockUpdateMap.empty())
-					{
-						RebuildMesh();
-					}
+					m_pSectionList[s]->bCancel = true;
 				}
 			}
+		}
 
-			if(!m_blockUpdateMap.empty())
-			{
-				u8 adjUpdates = 0;
+		if(!bBuilding && !m_blockUpdateMap.empty() && budget.HasTime())
+		{
+			u8 sectionMask = 0;
+			u8 adjMaskList[6] = { };
+			u8 lightSideMask = 0;
+			u32 lightMin = 0, lightMax = 0;
+
+			{ // Update blocks and the indices provided.
+				// An edit changes the whole cell containing it at the current LOD level.
+				const u32 lodStep = 1 << m_lodLevel;
 
-				{ // Update blocks and the indices provided.
+				{
+					std::lock_guard<std::shared_mutex> lk(m_mutex);
+					
+					if(m_pBlockList == nullptr)
 					{
-						std::lock_guard<std::shared_mutex> lk(m_mutex);
-						
-						if(m_pBlockList == nullptr)
-						{
-							AllocateBlockList();
-						}
+						AllocateBlockList();
+					}
 
-						for(const auto& elem : m_blockUpdateMap)
+					for(const auto& elem : m_blockUpdateMap)
+					{
+						m_pBlockList[elem.first].bFilled = elem.second <= 0xFF;
+						if(m_pBlockList[elem.first].bFilled)
 						{
-							m_pBlockList[elem.first].bFilled = elem.second <= 0xFF;
-							if(m_pBlockList[elem.first].bFilled)
-							{
-								m_pBlockList[elem.first].id = static_cast<u8>(elem.second);
-							}
+							m_pBlockList[elem.first].id = static_cast<u8>(elem.second);
 						}
+
+						m_lod.MarkDirty(elem.first);
 					}
 
+					// Only the parent cells of the edited blocks are rebuilt.
+					m_lod.Update(m_pBlockList);
+					m_border.Publish(m_pBlockList + m_lodLevelOffset);
+
+					// Light is relit incrementally around the edited blocks, at full resolution. The list is shared by every chunk the thread commits
+					//  edits for, so it keeps its capacity from one commit to the next.
+					static thread_local std::vector<u32> indexList;
+					indexList.clear();
 					for(const auto& elem : m_blockUpdateMap)
 					{
-						u32 i, j, k;
-						internalGetCoordsFromIndex(elem.first, i, j, k);
-						if(i == 0 && m_pChunkAdj[SIDE_LEFT] && m_pChunkAdj[SIDE_LEFT]->GetBlock(m_pChunkAdj[SIDE_LEFT]->internalGetIndexRight(j, k)).bFilled) adjUpdates |= SIDE_FLAG_LEFT;
-						if(i == m_data.width - 1 && m_pChunkAdj[SIDE_RIGHT] && m_pChunkAdj[SIDE_RIGHT]->GetBlock(m_pChunkAdj[SIDE_RIGHT]->internalGetIndexLeft(j, k)).bFilled) adjUpdates |= SIDE_FLAG_RIGHT;
-						if(j == 0 && m_pChunkAdj[SIDE_BOTTOM] && m_pChunkAdj[SIDE_BOTTOM]->GetBlock(m_pChunkAdj[SIDE_BOTTOM]->internalGetIndexTop(i, k)).bFilled) adjUpdates |= SIDE_FLAG_BOTTOM;
-						if(j == m_data.height - 1 && m_pChunkAdj[SIDE_TOP] && m_pChunkAdj[SIDE_TOP]->GetBlock(m_pChunkAdj[SIDE_TOP]->internalGetIndexBottom(i, k)).bFilled) adjUpdates |= SIDE_FLAG_TOP;
-						if(k == 0 && m_pChunkAdj[SIDE_BACK] && m_pChunkAdj[SIDE_BACK]->GetBlock(m_pChunkAdj[SIDE_BACK]->internalGetIndexFront(i, j)).bFilled) adjUpdates |= SIDE_FLAG_BACK;
-						if(k == m_data.length - 1 && m_pChunkAdj[SIDE_FRONT] && m_pChunkAdj[SIDE_FRONT]->GetBlock(m_pChunkAdj[SIDE_FRONT]->internalGetIndexBack(i, j)).bFilled) adjUpdates |= SIDE_FLAG_FRONT;
+						indexList.push_back(elem.first);
 					}
 
-					m_blockUpdateMap.clear();
-				}
+					CChunkLight::AdjList adjLightList;
+					AcquireAdjacentLight(adjLightList);
+					m_light.Update(m_pBlockList, adjLightList, indexList.data(), indexList.size());
+					lightSideMask = m_light.Publish();
 
-				// Update the mesh after block updates.
-				RebuildMesh();
-				u32 index = 0;
-				while(adjUpdates)
-				{
-					if(adjUpdates & 0x1)
+					if(m_light.GetChangedRows(lightMin, lightMax))
 					{
-						m_pChunkAdj[index]->RebuildMesh();
+						sectionMask |= internalGetSectionMask(lightMin, lightMax);
 					}
+				}
 
-					adjUpdates >>= 1;
-					++index;
+				std::shared_ptr<const CChunkBorder::Slices> adjList[6];
+				AcquireAdjacentBorders(adjList);
+
+				for(const auto& elem : m_blockUpdateMap)
+				{
+					u32 i, j, k;
+					internalGetCoordsFromIndex(elem.first, i, j, k);
+
+					const u32 jMin = j & ~(lodStep - 1);
+					const u32 jMax = std::min(jMin + lodStep, m_data.height) - 1;
+					sectionMask |= internalGetSectionMask(jMin, jMax);
+
+					// Side neighbours share this chunk's dimensions, so the same rows are affected. Vertical neighbours only have their facing section affected.
+					// Faces near the seam are occluded by border blocks even when the block directly across is empty, so any border edit rebuilds the neighbour.
+					if(i == 0 && adjList[SIDE_LEFT]) adjMaskList[SIDE_LEFT] |= m_pChunkAdj[SIDE_LEFT]->internalGetSectionMask(jMin, jMax);
+					if(i == m_data.width - 1 && adjList[SIDE_RIGHT]) adjMaskList[SIDE_RIGHT] |= m_pChunkAdj[SIDE_RIGHT]->internalGetSectionMask(jMin, jMax);
+					if(j == 0 && adjList[SIDE_BOTTOM]) adjMaskList[SIDE_BOTTOM] |= 1 << (m_pChunkAdj[SIDE_BOTTOM]->GetSectionCount() - 1);
+					if(j == m_data.height - 1 && adjList[SIDE_TOP]) adjMaskList[SIDE_TOP] |= 1;
+					if(k == 0 && adjList[SIDE_BACK]) adjMaskList[SIDE_BACK] |= m_pChunkAdj[SIDE_BACK]->internalGetSectionMask(jMin, jMax);
+					if(k == m_data.length - 1 && adjList[SIDE_FRONT]) adjMaskList[SIDE_FRONT] |= m_pChunkAdj[SIDE_FRONT]->internalGetSectionMask(jMin, jMax);
 				}
+
+				m_blockUpdateMap.clear();
+			}
+
+			// Update the mesh after block updates.
+			RebuildMesh(sectionMask);
+			for(u32 side = 0; side < 6; ++side)
+			{
+				if(adjMaskList[side])
+				{
+					m_pChunkAdj[side]->RebuildMesh(adjMaskList[side]);
+				}
+			}
+
+			RelightAdjacent(lightSideMask, lightMin, lightMax);
+		}
+
+		if(m_bLightDirty && !bBuilding && budget.HasTime())
+		{ // Full relight, after the chunk's blocks were replaced. Builds wait for it, so they don't bake stale light.
+			CChunkLight::AdjList adjLightList;
+			AcquireAdjacentLight(adjLightList);
+
+			u8 lightSideMask;
+			{
+				std::shared_lock<std::shared_mutex> lk(m_mutex);
+				m_light.Compute(m_pBlockList, adjLightList);
+				lightSideMask = m_light.Publish();
+			}
+
+			m_bLightDirty = false;
+
+			u32 lightMin, lightMax;
+			if(m_light.GetChangedRows(lightMin, lightMax))
+			{
+				RebuildMesh(internalGetSectionMask(lightMin, lightMax));
+			}
+
+			RelightAdjacent(lightSideMask, lightMin, lightMax);
+		}
+
+		if(!m_bLightDirty && m_light.IsSeamPending() && !bBuilding && budget.HasTime())
+		{ // A neighbour's light changed along a seam, so only the cells it changed are relit. Builds wait for this too.
+			CChunkLight::AdjList adjLightList;
+			AcquireAdjacentLight(adjLightList);
+
+			u8 lightSideMask;
+			{
+				std::shared_lock<std::shared_mutex> lk(m_mutex);
+				m_light.Relight(m_pBlockList, adjLightList);
+				lightSideMask = m_light.Publish();
+			}
+
+			u32 lightMin, lightMax;
+			if(m_light.GetChangedRows(lightMin, lightMax))
+			{
+				RebuildMesh(internalGetSectionMask(lightMin, lightMax));
 			}
+
+			RelightAdjacent(lightSideMask, lightMin, lightMax);
+		}
+
+		if(!m_bLightDirty && !m_light.IsSeamPending())
+		{
+			DispatchBuilds(budget);
+		}
+
+		bool bPending = !m_blockUpdateMap.empty() || m_bLightDirty || m_light.IsSeamPending();
+		bool bMeshing = false;
+		for(const Section* pSection : m_pSectionList)
+		{
+			bPending |= pSection->bDirty || pSection->bAwaitingRebuild;
+			bMeshing |= pSection->bDirty;
 		}
 
-		if(m_bDirty)
-		{ // Keep chunk in update queue while it is dirty.
-			App::CSceneManager::Instance().UniverseManager().ChunkManager().QueueChunkUpdate(this);
+		if(bMeshing)
+		{
+			++budget.meshingCount;
+		}
+
+		if(bPending)
+		{ // Keep chunk in update queue until its edits are applied and its sections are built.
+			PushToUpdateQueue();
 		}
 	}
 
 	
 	void CChunk::ForceRender(size_t materialIndex)
 	{
+		for(u32 s = 0; s < m_pSectionList.size(); ++s)
+		{
+			RenderSection(s, materialIndex);
+		}
+	}
+
+	// Each non-empty section is drawn through the chunk's container, which supplies the shared world matrix.
+	void CChunk::RenderSection(u32 section, size_t materialIndex)
+	{
+		const Section* pSection = m_pSectionList[section];
+		if(pSection->pMeshRenderer == nullptr) return;
+		if(materialIndex == CHUNK_MATERIAL_TRANSLUCENT && pSection->translucentCount == 0) return;
+
+		m_meshContainer.SetMeshRenderer(pSection->pMeshRenderer);
 		m_meshContainer.RenderWithMaterial(materialIndex);
+		m_meshContainer.SetMeshRenderer(nullptr);
+	}
+
+	// Only the opaque range is clustered. Translucent ranges are drawn whole, in the order the build sorted them.
+	void CChunk::CullMeshlets(const CChunkMeshlets::CameraSample& camera, CChunkMeshlets::Stats& stats)
+	{
+		const CChunkMeshlets::CameraSample localCamera = CChunkMeshlets::ToLocal(camera, GetOffset(), m_data.blockSize);
+
+		for(Section* pSection : m_pSectionList)
+		{
+			pSection->rangeList.clear();
+			if(pSection->pMeshRenderer == nullptr || pSection->pMeshletList == nullptr) continue;
+
+			CChunkMeshlets::Cull(*pSection->pMeshletList, localCamera, pSection->rangeList, stats);
+		}
+	}
+
+	// Draws the opaque ranges left by the last call to CullMeshlets.
+	void CChunk::RenderMeshlets()
+	{
+		for(const Section* pSection : m_pSectionList)
+		{
+			if(pSection->pMeshRenderer == nullptr || pSection->rangeList.empty()) continue;
+
+			m_meshContainer.SetMeshRenderer(pSection->pMeshRenderer);
+			m_meshContainer.RenderRangesWithMaterial(CHUNK_MATERIAL_OPAQUE, pSection->rangeList.data(), pSection->rangeList.size());
+			m_meshContainer.SetMeshRenderer(nullptr);
+		}
+	}
+
+	// Vertices are chunk local, so the chunk's offset and block size are supplied through the world matrix.
+	void CChunk::PreRender(Graphics::CMaterial* pMaterial)
+	{
+		static const u32 frameBufferHash = Math::FNV1a_32("DrawBuffer");
+		static const u32 worldHash = Math::FNV1a_32("World");
+
+		const Math::SIMDMatrix world(
+			m_data.blockSize, 0.0f, 0.0f, static_cast<float>(m_data.offset.x) * m_data.blockSize,
+			0.0f, m_data.blockSize, 0.0f, static_cast<float>(m_data.offset.y) * m_data.blockSize,
+			0.0f, 0.0f, m_data.blockSize, static_cast<float>(m_data.offset.z) * m_data.blockSize,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+
+		pMaterial->SetFloat(frameBufferHash, worldHash, world.f32, 16);
 	}
 
 	void CChunk::Release()
@@ -226,51 +484,72 @@ namespace Universe
 		//m_meshContainerWire.Release();
 		//SAFE_RELEASE_DELETE(m_pMeshRendererListWire[1]);
 		//SAFE_RELEASE_DELETE(m_pMeshRendererListWire[0]);
-		SAFE_RELEASE_DELETE(m_pMeshRendererList[1]);
-		SAFE_RELEASE_DELETE(m_pMeshRendererList[0]);
+		for(Section* pSection : m_pSectionList)
+		{
+			SAFE_RELEASE_DELETE(pSection->pMeshRendererList[1]);
+			SAFE_RELEASE_DELETE(pSection->pMeshRendererList[0]);
+			MeshBytesMetric()->Add(-static_cast<s64>(pSection->meshBytesList[0] + pSection->meshBytesList[1]));
+			delete pSection;
+		}
+
+		m_pSectionList.clear();
 		
 		SAFE_DELETE_ARRAY(m_pBlockList);
+		m_lod.Release();
+		m_border.Release();
+		m_light.Release();
 	}
 	
 	//-----------------------------------------------------------------------------------------------
 	// Mesh methods.
 	//-----------------------------------------------------------------------------------------------
 	
-	void CChunk::BuildMesh(u8 meshIndex, bool bOptimize)
+	// Builds the mesh of a single section. Only rows within the section are touched, so sections can build concurrently.
+	void CChunk::BuildMesh(Section* pSection, u8 meshIndex, bool bOptimize)
 	{
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_MESH);
+		PROFILE_ZONE("CChunk::BuildMesh");
+
+		const u32 jMin = pSection->blockMin;
+		const u32 jMax = pSection->blockMax;
+
 		Graphics::CMeshData_::Data data { };
 		data.topology = Graphics::PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-		data.vertexStride = sizeof(Vertex);
+		data.vertexStride = sizeof(PackedChunkVertex);
 		data.indexStride = sizeof(Index);
 		
-		uintptr_t mutexList[7] = {
-			reinterpret_cast<uintptr_t>(&m_mutex),
-			reinterpret_cast<uintptr_t>(m_pChunkAdj[0] ? &m_pChunkAdj[0]->m_mutex : nullptr),
-			reinterpret_cast<uintptr_t>(m_pChunkAdj[1] ? &m_pChunkAdj[1]->m_mutex : nullptr),
-			reinterpret_cast<uintptr_t>(m_pChunkAdj[2] ? &m_pChunkAdj[2]->m_mutex : nullptr),
-			reinterpret_cast<uintptr_t>(m_pChunkAdj[3] ? &m_pChunkAdj[3]->m_mutex : nullptr),
-			reinterpret_cast<uintptr_t>(m_pChunkAdj[4] ? &m_pChunkAdj[4]->m_mutex : nullptr),
-			reinterpret_cast<uintptr_t>(m_pChunkAdj[5] ? &m_pChunkAdj[5]->m_mutex : nullptr)
+		// Neighbours are only read through their published border and light slices, so the only lock taken is this chunk's own.
+		std::shared_ptr<const CChunkBorder::Slices> adjList[6];
+		AcquireAdjacentBorders(adjList);
+
+		CChunkLight::AdjList adjLightList;
+		AcquireAdjacentLight(adjLightList);
+
+		const CBlockRegistry& registry = CBlockRegistry::Instance();
+		auto IsFaceHidden = [&registry](const Block& adj, BlockId id){
+			return adj.bFilled && registry.IsFaceHidden(id, adj.id);
 		};
 
-		std::sort(mutexList, mutexList + 7, [](uintptr_t a, uintptr_t b){ return a > b; });
+		u64 cacheKey = 0;
 
-		{ // Count quads.
-			std::unique_lock<std::shared_mutex> lk[7];
+		// The level can change while the section builds. Everything after counting reads the level counted at, and the build is
+		//  cancelled by the change, so a mesh mixing two levels is never stored or shown.
+		u32 lodLevelOffset = 0;
 
-			for(int i = 0; i < 7 && mutexList[i] != 0; ++i)
-			{
-				lk[i] = std::unique_lock<std::shared_mutex>(*reinterpret_cast<std::shared_mutex*>(mutexList[i]));
-			}
+		{ // Count quads.
+			std::lock_guard<std::shared_mutex> lk(m_mutex);
 
 			if(m_pBlockList == nullptr)
 			{ // Build initial chunk ids.
 				AllocateBlockList();
 				memset(m_pBlockList, 0, sizeof(Block) * m_chunkSize);
+				m_border.Publish(m_pBlockList + m_lodLevelOffset);
 			}
 
-			u32 index = m_lodLevelOffset;
+			lodLevelOffset = m_lodLevelOffset;
+			u32 index = lodLevelOffset;
 			u32 quadCount = 0;
+			u8 solidFaceMask = SIDE_FLAG_ALL;
 
 			auto AddQuad = [&](SIDE_FLAG flag){
 				++quadCount;
@@ -281,24 +560,38 @@ namespace Universe
 			{
 				for(u32 k = 0; k < m_data.length; ++k)
 				{
-					for(u32 j = 0; j < m_data.height; ++j)
+					index = lodLevelOffset + internalGetIndex(i, jMin, k);
+					for(u32 j = jMin; j < jMax; ++j)
 					{
 						m_pBlockList[index].sideFlag = 0;
-						if(!m_pBlockList[index].bFilled)
-						{
-							++index;
-							continue;
+
+						const bool bFilled = m_pBlockList[index].bFilled;
+						const BlockId id = m_pBlockList[index].id;
+						if(!bFilled || !registry.IsOpaque(id))
+						{ // Any gap, or block that can be seen through, on a border means that face can't be used as an occluder.
+							if(i == 0) solidFaceMask &= ~SIDE_FLAG_LEFT;
+							if(i == m_data.width - 1) solidFaceMask &= ~SIDE_FLAG_RIGHT;
+							if(j == 0) solidFaceMask &= ~SIDE_FLAG_BOTTOM;
+							if(j == m_data.height - 1) solidFaceMask &= ~SIDE_FLAG_TOP;
+							if(k == 0) solidFaceMask &= ~SIDE_FLAG_BACK;
+							if(k == m_data.length - 1) solidFaceMask &= ~SIDE_FLAG_FRONT;
+
+							if(!bFilled)
+							{
+								++index;
+								continue;
+							}
 						}
 
 						// Left.
 						if(i == 0)
 						{
-							if(!m_pChunkAdj[SIDE_LEFT] || !m_pChunkAdj[SIDE_LEFT]->internalGetBlock(m_pChunkAdj[SIDE_LEFT]->internalGetIndexRight(j, k)).bFilled)
+							if(!adjList[SIDE_LEFT] || !adjList[SIDE_LEFT]->HidesFace(SIDE_RIGHT, j, k, id))
 							{
 								AddQuad(SIDE_FLAG_LEFT);
 							}
 						}
-						else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i - 1, j, k)].bFilled)
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i - 1, j, k)], id))
 						{
 							AddQuad(SIDE_FLAG_LEFT);
 						}
@@ -306,12 +599,12 @@ namespace Universe
 						// Right.
 						if(i == m_data.width - 1)
 						{
-							if(!m_pChunkAdj[SIDE_RIGHT] || !m_pChunkAdj[SIDE_RIGHT]->internalGetBlock(m_pChunkAdj[SIDE_RIGHT]->internalGetIndexLeft(j, k)).bFilled)
+							if(!adjList[SIDE_RIGHT] || !adjList[SIDE_RIGHT]->HidesFace(SIDE_LEFT, j, k, id))
 							{
 								AddQuad(SIDE_FLAG_RIGHT);
 							}
 						}
-						else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i + 1, j, k)].bFilled)
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i + 1, j, k)], id))
 						{
 							AddQuad(SIDE_FLAG_RIGHT);
 						}
@@ -319,12 +612,12 @@ namespace Universe
 						// Bottom.
 						if(j == 0)
 						{
-							if(!m_pChunkAdj[SIDE_BOTTOM] || !m_pChunkAdj[SIDE_BOTTOM]->internalGetBlock(m_pChunkAdj[SIDE_BOTTOM]->internalGetIndexTop(i, k)).bFilled)
+							if(!adjList[SIDE_BOTTOM] || !adjList[SIDE_BOTTOM]->HidesFace(SIDE_TOP, i, k, id))
 							{
 								AddQuad(SIDE_FLAG_BOTTOM);
 							}
 						}
-						else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i, j - 1, k)].bFilled)
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i, j - 1, k)], id))
 						{
 							AddQuad(SIDE_FLAG_BOTTOM);
 						}
@@ -332,12 +625,12 @@ namespace Universe
 						// Top.
 						if(j == m_data.height - 1)
 						{
-							if(!m_pChunkAdj[SIDE_TOP] || !m_pChunkAdj[SIDE_TOP]->internalGetBlock(m_pChunkAdj[SIDE_TOP]->internalGetIndexBottom(i, k)).bFilled)
+							if(!adjList[SIDE_TOP] || !adjList[SIDE_TOP]->HidesFace(SIDE_BOTTOM, i, k, id))
 							{
 								AddQuad(SIDE_FLAG_TOP);
 							}
 						}
-						else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i, j + 1, k)].bFilled)
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i, j + 1, k)], id))
 						{
 							AddQuad(SIDE_FLAG_TOP);
 						}
@@ -345,12 +638,12 @@ namespace Universe
 						// Back.
 						if(k == 0)
 						{
-							if(!m_pChunkAdj[SIDE_BACK] || !m_pChunkAdj[SIDE_BACK]->internalGetBlock(m_pChunkAdj[SIDE_BACK]->internalGetIndexFront(i, j)).bFilled)
+							if(!adjList[SIDE_BACK] || !adjList[SIDE_BACK]->HidesFace(SIDE_FRONT, i, j, id))
 							{
 								AddQuad(SIDE_FLAG_BACK);
 							}
 						}
-						else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i, j, k - 1)].bFilled)
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i, j, k - 1)], id))
 						{
 							AddQuad(SIDE_FLAG_BACK);
 						}
@@ -358,12 +651,12 @@ namespace Universe
 						// Front.
 						if(k == m_data.length - 1)
 						{
-							if(!m_pChunkAdj[SIDE_FRONT] || !m_pChunkAdj[SIDE_FRONT]->internalGetBlock(m_pChunkAdj[SIDE_FRONT]->internalGetIndexBack(i, j)).bFilled)
+							if(!adjList[SIDE_FRONT] || !adjList[SIDE_FRONT]->HidesFace(SIDE_BACK, i, j, id))
 							{
 								AddQuad(SIDE_FLAG_FRONT);
 							}
 						}
-						else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i, j, k + 1)].bFilled)
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i, j, k + 1)], id))
 						{
 							AddQuad(SIDE_FLAG_FRONT);
 						}
@@ -373,6 +666,15 @@ namespace Universe
 				}
 			}
 
+			// Side faces are only solid if they are in every section. Bottom and top faces are only ever cleared by the end sections.
+			pSection->solidFaceMask = solidFaceMask;
+			for(const Section* pOther : m_pSectionList)
+			{
+				solidFaceMask &= pOther->solidFaceMask;
+			}
+
+			m_solidFaceMask = solidFaceMask;
+
 			if(static_cast<u64>(quadCount) * 6 >= std::numeric_limits<u32>().max())
 			{
 				// Index overflow from counted quads. Force optimization in an attempt to bring indices back within numerical bounds.
@@ -383,273 +685,507 @@ namespace Universe
 				data.vertexCount = quadCount << 2;
 				data.indexCount = quadCount * 6;
 			}
+
+			if(App::CSceneManager::Instance().UniverseManager().ChunkManager().MeshCache().IsEnabled())
+			{
+				cacheKey = ComputeMeshKey(pSection, bOptimize, adjList, adjLightList);
+			}
 		}
 
-		if(bOptimize)
-		{
-			GenerateOptimalMeshData(meshIndex, data);
+		// A newer edit has made this build stale. The section is rebuilt once the chunk sees it's finished.
+		if(pSection->bCancel) return;
+
+		CChunkMeshCache& meshCache = App::CSceneManager::Instance().UniverseManager().ChunkManager().MeshCache();
+		CChunkMeshCache::Entry cached;
+
+		u32 opaqueCount;
+		const void* pVertexData;
+		const void* pIndexData;
+
+		if(cacheKey && meshCache.Load(cacheKey, cached))
+		{ // Uploaded straight from the mapped file. Translucent triangles keep the order they were stored in until the section is next built.
+			data.vertexCount = cached.GetVertexCount();
+			data.indexCount = cached.GetIndexCount();
+			opaqueCount = cached.GetOpaqueCount();
+			pVertexData = cached.GetVertexList();
+			pIndexData = cached.GetIndexList();
 		}
 		else
 		{
-			m_meshData[meshIndex].SetData(data);
-			m_meshData[meshIndex].Initialize();
+			// Mesh data is generated into this thread's scratch arena, which the mesh data borrows until the renderer has uploaded it.
+			CChunkMeshScratch& scratch = CChunkMeshScratch::Local();
+			scratch.Prepare(m_chunkSize, (m_data.width + 1) * (m_data.height + 1) * (m_data.length + 1));
+
+			if(m_data.meshSurface == MESH_SURFACE_SMOOTH)
+			{ // Faces can't be merged once their corners have moved, so smooth surfaces are always a quad per face.
+				scratch.vertexList.reserve(data.vertexCount);
+				scratch.indexList.reserve(data.indexCount);
+				PlaceSurface(scratch, jMin, jMax, lodLevelOffset, adjList);
+				GenerateQuadMeshData(scratch, jMin, jMax, lodLevelOffset, adjList, adjLightList, true);
+			}
+			else if(bOptimize)
+			{
+				GenerateOptimalMeshData(scratch, jMin, jMax, lodLevelOffset, adjList, adjLightList);
+			}
+			else
+			{
+				scratch.vertexList.reserve(data.vertexCount);
+				scratch.indexList.reserve(data.indexCount);
+				GenerateQuadMeshData(scratch, jMin, jMax, lodLevelOffset, adjList, adjLightList);
+			}
 
-			{ // Generate vertex and index data.
-				std::shared_lock<std::shared_mutex> lk[7];
+			{ // Weld and reorder the generated mesh.
+				CChunkMeshOptimizer::Stats stats { };
+				CChunkMeshOptimizer::Optimize(scratch, m_data.meshOptimizeFlags, &stats);
 
-				for(int i = 0; i < 7 && mutexList[i] != 0; ++i)
+				if(m_data.meshOptimizeFlags & MESH_OPTIMIZE_STATS)
 				{
-					lk[i] = std::shared_lock<std::shared_mutex>(*reinterpret_cast<std::shared_mutex*>(mutexList[i]));
+					std::lock_guard<std::shared_mutex> lk(m_mutex);
+					pSection->stats = stats;
 				}
+			}
 
-				u32 vIndex = 0;
-				u32 iIndex = 0;
+			// Translucent triangles are moved into their own range at the end, ordered for the camera position at dispatch.
+			opaqueCount = CChunkMeshOptimizer::SplitTranslucent(scratch, pSection->sortOrigin);
+			CChunkMeshlets::SortByFace(scratch, opaqueCount);
 
-				auto GenerateQuad = [&](BlockId id, const Math::Vector3& offset, const Math::Vector3& center, const Math::Vector3& right, const Math::Vector3& up, const Math::Vector3& normal){
-					*(Index*)m_meshData[meshIndex].GetIndexAt(iIndex++) = vIndex;
-					*(Index*)m_meshData[meshIndex].GetIndexAt(iIndex++) = vIndex + 1;
-					*(Index*)m_meshData[meshIndex].GetIndexAt(iIndex++) = vIndex + 2;
-					*(Index*)m_meshData[meshIndex].GetIndexAt(iIndex++) = vIndex;
-					*(Index*)m_meshData[meshIndex].GetIndexAt(iIndex++) = vIndex + 2;
-					*(Index*)m_meshData[meshIndex].GetIndexAt(iIndex++) = vIndex + 3;
+			data.vertexCount = static_cast<u32>(scratch.vertexList.size());
+			data.indexCount = static_cast<u32>(scratch.indexList.size());
+			pVertexData = scratch.vertexList.data();
+			pIndexData = scratch.indexList.data();
 
-					static const float u = 1.0f / 8.0f;
-					static const float v = 1.0f / 32.0f;
-					const BlockId i = id % 8;
-					const BlockId j = id / 8;
+			if(cacheKey && !pSection->bCancel)
+			{
+				meshCache.Store(cacheKey, scratch.vertexList.data(), data.vertexCount, scratch.indexList.data(), data.indexCount, opaqueCount);
+			}
+		}
 
-					const Math::Vector2 uv = Math::Vector2(u * i, v * j);
+		pSection->translucentCountList[meshIndex] = data.indexCount - opaqueCount;
 
-					const Math::Vector3 v0 = center + (-right - up + normal) * 0.5f;
-					const Math::Vector3 v1 = center + ( right - up + normal) * 0.5f;
-					const Math::Vector3 v2 = center + ( right + up + normal) * 0.5f;
-					const Math::Vector3 v3 = center + (-right + up + normal) * 0.5f;
+		CChunkMeshlets::Build(CChunkMeshScratch::Local(), reinterpret_cast<const PackedChunkVertex*>(pVertexData), data.vertexCount,
+			reinterpret_cast<const u32*>(pIndexData), opaqueCount, pSection->meshletList[meshIndex]);
 
-					const Math::Vector4 uv0(Math::Vector3::Dot(right, v0), Math::Vector3::Dot(up, v0), uv.x, uv.y);
-					const Math::Vector4 uv1(Math::Vector3::Dot(right, v1), Math::Vector3::Dot(up, v1), uv.x, uv.y);
-					const Math::Vector4 uv2(Math::Vector3::Dot(right, v2), Math::Vector3::Dot(up, v2), uv.x, uv.y);
-					const Math::Vector4 uv3(Math::Vector3::Dot(right, v3), Math::Vector3::Dot(up, v3), uv.x, uv.y);
+		if(data.indexCount == 0)
+		{ // Empty sections don't need a renderer.
+			pSection->pMeshRendererList[meshIndex] = nullptr;
+			return;
+		}
 
-					*(Vertex*)m_meshData[meshIndex].GetVertexAt(vIndex++) = { { offset + v0 * m_data.blockSize }, normal, right, uv0 };
-					*(Vertex*)m_meshData[meshIndex].GetVertexAt(vIndex++) = { { offset + v1 * m_data.blockSize }, normal, right, uv1 };
-					*(Vertex*)m_meshData[meshIndex].GetVertexAt(vIndex++) = { { offset + v2 * m_data.blockSize }, normal, right, uv2 };
-					*(Vertex*)m_meshData[meshIndex].GetVertexAt(vIndex++) = { { offset + v3 * m_data.blockSize }, normal, right, uv3 };
-				};
+		if(pSection->bCancel) return;
+
+		pSection->meshData[meshIndex].SetData(data);
+		pSection->meshData[meshIndex].InitializeBorrowed(reinterpret_cast<u8*>(const_cast<void*>(pVertexData)), nullptr, reinterpret_cast<u8*>(const_cast<void*>(pIndexData)));
+
+		{ // Create the mesh renderer.
+			pSection->pMeshRendererList[meshIndex] = CFactory::Instance().CreateMeshRenderer(m_pObject); // TODO: Create a pool of these renderers managed by CChunkManager.
+
+			Graphics::CMeshRenderer_::Data data { };
+			data.bSkipRegistration = true;
+			data.pMeshData = &pSection->meshData[meshIndex];
+			data.indexRangeList = { { 0, opaqueCount }, { opaqueCount, pSection->translucentCountList[meshIndex] } };
+			pSection->pMeshRendererList[meshIndex]->SetData(data);
+			pSection->pMeshRendererList[meshIndex]->AddMaterial(m_pMaterial);
+			pSection->pMeshRendererList[meshIndex]->AddMaterial(m_pMaterialTranslucent);
+			//pSection->pMeshRendererList[meshIndex]->AddMaterial(m_pMaterialWire);
+
+			pSection->pMeshRendererList[meshIndex]->Initialize();
+		}
+
+		pSection->meshBytesList[meshIndex] = data.vertexCount * data.vertexStride + data.indexCount * data.indexStride;
+		MeshBytesMetric()->Add(pSection->meshBytesList[meshIndex]);
 
-				const Math::Vector3 offset(
-					static_cast<float>(m_data.offset.x) * m_data.blockSize,
-					static_cast<float>(m_data.offset.y) * m_data.blockSize,
-					static_cast<float>(m_data.offset.z) * m_data.blockSize
-				);
+		/*{ // Create the mesh wire renderer.
+			m_pMeshRendererListWire[meshIndex] = CFactory::Instance().CreateMeshRenderer(m_pObject);
 
-				u32 index = m_lodLevelOffset;
-				for(u32 i = 0; i < m_data.width; ++i)
+			Graphics::CMeshRenderer_::Data data { };
+			data.bSkipRegistration = true;
+			data.pMeshData = &pSection->meshData[meshIndex];
+			m_pMeshRendererListWire[meshIndex]->SetData(data);
+			m_pMeshRendererListWire[meshIndex]->AddMaterial(m_pMaterialWire);
+
+			m_pMeshRendererListWire[meshIndex]->Initialize();
+		}*/
+		
+		pSection->meshData[meshIndex].Release();
+	}
+
+	// Key of a section's mesh in the mesh cache, covering everything its build reads: blocks and light from the row below the section to the
+	//  row above it, the neighbours' facing slices over those rows, and the settings the mesher runs with. Expected to be called while the
+	//  chunk's lock is held.
+	u64 CChunk::ComputeMeshKey(const Section* pSection, bool bOptimize, const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6],
+		const CChunkLight::AdjList& adjLightList) const
+	{
+		u64 hash = Math::FNV1a_64_OFFSET;
+		auto Add = [&hash](const auto& value){
+			hash = Math::FNV1a_64(hash, &value, sizeof(value));
+		};
+
+		Add(CChunkMeshCache::VERSION);
+		Add(CBlockRegistry::Instance().GetHash());
+		Add(m_data.width);
+		Add(m_data.height);
+		Add(m_data.length);
+		Add(pSection->blockMin);
+		Add(pSection->blockMax);
+		Add(m_lodLevel);
+		Add(static_cast<u8>(m_data.meshOptimizeFlags & ~MESH_OPTIMIZE_STATS));
+		Add(m_data.meshSurface);
+		Add(bOptimize);
+
+		const u32 rowMin = pSection->blockMin > 0 ? pSection->blockMin - 1 : 0;
+		const u32 rowMax = std::min(pSection->blockMax + 1, m_data.height);
+
+		for(u32 i = 0; i < m_data.width; ++i)
+		{
+			for(u32 k = 0; k < m_data.length; ++k)
+			{
+				const u32 index = internalGetIndex(i, rowMin, k);
+				for(u32 j = 0; j < rowMax - rowMin; ++j)
 				{
-					for(u32 k = 0; k < m_data.length; ++k)
+					const Block block = internalGetBlock(index + j);
+					Add(static_cast<u16>(block.bFilled ? block.id : 0x100));
+					Add(m_light.Get(index + j));
+				}
+			}
+		}
+
+		// Missing neighbours hash differently from empty ones, since the mesher treats them differently.
+		auto AddSlice = [&](SIDE side, u32 uMin, u32 uMax, u32 vMin, u32 vMax){
+			const SIDE facing = static_cast<SIDE>(side ^ 1);
+			Add(static_cast<u8>((adjList[side] ? 0x1 : 0x0) | (adjLightList[side] ? 0x2 : 0x0)));
+
+			for(u32 v = vMin; v < vMax; ++v)
+			{
+				for(u32 u = uMin; u < uMax; ++u)
+				{
+					if(adjList[side]) Add(static_cast<u16>(adjList[side]->IsFilled(facing, u, v) ? adjList[side]->GetId(facing, u, v) : 0x100));
+					if(adjLightList[side]) Add(adjLightList[side]->Get(facing, u, v));
+				}
+			}
+		};
+
+		// Slices are laid out (j, k), (i, k) and (i, j), so only the section's rows of the side slices are read.
+		AddSlice(SIDE_LEFT, rowMin, rowMax, 0, m_data.length);
+		AddSlice(SIDE_RIGHT, rowMin, rowMax, 0, m_data.length);
+		AddSlice(SIDE_BACK, 0, m_data.width, rowMin, rowMax);
+		AddSlice(SIDE_FRONT, 0, m_data.width, rowMin, rowMax);
+		if(pSection->blockMin == 0) AddSlice(SIDE_BOTTOM, 0, m_data.width, 0, m_data.length);
+		if(pSection->blockMax == m_data.height) AddSlice(SIDE_TOP, 0, m_data.width, 0, m_data.length);
+
+		return hash;
+	}
+
+	// One quad per visible face, without merging. Smooth surfaces move each corner by the offset PlaceSurface found for it.
+	void CChunk::GenerateQuadMeshData(CChunkMeshScratch& scratch, u32 jMin, u32 jMax, u32 lodLevelOffset,
+		const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6], const CChunkLight::AdjList& adjLightList, bool bSmooth)
+	{
+		const CBlockRegistry& registry = CBlockRegistry::Instance();
+		auto IsFaceHidden = [&registry](const Block& adj, BlockId id){
+			return adj.bFilled && registry.IsFaceHidden(id, adj.id);
+		};
+
+		{ // Generate vertex and index data.
+			std::shared_lock<std::shared_mutex> lk(m_mutex);
+
+			// Lattice points on two or more chunk seams would be placed from blocks diagonal to the chunk, which neighbours don't publish, so they
+			//  stay on the lattice. Every chunk sharing such a point does the same, which keeps seams closed.
+			auto GetSurfaceOffset = [&](u32 x, u32 y, u32 z) -> u16 {
+				const u32 seamCount = (x == 0 || x == m_data.width) + (y == 0 || y == m_data.height) + (z == 0 || z == m_data.length);
+				if(seamCount >= 2) return PackedChunkVertex::OFFSET_SMOOTH;
+				return scratch.surfaceOffsetList[CChunkSurfaceNets::GetLatticeIndex(x, z, y - jMin, m_data.length, jMax - jMin)];
+			};
+
+			auto GenerateQuad = [&](BlockId id, const Math::Vector3& offset, const Math::Vector3& center, const Math::Vector3& right, const Math::Vector3& up, const Math::Vector3& normal){
+				const Index vIndex = static_cast<Index>(scratch.vertexList.size());
+				for(const Index i : { 0, 1, 2, 0, 2, 3 })
+				{
+					scratch.indexList.push_back(vIndex + i);
+				}
+
+				static const float u = 1.0f / 8.0f;
+				static const float v = 1.0f / 32.0f;
+				const BlockId i = id % 8;
+				const BlockId j = id / 8;
+
+				const Math::Vector2 uv = Math::Vector2(u * i, v * j);
+
+				const Math::Vector3 v0 = center + (-right - up + normal) * 0.5f;
+				const Math::Vector3 v1 = center + ( right - up + normal) * 0.5f;
+				const Math::Vector3 v2 = center + ( right + up + normal) * 0.5f;
+				const Math::Vector3 v3 = center + (-right + up + normal) * 0.5f;
+
+				const u8 side = PackedChunkVertex::GetAxisIndex(normal);
+				for(const Math::Vector3& vertex : { v0, v1, v2, v3 })
+				{
+					const u32 x = static_cast<u32>(vertex.x + 0.5f);
+					const u32 y = static_cast<u32>(vertex.y + 0.5f);
+					const u32 z = static_cast<u32>(vertex.z + 0.5f);
+
+					const u16 shade = GetVertexShade(x, y, z, side, lodLevelOffset, adjList, adjLightList);
+					const u16 surfaceOffset = bSmooth ? GetSurfaceOffset(x, y, z) : PackedChunkVertex::OFFSET_NONE;
+					const PackedChunkVertex packed = PackedChunkVertex::Pack(vertex, normal, right, up, id, shade, surfaceOffset);
+#if _DEBUG
+					const Math::Vector3 position = vertex + PackedChunkVertex::UnpackOffset(surfaceOffset);
+					const ChunkVertex reference = { offset + position * m_data.blockSize, normal, right,
+						Math::Vector4(Math::Vector3::Dot(right, position), Math::Vector3::Dot(up, position), uv.x, uv.y) };
+					assert(PackedChunkVertex::IsEquivalent(packed.Unpack(offset, m_data.blockSize), reference));
+#endif
+					scratch.vertexList.push_back(packed);
+				}
+			};
+
+			const Math::Vector3 offset(
+				static_cast<float>(m_data.offset.x) * m_data.blockSize,
+				static_cast<float>(m_data.offset.y) * m_data.blockSize,
+				static_cast<float>(m_data.offset.z) * m_data.blockSize
+			);
+
+			for(u32 i = 0; i < m_data.width; ++i)
+			{
+				for(u32 k = 0; k < m_data.length; ++k)
+				{
+					u32 index = lodLevelOffset + internalGetIndex(i, jMin, k);
+					for(u32 j = jMin; j < jMax; ++j)
 					{
-						for(u32 j = 0; j < m_data.height; ++j)
-						{
-							const Block block = m_pBlockList[index++];
-							if(!block.bFilled) continue;
+						const Block block = m_pBlockList[index++];
+						if(!block.bFilled) continue;
 
-							Math::Vector3 center(i + 0.5f, j + 0.5f, k + 0.5f);
+						const BlockId id = block.id;
 
-							
-							// Left.
-							if(i == 0)
-							{
-								if(!m_pChunkAdj[SIDE_LEFT] || !m_pChunkAdj[SIDE_LEFT]->internalGetBlock(m_pChunkAdj[SIDE_LEFT]->internalGetIndexRight(j, k)).bFilled)
-								{
-									GenerateQuad(block.id, offset, center, Math::VEC3_BACKWARD, Math::VEC3_UP, Math::VEC3_LEFT);
-								}
-							}
-							else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i - 1, j, k)].bFilled)
+						Math::Vector3 center(i + 0.5f, j + 0.5f, k + 0.5f);
+
+						
+						// Left.
+						if(i == 0)
+						{
+							if(!adjList[SIDE_LEFT] || !adjList[SIDE_LEFT]->HidesFace(SIDE_RIGHT, j, k, id))
 							{
 								GenerateQuad(block.id, offset, center, Math::VEC3_BACKWARD, Math::VEC3_UP, Math::VEC3_LEFT);
 							}
+						}
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i - 1, j, k)], id))
+						{
+							GenerateQuad(block.id, offset, center, Math::VEC3_BACKWARD, Math::VEC3_UP, Math::VEC3_LEFT);
+						}
 
-							// Right.
-							if(i == m_data.width - 1)
-							{
-								if(!m_pChunkAdj[SIDE_RIGHT] || !m_pChunkAdj[SIDE_RIGHT]->internalGetBlock(m_pChunkAdj[SIDE_RIGHT]->internalGetIndexLeft(j, k)).bFilled)
-								{
-									GenerateQuad(block.id, offset, center, Math::VEC3_FORWARD, Math::VEC3_UP, Math::VEC3_RIGHT);
-								}
-							}
-							else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i + 1, j, k)].bFilled)
+						// Right.
+						if(i == m_data.width - 1)
+						{
+							if(!adjList[SIDE_RIGHT] || !adjList[SIDE_RIGHT]->HidesFace(SIDE_LEFT, j, k, id))
 							{
 								GenerateQuad(block.id, offset, center, Math::VEC3_FORWARD, Math::VEC3_UP, Math::VEC3_RIGHT);
 							}
+						}
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i + 1, j, k)], id))
+						{
+							GenerateQuad(block.id, offset, center, Math::VEC3_FORWARD, Math::VEC3_UP, Math::VEC3_RIGHT);
+						}
 
-							// Bottom.
-							if(j == 0)
-							{
-								if(!m_pChunkAdj[SIDE_BOTTOM] || !m_pChunkAdj[SIDE_BOTTOM]->internalGetBlock(m_pChunkAdj[SIDE_BOTTOM]->internalGetIndexTop(i, k)).bFilled)
-								{
-									GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_BACKWARD, Math::VEC3_DOWN);
-								}
-							}
-							else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i, j - 1, k)].bFilled)
+						// Bottom.
+						if(j == 0)
+						{
+							if(!adjList[SIDE_BOTTOM] || !adjList[SIDE_BOTTOM]->HidesFace(SIDE_TOP, i, k, id))
 							{
 								GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_BACKWARD, Math::VEC3_DOWN);
 							}
+						}
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i, j - 1, k)], id))
+						{
+							GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_BACKWARD, Math::VEC3_DOWN);
+						}
 
-							// Top.
-							if(j == m_data.height - 1)
-							{
-								if(!m_pChunkAdj[SIDE_TOP] || !m_pChunkAdj[SIDE_TOP]->internalGetBlock(m_pChunkAdj[SIDE_TOP]->internalGetIndexBottom(i, k)).bFilled)
-								{
-									GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_FORWARD, Math::VEC3_UP);
-								}
-							}
-							else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i, j + 1, k)].bFilled)
+						// Top.
+						if(j == m_data.height - 1)
+						{
+							if(!adjList[SIDE_TOP] || !adjList[SIDE_TOP]->HidesFace(SIDE_BOTTOM, i, k, id))
 							{
 								GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_FORWARD, Math::VEC3_UP);
 							}
+						}
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i, j + 1, k)], id))
+						{
+							GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_FORWARD, Math::VEC3_UP);
+						}
 
-							// Back.
-							if(k == 0)
-							{
-								if(!m_pChunkAdj[SIDE_BACK] || !m_pChunkAdj[SIDE_BACK]->internalGetBlock(m_pChunkAdj[SIDE_BACK]->internalGetIndexFront(i, j)).bFilled)
-								{
-									GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_UP, Math::VEC3_BACKWARD);
-								}
-							}
-							else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i, j, k - 1)].bFilled)
+						// Back.
+						if(k == 0)
+						{
+							if(!adjList[SIDE_BACK] || !adjList[SIDE_BACK]->HidesFace(SIDE_FRONT, i, j, id))
 							{
 								GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_UP, Math::VEC3_BACKWARD);
 							}
+						}
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i, j, k - 1)], id))
+						{
+							GenerateQuad(block.id, offset, center, Math::VEC3_RIGHT, Math::VEC3_UP, Math::VEC3_BACKWARD);
+						}
 
-							// Front.
-							if(k == m_data.length - 1)
-							{
-								if(!m_pChunkAdj[SIDE_FRONT] || !m_pChunkAdj[SIDE_FRONT]->internalGetBlock(m_pChunkAdj[SIDE_FRONT]->internalGetIndexBack(i, j)).bFilled)
-								{
-									GenerateQuad(block.id, offset, center, Math::VEC3_LEFT, Math::VEC3_UP, Math::VEC3_FORWARD);
-								}
-							}
-							else if(!m_pBlockList[m_lodLevelOffset + internalGetIndex(i, j, k + 1)].bFilled)
+						// Front.
+						if(k == m_data.length - 1)
+						{
+							if(!adjList[SIDE_FRONT] || !adjList[SIDE_FRONT]->HidesFace(SIDE_BACK, i, j, id))
 							{
 								GenerateQuad(block.id, offset, center, Math::VEC3_LEFT, Math::VEC3_UP, Math::VEC3_FORWARD);
 							}
 						}
+						else if(!IsFaceHidden(m_pBlockList[lodLevelOffset + internalGetIndex(i, j, k + 1)], id))
+						{
+							GenerateQuad(block.id, offset, center, Math::VEC3_LEFT, Math::VEC3_UP, Math::VEC3_FORWARD);
+						}
 					}
 				}
 			}
 		}
+	}
 
-		{ // Create the mesh renderer.
-			m_pMeshRendererList[meshIndex] = CFactory::Instance().CreateMeshRenderer(m_pObject); // TODO: Create a pool of these renderers managed by CChunkManager.
+	// Samples occupancy for CChunkSurfaceNets, from the row below the section to the row above it, and one block into each neighbour through its
+	//  published border slices. Missing neighbours read as empty, as they do for face culling, and blocks diagonal to the chunk are left empty.
+	void CChunk::PlaceSurface(CChunkMeshScratch& scratch, u32 jMin, u32 jMax, u32 lodLevelOffset, const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6])
+	{
+		const u32 rowCount = jMax - jMin;
+		const s32 width = static_cast<s32>(m_data.width);
+		const s32 height = static_cast<s32>(m_data.height);
+		const s32 length = static_cast<s32>(m_data.length);
 
-			Graphics::CMeshRenderer_::Data data { };
-			data.bSkipRegistration = true;
-			data.pMeshData = &m_meshData[meshIndex];
-			m_pMeshRendererList[meshIndex]->SetData(data);
-			m_pMeshRendererList[meshIndex]->AddMaterial(m_pMaterial);
-			//m_pMeshRendererList[meshIndex]->AddMaterial(m_pMaterialWire);
+		const size_t sampleCount = static_cast<size_t>(m_data.width + 2) * (m_data.length + 2) * CChunkSurfaceNets::GetSampleStride(rowCount);
+		if(scratch.sampleList.size() < sampleCount) scratch.sampleList.resize(sampleCount);
+		std::fill_n(scratch.sampleList.begin(), sampleCount, static_cast<u8>(0));
 
-			m_pMeshRendererList[meshIndex]->Initialize();
-		}
+		auto Sample = [](bool bFilled){
+			return static_cast<u8>(bFilled ? 0xFF : 0x00);
+		};
 
-		/*{ // Create the mesh wire renderer.
-			m_pMeshRendererListWire[meshIndex] = CFactory::Instance().CreateMeshRenderer(m_pObject);
+		auto SampleSlice = [&](SIDE side, u32 u, u32 v){
+			return Sample(adjList[side] && adjList[side]->IsFilled(static_cast<SIDE>(side ^ 1), u, v));
+		};
 
-			Graphics::CMeshRenderer_::Data data { };
-			data.bSkipRegistration = true;
-			data.pMeshData = &m_meshData[meshIndex];
-			m_pMeshRendererListWire[meshIndex]->SetData(data);
-			m_pMeshRendererListWire[meshIndex]->AddMaterial(m_pMaterialWire);
+		{
+			std::shared_lock<std::shared_mutex> lk(m_mutex);
 
-			m_pMeshRendererListWire[meshIndex]->Initialize();
-		}*/
-		
-		m_meshData[meshIndex].Release();
+			for(s32 x = -1; x <= width; ++x)
+			{
+				for(s32 z = -1; z <= length; ++z)
+				{
+					const bool bOutsideX = x < 0 || x == width;
+					const bool bOutsideZ = z < 0 || z == length;
+					if(bOutsideX && bOutsideZ) continue;
+
+					u8* pColumn = scratch.sampleList.data() + CChunkSurfaceNets::GetSampleIndex(x + 1, z + 1, 0, m_data.length, rowCount);
+
+					// Sample row r is block row jMin - 1 + r.
+					for(u32 r = 0; r <= rowCount + 1; ++r)
+					{
+						const s32 j = static_cast<s32>(jMin + r) - 1;
+						const bool bOutsideY = j < 0 || j == height;
+
+						if(bOutsideX)
+						{
+							if(!bOutsideY) pColumn[r] = SampleSlice(x < 0 ? SIDE_LEFT : SIDE_RIGHT, j, z);
+						}
+						else if(bOutsideZ)
+						{
+							if(!bOutsideY) pColumn[r] = SampleSlice(z < 0 ? SIDE_BACK : SIDE_FRONT, x, j);
+						}
+						else if(bOutsideY)
+						{
+							pColumn[r] = SampleSlice(j < 0 ? SIDE_BOTTOM : SIDE_TOP, x, z);
+						}
+						else
+						{
+							pColumn[r] = Sample(m_pBlockList[lodLevelOffset + internalGetIndex(x, j, z)].bFilled);
+						}
+					}
+				}
+			}
+		}
+
+		CChunkSurfaceNets::Place(scratch, m_data.width, m_data.length, rowCount);
 	}
 
-	void CChunk::ProcessIsland(std::unordered_set<u32>& set, std::unordered_set<u32>::iterator it, u32 iStep, u32 kStep, u32 maxIndex, u32 iAxis, u32 kAxis,
-		const QuadSides& flags, const QuadEdges& edges, std::unordered_map<u32, u64>& disjointedSet)
+	void CChunk::ProcessIsland(CChunkMeshScratch& scratch, u32 seed, u32 iStep, u32 kStep, u32 jMin, u32 jMax, u32 lodLevelOffset, u32 iAxis, u32 kAxis,
+		const QuadSides& flags, const QuadEdges& edges, const std::vector<u16>& shadeList)
 	{
-		// Sub-Lambda for adding edge to disjointed set.
-		auto AddEdge = [&](u32 a, u32 b){
-			auto elem = disjointedSet.find(a);
-			if(elem != disjointedSet.end())
-			{
-				elem->second <<= 32;
-				elem->second |= b;
-			}
-			else
-			{
-				disjointedSet.insert({ a, b });
-			}
+		auto AddEdge = [&scratch](u32 a, u32 b){
+			scratch.edgeSet.Add(a, b);
 		};
 
-		u32 chunkSize[3] = { m_data.width, m_data.height, m_data.length };
+		// Islands are bounded by the section being built, as well as the chunk.
+		const u32 minList[3] = { 0, jMin, 0 };
+		const u32 maxList[3] = { m_data.width, jMax, m_data.length };
 
-		std::queue<u32> q;
-		q.push(*it);
+		// The queue is consumed from the front without popping, so it never reallocates once the arena has grown.
+		auto& q = scratch.islandQueue;
+		q.clear();
+		q.push_back(seed);
 
-		while(!q.empty())
+		for(size_t head = 0; head < q.size(); ++head)
 		{
-			auto iter = set.find(q.front());
-			q.pop();
-
-			if(iter == set.end()) continue;
+			const u32 index = q[head];
+			if(!scratch.pendingList[index]) continue;
 
-			const u32 index = *iter;
-			// Erase quad from set so it isn't revisited.
-			set.erase(iter);
+			// Remove quad from pending list so it isn't revisited.
+			scratch.pendingList[index] = 0;
 			
 			u32 indices[3];
 			internalGetCoordsFromIndex(index, indices[0], indices[1], indices[2]);
 
-			const u32 blockIndex = m_lodLevelOffset + index;
+			const u32 blockIndex = lodLevelOffset + index;
+
+			// Baked shading is interpolated across each triangle, so only faces shaded the same at every corner can be merged.
+			const u16 shade = shadeList[index];
+			auto IsShadeSplit = [&](u32 adjIndex){
+				return shade == SHADE_MIXED || shadeList[adjIndex] != shade;
+			};
 
 			// Add edges of quad to disjointed set.
-			if((m_pBlockList[blockIndex].sideFlag & flags.v[1]) || indices[iAxis] == 0 || m_pBlockList[blockIndex - iStep].id != m_pBlockList[blockIndex].id || !(m_pBlockList[blockIndex - iStep].sideFlag & flags.v[0])) 
+			if((m_pBlockList[blockIndex].sideFlag & flags.v[1]) || indices[iAxis] == minList[iAxis] || m_pBlockList[blockIndex - iStep].id != m_pBlockList[blockIndex].id || !(m_pBlockList[blockIndex - iStep].sideFlag & flags.v[0]) || IsShadeSplit(index - iStep)) 
 			{
 				AddEdge(internalGetVertexIndex(indices[0] + (u32)edges.e[0].e0.x, indices[1] + (u32)edges.e[0].e0.y, indices[2] + (u32)edges.e[0].e0.z),
 					internalGetVertexIndex(indices[0] + (u32)edges.e[0].e1.x, indices[1] + (u32)edges.e[0].e1.y, indices[2] + (u32)edges.e[0].e1.z));
 			}
 
-			if((m_pBlockList[blockIndex].sideFlag & flags.v[2]) || indices[iAxis] == chunkSize[iAxis] - 1 || m_pBlockList[blockIndex + iStep].id != m_pBlockList[blockIndex].id || !(m_pBlockList[blockIndex + iStep].sideFlag & flags.v[0]))
+			if((m_pBlockList[blockIndex].sideFlag & flags.v[2]) || indices[iAxis] == maxList[iAxis] - 1 || m_pBlockList[blockIndex + iStep].id != m_pBlockList[blockIndex].id || !(m_pBlockList[blockIndex + iStep].sideFlag & flags.v[0]) || IsShadeSplit(index + iStep))
 			{
 				AddEdge(internalGetVertexIndex(indices[0] + (u32)edges.e[1].e0.x, indices[1] + (u32)edges.e[1].e0.y, indices[2] + (u32)edges.e[1].e0.z),
 					internalGetVertexIndex(indices[0] + (u32)edges.e[1].e1.x, indices[1] + (u32)edges.e[1].e1.y, indices[2] + (u32)edges.e[1].e1.z));
 			}
 
-			if((m_pBlockList[blockIndex].sideFlag & flags.v[3]) || indices[kAxis] == 0 || m_pBlockList[blockIndex - kStep].id != m_pBlockList[blockIndex].id || !(m_pBlockList[blockIndex - kStep].sideFlag & flags.v[0]))
+			if((m_pBlockList[blockIndex].sideFlag & flags.v[3]) || indices[kAxis] == minList[kAxis] || m_pBlockList[blockIndex - kStep].id != m_pBlockList[blockIndex].id || !(m_pBlockList[blockIndex - kStep].sideFlag & flags.v[0]) || IsShadeSplit(index - kStep))
 			{
 				AddEdge(internalGetVertexIndex(indices[0] + (u32)edges.e[2].e0.x, indices[1] + (u32)edges.e[2].e0.y, indices[2] + (u32)edges.e[2].e0.z),
 					internalGetVertexIndex(indices[0] + (u32)edges.e[2].e1.x, indices[1] + (u32)edges.e[2].e1.y, indices[2] + (u32)edges.e[2].e1.z));
 			}
 
-			if((m_pBlockList[blockIndex].sideFlag & flags.v[4]) || indices[kAxis] == chunkSize[kAxis] - 1 || m_pBlockList[blockIndex + kStep].id != m_pBlockList[blockIndex].id || !(m_pBlockList[blockIndex + kStep].sideFlag & flags.v[0]))
+			if((m_pBlockList[blockIndex].sideFlag & flags.v[4]) || indices[kAxis] == maxList[kAxis] - 1 || m_pBlockList[blockIndex + kStep].id != m_pBlockList[blockIndex].id || !(m_pBlockList[blockIndex + kStep].sideFlag & flags.v[0]) || IsShadeSplit(index + kStep))
 			{
 				AddEdge(internalGetVertexIndex(indices[0] + (u32)edges.e[3].e0.x, indices[1] + (u32)edges.e[3].e0.y, indices[2] + (u32)edges.e[3].e0.z),
 					internalGetVertexIndex(indices[0] + (u32)edges.e[3].e1.x, indices[1] + (u32)edges.e[3].e1.y, indices[2] + (u32)edges.e[3].e1.z));
 			}
 
-			if(indices[iAxis] > 0)
+			if(shade == SHADE_MIXED) continue;
+
+			if(indices[iAxis] > minList[iAxis])
 			{ // Left.
-				q.push(index - iStep);
+				q.push_back(index - iStep);
 			}
-			if(indices[iAxis] < chunkSize[iAxis] - 1)
+			if(indices[iAxis] < maxList[iAxis] - 1)
 			{ // Right.
-				q.push(index + iStep);
+				q.push_back(index + iStep);
 			}
 
-			if(indices[kAxis] > 0)
+			if(indices[kAxis] > minList[kAxis])
 			{ // Back.
-				q.push(index - kStep);
+				q.push_back(index - kStep);
 			}
-			if(indices[kAxis] < chunkSize[kAxis] - 1)
+			if(indices[kAxis] < maxList[kAxis] - 1)
 			{ // Front.
-				q.push(index + kStep);
+				q.push_back(index + kStep);
 			}
 		}
 	}
 
-	void CChunk::GenerateOptimalMeshData(u8 meshIndex, Graphics::CMeshData_::Data& data)
+	void CChunk::GenerateOptimalMeshData(CChunkMeshScratch& scratch, u32 jMin, u32 jMax, u32 lodLevelOffset,
+		const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6], const CChunkLight::AdjList& adjLightList)
 	{
 		const Math::Vector3 offset(
 			static_cast<float>(m_data.offset.x) * m_data.blockSize,
@@ -657,15 +1193,14 @@ namespace Universe
 			static_cast<float>(m_data.offset.z) * m_data.blockSize
 		);
 
-		std::vector<Vertex> vertexList;
-		std::vector<Index> indexList;
-
-		std::unordered_map<BlockId, std::unordered_set<u32>> blockMap[2];
-		std::unordered_map<u32, u64> disjointedSet;
+		auto& vertexList = scratch.vertexList;
+		auto& indexList = scratch.indexList;
+		auto& disjointedSet = scratch.edgeSet;
 
 		// Lambda for triangulating a planar adjacency list.
-		auto Triangulate = [this, &vertexList, &indexList, &offset](const std::vector<Math::Vector3>& pointList, const Math::Vector3& normal, const Math::Vector3& tangent, const Math::Vector3& bitangent, BlockId id){
-			std::unordered_map<u32, u32> vertexMap;
+		auto Triangulate = [this, &scratch, &vertexList, &indexList, &offset, &adjList, &adjLightList, lodLevelOffset](const std::vector<Math::Vector3>& pointList, const Math::Vector3& normal, const Math::Vector3& tangent, const Math::Vector3& bitangent, BlockId id){
+			scratch.NextRemapStamp();
+			const u8 side = PackedChunkVertex::GetAxisIndex(normal);
 
 			int n = static_cast<int>(pointList.size());
 			short prev[4096];
@@ -748,22 +1283,23 @@ namespace Universe
 						internalGetVertexIndex(static_cast<u32>(vList[2].x), static_cast<u32>(vList[2].y), static_cast<u32>(vList[2].z))
 					};
 
-					std::unordered_map<u32, u32>::iterator it[3] = {
-						vertexMap.find(iList[0]),
-						vertexMap.find(iList[1]),
-						vertexMap.find(iList[2]),
-					};
-
 					for(size_t j = 0; j < 3; ++j)
 					{
-						if(it[j] == vertexMap.end())
+						if(scratch.remapStampList[iList[j]] != scratch.remapStamp)
 						{
-							it[j] = vertexMap.insert({ iList[j], static_cast<u32>(vertexList.size()) }).first;
-							Math::Vector4 texCoord(Math::Vector3::Dot(tangent, vList[j]), Math::Vector3::Dot(bitangent, vList[j]), uv.x, uv.y);
-							vertexList.push_back({ offset + vList[j] * m_data.blockSize, normal, tangent, texCoord });
+							scratch.remapStampList[iList[j]] = scratch.remapStamp;
+							scratch.remapList[iList[j]] = static_cast<u32>(vertexList.size());
+							const u16 shade = GetVertexShade(static_cast<u32>(vList[j].x), static_cast<u32>(vList[j].y), static_cast<u32>(vList[j].z), side, lodLevelOffset, adjList, adjLightList);
+							const PackedChunkVertex packed = PackedChunkVertex::Pack(vList[j], normal, tangent, bitangent, id, shade);
+#if _DEBUG
+							const ChunkVertex reference = { offset + vList[j] * m_data.blockSize, normal, tangent,
+								Math::Vector4(Math::Vector3::Dot(tangent, vList[j]), Math::Vector3::Dot(bitangent, vList[j]), uv.x, uv.y) };
+							assert(PackedChunkVertex::IsEquivalent(packed.Unpack(offset, m_data.blockSize), reference));
+#endif
+							vertexList.push_back(packed);
 						}
 
-						indexList.push_back(it[j]->second);
+						indexList.push_back(scratch.remapList[iList[j]]);
 					}
 
 					next[prev[i]] = next[i];
@@ -795,27 +1331,29 @@ namespace Universe
 			size_t closestVertex = 0;
 
 			// Create point lists out of the disjointed set created for the current island.
-			std::vector<std::vector<Math::Vector3>> pointLists;
-			while(!disjointedSet.empty())
+			auto& pointLists = scratch.pointLists;
+			scratch.pointListCount = 0;
+			while(!disjointedSet.Empty())
 			{
-				std::vector<Math::Vector3> pointList;
-				u32 index = disjointedSet.begin()->first;
+				auto& pointList = scratch.pointList;
+				pointList.clear();
+				u32 index = disjointedSet.Front();
 				u32 i0, j0, k0;
-				while(!disjointedSet.empty())
+				while(!disjointedSet.Empty())
 				{
 					internalGetCoordsFromVertexIndex(index, i0, j0, k0);
 					const Math::Vector3 vertex = { static_cast<float>(i0), static_cast<float>(j0), static_cast<float>(k0) };
 
-					auto vertexIter = disjointedSet.find(index);
-					if(vertexIter == disjointedSet.end()) break;
+					u64* pEdge = disjointedSet.Find(index);
+					if(pEdge == nullptr) break;
 
-					if(vertexIter->second > std::numeric_limits<u32>::max())
+					if(*pEdge > std::numeric_limits<u32>::max())
 					{
-						index = static_cast<u32>(vertexIter->second & 0xFFFFFFFF);
+						index = static_cast<u32>(*pEdge & 0xFFFFFFFF);
 
 						if(pointList.empty())
 						{
-							vertexIter->second >>= 32;
+							*pEdge >>= 32;
 						}
 						else
 						{
@@ -824,19 +1362,20 @@ namespace Universe
 							const Math::Vector3 nextVertex = { static_cast<float>(i1), static_cast<float>(j1), static_cast<float>(k1) };
 							if(Math::Vector3::Dot(Math::Vector3::Cross(nextVertex - vertex, vertex - pointList.back()), normal) > 0.0f)
 							{ // CCW
-								vertexIter->second >>= 32;
+								*pEdge >>= 32;
 							}
 							else
 							{ // CW, so swap the order.
-								index = static_cast<u32>(vertexIter->second >> 32);
-								vertexIter->second &= 0xFFFFFFFF;
+								index = static_cast<u32>(*pEdge >> 32);
+								*pEdge &= 0xFFFFFFFF;
 							}
 						}
 					}
 					else
 					{
-						index = static_cast<u32>(vertexIter->second);
-						disjointedSet.erase(vertexIter);
+						const u32 nextIndex = static_cast<u32>(*pEdge);
+						disjointedSet.Erase(index);
+						index = nextIndex;
 					}
 
 					pointList.push_back(vertex);
@@ -867,31 +1406,31 @@ namespace Universe
 					const float dot = Math::Vector3::Dot(tangent, point);
 					if(dot < closestDot)
 					{
-						closestList = pointLists.size() - 1;
-						closestVertex = pointLists.back().size();
+						closestList = scratch.pointListCount - 1;
+						closestVertex = pointLists[scratch.pointListCount - 1].size();
 						closestDot = dot;
 					}
 
-					pointLists.back().push_back(point);
+					pointLists[scratch.pointListCount - 1].push_back(point);
 				};
 
 				if(ptOffset + 2 < pointList.size())
 				{
-					pointLists.push_back({ });
+					scratch.AddPointList();
 					AddPoint(pointList[ptOffset]);
 
 					for(size_t pt = ptOffset + 1; pt < pointList.size(); ++pt)
 					{
 						if(pt + 1 < pointList.size())
 						{
-							if(!TestCollinear(pointLists.back().back(), pointList[pt], pointList[pt + 1]))
+							if(!TestCollinear(pointLists[scratch.pointListCount - 1].back(), pointList[pt], pointList[pt + 1]))
 							{
 								AddPoint(pointList[pt]);
 							}
 						}
 						else
 						{
-							if(!TestCollinear(pointLists.back().back(), pointList[pt], pointLists.back().front()))
+							if(!TestCollinear(pointLists[scratch.pointListCount - 1].back(), pointList[pt], pointLists[scratch.pointListCount - 1].front()))
 							{
 								AddPoint(pointList[pt]);
 							}
@@ -900,16 +1439,20 @@ namespace Universe
 				}
 			}
 
+			if(scratch.pointListCount == 0) return;
+
 			const size_t mergedListIndex = closestList;
-			std::unordered_set<size_t> mergedLists;
-			mergedLists.insert(closestList);
-			while(mergedLists.size() < pointLists.size())
+			auto& mergedLists = scratch.mergedList;
+			mergedLists.assign(scratch.pointListCount, 0);
+			mergedLists[closestList] = 1;
+			size_t mergedCount = 1;
+			while(mergedCount < scratch.pointListCount)
 			{
 				// Find point in remaining point lists that is closest to -tangent direction.
 				closestDot = FLT_MAX;
-				for(size_t l = 0; l < pointLists.size(); ++l)
+				for(size_t l = 0; l < scratch.pointListCount; ++l)
 				{
-					if(mergedLists.find(l) != mergedLists.end()) continue;
+					if(mergedLists[l]) continue;
 
 					for(size_t v = 0; v < pointLists[l].size(); ++v)
 					{
@@ -998,33 +1541,72 @@ namespace Universe
 
 				pointLists[mergedListIndex][closestMergedVertex + pointLists[closestList].size() + 2] = pointLists[mergedListIndex][closestMergedVertex];
 
-				mergedLists.insert(closestList);
+				mergedLists[closestList] = 1;
+				++mergedCount;
 			}
 
 			// Build island mesh data out of completed adjacency list.
 			Triangulate(pointLists[mergedListIndex], normal, tangent, bitangent, id);
 		};
 
+		// Queues a face of the block at index, keyed by its id and the shading of its corners.
+		auto AddQuad = [&](u32 list, u32 index, SIDE side){
+			u32 i, j, k;
+			internalGetCoordsFromIndex(index, i, j, k);
+
+			const u16 shade = GetFaceShade(i, j, k, side, lodLevelOffset, adjList, adjLightList);
+			scratch.shadeList[list][index] = shade;
+			scratch.quadList[list].push_back(static_cast<u64>(m_pBlockList[lodLevelOffset + index].id) << 48 | static_cast<u64>(shade) << 32 | index);
+		};
+
+		// Flood fills the islands of each block id and shading in a slice's quad list, and builds a polygon out of each island.
+		auto ProcessQuadList = [&](u32 list, u32 iStep, u32 kStep, u32 iAxis, u32 kAxis, const QuadSides& flags, const QuadEdges& edges,
+			const Math::Vector3& normal, const Math::Vector3& tangent, const Math::Vector3& bitangent){
+			std::vector<u64>& quadList = scratch.quadList[list];
+			std::sort(quadList.begin(), quadList.end());
+
+			for(size_t begin = 0, end = 0; begin < quadList.size(); begin = end)
+			{
+				const u64 group = quadList[begin] >> 32;
+				for(end = begin; end < quadList.size() && (quadList[end] >> 32) == group; ++end)
+				{
+					scratch.pendingList[quadList[end] & 0xFFFFFFFF] = 1;
+				}
+
+				const BlockId id = static_cast<BlockId>(group >> 16);
+
+				disjointedSet.Clear();
+				for(size_t q = begin; q < end; ++q)
+				{
+					const u32 index = quadList[q] & 0xFFFFFFFF;
+					if(!scratch.pendingList[index]) continue;
+
+					ProcessIsland(scratch, index, iStep, kStep, jMin, jMax, lodLevelOffset, iAxis, kAxis, flags, edges, scratch.shadeList[list]);
+					ProcessAdjList(normal, tangent, bitangent, id);
+				}
+			}
+
+			quadList.clear();
+		};
+
 		// X-Axis.
-		for(u32 i = 0, index = 0; i < m_data.width; ++i)
+		for(u32 i = 0; i < m_data.width; ++i)
 		{
-			blockMap[0].clear();
-			blockMap[1].clear();
-			//u32 index = i * m_data.length * m_data.height;
-
 			for(u32 k = 0; k < m_data.length; ++k)
 			{
-				for(u32 j = 0; j < m_data.height; ++j)
+				u32 index = internalGetIndex(i, jMin, k);
+
+				for(u32 j = jMin; j < jMax; ++j)
 				{
-					if(m_pBlockList[m_lodLevelOffset + index].bFilled)
+					if(m_pBlockList[lodLevelOffset + index].bFilled)
 					{
-						if(m_pBlockList[m_lodLevelOffset + index].sideFlag & SIDE_FLAG_LEFT)
+						if(m_pBlockList[lodLevelOffset + index].sideFlag & SIDE_FLAG_LEFT)
 						{
-							blockMap[0][m_pBlockList[m_lodLevelOffset + index].id].insert(index);
+							AddQuad(0, index, SIDE_LEFT);
 						}
-						if(m_pBlockList[m_lodLevelOffset + index].sideFlag & SIDE_FLAG_RIGHT)
+						if(m_pBlockList[lodLevelOffset + index].sideFlag & SIDE_FLAG_RIGHT)
 						{
-							blockMap[1][m_pBlockList[m_lodLevelOffset + index].id].insert(index);
+							AddQuad(1, index, SIDE_RIGHT);
 						}
 					}
 
@@ -1033,64 +1615,44 @@ namespace Universe
 			}
 
 			// Left.
-			for(auto elem : blockMap[0])
-			{
-				disjointedSet.clear();
-				while(!elem.second.empty())
-				{
-					ProcessIsland(elem.second, elem.second.begin(), m_data.height, 1, m_chunkSize, 2, 1,
-						{ SIDE_FLAG_LEFT, SIDE_FLAG_BACK, SIDE_FLAG_FRONT, SIDE_FLAG_BOTTOM, SIDE_FLAG_TOP },
-						{ 
-							Math::VectorInt3(0, 0, 0), Math::VectorInt3(0, 1, 0),
-							Math::VectorInt3(0, 1, 1), Math::VectorInt3(0, 0, 1),
-							Math::VectorInt3(0, 0, 1), Math::VectorInt3(0, 0, 0),
-							Math::VectorInt3(0, 1, 0), Math::VectorInt3(0, 1, 1)
-						}, disjointedSet);
-
-					ProcessAdjList(Math::VEC3_LEFT, Math::VEC3_BACKWARD, Math::VEC3_UP, elem.first);
-				}
-			}
+			ProcessQuadList(0, m_data.height, 1, 2, 1,
+				{ SIDE_FLAG_LEFT, SIDE_FLAG_BACK, SIDE_FLAG_FRONT, SIDE_FLAG_BOTTOM, SIDE_FLAG_TOP },
+				{ 
+					Math::VectorInt3(0, 0, 0), Math::VectorInt3(0, 1, 0),
+					Math::VectorInt3(0, 1, 1), Math::VectorInt3(0, 0, 1),
+					Math::VectorInt3(0, 0, 1), Math::VectorInt3(0, 0, 0),
+					Math::VectorInt3(0, 1, 0), Math::VectorInt3(0, 1, 1)
+				}, Math::VEC3_LEFT, Math::VEC3_BACKWARD, Math::VEC3_UP);
 
 			// Right.
-			for(auto elem : blockMap[1])
-			{
-				disjointedSet.clear();
-				while(!elem.second.empty())
-				{
-					ProcessIsland(elem.second, elem.second.begin(), m_data.height, 1, m_chunkSize, 2, 1,
-						{ SIDE_FLAG_RIGHT, SIDE_FLAG_BACK, SIDE_FLAG_FRONT, SIDE_FLAG_BOTTOM, SIDE_FLAG_TOP },
-						{ 
-							Math::VectorInt3(1, 1, 0), Math::VectorInt3(1, 0, 0),
-							Math::VectorInt3(1, 0, 1), Math::VectorInt3(1, 1, 1),
-							Math::VectorInt3(1, 0, 0), Math::VectorInt3(1, 0, 1),
-							Math::VectorInt3(1, 1, 1), Math::VectorInt3(1, 1, 0)
-						}, disjointedSet);
-
-					ProcessAdjList(Math::VEC3_RIGHT, Math::VEC3_FORWARD, Math::VEC3_UP, elem.first);
-				}
-			}
+			ProcessQuadList(1, m_data.height, 1, 2, 1,
+				{ SIDE_FLAG_RIGHT, SIDE_FLAG_BACK, SIDE_FLAG_FRONT, SIDE_FLAG_BOTTOM, SIDE_FLAG_TOP },
+				{ 
+					Math::VectorInt3(1, 1, 0), Math::VectorInt3(1, 0, 0),
+					Math::VectorInt3(1, 0, 1), Math::VectorInt3(1, 1, 1),
+					Math::VectorInt3(1, 0, 0), Math::VectorInt3(1, 0, 1),
+					Math::VectorInt3(1, 1, 1), Math::VectorInt3(1, 1, 0)
+				}, Math::VEC3_RIGHT, Math::VEC3_FORWARD, Math::VEC3_UP);
 		}
 
 		// Y-Axis.
-		for(u32 j = 0; j < m_data.height; ++j)
+		for(u32 j = jMin; j < jMax; ++j)
 		{
-			blockMap[0].clear();
-			blockMap[1].clear();
 			u32 index = j;
 
 			for(u32 i = 0; i < m_data.width; ++i)
 			{
 				for(u32 k = 0; k < m_data.length; ++k)
 				{
-					if(m_pBlockList[m_lodLevelOffset + index].bFilled)
+					if(m_pBlockList[lodLevelOffset + index].bFilled)
 					{
-						if(m_pBlockList[m_lodLevelOffset + index].sideFlag & SIDE_FLAG_BOTTOM)
+						if(m_pBlockList[lodLevelOffset + index].sideFlag & SIDE_FLAG_BOTTOM)
 						{
-							blockMap[0][m_pBlockList[m_lodLevelOffset + index].id].insert(index);
+							AddQuad(0, index, SIDE_BOTTOM);
 						}
-						if(m_pBlockList[m_lodLevelOffset + index].sideFlag & SIDE_FLAG_TOP)
+						if(m_pBlockList[lodLevelOffset + index].sideFlag & SIDE_FLAG_TOP)
 						{
-							blockMap[1][m_pBlockList[m_lodLevelOffset + index].id].insert(index);
+							AddQuad(1, index, SIDE_TOP);
 						}
 					}
 
@@ -1099,65 +1661,44 @@ namespace Universe
 			}
 
 			// Bottom.
-			for(auto elem : blockMap[0])
-			{
-				disjointedSet.clear();
-				while(!elem.second.empty())
-				{
-					ProcessIsland(elem.second, elem.second.begin(), m_data.length * m_data.height, m_data.height, m_chunkSize, 0, 2,
-						{ SIDE_FLAG_BOTTOM, SIDE_FLAG_LEFT, SIDE_FLAG_RIGHT, SIDE_FLAG_BACK, SIDE_FLAG_FRONT },
-						{ 
-							Math::VectorInt3(0, 0, 0), Math::VectorInt3(0, 0, 1),
-							Math::VectorInt3(1, 0, 1), Math::VectorInt3(1, 0, 0),
-							Math::VectorInt3(1, 0, 0), Math::VectorInt3(0, 0, 0),
-							Math::VectorInt3(0, 0, 1), Math::VectorInt3(1, 0, 1)
-						}, disjointedSet);
-
-					ProcessAdjList(Math::VEC3_DOWN, Math::VEC3_RIGHT, Math::VEC3_BACKWARD, elem.first);
-				}
-			}
+			ProcessQuadList(0, m_data.length * m_data.height, m_data.height, 0, 2,
+				{ SIDE_FLAG_BOTTOM, SIDE_FLAG_LEFT, SIDE_FLAG_RIGHT, SIDE_FLAG_BACK, SIDE_FLAG_FRONT },
+				{ 
+					Math::VectorInt3(0, 0, 0), Math::VectorInt3(0, 0, 1),
+					Math::VectorInt3(1, 0, 1), Math::VectorInt3(1, 0, 0),
+					Math::VectorInt3(1, 0, 0), Math::VectorInt3(0, 0, 0),
+					Math::VectorInt3(0, 0, 1), Math::VectorInt3(1, 0, 1)
+				}, Math::VEC3_DOWN, Math::VEC3_RIGHT, Math::VEC3_BACKWARD);
 
 			// Top.
-			for(auto elem : blockMap[1])
-			{
-				disjointedSet.clear();
-				while(!elem.second.empty())
-				{
-					ProcessIsland(elem.second, elem.second.begin(), m_data.length * m_data.height, m_data.height, m_chunkSize, 0, 2,
-						{ SIDE_FLAG_TOP, SIDE_FLAG_LEFT, SIDE_FLAG_RIGHT, SIDE_FLAG_BACK, SIDE_FLAG_FRONT },
-						{ 
-							Math::VectorInt3(0, 1, 1), Math::VectorInt3(0, 1, 0),
-							Math::VectorInt3(1, 1, 0), Math::VectorInt3(1, 1, 1),
-							Math::VectorInt3(0, 1, 0), Math::VectorInt3(1, 1, 0),
-							Math::VectorInt3(1, 1, 1), Math::VectorInt3(0, 1, 1)
-						}, disjointedSet);
-
-					ProcessAdjList(Math::VEC3_UP, Math::VEC3_RIGHT, Math::VEC3_FORWARD, elem.first);
-				}
-			}
+			ProcessQuadList(1, m_data.length * m_data.height, m_data.height, 0, 2,
+				{ SIDE_FLAG_TOP, SIDE_FLAG_LEFT, SIDE_FLAG_RIGHT, SIDE_FLAG_BACK, SIDE_FLAG_FRONT },
+				{ 
+					Math::VectorInt3(0, 1, 1), Math::VectorInt3(0, 1, 0),
+					Math::VectorInt3(1, 1, 0), Math::VectorInt3(1, 1, 1),
+					Math::VectorInt3(0, 1, 0), Math::VectorInt3(1, 1, 0),
+					Math::VectorInt3(1, 1, 1), Math::VectorInt3(0, 1, 1)
+				}, Math::VEC3_UP, Math::VEC3_RIGHT, Math::VEC3_FORWARD);
 		}
 
 		// Z-Axis.
 		for(u32 k = 0; k < m_data.length; ++k)
 		{
-			blockMap[0].clear();
-			blockMap[1].clear();
-
 			for(u32 i = 0; i < m_data.width; ++i)
 			{
-				u32 index = i * m_data.length * m_data.height + k * m_data.height;
+				u32 index = internalGetIndex(i, jMin, k);
 
-				for(u32 j = 0; j < m_data.height; ++j)
+				for(u32 j = jMin; j < jMax; ++j)
 				{
-					if(m_pBlockList[m_lodLevelOffset + index].bFilled)
+					if(m_pBlockList[lodLevelOffset + index].bFilled)
 					{
-						if(m_pBlockList[m_lodLevelOffset + index].sideFlag & SIDE_FLAG_BACK)
+						if(m_pBlockList[lodLevelOffset + index].sideFlag & SIDE_FLAG_BACK)
 						{
-							blockMap[0][m_pBlockList[m_lodLevelOffset + index].id].insert(index);
+							AddQuad(0, index, SIDE_BACK);
 						}
-						if(m_pBlockList[m_lodLevelOffset + index].sideFlag & SIDE_FLAG_FRONT)
+						if(m_pBlockList[lodLevelOffset + index].sideFlag & SIDE_FLAG_FRONT)
 						{
-							blockMap[1][m_pBlockList[m_lodLevelOffset + index].id].insert(index);
+							AddQuad(1, index, SIDE_FRONT);
 						}
 					}
 
@@ -1166,82 +1707,182 @@ namespace Universe
 			}
 
 			// Back.
-			for(auto elem : blockMap[0])
+			ProcessQuadList(0, m_data.length * m_data.height, 1, 0, 1,
+				{ SIDE_FLAG_BACK, SIDE_FLAG_LEFT, SIDE_FLAG_RIGHT, SIDE_FLAG_BOTTOM, SIDE_FLAG_TOP },
+				{ 
+					Math::VectorInt3(0, 1, 0), Math::VectorInt3(0, 0, 0),
+					Math::VectorInt3(1, 0, 0), Math::VectorInt3(1, 1, 0),
+					Math::VectorInt3(0, 0, 0), Math::VectorInt3(1, 0, 0),
+					Math::VectorInt3(1, 1, 0), Math::VectorInt3(0, 1, 0)
+				}, Math::VEC3_BACKWARD, Math::VEC3_RIGHT, Math::VEC3_UP);
+
+			// Front.
+			ProcessQuadList(1, m_data.length * m_data.height, 1, 0, 1,
+				{ SIDE_FLAG_FRONT, SIDE_FLAG_LEFT, SIDE_FLAG_RIGHT, SIDE_FLAG_BOTTOM, SIDE_FLAG_TOP },
+				{ 
+					Math::VectorInt3(0, 0, 1), Math::VectorInt3(0, 1, 1),
+					Math::VectorInt3(1, 1, 1), Math::VectorInt3(1, 0, 1),
+					Math::VectorInt3(1, 0, 1), Math::VectorInt3(0, 0, 1),
+					Math::VectorInt3(0, 1, 1), Math::VectorInt3(1, 1, 1)
+				}, Math::VEC3_FORWARD, Math::VEC3_LEFT, Math::VEC3_UP);
+		}
+
+	}
+
+	// Ambient occlusion and light of a vertex on a face pointing towards side, from the four blocks touching the vertex in front of the face.
+	//  Occlusion counts the opaque ones, and light is the brightest of the rest. Blocks across a seam are read from the neighbour's published
+	//  slices, and those in diagonal neighbours are skipped.
+	u16 CChunk::GetVertexShade(u32 x, u32 y, u32 z, u8 side, u32 lodLevelOffset, const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6],
+		const CChunkLight::AdjList& adjLightList) const
+	{
+		const CBlockRegistry& registry = CBlockRegistry::Instance();
+
+		const u32 axis = side >> 1;
+		const u32 uAxis = (axis + 1) % 3;
+		const u32 vAxis = (axis + 2) % 3;
+		const s32 sizeList[3] = { static_cast<s32>(m_data.width), static_cast<s32>(m_data.height), static_cast<s32>(m_data.length) };
+		const s32 vertex[3] = { static_cast<s32>(x), static_cast<s32>(y), static_cast<s32>(z) };
+
+		u32 opaqueCount = 0;
+		u8 sky = 0;
+		u8 block = 0;
+
+		for(s32 du = -1; du <= 0; ++du)
+		{
+			for(s32 dv = -1; dv <= 0; ++dv)
 			{
-				disjointedSet.clear();
-				while(!elem.second.empty())
+				s32 c[3];
+				c[axis] = (side & 0x1) ? vertex[axis] : vertex[axis] - 1;
+				c[uAxis] = vertex[uAxis] + du;
+				c[vAxis] = vertex[vAxis] + dv;
+
+				u32 outsideCount = 0;
+				u32 outsideAxis = 0;
+				for(u32 a = 0; a < 3; ++a)
 				{
-					ProcessIsland(elem.second, elem.second.begin(), m_data.length * m_data.height, 1, m_chunkSize, 0, 1,
-						{ SIDE_FLAG_BACK, SIDE_FLAG_LEFT, SIDE_FLAG_RIGHT, SIDE_FLAG_BOTTOM, SIDE_FLAG_TOP },
-						{ 
-							Math::VectorInt3(0, 1, 0), Math::VectorInt3(0, 0, 0),
-							Math::VectorInt3(1, 0, 0), Math::VectorInt3(1, 1, 0),
-							Math::VectorInt3(0, 0, 0), Math::VectorInt3(1, 0, 0),
-							Math::VectorInt3(1, 1, 0), Math::VectorInt3(0, 1, 0)
-						}, disjointedSet);
-
-					ProcessAdjList(Math::VEC3_BACKWARD, Math::VEC3_RIGHT, Math::VEC3_UP, elem.first);
+					if(c[a] < 0 || c[a] >= sizeList[a])
+					{
+						outsideAxis = a;
+						++outsideCount;
+					}
 				}
-			}
 
-			// Front.
-			for(auto elem : blockMap[1])
-			{
-				disjointedSet.clear();
-				while(!elem.second.empty())
+				bool bOpaque;
+				u8 light;
+
+				if(outsideCount == 0)
 				{
-					ProcessIsland(elem.second, elem.second.begin(), m_data.length * m_data.height, 1, m_chunkSize, 0, 1,
-						{ SIDE_FLAG_FRONT, SIDE_FLAG_LEFT, SIDE_FLAG_RIGHT, SIDE_FLAG_BOTTOM, SIDE_FLAG_TOP },
-						{ 
-							Math::VectorInt3(0, 0, 1), Math::VectorInt3(0, 1, 1),
-							Math::VectorInt3(1, 1, 1), Math::VectorInt3(1, 0, 1),
-							Math::VectorInt3(1, 0, 1), Math::VectorInt3(0, 0, 1),
-							Math::VectorInt3(0, 1, 1), Math::VectorInt3(1, 1, 1)
-						}, disjointedSet);
-
-					ProcessAdjList(Math::VEC3_FORWARD, Math::VEC3_LEFT, Math::VEC3_UP, elem.first);
+					const u32 index = internalGetIndex(c[0], c[1], c[2]);
+					const Block blockAt = m_pBlockList[lodLevelOffset + index];
+					bOpaque = blockAt.bFilled && registry.IsOpaque(blockAt.id);
+					light = m_light.Get(index);
 				}
-			}
-		}
+				else if(outsideCount == 1)
+				{
+					const SIDE adjSide = static_cast<SIDE>(outsideAxis * 2 + (c[outsideAxis] < 0 ? 0 : 1));
+					const SIDE facing = static_cast<SIDE>(adjSide ^ 1);
 
-		data.vertexCount = static_cast<u32>(vertexList.size());
-		data.indexCount = static_cast<u32>(indexList.size());
+					// Slice coordinates are the two free block coordinates, in (i, j, k) order.
+					const u32 u = static_cast<u32>(outsideAxis == 0 ? c[1] : c[0]);
+					const u32 v = static_cast<u32>(outsideAxis == 2 ? c[1] : c[2]);
 
-		m_meshData[meshIndex].SetData(data);
-		m_meshData[meshIndex].Initialize();
+					bOpaque = adjList[adjSide] && adjList[adjSide]->IsFilled(facing, u, v) && registry.IsOpaque(adjList[adjSide]->GetId(facing, u, v));
+					light = adjLightList[adjSide] ? adjLightList[adjSide]->Get(facing, u, v) : (adjSide == SIDE_TOP ? CChunkLight::LIGHT_MAX << 4 : 0);
+				}
+				else
+				{
+					continue;
+				}
 
-		m_meshData[meshIndex].ProcessVertexList([&vertexList](u32 index, u8* pData){
-			*(Vertex*)pData = vertexList[index];
-		});
+				if(bOpaque)
+				{
+					++opaqueCount;
+				}
+				else
+				{
+					sky = std::max(sky, CChunkLight::GetSky(light));
+					block = std::max(block, CChunkLight::GetBlock(light));
+				}
+			}
+		}
 
-		m_meshData[meshIndex].ProcessIndexList([&indexList](u32 index, u8* pData){
-			*(Index*)pData = indexList[index];
-		});
+		return PackedChunkVertex::PackShade(static_cast<u8>(3 - std::min(opaqueCount, 3u)), sky, block);
 	}
 
-	void CChunk::RebuildMesh()
+	// Shading shared by all four corners of a block's face, or SHADE_MIXED if they differ.
+	u16 CChunk::GetFaceShade(u32 i, u32 j, u32 k, u8 side, u32 lodLevelOffset, const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6],
+		const CChunkLight::AdjList& adjLightList) const
 	{
-		if(m_blockUpdateMap.size())
+		const u32 axis = side >> 1;
+		const u32 uAxis = (axis + 1) % 3;
+		const u32 vAxis = (axis + 2) % 3;
+
+		u32 corner[3] = { i, j, k };
+		corner[axis] += side & 0x1;
+
+		u16 shade = 0;
+		for(u32 n = 0; n < 4; ++n)
 		{
-			return;
+			u32 c[3] = { corner[0], corner[1], corner[2] };
+			c[uAxis] += n & 0x1;
+			c[vAxis] += n >> 1;
+
+			const u16 cornerShade = GetVertexShade(c[0], c[1], c[2], side, lodLevelOffset, adjList, adjLightList);
+			if(n == 0) shade = cornerShade;
+			else if(cornerShade != shade) return SHADE_MIXED;
 		}
 
-		if(m_bDirty)
+		return shade;
+	}
+
+	// Only marks the sections as requested. Repeated requests before the scheduler gets to the chunk share a single build, and a request
+	//  for a section already building makes that build stale.
+	void CChunk::RebuildMesh(u8 sectionMask)
+	{
+		for(u32 s = 0; s < m_pSectionList.size(); ++s)
 		{
-			m_bAwaitingRebuild = true;
-			return;
-		}
-		
-		m_bDirty = true;
-		u8 meshIndex = m_meshIndex = (m_meshIndex + 1) & 0x1;
+			if(!(sectionMask & (1 << s))) continue;
 
-		m_meshFuture[meshIndex] = Util::CJobSystem::Instance().JobGraphics([meshIndex, this](){
-			BuildMesh(meshIndex, true);
-		}, true);
+			Section* pSection = m_pSectionList[s];
+			pSection->bAwaitingRebuild = true;
+			if(pSection->bDirty)
+			{
+				pSection->bCancel = true;
+			}
+		}
 
 		// Push chunk to update queue until finished generating.
 		PushToUpdateQueue();
 	}
+
+	// Starts the requested builds. Nothing is started while edits are pending, since applying them would request the same sections again.
+	void CChunk::DispatchBuilds(CChunkRebuildScheduler::Budget& budget)
+	{
+		if(!m_blockUpdateMap.empty()) return;
+
+		// Camera position in vertex coordinates, for ordering translucent triangles.
+		const Math::Vector3 cameraPosition = *(Math::Vector3*)App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetTransform()->GetPosition().ToFloat();
+		const Math::Vector3 sortOrigin = (cameraPosition - GetOffset()) / m_data.blockSize;
+
+		for(Section* pSection : m_pSectionList)
+		{
+			if(!budget.CanBuild()) break;
+			if(!pSection->bAwaitingRebuild || pSection->bDirty) continue;
+
+			pSection->sortOrigin = sortOrigin;
+			pSection->bAwaitingRebuild = false;
+			pSection->bCancel = false;
+			pSection->bDirty = true;
+			const u8 meshIndex = pSection->meshIndex = (pSection->meshIndex + 1) & 0x1;
+
+			pSection->meshFuture[meshIndex] = Util::CJobSystem::Instance().JobGraphics([pSection, meshIndex, this](){
+				BuildMesh(pSection, meshIndex, true);
+			}, true);
+
+			--budget.buildCount;
+			++budget.dispatchCount;
+		}
+	}
 	
 	//-----------------------------------------------------------------------------------------------
 	// Utility methods.
@@ -1326,8 +1967,11 @@ namespace Universe
 			std::lock_guard<std::shared_mutex> lk(m_mutex);
 			if(m_pBlockList == nullptr) AllocateBlockList();
 			memcpy(m_pBlockList, pBlocks, sizeof(Block) * m_chunkSize);
+			m_lod.Build(m_pBlockList);
+			m_border.Publish(m_pBlockList + m_lodLevelOffset);
 		}
 
+		m_bLightDirty = true;
 		RebuildMesh();
 	}
 	
@@ -1337,8 +1981,11 @@ namespace Universe
 			std::lock_guard<std::shared_mutex> lk(m_mutex);
 			if(m_pBlockList == nullptr) AllocateBlockList();
 			func(m_pBlockList, m_chunkSize);
+			m_lod.Build(m_pBlockList);
+			m_border.Publish(m_pBlockList + m_lodLevelOffset);
 		}
 
+		m_bLightDirty = true;
 		RebuildMesh();
 	}
 
@@ -1366,8 +2013,12 @@ namespace Universe
 					}
 				}
 			}
+
+			m_lod.Build(m_pBlockList);
+			m_border.Publish(m_pBlockList + m_lodLevelOffset);
 		}
 
+		m_bLightDirty = true;
 		RebuildMesh();
 	}
 
@@ -1386,8 +2037,12 @@ namespace Universe
 					}
 				}
 			}
+
+			m_lod.Build(m_pBlockList);
+			m_border.Publish(m_pBlockList + m_lodLevelOffset);
 		}
 
+		m_bLightDirty = true;
 		RebuildMesh();
 	}
 
@@ -1405,208 +2060,209 @@ namespace Universe
 	void CChunk::SetLODLevel(u8 lodLevel)
 	{
 		if(m_lodLevel == lodLevel || m_lodLevelMax < lodLevel) return;
+
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_CHUNK);
+		PROFILE_ZONE("CChunk::SetLODLevel");
+
+		// Every level is kept current by m_lod as blocks change, so switching levels only moves the block list offset.
+		std::lock_guard<std::shared_mutex> lk(m_mutex);
 		m_lodLevel = lodLevel;
 		m_lodLevelOffset = m_lodLevel * m_chunkSize;
+		m_border.Publish(m_pBlockList ? m_pBlockList + m_lodLevelOffset : nullptr);
 
-		if(m_lodLevel > 0)
+		// Builds in flight counted faces at the old level. They're abandoned rather than stored, and the rebuild that follows the change
+		//  replaces them.
+		for(Section* pSection : m_pSectionList)
 		{
-			const u32 lodLevelOffsetLast = (m_lodLevel - 1) * m_chunkSize;
-			const u32 stepSize = 1 << m_lodLevel;
-
-			const double targetCoverage = 0.3333;//Math::g_1Over3;
-			const double targetPlanarCoverage = 0.0;//Math::g_1Over3;
-			const double targetExtentCoveragePlanar = 0.125;//Math::g_1Over3;
-			const double targetExtentCoverageLinear = 0.275;//Math::g_1Over3;
-			const double blockStength = 1.0 / pow(stepSize, 3U);
-			const double blockStength2D = 1.0 / pow(stepSize, 2U);
-			const double blockStength1D = 1.0 / pow(stepSize, 1U);
-		
-			double coverage;
-			std::unordered_map<BlockId, u32> blockMap;
-			std::pair<BlockId, u32> maxBlock;
+			if(pSection->bDirty)
+			{
+				pSection->bCancel = true;
+			}
+		}
+	}
 
-			struct VectorUInt2 { union { struct { u32 x, y; }; u32 v[2]; }; u32 operator [] (size_t index) const { return v[index]; } };
-			struct VectorUInt3 { union { struct { u32 x, y, z; }; u32 v[3]; }; u32 operator [] (size_t index) const { return v[index]; } };
-			VectorUInt3 mnExtents;
-			VectorUInt3 mxExtents;
+	// Totals the statistics of every section. ACMR is weighted by each section's triangle count.
+	CChunkMeshOptimizer::Stats CChunk::GetMeshStats() const
+	{
+		std::shared_lock<std::shared_mutex> lk(m_mutex);
 
-			std::lock_guard<std::shared_mutex> lk(m_mutex);
+		CChunkMeshOptimizer::Stats stats { };
+		for(const Section* pSection : m_pSectionList)
+		{
+			CChunkMeshOptimizer::Accumulate(stats, pSection->stats);
+		}
+
+		return stats;
+	}
 
-			memset(m_pBlockList + m_lodLevelOffset, 0, sizeof(Block) * m_chunkSize);
+	// Meshes every section with both surfaces on the calling thread, without uploading anything. Faces are taken from the flags the last build
+	//  left on each block, so results are only meaningful once the chunk has built.
+	// The optimizer's statistics come from one extra pass after the timed ones, so measuring ACMR doesn't count against the times.
+	CChunk::SurfaceBenchmark CChunk::BenchmarkSurfaces(u32 iterationCount)
+	{
+		SurfaceBenchmark benchmark { };
+		if(m_pBlockList == nullptr || iterationCount == 0) return benchmark;
 
-			for(u32 i = 0; i < m_data.width; i += stepSize)
+		std::shared_ptr<const CChunkBorder::Slices> adjList[6];
+		AcquireAdjacentBorders(adjList);
+
+		CChunkLight::AdjList adjLightList;
+		AcquireAdjacentLight(adjLightList);
+
+		CChunkMeshScratch& scratch = CChunkMeshScratch::Local();
+		const u8 optimizeFlags = m_data.meshOptimizeFlags & ~MESH_OPTIMIZE_STATS;
+		const u32 lodLevelOffset = m_lodLevelOffset;
+
+		// Returns the section's triangle count.
+		auto MeshSection = [&](const Section* pSection, MESH_SURFACE surface, u8 flags, CChunkMeshOptimizer::Stats* pStats){
+			scratch.Prepare(m_chunkSize, (m_data.width + 1) * (m_data.height + 1) * (m_data.length + 1));
+
+			if(surface == MESH_SURFACE_SMOOTH)
+			{
+				PlaceSurface(scratch, pSection->blockMin, pSection->blockMax, lodLevelOffset, adjList);
+				GenerateQuadMeshData(scratch, pSection->blockMin, pSection->blockMax, lodLevelOffset, adjList, adjLightList, true);
+			}
+			else
 			{
-				for(u32 k = 0; k < m_data.length; k += stepSize)
+				GenerateOptimalMeshData(scratch, pSection->blockMin, pSection->blockMax, lodLevelOffset, adjList, adjLightList);
+			}
+
+			CChunkMeshOptimizer::Optimize(scratch, flags, pStats);
+			return static_cast<u64>(scratch.indexList.size() / 3);
+		};
+
+		for(const MESH_SURFACE surface : { MESH_SURFACE_BLOCKY, MESH_SURFACE_SMOOTH })
+		{
+			u64 triangleCount = 0;
+			const auto start = std::chrono::steady_clock::now();
+
+			for(u32 iteration = 0; iteration < iterationCount; ++iteration)
+			{
+				for(const Section* pSection : m_pSectionList)
 				{
-					for(u32 j = 0; j < m_data.height; j += stepSize)
-					{
-						coverage = 0.0;
-						blockMap.clear();
-						maxBlock = { 0, 0 };
+					triangleCount += MeshSection(pSection, surface, optimizeFlags, nullptr);
+				}
+			}
 
-						mnExtents = { UINT_MAX, UINT_MAX, UINT_MAX };
-						mxExtents = { 0, 0, 0 };
+			const float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / static_cast<float>(iterationCount);
+			const u32 averageTriangleCount = static_cast<u32>(triangleCount / iterationCount);
 
-						auto PlanarCoverage = [&](u32 u, u32 v, u32 w, u32 wOffset){
-							u32 steps[3];
-							const u32 x = wOffset;
-							double planarCoverage = 0.0;
+			CChunkMeshOptimizer::Stats& totalStats = surface == MESH_SURFACE_SMOOTH ? benchmark.smoothStats : benchmark.blockyStats;
+			for(const Section* pSection : m_pSectionList)
+			{
+				CChunkMeshOptimizer::Stats stats { };
+				MeshSection(pSection, surface, optimizeFlags | MESH_OPTIMIZE_STATS, &stats);
+				CChunkMeshOptimizer::Accumulate(totalStats, stats);
+			}
 
-							for(u32 z = 0; z < stepSize; ++z)
-							{
-								for(u32 y = 0; y < stepSize; ++y)
-								{
-									steps[u] = y; steps[v] = z; steps[w] = x;
-
-									Block block = m_pBlockList[lodLevelOffsetLast + internalGetIndex(i + steps[0], j + steps[1], k + steps[2])];
-									if(block.bFilled)
-									{
-										planarCoverage += blockStength2D;
-									}
-								}
-							}
+			if(surface == MESH_SURFACE_SMOOTH)
+			{
+				benchmark.smoothTime = time;
+				benchmark.smoothTriangleCount = averageTriangleCount;
+			}
+			else
+			{
+				benchmark.blockyTime = time;
+				benchmark.blockyTriangleCount = averageTriangleCount;
+			}
+		}
 
-							return planarCoverage >= targetExtentCoveragePlanar;
-						};
+		return benchmark;
+	}
 
-						auto LinearCoverage = [&](u32 u, u32 v, u32 w, u32 vOffset, u32 wOffset){
-							u32 steps[3];
-							const u32 x = wOffset;
-							const u32 z = vOffset;
-							double linearCoverage = 0.0;
+	// Relights a copy of the chunk in full, then erases the top block of 'editCount' scattered columns one at a time, restoring each before the
+	//  next so every update starts from the same light. The chunk's own light is left untouched, and columns without a filled block are skipped.
+	CChunk::LightBenchmark CChunk::BenchmarkLight(u32 editCount)
+	{
+		LightBenchmark benchmark { };
 
-							for(u32 y = 0; y < stepSize; ++y)
-							{
-								steps[u] = y; steps[v] = z; steps[w] = x;
+		std::vector<Block> blockList;
+		{
+			std::shared_lock<std::shared_mutex> lk(m_mutex);
+			if(m_pBlockList == nullptr) return benchmark;
+			blockList.assign(m_pBlockList, m_pBlockList + m_chunkSize);
+		}
 
-								Block block = m_pBlockList[lodLevelOffsetLast + internalGetIndex(i + steps[0], j + steps[1], k + steps[2])];
-								if(block.bFilled)
-								{
-									linearCoverage += blockStength1D;
-								}
-							}
+		CChunkLight::AdjList adjLightList;
+		AcquireAdjacentLight(adjLightList);
 
-							return linearCoverage >= targetExtentCoverageLinear;
-						};
+		CChunkLight light;
+		{
+			CChunkLight::Data data { };
+			data.width = m_data.width;
+			data.height = m_data.height;
+			data.length = m_data.length;
+			light.SetData(data);
+			light.Initialize();
+		}
 
-						// Check for LOD block for coverage.
-						for(u32 x = 0; x < stepSize; ++x)
-						{
-							for(u32 z = 0; z < stepSize; ++z)
-							{
-								for(u32 y = 0; y < stepSize; ++y)
-								{
-									Block block = m_pBlockList[lodLevelOffsetLast + internalGetIndex(i + x, j + y, k + z)];
-									if(block.bFilled)
-									{
-										if(x < mnExtents.x && PlanarCoverage(1, 2, 0, x)) mnExtents.x = x;
-										if(x >= mxExtents.x && PlanarCoverage(1, 2, 0, x)) mxExtents.x = x + 1;
-										if(y < mnExtents.y && PlanarCoverage(2, 0, 1, y)) mnExtents.y = y;
-										if(y >= mxExtents.y && PlanarCoverage(2, 0, 1, y)) mxExtents.y = y + 1;
-										if(z < mnExtents.z && PlanarCoverage(1, 0, 2, z)) mnExtents.z = z;
-										if(z >= mxExtents.z && PlanarCoverage(1, 0, 2, z)) mxExtents.z = z + 1;
-
-										coverage += blockStength;
-
-										while(block.sideFlag)
-										{
-											if((block.sideFlag & 0x1) && maxBlock.second < ++blockMap[block.id])
-											{
-												maxBlock.first = block.id;
-											}
-
-											block.sideFlag >>= 1;
-										}
-									}
-								}
-							}
-						}
+		light.Compute(blockList.data(), adjLightList);
+		benchmark.computeTime = light.GetStats().computeTime;
+		benchmark.computeVisitCount = light.GetStats().visitCount;
 
-						if(coverage >= targetCoverage)
-						{ 
-							for(u32 x = mnExtents.x; x < mxExtents.x; ++x)
-							{
-								for(u32 z = mnExtents.z; z < mxExtents.z; ++z)
-								{
-									for(u32 y = mnExtents.y; y < mxExtents.y; ++y)
-									{
-										m_pBlockList[m_lodLevelOffset + internalGetIndex(i + x, j + y, k + z)] = Block(maxBlock.first, true);
-									}
-								}
-							}
-						}
-						else
-						{ // If LOD block < target coverage, check for LOD planes for coverage.
-							VectorUInt2 mnPlanar;
-							VectorUInt2 mxPlanar;
-
-							auto PlanarLOD = [&](u32 u, u32 v, u32 w){
-								u32 steps[3];
-
-								for(u32 x = 0; x < stepSize; ++x)
-								{
-									coverage = 0.0;
-									blockMap.clear();
-									maxBlock = { 0, 0 };
-									mnPlanar = { UINT_MAX, UINT_MAX };
-									mxPlanar = { 0, 0 };
-
-									for(u32 z = 0; z < stepSize; ++z)
-									{
-										for(u32 y = 0; y < stepSize; ++y)
-										{
-											steps[u] = y; steps[v] = z; steps[w] = x;
-
-											Block block = m_pBlockList[lodLevelOffsetLast + internalGetIndex(i + steps[0], j + steps[1], k + steps[2])];
-											if(block.bFilled)
-											{
-												if(y < mnPlanar.x && LinearCoverage(v, u, w, y, x)) mnPlanar.x = y;
-												if(y >= mxPlanar.x && LinearCoverage(v, u, w, y, x)) mxPlanar.x = y + 1;
-												if(z < mnPlanar.y && LinearCoverage(u, v, w, z, x)) mnPlanar.y = z;
-												if(z >= mxPlanar.y && LinearCoverage(u, v, w, z, x)) mxPlanar.y = z + 1;
-
-												coverage += blockStength2D;
-
-												while(block.sideFlag)
-												{
-													if((block.sideFlag & 0x1) && maxBlock.second < ++blockMap[block.id])
-													{
-														maxBlock.first = block.id;
-													}
-
-													block.sideFlag >>= 1;
-												}
-											}
-										}
-									}
-
-									if(coverage >= targetPlanarCoverage)
-									{
-										for(u32 z = mnPlanar.y; z < mxPlanar.y; ++z)
-										{
-											for(u32 y = mnPlanar.x; y < mxPlanar.x; ++y)
-											{
-												steps[u] = y; steps[v] = z; steps[w] = x;
-
-												m_pBlockList[m_lodLevelOffset + internalGetIndex(i + steps[0], j + steps[1], k + steps[2])] = Block(maxBlock.first, true);
-											}
-										}
-									}
-								}
-							};
+		const u32 columnCount = m_data.width * m_data.length;
+		for(u32 n = 0; n < editCount; ++n)
+		{
+			const u32 column = (n * 2654435761U) % columnCount;
+			const u32 i = column / m_data.length;
+			const u32 k = column % m_data.length;
 
-							// X-Axis.
-							PlanarLOD(1, 2, 0);
-							
-							// Y-Axis.
-							PlanarLOD(2, 0, 1);
+			u32 j = m_data.height;
+			while(j > 0 && !blockList[internalGetIndex(i, j - 1, k)].bFilled) --j;
+			if(j == 0) continue;
 
-							// Z-Axis.
-							PlanarLOD(1, 0, 2);
-						}
-					}
-				}
+			const u32 index = internalGetIndex(i, j - 1, k);
+			const Block block = blockList[index];
+
+			for(const Block& edit : { Block(), block })
+			{
+				blockList[index] = edit;
+				light.Update(blockList.data(), adjLightList, &index, 1);
+
+				benchmark.updateTime += light.GetStats().updateTime;
+				benchmark.updateVisitCount += light.GetStats().visitCount;
+				++benchmark.updateCount;
 			}
 		}
+
+		light.Release();
+		return benchmark;
+	}
+
+	// Snapshots the light slices of every neighbour. Missing neighbours, or those yet to publish, are left empty.
+	void CChunk::AcquireAdjacentLight(CChunkLight::AdjList& adjList) const
+	{
+		for(u32 side = 0; side < 6; ++side)
+		{
+			adjList[side] = m_pChunkAdj[side] ? m_pChunkAdj[side]->m_light.Acquire() : nullptr;
+		}
+	}
+
+	// Neighbours facing a changed light slice are handed the border cells that changed, which they relight around on their next update, and
+	//  rebuild the rows that changed here as they shade the vertices along the seam with it. Vertical neighbours only have their facing section
+	//  affected.
+	void CChunk::RelightAdjacent(u8 sideMask, u32 jMin, u32 jMax)
+	{
+		for(u32 side = 0; side < 6; ++side)
+		{
+			CChunk* pAdj = m_pChunkAdj[side];
+			if(pAdj == nullptr || (sideMask & (1 << side)) == 0) continue;
+
+			if(side == SIDE_BOTTOM) pAdj->RebuildMesh(1 << (pAdj->GetSectionCount() - 1));
+			else if(side == SIDE_TOP) pAdj->RebuildMesh(1);
+			else pAdj->RebuildMesh(jMin <= jMax ? pAdj->internalGetSectionMask(jMin, jMax) : 0xFF); // First publish, with nothing lit.
+
+			pAdj->m_light.QueueSeam(static_cast<SIDE>(side ^ 1), m_light.GetSeamList(static_cast<SIDE>(side)));
+			pAdj->PushToUpdateQueue();
+		}
+	}
+
+	// Snapshots the border slices of every neighbour. Missing neighbours, or those yet to publish, are left empty.
+	void CChunk::AcquireAdjacentBorders(std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6]) const
+	{
+		for(u32 side = 0; side < 6; ++side)
+		{
+			adjList[side] = m_pChunkAdj[side] ? m_pChunkAdj[side]->m_border.Acquire() : nullptr;
+		}
 	}
 };
@@ -12,6 +12,15 @@
 #define CCHUNK_H
 
 #include "CChunkData.h"
+#include "CChunkLOD.h"
+#include "CChunkBorder.h"
+#include "CChunkLight.h"
+#include "CChunkMeshCache.h"
+#include "CChunkVertex.h"
+#include "CChunkMeshOptimizer.h"
+#include "CChunkSurfaceNets.h"
+#include "CChunkMeshlets.h"
+#include "CChunkRebuildScheduler.h"
 #include "../Physics/CVolumeChunk.h"
 #include "../Graphics/CMeshData_.h"
 #include "../Graphics/CMeshContainer_.h"
@@ -23,6 +32,7 @@
 #include <shared_mutex>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 
 #if _DEBUG
 #include <cassert>
@@ -39,15 +49,46 @@ namespace Universe
 	class CChunk : CVComponent
 	{
 	private:
-		struct Vertex
+		typedef u32 Index;
+
+		// Shading key of a face whose corners are shaded differently. Such faces are never merged.
+		static constexpr u16 SHADE_MIXED = 0xFFFF;
+
+		// A horizontal slab of the chunk's mesh, double buffered so the last mesh keeps drawing while the next one builds.
+		struct Section
 		{
-			Math::Vector3 position;
-			Math::Vector3 normal;
-			Math::Vector3 tangent;
-			Math::Vector4 texCoord;
-		};
+			u32 blockMin; // First block row (j) in the section.
+			u32 blockMax; // One past the last block row.
 
-		typedef u32 Index;
+			bool bDirty; // A build is in flight.
+			bool bAwaitingRebuild; // A build has been requested, but the scheduler hasn't started it yet.
+			Abool bCancel; // The build in flight is stale, and should be abandoned.
+			u8 meshIndex;
+			u8 solidFaceMask;
+
+			u32 translucentCountList[2]; // Translucent indices at the end of each mesh.
+			u32 translucentCount; // Translucent indices of the mesh currently drawn.
+			u32 meshBytesList[2]; // Vertex and index bytes held by each mesh's renderer.
+			Math::Vector3 sortOrigin; // Camera position in vertex coordinates, which the build orders translucent triangles from.
+
+			CChunkMeshOptimizer::Stats stats;
+
+			// Clusters of each mesh's opaque range, and the ranges of the drawn mesh that passed the last cull.
+			std::vector<CChunkMeshlets::Meshlet> meshletList[2];
+			const std::vector<CChunkMeshlets::Meshlet>* pMeshletList;
+			std::vector<Graphics::CMeshRenderer_::IndexRange> rangeList;
+
+			Graphics::CMeshData_ meshData[2];
+			Graphics::CMeshRenderer_* pMeshRendererList[2];
+			Graphics::CMeshRenderer_* pMeshRenderer; // Renderer currently drawn.
+			Util::CFuture<void> meshFuture[2];
+
+			Section(const CVObject* pObject) :
+				blockMin(0), blockMax(0), bDirty(false), bAwaitingRebuild(false), bCancel(false), meshIndex(0), solidFaceMask(SIDE_FLAG_ALL), translucentCountList{ 0, 0 }, translucentCount(0), meshBytesList{ 0, 0 }, stats{ },
+				pMeshletList(nullptr), meshData{ pObject, pObject }, pMeshRendererList{ nullptr, nullptr }, pMeshRenderer(nullptr) { }
+
+			inline bool Ready() { return meshFuture[0].Ready() && meshFuture[1].Ready(); }
+		};
 
 	public:
 		struct Data
@@ -57,10 +98,33 @@ namespace Universe
 			u32 height;
 			u32 length;
 			float blockSize;
+			u8 meshOptimizeFlags;
+			u8 meshSurface;
+			u8 lodLevelMax; // Levels requested. The chunk keeps fewer if its size doesn't divide that far, and never more than CHUNK_LOD_LEVEL_LIMIT.
 			u64 matHash;
+			u64 matTranslucentHash;
 			u64 matWireHash;
 		};
 
+		struct SurfaceBenchmark
+		{
+			float blockyTime; // Milliseconds to mesh and optimize every section, averaged over the iterations run.
+			float smoothTime;
+			u32 blockyTriangleCount;
+			u32 smoothTriangleCount;
+			CChunkMeshOptimizer::Stats blockyStats; // Vertex counts and ACMR before and after optimizing, over every section.
+			CChunkMeshOptimizer::Stats smoothStats;
+		};
+
+		struct LightBenchmark
+		{
+			float computeTime; // Milliseconds for a full relight.
+			float updateTime; // Milliseconds for every single block update together.
+			u32 computeVisitCount;
+			u32 updateVisitCount;
+			u32 updateCount;
+		};
+
 	public:
 		CChunk(const CVObject* pObject);
 		~CChunk();
@@ -70,10 +134,13 @@ namespace Universe
 		CChunk& operator = (CChunk&&) = delete;
 
 		void Setup();
-		void RebuildMesh();
+		void RebuildMesh(u8 sectionMask = 0xFF);
 		void Initialize() final;
-		void LateUpdate() final;
+		void ProcessUpdates(CChunkRebuildScheduler::Budget& budget);
 		void ForceRender(size_t materialIndex);
+		void RenderSection(u32 section, size_t materialIndex);
+		void CullMeshlets(const CChunkMeshlets::CameraSample& camera, CChunkMeshlets::Stats& stats);
+		void RenderMeshlets();
 		void Release() final;
 		
 		u16 UpdateBlock(u32 index, u16 id);
@@ -91,6 +158,26 @@ namespace Universe
 		// Accessors.
 		inline u8 GetLODLevel() const { return m_lodLevel; }
 		inline u8 GetLODLevelMax() const { return m_lodLevelMax; }
+		inline u8 GetSolidFaceMask() const { return m_solidFaceMask; } // SIDE_FLAG mask of faces whose border slice is completely filled.
+
+		CChunkMeshOptimizer::Stats GetMeshStats() const;
+		SurfaceBenchmark BenchmarkSurfaces(u32 iterationCount);
+		LightBenchmark BenchmarkLight(u32 editCount);
+		inline const CChunkLight::Stats& GetLightStats() const { return m_light.GetStats(); }
+
+		inline u32 GetSectionCount() const { return static_cast<u32>(m_pSectionList.size()); }
+		inline u32 GetSectionIndex(u32 j) const { return j / m_sectionHeight; }
+		inline bool HasTranslucentSection(u32 section) const { return m_pSectionList[section]->pMeshRenderer && m_pSectionList[section]->translucentCount; }
+
+		inline Math::Vector3 GetSectionCenter(u32 section) const
+		{
+			const Math::Vector3 mn = GetOffset();
+			const float blockMin = static_cast<float>(m_pSectionList[section]->blockMin) * m_data.blockSize;
+			const float blockMax = static_cast<float>(m_pSectionList[section]->blockMax) * m_data.blockSize;
+
+			return mn + Math::Vector3(static_cast<float>(m_data.width) * m_data.blockSize * 0.5f, (blockMin + blockMax) * 0.5f,
+				static_cast<float>(m_data.length) * m_data.blockSize * 0.5f);
+		}
 
 		inline Math::Vector3 GetOffset() const
 		{
@@ -102,6 +189,19 @@ namespace Universe
 			);
 		}
 		
+		inline void GetBounds(Math::Vector3& mn, Math::Vector3& mx) const
+		{
+			mn = GetOffset();
+			mx = mn + Math::Vector3(
+				static_cast<float>(m_data.width) * m_data.blockSize,
+				static_cast<float>(m_data.height) * m_data.blockSize,
+				static_cast<float>(m_data.length) * m_data.blockSize
+			);
+		}
+
+		inline float GetBlockSize() const { return m_data.blockSize; }
+		inline CChunk* GetAdjacentChunk(SIDE side) const { return m_pChunkAdj[side]; }
+		
 		inline u32 GetIndex(u32 i, u32 j, u32 k) const
 		{
 			//std::shared_lock<std::shared_mutex> lk(m_mutex);
@@ -146,7 +246,8 @@ namespace Universe
 		}
 
 	private:
-		void BuildMesh(u8 meshIndex, bool bOptimize);
+		void PreRender(Graphics::CMaterial* pMaterial);
+		void BuildMesh(Section* pSection, u8 meshIndex, bool bOptimize);
 
 		struct QuadSides
 		{
@@ -187,11 +288,24 @@ namespace Universe
 			};
 		};
 
-		void ProcessIsland(std::unordered_set<u32>& set, std::unordered_set<u32>::iterator it, u32 iStep, u32 kStep, u32 maxIndex, u32 iAxis, u32 kAxis, 
-			const QuadSides& flags, const QuadEdges& edges, std::unordered_map<u32, u64>& disjointedSet);
-		void GenerateOptimalMeshData(u8 meshIndex, Graphics::CMeshData_::Data& data);
+		void ProcessIsland(class CChunkMeshScratch& scratch, u32 seed, u32 iStep, u32 kStep, u32 jMin, u32 jMax, u32 lodLevelOffset, u32 iAxis, u32 kAxis, 
+			const QuadSides& flags, const QuadEdges& edges, const std::vector<u16>& shadeList);
+		void GenerateOptimalMeshData(class CChunkMeshScratch& scratch, u32 jMin, u32 jMax, u32 lodLevelOffset,
+			const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6], const CChunkLight::AdjList& adjLightList);
+		void GenerateQuadMeshData(class CChunkMeshScratch& scratch, u32 jMin, u32 jMax, u32 lodLevelOffset,
+			const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6], const CChunkLight::AdjList& adjLightList, bool bSmooth = false);
+		void PlaceSurface(class CChunkMeshScratch& scratch, u32 jMin, u32 jMax, u32 lodLevelOffset, const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6]);
+		u64 ComputeMeshKey(const Section* pSection, bool bOptimize, const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6],
+			const CChunkLight::AdjList& adjLightList) const;
+
+		u16 GetVertexShade(u32 x, u32 y, u32 z, u8 side, u32 lodLevelOffset, const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6], const CChunkLight::AdjList& adjLightList) const;
+		u16 GetFaceShade(u32 i, u32 j, u32 k, u8 side, u32 lodLevelOffset, const std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6], const CChunkLight::AdjList& adjLightList) const;
 
+		void DispatchBuilds(CChunkRebuildScheduler::Budget& budget);
 		void PushToUpdateQueue();
+		void AcquireAdjacentBorders(std::shared_ptr<const CChunkBorder::Slices> (&adjList)[6]) const;
+		void AcquireAdjacentLight(CChunkLight::AdjList& adjList) const;
+		void RelightAdjacent(u8 sideMask, u32 jMin, u32 jMax);
 		
 		// Internal accessors.
 		inline u32 internalGetIndex(u32 i, u32 j, u32 k) const
@@ -247,6 +361,21 @@ namespace Universe
 			return m_pBlockList ? m_pBlockList[m_lodLevelOffset + index] : Block();
 		}
 
+		// Sections whose faces can change when blocks in rows jMin through jMax (inclusive) change. A row on a section boundary also affects the section across it.
+		inline u8 internalGetSectionMask(u32 jMin, u32 jMax) const
+		{
+			if(jMin > 0) --jMin;
+			if(jMax + 1 < m_data.height) ++jMax;
+
+			u8 mask = 0;
+			for(u32 s = jMin / m_sectionHeight; s <= jMax / m_sectionHeight; ++s)
+			{
+				mask |= 1 << s;
+			}
+
+			return mask;
+		}
+
 		inline void AllocateBlockList()
 		{
 			m_chunkSize = m_data.width * m_data.height * m_data.length;
@@ -261,28 +390,30 @@ namespace Universe
 		bool m_bInitialized;
 #endif
 
-		bool m_bDirty;
-		bool m_bAwaitingRebuild;
 		bool m_bUpdateQueued;
-		u8 m_meshIndex;
+		bool m_bLightDirty; // Light needs a full recompute before the next build is dispatched.
 		u8 m_lodLevel;
 		u8 m_lodLevelMax;
 		u32 m_lodLevelOffset;
 		u32 m_chunkSize;
 		u32 m_blockListSize;
+		u32 m_sectionHeight;
+		Au8 m_solidFaceMask;
 
 		Data m_data;
 		Math::VectorInt3 m_chunkCoord;
 		
 		std::unordered_map<u32, u16> m_blockUpdateMap;
 
-		Graphics::CMeshData_ m_meshData[2];
+		CChunkLOD m_lod;
+		CChunkBorder m_border;
+		CChunkLight m_light;
+
+		std::vector<Section*> m_pSectionList;
 		Graphics::CMeshContainer_ m_meshContainer;
 		//Graphics::CMeshContainer_ m_meshContainerWire;
-		Graphics::CMeshRenderer_* m_pMeshRendererList[2];
-		//Graphics::CMeshRenderer_* m_pMeshRendererListWire[2];
-		Util::CFuture<void> m_meshFuture[2];
 		Graphics::CMaterial* m_pMaterial;
+		Graphics::CMaterial* m_pMaterialTranslucent;
 		Graphics::CMaterial* m_pMaterialWire;
 
 		CChunk* m_pChunkAdj[6];
@@ -0,0 +1,88 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkBorder.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkBorder.h"
+
+namespace Universe
+{
+	CChunkBorder::CChunkBorder() :
+		m_data{ }
+	{
+	}
+
+	CChunkBorder::~CChunkBorder()
+	{
+	}
+
+	// Builds the slices from the block list of the level currently being meshed. Expected to be called while the chunk's lock is held.
+	void CChunkBorder::Publish(const Block* pBlockList)
+	{
+		auto pSlices = std::make_shared<Slices>();
+
+		const u32 strideList[6] = { m_data.height, m_data.height, m_data.width, m_data.width, m_data.width, m_data.width };
+		const u32 sizeList[6] = {
+			m_data.height * m_data.length, m_data.height * m_data.length,
+			m_data.width * m_data.length, m_data.width * m_data.length,
+			m_data.width * m_data.height, m_data.width * m_data.height,
+		};
+
+		for(u32 side = 0; side < 6; ++side)
+		{
+			pSlices->m_strideList[side] = strideList[side];
+			pSlices->m_bitList[side].assign((sizeList[side] + 63) >> 6, 0);
+			pSlices->m_idList[side].assign(sizeList[side], 0);
+		}
+
+		if(pBlockList)
+		{
+			auto Set = [&pSlices](SIDE side, u32 u, u32 v, const Block& block){
+				if(!block.bFilled) return;
+
+				const u32 bit = v * pSlices->m_strideList[side] + u;
+				pSlices->m_bitList[side][bit >> 6] |= 1ULL << (bit & 63);
+				pSlices->m_idList[side][bit] = block.id;
+			};
+
+			const u32 strideI = m_data.length * m_data.height;
+			const u32 strideK = m_data.height;
+
+			for(u32 k = 0; k < m_data.length; ++k)
+			{
+				for(u32 j = 0; j < m_data.height; ++j)
+				{
+					Set(SIDE_LEFT, j, k, pBlockList[k * strideK + j]);
+					Set(SIDE_RIGHT, j, k, pBlockList[(m_data.width - 1) * strideI + k * strideK + j]);
+				}
+			}
+
+			for(u32 i = 0; i < m_data.width; ++i)
+			{
+				for(u32 k = 0; k < m_data.length; ++k)
+				{
+					Set(SIDE_BOTTOM, i, k, pBlockList[i * strideI + k * strideK]);
+					Set(SIDE_TOP, i, k, pBlockList[i * strideI + k * strideK + m_data.height - 1]);
+				}
+
+				for(u32 j = 0; j < m_data.height; ++j)
+				{
+					Set(SIDE_BACK, i, j, pBlockList[i * strideI + j]);
+					Set(SIDE_FRONT, i, j, pBlockList[i * strideI + (m_data.length - 1) * strideK + j]);
+				}
+			}
+		}
+
+		m_slices.store(std::move(pSlices), std::memory_order_release);
+	}
+
+	void CChunkBorder::Release()
+	{
+		m_slices.store(nullptr, std::memory_order_release);
+	}
+};
@@ -0,0 +1,86 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkBorder.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKBORDER_H
+#define CCHUNKBORDER_H
+
+#include "CChunkData.h"
+#include "CBlockRegistry.h"
+#include <Globals/CGlobals.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Universe
+{
+	// Occupancy and block ids of a chunk's six border slices. A new set of slices is built whenever the chunk commits block changes and is published atomically,
+	//  so neighbours can cull faces along the seam without taking the chunk's lock.
+	class CChunkBorder
+	{
+	public:
+		struct Data
+		{
+			u32 width;
+			u32 height;
+			u32 length;
+		};
+
+		// Immutable once published. Coordinates are the two free block coordinates of the face, in (i, j, k) order:
+		//  left/right use (j, k), bottom/top use (i, k), and back/front use (i, j).
+		class Slices
+		{
+		public:
+			inline bool IsFilled(SIDE side, u32 u, u32 v) const
+			{
+				const u32 bit = v * m_strideList[side] + u;
+				return (m_bitList[side][bit >> 6] >> (bit & 63)) & 0x1;
+			}
+
+			inline BlockId GetId(SIDE side, u32 u, u32 v) const { return m_idList[side][v * m_strideList[side] + u]; }
+
+			// Whether the border block hides the face of a block with the given id that touches it.
+			inline bool HidesFace(SIDE side, u32 u, u32 v, BlockId id) const
+			{
+				return IsFilled(side, u, v) && CBlockRegistry::Instance().IsFaceHidden(id, GetId(side, u, v));
+			}
+
+		private:
+			friend class CChunkBorder;
+
+			u32 m_strideList[6];
+			std::vector<u64> m_bitList[6];
+			std::vector<BlockId> m_idList[6];
+		};
+
+	public:
+		CChunkBorder();
+		~CChunkBorder();
+		CChunkBorder(const CChunkBorder&) = delete;
+		CChunkBorder(CChunkBorder&&) = delete;
+		CChunkBorder& operator = (const CChunkBorder&) = delete;
+		CChunkBorder& operator = (CChunkBorder&&) = delete;
+
+		void Publish(const Block* pBlockList);
+		void Release();
+
+		// Accessors.
+		inline std::shared_ptr<const Slices> Acquire() const { return m_slices.load(std::memory_order_acquire); }
+
+		// Modifiers.
+		inline void SetData(const Data& data) { m_data = data; }
+
+	private:
+		Data m_data;
+
+		std::atomic<std::shared_ptr<const Slices>> m_slices;
+	};
+};
+
+#endif
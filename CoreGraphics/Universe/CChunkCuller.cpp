@@ -0,0 +1,253 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkCuller.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkCuller.h"
+#include "CChunk.h"
+#include <Logic/CCamera.h>
+#include <algorithm>
+#include <cfloat>
+
+namespace Universe
+{
+	static const u32 PLANE_MASK_ALL = 0x3F;
+
+	CChunkCuller::CChunkCuller() :
+		m_bDirty(true),
+		m_planeList{ }
+	{
+	}
+
+	CChunkCuller::~CChunkCuller()
+	{
+	}
+
+	void CChunkCuller::Release()
+	{
+		m_nodeList.clear();
+		m_boundsList.clear();
+		m_orderList.clear();
+		m_chunkList.clear();
+		m_stack.clear();
+		m_visibleList.clear();
+		m_bDirty = true;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Build methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// Rebuilds the tree over the given chunks. Chunks don't move, so this is only needed when chunks are added or removed.
+	void CChunkCuller::Build(CChunk* const* ppChunkList, size_t chunkCount)
+	{
+		m_chunkList.assign(ppChunkList, ppChunkList + chunkCount);
+		m_boundsList.resize(chunkCount);
+		m_orderList.resize(chunkCount);
+		m_nodeList.clear();
+		m_visibleList.clear();
+
+		for(u32 i = 0; i < static_cast<u32>(chunkCount); ++i)
+		{
+			m_chunkList[i]->GetBounds(m_boundsList[i].mn, m_boundsList[i].mx);
+			m_orderList[i] = i;
+		}
+
+		if(chunkCount)
+		{
+			m_nodeList.reserve(chunkCount);
+			BuildNode(0, static_cast<u32>(chunkCount));
+		}
+
+		m_bDirty = false;
+	}
+
+	// Splits the range into up to four groups along the longest centroid axis, twice, and recurses into any group with more than one chunk.
+	u32 CChunkCuller::BuildNode(u32 start, u32 end)
+	{
+		const u32 nodeIndex = static_cast<u32>(m_nodeList.size());
+		m_nodeList.push_back({ });
+
+		u32 groupList[5];
+		u32 groupCount = 0;
+
+		if(end - start <= 4)
+		{
+			for(u32 i = start; i <= end; ++i)
+			{
+				groupList[groupCount++] = i;
+			}
+		}
+		else
+		{
+			auto Split = [this](u32 s, u32 e){
+				Math::Vector3 mn(FLT_MAX);
+				Math::Vector3 mx(-FLT_MAX);
+				for(u32 i = s; i < e; ++i)
+				{
+					const Bounds& bounds = m_boundsList[m_orderList[i]];
+					for(u32 axis = 0; axis < 3; ++axis)
+					{
+						const float centroid = bounds.mn[axis] + bounds.mx[axis];
+						mn[axis] = std::min(mn[axis], centroid);
+						mx[axis] = std::max(mx[axis], centroid);
+					}
+				}
+
+				const Math::Vector3 extents = mx - mn;
+				const u32 axis = extents.x >= extents.y && extents.x >= extents.z ? 0 : (extents.y >= extents.z ? 1 : 2);
+				const u32 mid = s + ((e - s) >> 1);
+
+				std::nth_element(m_orderList.begin() + s, m_orderList.begin() + mid, m_orderList.begin() + e, [this, axis](u32 a, u32 b){
+					return m_boundsList[a].mn[axis] + m_boundsList[a].mx[axis] < m_boundsList[b].mn[axis] + m_boundsList[b].mx[axis];
+				});
+
+				return mid;
+			};
+
+			const u32 mid = Split(start, end);
+			groupList[0] = start;
+			groupList[1] = Split(start, mid);
+			groupList[2] = mid;
+			groupList[3] = Split(mid, end);
+			groupList[4] = end;
+			groupCount = 5;
+		}
+
+		u32 childCount = 0;
+		s32 childList[4];
+		Bounds boundsList[4];
+
+		for(u32 g = 0; g + 1 < groupCount; ++g)
+		{
+			const u32 s = groupList[g];
+			const u32 e = groupList[g + 1];
+			if(s == e) continue;
+
+			boundsList[childCount] = GetBounds(s, e);
+			childList[childCount] = (e - s == 1) ? ~static_cast<s32>(m_orderList[s]) : static_cast<s32>(BuildNode(s, e));
+			++childCount;
+		}
+
+		// Recursion may have reallocated the node list, so the node is only written once its children are known.
+		Node& node = m_nodeList[nodeIndex];
+		node.childCount = childCount;
+
+		for(u32 i = 0; i < 4; ++i)
+		{
+			// Unused lanes get inverted bounds, and are masked out during culling regardless.
+			const Bounds& bounds = i < childCount ? boundsList[i] : Bounds{ Math::Vector3(FLT_MAX), Math::Vector3(-FLT_MAX) };
+			node.mnX[i] = bounds.mn.x; node.mnY[i] = bounds.mn.y; node.mnZ[i] = bounds.mn.z;
+			node.mxX[i] = bounds.mx.x; node.mxY[i] = bounds.mx.y; node.mxZ[i] = bounds.mx.z;
+			node.child[i] = i < childCount ? childList[i] : 0;
+		}
+
+		return nodeIndex;
+	}
+
+	CChunkCuller::Bounds CChunkCuller::GetBounds(u32 start, u32 end) const
+	{
+		Bounds bounds = { Math::Vector3(FLT_MAX), Math::Vector3(-FLT_MAX) };
+		for(u32 i = start; i < end; ++i)
+		{
+			const Bounds& chunkBounds = m_boundsList[m_orderList[i]];
+			for(u32 axis = 0; axis < 3; ++axis)
+			{
+				bounds.mn[axis] = std::min(bounds.mn[axis], chunkBounds.mn[axis]);
+				bounds.mx[axis] = std::max(bounds.mx[axis], chunkBounds.mx[axis]);
+			}
+		}
+
+		return bounds;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Cull methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// Iteratively walks the tree, testing four children per plane at a time. Planes a node is fully inside of are dropped for its subtree.
+	void CChunkCuller::Cull(const Logic::CCamera* pCamera)
+	{
+		m_visibleList.clear();
+		if(m_nodeList.empty()) return;
+
+		// Snapshot the frustum once per frame. Plane normals point into the frustum.
+		for(u32 i = 0; i < 6; ++i)
+		{
+			const float* pPlane = pCamera->GetFrustumPlane(i).ToFloat();
+			m_planeList[i][0] = pPlane[0];
+			m_planeList[i][1] = pPlane[1];
+			m_planeList[i][2] = pPlane[2];
+			m_planeList[i][3] = pPlane[3];
+		}
+
+		const vf32 zero = _mm_setzero_ps();
+
+		m_stack.clear();
+		m_stack.push_back({ 0, PLANE_MASK_ALL });
+
+		while(!m_stack.empty())
+		{
+			const StackEntry entry = m_stack.back();
+			m_stack.pop_back();
+
+			const Node& node = m_nodeList[entry.node];
+
+			// Lanes past the child count start out culled.
+			int visibleMask = (1 << node.childCount) - 1;
+			int insideMask[6] = { visibleMask, visibleMask, visibleMask, visibleMask, visibleMask, visibleMask };
+
+			for(u32 i = 0; i < 6 && visibleMask; ++i)
+			{
+				if((entry.planeMask & (1 << i)) == 0) continue;
+
+				const float* pPlane = m_planeList[i];
+
+				// The sign of each normal component picks the corner nearest the inside (p) and the outside (n) of the plane.
+				const vf32 px = _mm_load_ps(pPlane[0] > 0.0f ? node.mxX : node.mnX);
+				const vf32 py = _mm_load_ps(pPlane[1] > 0.0f ? node.mxY : node.mnY);
+				const vf32 pz = _mm_load_ps(pPlane[2] > 0.0f ? node.mxZ : node.mnZ);
+				const vf32 nx = _mm_load_ps(pPlane[0] > 0.0f ? node.mnX : node.mxX);
+				const vf32 ny = _mm_load_ps(pPlane[1] > 0.0f ? node.mnY : node.mxY);
+				const vf32 nz = _mm_load_ps(pPlane[2] > 0.0f ? node.mnZ : node.mxZ);
+
+				const vf32 a = _mm_set1_ps(pPlane[0]);
+				const vf32 b = _mm_set1_ps(pPlane[1]);
+				const vf32 c = _mm_set1_ps(pPlane[2]);
+				const vf32 d = _mm_set1_ps(pPlane[3]);
+
+				const vf32 distP = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, px), _mm_mul_ps(b, py)), _mm_add_ps(_mm_mul_ps(c, pz), d));
+				const vf32 distN = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, nx), _mm_mul_ps(b, ny)), _mm_add_ps(_mm_mul_ps(c, nz), d));
+
+				visibleMask &= ~_mm_movemask_ps(_mm_cmplt_ps(distP, zero));
+				insideMask[i] = _mm_movemask_ps(_mm_cmpge_ps(distN, zero));
+			}
+
+			for(u32 lane = 0; lane < node.childCount; ++lane)
+			{
+				if((visibleMask & (1 << lane)) == 0) continue;
+
+				const s32 child = node.child[lane];
+				if(child < 0)
+				{
+					m_visibleList.push_back(m_chunkList[~child]);
+				}
+				else
+				{
+					u32 planeMask = entry.planeMask;
+					for(u32 i = 0; i < 6; ++i)
+					{
+						if(insideMask[i] & (1 << lane)) planeMask &= ~(1 << i);
+					}
+
+					m_stack.push_back({ static_cast<u32>(child), planeMask });
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,97 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkCuller.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKCULLER_H
+#define CCHUNKCULLER_H
+
+#include <Math/CMathVector3.h>
+#include <Globals/CGlobals.h>
+#include <vector>
+
+namespace Logic
+{
+	class CCamera;
+};
+
+namespace Universe
+{
+	// Frustum culls chunks over a persistent 4-wide BVH. Each node stores its children's bounds as SoA so that all four are tested against a plane at once.
+	class CChunkCuller
+	{
+	private:
+		struct alignas(16) Node
+		{
+			float mnX[4];
+			float mnY[4];
+			float mnZ[4];
+			float mxX[4];
+			float mxY[4];
+			float mxZ[4];
+
+			// Values >= 0 index a child node, while negative values are leaves storing ~chunkIndex.
+			s32 child[4];
+			u32 childCount;
+		};
+
+		struct StackEntry
+		{
+			u32 node;
+			u32 planeMask;
+		};
+
+		struct Bounds
+		{
+			Math::Vector3 mn;
+			Math::Vector3 mx;
+		};
+
+	public:
+		CChunkCuller();
+		~CChunkCuller();
+		CChunkCuller(const CChunkCuller&) = delete;
+		CChunkCuller(CChunkCuller&&) = delete;
+		CChunkCuller& operator = (const CChunkCuller&) = delete;
+		CChunkCuller& operator = (CChunkCuller&&) = delete;
+
+		void Build(class CChunk* const* ppChunkList, size_t chunkCount);
+		void Cull(const Logic::CCamera* pCamera);
+		void Release();
+
+		// Accessors.
+		inline bool IsDirty() const { return m_bDirty; }
+		inline const std::vector<class CChunk*>& GetVisibleList() const { return m_visibleList; }
+
+		// Modifiers.
+		inline void MarkDirty()
+		{
+			// The visible list may hold chunks that are about to be released.
+			m_visibleList.clear();
+			m_bDirty = true;
+		}
+
+	private:
+		u32 BuildNode(u32 start, u32 end);
+		Bounds GetBounds(u32 start, u32 end) const;
+
+	private:
+		bool m_bDirty;
+
+		float m_planeList[6][4];
+
+		std::vector<Node> m_nodeList;
+		std::vector<Bounds> m_boundsList;
+		std::vector<u32> m_orderList;
+		std::vector<class CChunk*> m_chunkList;
+		std::vector<StackEntry> m_stack;
+		std::vector<class CChunk*> m_visibleList;
+	};
+};
+
+#endif
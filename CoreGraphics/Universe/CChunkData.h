@@ -20,6 +20,20 @@ typedef Au8 AblockId;
 
 namespace Universe
 {
+	// Highest LOD level a chunk will allocate. Each level costs another full block list, so chunk nodes opt in through their lodLevelMax.
+	const u8 CHUNK_LOD_LEVEL_LIMIT = 3;
+
+	// Most horizontal slabs a chunk mesh is split into. Each slab is remeshed and uploaded on its own, so an edit only rebuilds the slabs it touches.
+	const u8 CHUNK_SECTION_LIMIT = 8;
+
+	// Material slots of a chunk mesh. Each one draws its own index range of a section's mesh.
+	enum CHUNK_MATERIAL : u8
+	{
+		CHUNK_MATERIAL_OPAQUE, // Opaque and cutout blocks.
+		CHUNK_MATERIAL_TRANSLUCENT,
+		CHUNK_MATERIAL_COUNT,
+	};
+
 	enum SIDE : u8
 	{
 		SIDE_LEFT,
@@ -0,0 +1,340 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkLOD.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkLOD.h"
+#include "../Utilities/CJobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Universe
+{
+	static const double TARGET_COVERAGE = 0.3333;
+	static const double TARGET_EXTENT_COVERAGE_PLANAR = 0.125;
+	static const double TARGET_EXTENT_COVERAGE_LINEAR = 0.275;
+
+	// Converts a coverage fraction into the number of filled blocks required to reach it.
+	static inline u32 CoverageThreshold(u32 total, double coverage)
+	{
+		return static_cast<u32>(ceil(total * coverage - 1e-9));
+	}
+
+	// Surface blocks dominate the vote, but interior and generated blocks (which carry no side flags) still count.
+	static inline u32 BlockWeight(const Block& block)
+	{
+		u32 weight = 1;
+		for(u8 flag = block.sideFlag; flag; flag >>= 1)
+		{
+			weight += flag & 0x1;
+		}
+
+		return weight;
+	}
+
+	// Finds the [mn, mx) range of slices whose filled count reaches the threshold.
+	static inline void FindExtents(const u32* pCountList, u32 stepSize, u32 threshold, u32& mn, u32& mx)
+	{
+		mn = stepSize;
+		mx = 0;
+
+		for(u32 s = 0; s < stepSize; ++s)
+		{
+			if(pCountList[s] && pCountList[s] >= threshold)
+			{
+				mn = std::min(mn, s);
+				mx = s + 1;
+			}
+		}
+	}
+
+	CChunkLOD::CChunkLOD() :
+		m_data{ },
+		m_chunkSize(0)
+	{
+	}
+
+	CChunkLOD::~CChunkLOD()
+	{
+	}
+
+	void CChunkLOD::Initialize()
+	{
+		m_chunkSize = m_data.width * m_data.height * m_data.length;
+
+		m_levelList.resize(m_data.lodLevelMax);
+		for(u8 lodLevel = 1; lodLevel <= m_data.lodLevelMax; ++lodLevel)
+		{
+			Level& level = m_levelList[lodLevel - 1];
+			level.cellWidth = m_data.width >> lodLevel;
+			level.cellHeight = m_data.height >> lodLevel;
+			level.cellLength = m_data.length >> lodLevel;
+			level.dirtyMask.assign(level.cellWidth * level.cellHeight * level.cellLength, 0);
+			level.dirtyList.clear();
+		}
+	}
+
+	void CChunkLOD::Release()
+	{
+		m_levelList.clear();
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Update methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// Marks every parent cell of the level 0 block at 'index' as requiring a rebuild.
+	void CChunkLOD::MarkDirty(u32 index)
+	{
+		u32 i = index;
+		const u32 j = i % m_data.height;
+		i = i / m_data.height;
+		const u32 k = i % m_data.length;
+		i = i / m_data.length;
+
+		for(u8 lodLevel = 1; lodLevel <= m_data.lodLevelMax; ++lodLevel)
+		{
+			Level& level = m_levelList[lodLevel - 1];
+			const u32 cell = (i >> lodLevel) * level.cellLength * level.cellHeight + (k >> lodLevel) * level.cellHeight + (j >> lodLevel);
+			if(level.dirtyMask[cell] == 0)
+			{
+				level.dirtyMask[cell] = 1;
+				level.dirtyList.push_back(cell);
+			}
+		}
+	}
+
+	// Rebuilds dirty cells from the finest level up. Returns true if any level was modified.
+	bool CChunkLOD::Update(Block* pBlockList)
+	{
+		if(pBlockList == nullptr) return false;
+
+		bool bUpdated = false;
+		for(u8 lodLevel = 1; lodLevel <= m_data.lodLevelMax; ++lodLevel)
+		{
+			Level& level = m_levelList[lodLevel - 1];
+			if(level.dirtyList.empty()) continue;
+
+			BuildLevel(pBlockList, lodLevel, level.dirtyList.data(), static_cast<u32>(level.dirtyList.size()));
+
+			for(u32 cell : level.dirtyList)
+			{
+				level.dirtyMask[cell] = 0;
+			}
+
+			level.dirtyList.clear();
+			bUpdated = true;
+		}
+
+		return bUpdated;
+	}
+
+	// Rebuilds every level from level 0.
+	void CChunkLOD::Build(Block* pBlockList)
+	{
+		if(pBlockList == nullptr) return;
+
+		for(u8 lodLevel = 1; lodLevel <= m_data.lodLevelMax; ++lodLevel)
+		{
+			Level& level = m_levelList[lodLevel - 1];
+			BuildLevel(pBlockList, lodLevel, nullptr, static_cast<u32>(level.dirtyMask.size()));
+
+			std::fill(level.dirtyMask.begin(), level.dirtyMask.end(), 0);
+			level.dirtyList.clear();
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Build methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// Builds the listed cells of a level, or every cell if no list is provided. Cells are independent, so they're spread across the job system.
+	void CChunkLOD::BuildLevel(Block* pBlockList, u8 lodLevel, const u32* pCellList, u32 cellCount)
+	{
+		const Level& level = m_levelList[lodLevel - 1];
+		const Block* pSrc = pBlockList + (lodLevel - 1) * m_chunkSize;
+		Block* pDst = pBlockList + lodLevel * m_chunkSize;
+		const u32 stepSize = 1 << lodLevel;
+
+		// Aim for roughly 4K block reads per batch.
+		const u32 batchSize = std::max(1U, 4096U >> (3 * lodLevel));
+
+		Util::CJobSystem::Instance().ParallelFor(cellCount, batchSize, [&](u32 start, u32 end){
+			Histogram histogram;
+
+			for(u32 n = start; n < end; ++n)
+			{
+				u32 ci = pCellList ? pCellList[n] : n;
+				const u32 cj = ci % level.cellHeight;
+				ci = ci / level.cellHeight;
+				const u32 ck = ci % level.cellLength;
+				ci = ci / level.cellLength;
+
+				BuildCell(pSrc, pDst, ci << lodLevel, cj << lodLevel, ck << lodLevel, stepSize, histogram);
+			}
+		});
+	}
+
+	void CChunkLOD::BuildCell(const Block* pSrc, Block* pDst, u32 i, u32 j, u32 k, u32 stepSize, Histogram& histogram) const
+	{
+		const u32 origin[3] = { i, j, k };
+
+		u32 filledCount = 0;
+		u32 planeCount[3][LOD_STEP_MAX] = { };
+		u32 lineXY[LOD_STEP_MAX][LOD_STEP_MAX] = { }; // Filled count along z for each (x, y).
+		u32 lineXZ[LOD_STEP_MAX][LOD_STEP_MAX] = { }; // Filled count along y for each (x, z).
+		u32 lineYZ[LOD_STEP_MAX][LOD_STEP_MAX] = { }; // Filled count along x for each (y, z).
+
+		histogram.Reset();
+
+		// Gather coverage for the cell, its planes, and its lines in a single pass.
+		for(u32 x = 0; x < stepSize; ++x)
+		{
+			for(u32 z = 0; z < stepSize; ++z)
+			{
+				const Block* pColumn = pSrc + GetIndex(i + x, j, k + z);
+				for(u32 y = 0; y < stepSize; ++y)
+				{
+					const Block block = pColumn[y];
+					if(!block.bFilled) continue;
+
+					++filledCount;
+					++planeCount[0][x];
+					++planeCount[1][y];
+					++planeCount[2][z];
+					++lineXY[x][y];
+					++lineXZ[x][z];
+					++lineYZ[y][z];
+
+					histogram.Add(block.id, BlockWeight(block));
+				}
+			}
+		}
+
+		// Clear the cell's region before writing the new LOD blocks.
+		for(u32 x = 0; x < stepSize; ++x)
+		{
+			for(u32 z = 0; z < stepSize; ++z)
+			{
+				Block* pColumn = pDst + GetIndex(i + x, j, k + z);
+				for(u32 y = 0; y < stepSize; ++y)
+				{
+					pColumn[y] = Block();
+				}
+			}
+		}
+
+		if(filledCount == 0) return;
+
+		const u32 area = stepSize * stepSize;
+		const u32 volume = area * stepSize;
+
+		if(filledCount >= CoverageThreshold(volume, TARGET_COVERAGE))
+		{ // Dense enough to become a single block spanning the extents of its well covered planes.
+			const u32 planarThreshold = CoverageThreshold(area, TARGET_EXTENT_COVERAGE_PLANAR);
+
+			u32 mn[3], mx[3];
+			for(u32 axis = 0; axis < 3; ++axis)
+			{
+				FindExtents(planeCount[axis], stepSize, planarThreshold, mn[axis], mx[axis]);
+			}
+
+			const Block block(histogram.Mode(), true);
+			for(u32 x = mn[0]; x < mx[0]; ++x)
+			{
+				for(u32 z = mn[2]; z < mx[2]; ++z)
+				{
+					Block* pColumn = pDst + GetIndex(i + x, j, k + z);
+					for(u32 y = mn[1]; y < mx[1]; ++y)
+					{
+						pColumn[y] = block;
+					}
+				}
+			}
+
+			return;
+		}
+
+		// Otherwise fall back to LOD planes along each axis.
+		const u32 linearThreshold = CoverageThreshold(stepSize, TARGET_EXTENT_COVERAGE_LINEAR);
+
+		// Each entry is { u, v, w } where w is the slice axis.
+		static const u32 AXIS_LIST[3][3] = {
+			{ 1, 2, 0 }, // X-Axis.
+			{ 2, 0, 1 }, // Y-Axis.
+			{ 1, 0, 2 }, // Z-Axis.
+		};
+
+		u32 coords[3];
+		u32 uCountList[LOD_STEP_MAX];
+		u32 vCountList[LOD_STEP_MAX];
+
+		for(u32 n = 0; n < 3; ++n)
+		{
+			const u32 u = AXIS_LIST[n][0];
+			const u32 v = AXIS_LIST[n][1];
+			const u32 w = AXIS_LIST[n][2];
+
+			for(u32 s = 0; s < stepSize; ++s)
+			{
+				if(planeCount[w][s] == 0) continue;
+
+				// Coverage of the lines running along v (indexed by u) and along u (indexed by v).
+				for(u32 a = 0; a < stepSize; ++a)
+				{
+					switch(w)
+					{
+						case 0:
+							uCountList[a] = lineXY[s][a];
+							vCountList[a] = lineXZ[s][a];
+							break;
+						case 1:
+							uCountList[a] = lineYZ[s][a];
+							vCountList[a] = lineXY[a][s];
+							break;
+						default:
+							uCountList[a] = lineYZ[a][s];
+							vCountList[a] = lineXZ[a][s];
+							break;
+					}
+				}
+
+				u32 mnU, mxU, mnV, mxV;
+				FindExtents(uCountList, stepSize, linearThreshold, mnU, mxU);
+				FindExtents(vCountList, stepSize, linearThreshold, mnV, mxV);
+				if(mnU >= mxU || mnV >= mxV) continue;
+
+				// The dominant id is resolved per slice.
+				histogram.Reset();
+				coords[w] = s;
+				for(u32 b = 0; b < stepSize; ++b)
+				{
+					for(u32 a = 0; a < stepSize; ++a)
+					{
+						coords[u] = a; coords[v] = b;
+						const Block block = pSrc[GetIndex(origin[0] + coords[0], origin[1] + coords[1], origin[2] + coords[2])];
+						if(block.bFilled)
+						{
+							histogram.Add(block.id, BlockWeight(block));
+						}
+					}
+				}
+
+				const Block block(histogram.Mode(), true);
+				for(u32 b = mnV; b < mxV; ++b)
+				{
+					for(u32 a = mnU; a < mxU; ++a)
+					{
+						coords[u] = a; coords[v] = b;
+						pDst[GetIndex(origin[0] + coords[0], origin[1] + coords[1], origin[2] + coords[2])] = block;
+					}
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,127 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkLOD.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKLOD_H
+#define CCHUNKLOD_H
+
+#include "CChunkData.h"
+#include <Globals/CGlobals.h>
+#include <vector>
+#include <cstring>
+
+namespace Universe
+{
+	// Maintains every LOD level of a chunk's block list. Level n is stored at offset n * chunkSize and is derived from level n - 1,
+	//  so edits only need to recompute the parent cells that contain them.
+	class CChunkLOD
+	{
+	public:
+		struct Data
+		{
+			u32 width;
+			u32 height;
+			u32 length;
+			u8 lodLevelMax;
+		};
+
+	private:
+		static const u32 LOD_STEP_MAX = 1 << CHUNK_LOD_LEVEL_LIMIT;
+
+		// Fixed size block id histogram. Only touched ids are reset, so clearing is proportional to the cell's contents.
+		struct Histogram
+		{
+			u32 count[256];
+			BlockId idList[256];
+			u32 idCount;
+
+			Histogram() : idCount(0)
+			{
+				memset(count, 0, sizeof(count));
+			}
+
+			inline void Reset()
+			{
+				for(u32 i = 0; i < idCount; ++i)
+				{
+					count[idList[i]] = 0;
+				}
+
+				idCount = 0;
+			}
+
+			inline void Add(BlockId id, u32 weight)
+			{
+				if(count[id] == 0) idList[idCount++] = id;
+				count[id] += weight;
+			}
+
+			inline BlockId Mode() const
+			{
+				BlockId id = 0;
+				u32 maxCount = 0;
+				for(u32 i = 0; i < idCount; ++i)
+				{
+					if(count[idList[i]] > maxCount)
+					{
+						maxCount = count[idList[i]];
+						id = idList[i];
+					}
+				}
+
+				return id;
+			}
+		};
+
+		struct Level
+		{
+			u32 cellWidth;
+			u32 cellHeight;
+			u32 cellLength;
+			std::vector<u8> dirtyMask;
+			std::vector<u32> dirtyList;
+		};
+
+	public:
+		CChunkLOD();
+		~CChunkLOD();
+		CChunkLOD(const CChunkLOD&) = delete;
+		CChunkLOD(CChunkLOD&&) = delete;
+		CChunkLOD& operator = (const CChunkLOD&) = delete;
+		CChunkLOD& operator = (CChunkLOD&&) = delete;
+
+		void Initialize();
+		void Release();
+
+		void MarkDirty(u32 index);
+		bool Update(Block* pBlockList);
+		void Build(Block* pBlockList);
+
+		// Modifiers.
+		inline void SetData(const Data& data) { m_data = data; }
+
+	private:
+		void BuildLevel(Block* pBlockList, u8 lodLevel, const u32* pCellList, u32 cellCount);
+		void BuildCell(const Block* pSrc, Block* pDst, u32 i, u32 j, u32 k, u32 stepSize, Histogram& histogram) const;
+
+		inline u32 GetIndex(u32 i, u32 j, u32 k) const
+		{
+			return i * m_data.length * m_data.height + k * m_data.height + j;
+		}
+
+	private:
+		Data m_data;
+		u32 m_chunkSize;
+
+		// Element n holds the state of LOD level n + 1.
+		std::vector<Level> m_levelList;
+	};
+};
+
+#endif
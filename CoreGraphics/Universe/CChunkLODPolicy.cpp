@@ -0,0 +1,145 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkLODPolicy.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkLODPolicy.h"
+#include "CChunk.h"
+#include <Logic/CCamera.h>
+#include <algorithm>
+
+namespace Universe
+{
+	CChunkLODPolicy::CChunkLODPolicy() :
+		m_bPerspective(true),
+		m_projScale(0.0f),
+		m_nearView(0.0f)
+	{
+	}
+
+	CChunkLODPolicy::~CChunkLODPolicy()
+	{
+	}
+
+	// Snapshot the camera values needed to project errors for this frame.
+	void CChunkLODPolicy::Begin(const Logic::CCamera* pCamera)
+	{
+		m_transitionList.clear();
+		m_rebuildList.clear();
+
+		m_cameraPosition = *(Math::Vector3*)pCamera->GetTransform()->GetPosition().ToFloat();
+		m_nearView = std::max(pCamera->GetNearView(), 1e-3f);
+
+		const float screenHeight = static_cast<float>(std::max(pCamera->GetSreenRect().h, 1L));
+		if(pCamera->GetProjectionMode() == Logic::CAMERA_PROJ_MODE_PERSPECTIVE)
+		{
+			m_bPerspective = true;
+			m_projScale = screenHeight / (2.0f * tanf(pCamera->GetFOVRadians() * 0.5f));
+		}
+		else
+		{
+			m_bPerspective = false;
+			m_projScale = screenHeight / std::max(pCamera->GetSize(), 1e-3f);
+		}
+	}
+
+	void CChunkLODPolicy::Evaluate(CChunk* pChunk)
+	{
+		const u8 lodLevelMax = pChunk->GetLODLevelMax();
+		if(lodLevelMax == 0) return;
+
+		Math::Vector3 mn, mx;
+		pChunk->GetBounds(mn, mx);
+
+		// Distance from the camera to the closest point on the chunk.
+		Math::Vector3 closest;
+		for(size_t i = 0; i < 3; ++i)
+		{
+			closest[i] = std::min(std::max(m_cameraPosition[i], mn[i]), mx[i]);
+		}
+
+		const float distance = std::max((closest - m_cameraPosition).Length(), m_nearView);
+		const float blockSize = pChunk->GetBlockSize();
+		const u8 lodLevelCurrent = pChunk->GetLODLevel();
+
+		// Coarsest level that stays within the tolerated error.
+		u8 lodLevel = 0;
+		while(lodLevel < lodLevelMax && ProjectedError(blockSize, lodLevel + 1, distance) <= m_data.pixelError)
+		{
+			++lodLevel;
+		}
+
+		// Hysteresis, so that chunks sitting on a threshold don't thrash between levels.
+		if(lodLevel > lodLevelCurrent)
+		{
+			while(lodLevel > lodLevelCurrent && ProjectedError(blockSize, lodLevel, distance) > m_data.pixelError * (1.0f - m_data.hysteresis))
+			{
+				--lodLevel;
+			}
+		}
+		else if(lodLevel < lodLevelCurrent && ProjectedError(blockSize, lodLevelCurrent, distance) <= m_data.pixelError * (1.0f + m_data.hysteresis))
+		{
+			lodLevel = lodLevelCurrent;
+		}
+
+		if(lodLevel != lodLevelCurrent)
+		{
+			m_transitionList.push_back({ pChunk, lodLevel, distance });
+		}
+	}
+
+	// Applies up to the frame's transition budget. Refinements of the nearest chunks go first, then coarsening of the farthest.
+	void CChunkLODPolicy::Apply()
+	{
+		if(m_transitionList.empty()) return;
+
+		const u32 count = std::min(static_cast<u32>(m_transitionList.size()), m_data.transitionBudget);
+		std::partial_sort(m_transitionList.begin(), m_transitionList.begin() + count, m_transitionList.end(), [](const Transition& a, const Transition& b){
+			const bool bRefineA = a.lodLevel < a.pChunk->GetLODLevel();
+			const bool bRefineB = b.lodLevel < b.pChunk->GetLODLevel();
+			if(bRefineA != bRefineB) return bRefineA;
+			return bRefineA ? a.distance < b.distance : a.distance > b.distance;
+		});
+
+		auto QueueRebuild = [this](CChunk* pChunk){
+			if(pChunk && std::find(m_rebuildList.begin(), m_rebuildList.end(), pChunk) == m_rebuildList.end())
+			{
+				m_rebuildList.push_back(pChunk);
+			}
+		};
+
+		for(u32 i = 0; i < count; ++i)
+		{
+			const Transition& transition = m_transitionList[i];
+			transition.pChunk->SetLODLevel(transition.lodLevel);
+			QueueRebuild(transition.pChunk);
+
+			// Neighbours cull their border faces against this chunk's current level, so they're rebuilt with it to avoid cracks along the seam.
+			for(u8 side = SIDE_LEFT; side <= SIDE_FRONT; ++side)
+			{
+				QueueRebuild(transition.pChunk->GetAdjacentChunk(static_cast<SIDE>(side)));
+			}
+		}
+
+		for(CChunk* pChunk : m_rebuildList)
+		{
+			pChunk->ForceRebuild();
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Utility methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// A block at LOD level n can misplace a surface by up to (2^n - 1) blocks.
+	float CChunkLODPolicy::ProjectedError(float blockSize, u8 lodLevel, float distance) const
+	{
+		const float error = blockSize * static_cast<float>((1 << lodLevel) - 1);
+		return m_bPerspective ? error * m_projScale / distance : error * m_projScale;
+	}
+};
@@ -0,0 +1,79 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkLODPolicy.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKLODPOLICY_H
+#define CCHUNKLODPOLICY_H
+
+#include <Math/CMathVector3.h>
+#include <Globals/CGlobals.h>
+#include <vector>
+
+namespace Logic
+{
+	class CCamera;
+};
+
+namespace Universe
+{
+	// Picks each chunk's LOD level from its projected screen space error.
+	class CChunkLODPolicy
+	{
+	public:
+		struct Data
+		{
+			bool bEnabled = false;
+			float pixelError = 2.0f; // Largest error, in pixels, a chunk may show before it's refined.
+			float hysteresis = 0.25f; // Fraction of pixelError that a chunk must cross before it changes level.
+			u32 transitionBudget = 8; // Maximum number of LOD transitions per frame.
+		};
+
+	private:
+		struct Transition
+		{
+			class CChunk* pChunk;
+			u8 lodLevel;
+			float distance;
+		};
+
+	public:
+		CChunkLODPolicy();
+		~CChunkLODPolicy();
+		CChunkLODPolicy(const CChunkLODPolicy&) = delete;
+		CChunkLODPolicy(CChunkLODPolicy&&) = delete;
+		CChunkLODPolicy& operator = (const CChunkLODPolicy&) = delete;
+		CChunkLODPolicy& operator = (CChunkLODPolicy&&) = delete;
+
+		void Begin(const Logic::CCamera* pCamera);
+		void Evaluate(class CChunk* pChunk);
+		void Apply();
+
+		// Accessors.
+		inline bool IsEnabled() const { return m_data.bEnabled; }
+
+		// Modifiers.
+		inline void SetData(const Data& data) { m_data = data; }
+
+	private:
+		float ProjectedError(float blockSize, u8 lodLevel, float distance) const;
+
+	private:
+		Data m_data;
+
+		bool m_bPerspective;
+		float m_projScale;
+		float m_nearView;
+		Math::Vector3 m_cameraPosition;
+
+		std::vector<Transition> m_transitionList;
+		std::vector<class CChunk*> m_rebuildList;
+	};
+};
+
+#endif
@@ -0,0 +1,544 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkLight.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkLight.h"
+#include "CBlockRegistry.h"
+#include <chrono>
+
+namespace Universe
+{
+	namespace
+	{
+		const u8 CHANNEL_SHIFT[] = { 4, 0 };
+
+		inline bool IsOpaque(const Block* pBlockList, u32 index)
+		{
+			return pBlockList && pBlockList[index].bFilled && CBlockRegistry::Instance().IsOpaque(pBlockList[index].id);
+		}
+
+		inline u8 GetEmission(const Block* pBlockList, u32 index)
+		{
+			return pBlockList && pBlockList[index].bFilled ? CBlockRegistry::Instance().GetEmission(pBlockList[index].id) : 0;
+		}
+
+		inline float ElapsedMs(std::chrono::steady_clock::time_point start)
+		{
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+	};
+
+	CChunkLight::CChunkLight() :
+		m_data{ },
+		m_stats{ },
+		m_changeMin(1),
+		m_changeMax(0)
+	{
+	}
+
+	CChunkLight::~CChunkLight()
+	{
+	}
+
+	void CChunkLight::Initialize()
+	{
+		m_lightList.assign(m_data.width * m_data.height * m_data.length, 0);
+	}
+
+	// Recomputes every cell from the chunk's emitters and its neighbours' borders. Changed rows are found by comparing against the previous result.
+	// Border cells don't seed from neighbours dimmer than their previous light, which may have come from here. Publishing lists the cells that
+	//  dimmed, and the neighbour tells this side to seed again once it has taken that light back.
+	void CChunkLight::Compute(const Block* pBlockList, const AdjList& adjList)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		m_stats.visitCount = 0;
+
+		m_lightListPrev.swap(m_lightList);
+		m_lightList.assign(m_lightListPrev.size(), 0);
+
+		for(CHANNEL channel : { CHANNEL_SKY, CHANNEL_BLOCK })
+		{
+			m_queue.clear();
+
+			for(u32 i = 0; i < m_data.width; ++i)
+			{
+				for(u32 k = 0; k < m_data.length; ++k)
+				{
+					for(u32 j = 0; j < m_data.height; ++j)
+					{
+						const u32 index = (i * m_data.length + k) * m_data.height + j;
+						if(channel == CHANNEL_BLOCK)
+						{
+							const u8 emission = GetEmission(pBlockList, index);
+							if(emission)
+							{
+								SetLevel(index, CHANNEL_SHIFT[channel], emission);
+								m_queue.push_back(index);
+								continue;
+							}
+						}
+
+						const bool bBorder = i == 0 || i == m_data.width - 1 || j == 0 || j == m_data.height - 1 || k == 0 || k == m_data.length - 1;
+						if(bBorder && Seed(pBlockList, adjList, index, channel, (m_lightListPrev[index] >> CHANNEL_SHIFT[channel]) & 0xF))
+						{
+							m_queue.push_back(index);
+						}
+					}
+				}
+			}
+
+			Propagate(pBlockList, channel);
+		}
+
+		ResetChanges();
+		for(u32 index = 0; index < m_lightList.size(); ++index)
+		{
+			if(m_lightList[index] != m_lightListPrev[index])
+			{
+				const u32 j = index % m_data.height;
+				m_changeMin = std::min(m_changeMin, j);
+				m_changeMax = std::max(m_changeMax, j);
+			}
+		}
+
+		// Every border cell was seeded above, so cells the neighbours queued only need them told to seed back.
+		for(u32 side = 0; side < 6; ++side)
+		{
+			for(u32 seam : m_pendingList[side])
+			{
+				m_seamList[side].push_back(seam & ~0xFFu);
+			}
+
+			m_pendingList[side].clear();
+		}
+
+		m_stats.computeTime = ElapsedMs(start);
+	}
+
+	// Relights around the given blocks, which pBlockList already holds the new state of. Light the old blocks gave out is taken back first,
+	//  stopping wherever a brighter source is found, and those sources then fill the gap back in.
+	void CChunkLight::Update(const Block* pBlockList, const AdjList& adjList, const u32* pIndexList, size_t count)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		m_stats.visitCount = 0;
+		ResetChanges();
+
+		const u32 strideI = m_data.length * m_data.height;
+		const u32 strideK = m_data.height;
+
+		for(CHANNEL channel : { CHANNEL_SKY, CHANNEL_BLOCK })
+		{
+			const u8 shift = CHANNEL_SHIFT[channel];
+
+			m_queue.clear();
+			m_removeQueue.clear();
+
+			for(size_t n = 0; n < count; ++n)
+			{
+				const u32 index = pIndexList[n];
+				const u8 level = GetLevel(index, shift);
+				if(level)
+				{
+					SetLevel(index, shift, 0);
+					m_removeQueue.push_back(index << 4 | level);
+				}
+			}
+
+			const size_t removedCount = m_removeQueue.size();
+			Retract(pBlockList, adjList, channel);
+
+			// The changed blocks themselves may now emit, or let light in from around them. Those that were taken back were already seeded
+			//  from the neighbours that didn't take their light from them, and lead the remove queue in the same order.
+			size_t removed = 0;
+			for(size_t n = 0; n < count; ++n)
+			{
+				const u32 index = pIndexList[n];
+				const bool bRemoved = removed < removedCount && (m_removeQueue[removed] >> 4) == index;
+				if(bRemoved) ++removed;
+
+				if(channel == CHANNEL_BLOCK)
+				{
+					const u8 emission = GetEmission(pBlockList, index);
+					if(emission > GetLevel(index, shift))
+					{
+						SetLevel(index, shift, emission);
+						m_queue.push_back(index);
+					}
+				}
+
+				if(IsOpaque(pBlockList, index)) continue;
+
+				u32 i, j, k;
+				j = index % m_data.height;
+				k = (index / m_data.height) % m_data.length;
+				i = index / strideI;
+
+				if(i > 0 && GetLevel(index - strideI, shift)) m_queue.push_back(index - strideI);
+				if(i < m_data.width - 1 && GetLevel(index + strideI, shift)) m_queue.push_back(index + strideI);
+				if(j > 0 && GetLevel(index - 1, shift)) m_queue.push_back(index - 1);
+				if(j < m_data.height - 1 && GetLevel(index + 1, shift)) m_queue.push_back(index + 1);
+				if(k > 0 && GetLevel(index - strideK, shift)) m_queue.push_back(index - strideK);
+				if(k < m_data.length - 1 && GetLevel(index + strideK, shift)) m_queue.push_back(index + strideK);
+
+				if(!bRemoved && (i == 0 || i == m_data.width - 1 || j == 0 || j == m_data.height - 1 || k == 0 || k == m_data.length - 1) &&
+					Seed(pBlockList, adjList, index, channel))
+				{
+					m_queue.push_back(index);
+				}
+			}
+
+			Propagate(pBlockList, channel);
+		}
+
+		m_stats.updateTime = ElapsedMs(start);
+	}
+
+	// Relights around the border cells the neighbours queued, once their new light is published. Cells lit from the old light are taken back
+	//  as they are around an edited block, without recomputing the rest of the chunk, and every queued cell then seeds from the new light.
+	void CChunkLight::Relight(const Block* pBlockList, const AdjList& adjList)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		m_stats.visitCount = 0;
+		ResetChanges();
+
+		for(CHANNEL channel : { CHANNEL_SKY, CHANNEL_BLOCK })
+		{
+			const u8 shift = CHANNEL_SHIFT[channel];
+
+			m_queue.clear();
+			m_removeQueue.clear();
+
+			for(u32 side = 0; side < 6; ++side)
+			{
+				for(u32 seam : m_pendingList[side])
+				{
+					const u32 sliceIndex = seam >> 8;
+					const u8 level = (seam >> shift) & 0xF;
+
+					u8 adjLevel;
+					if(adjList[side])
+					{
+						adjLevel = (adjList[side]->m_lightList[side ^ 1][sliceIndex] >> shift) & 0xF;
+					}
+					else
+					{
+						adjLevel = channel == CHANNEL_SKY && side == SIDE_TOP ? LIGHT_MAX : 0;
+					}
+
+					if(adjLevel >= level) continue;
+
+					if(TakeBack(pBlockList, GetBorderIndex(static_cast<SIDE>(side), sliceIndex), channel, level, side == SIDE_TOP))
+					{ // The neighbour left this cell's light alone while taking back its own, so it's told to seed from it again.
+						m_seamList[side].push_back(sliceIndex << 8);
+					}
+				}
+			}
+
+			Retract(pBlockList, adjList, channel);
+
+			for(u32 side = 0; side < 6; ++side)
+			{
+				for(u32 seam : m_pendingList[side])
+				{
+					const u32 index = GetBorderIndex(static_cast<SIDE>(side), seam >> 8);
+					if(Seed(pBlockList, adjList, index, channel))
+					{
+						m_queue.push_back(index);
+					}
+				}
+			}
+
+			Propagate(pBlockList, channel);
+		}
+
+		for(u32 side = 0; side < 6; ++side)
+		{
+			m_pendingList[side].clear();
+		}
+
+		m_stats.updateTime = ElapsedMs(start);
+	}
+
+	// Builds the border slices, and adds the cells that differ from the last published slices to the seam lists. Returns the SIDE_FLAGs of faces
+	//  with anything in their seam list, so those neighbours can relight.
+	u8 CChunkLight::Publish()
+	{
+		auto pSlices = std::make_shared<Slices>();
+		const std::shared_ptr<const Slices> pPrev = m_slices.load(std::memory_order_acquire);
+
+		const u32 strideList[6] = { m_data.height, m_data.height, m_data.width, m_data.width, m_data.width, m_data.width };
+		const u32 sizeList[6] = {
+			m_data.height * m_data.length, m_data.height * m_data.length,
+			m_data.width * m_data.length, m_data.width * m_data.length,
+			m_data.width * m_data.height, m_data.width * m_data.height,
+		};
+
+		for(u32 side = 0; side < 6; ++side)
+		{
+			pSlices->m_strideList[side] = strideList[side];
+			pSlices->m_lightList[side].resize(sizeList[side]);
+		}
+
+		const u32 strideI = m_data.length * m_data.height;
+		const u32 strideK = m_data.height;
+
+		for(u32 k = 0; k < m_data.length; ++k)
+		{
+			for(u32 j = 0; j < m_data.height; ++j)
+			{
+				pSlices->m_lightList[SIDE_LEFT][k * strideList[SIDE_LEFT] + j] = m_lightList[k * strideK + j];
+				pSlices->m_lightList[SIDE_RIGHT][k * strideList[SIDE_RIGHT] + j] = m_lightList[(m_data.width - 1) * strideI + k * strideK + j];
+			}
+		}
+
+		for(u32 i = 0; i < m_data.width; ++i)
+		{
+			for(u32 k = 0; k < m_data.length; ++k)
+			{
+				pSlices->m_lightList[SIDE_BOTTOM][k * strideList[SIDE_BOTTOM] + i] = m_lightList[i * strideI + k * strideK];
+				pSlices->m_lightList[SIDE_TOP][k * strideList[SIDE_TOP] + i] = m_lightList[i * strideI + k * strideK + m_data.height - 1];
+			}
+
+			for(u32 j = 0; j < m_data.height; ++j)
+			{
+				pSlices->m_lightList[SIDE_BACK][j * strideList[SIDE_BACK] + i] = m_lightList[i * strideI + j];
+				pSlices->m_lightList[SIDE_FRONT][j * strideList[SIDE_FRONT] + i] = m_lightList[i * strideI + (m_data.length - 1) * strideK + j];
+			}
+		}
+
+		u8 changedMask = 0;
+		for(u32 side = 0; side < 6; ++side)
+		{
+			const std::vector<u8>& lightList = pSlices->m_lightList[side];
+			for(u32 n = 0; n < lightList.size(); ++n)
+			{
+				// Until the first publish, the neighbour below lights from open sky, and the others from darkness.
+				u8 prev = side == SIDE_BOTTOM ? LIGHT_MAX << CHANNEL_SHIFT[CHANNEL_SKY] : 0;
+				if(pPrev) prev = pPrev->m_lightList[side][n];
+				if(lightList[n] != prev)
+				{
+					m_seamList[side].push_back(n << 8 | prev);
+				}
+			}
+
+			if(pPrev == nullptr || !m_seamList[side].empty())
+			{
+				changedMask |= 1 << side;
+			}
+		}
+
+		m_slices.store(std::move(pSlices), std::memory_order_release);
+		return changedMask;
+	}
+
+	// Queues border cells on the side that the neighbour across changed, for the next relight.
+	void CChunkLight::QueueSeam(SIDE side, const std::vector<u32>& seamList)
+	{
+		m_pendingList[side].insert(m_pendingList[side].end(), seamList.begin(), seamList.end());
+	}
+
+	void CChunkLight::Release()
+	{
+		m_lightList.clear();
+		m_lightListPrev.clear();
+		m_queue.clear();
+		m_removeQueue.clear();
+
+		for(u32 side = 0; side < 6; ++side)
+		{
+			m_seamList[side].clear();
+			m_pendingList[side].clear();
+		}
+
+		m_slices.store(nullptr, std::memory_order_release);
+	}
+
+	// Raises a border cell to the light coming in through the faces it shares with neighbours. A missing top neighbour is open sky.
+	// If the cell's light of removedLevel was just taken back, neighbours that could have been lit from it are skipped, as they're still to
+	//  take that light back themselves.
+	bool CChunkLight::Seed(const Block* pBlockList, const AdjList& adjList, u32 index, CHANNEL channel, u8 removedLevel)
+	{
+		if(IsOpaque(pBlockList, index)) return false;
+
+		const u8 shift = CHANNEL_SHIFT[channel];
+
+		u32 i, j, k;
+		j = index % m_data.height;
+		k = (index / m_data.height) % m_data.length;
+		i = index / (m_data.length * m_data.height);
+
+		u8 level = 0;
+		auto Incoming = [&](SIDE side, u32 u, u32 v){
+			u8 adjLevel;
+			if(adjList[side])
+			{
+				adjLevel = (adjList[side]->Get(static_cast<SIDE>(side ^ 1), u, v) >> shift) & 0xF;
+			}
+			else
+			{
+				adjLevel = channel == CHANNEL_SKY && side == SIDE_TOP ? LIGHT_MAX : 0;
+			}
+
+			if(adjLevel < removedLevel || (channel == CHANNEL_SKY && side == SIDE_BOTTOM && removedLevel == LIGHT_MAX && adjLevel == LIGHT_MAX))
+			{
+				return;
+			}
+
+			if(channel == CHANNEL_SKY && side == SIDE_TOP && adjLevel == LIGHT_MAX)
+			{
+				level = LIGHT_MAX;
+			}
+			else if(adjLevel > 1)
+			{
+				level = std::max(level, static_cast<u8>(adjLevel - 1));
+			}
+		};
+
+		if(i == 0) Incoming(SIDE_LEFT, j, k);
+		if(i == m_data.width - 1) Incoming(SIDE_RIGHT, j, k);
+		if(j == 0) Incoming(SIDE_BOTTOM, i, k);
+		if(j == m_data.height - 1) Incoming(SIDE_TOP, i, k);
+		if(k == 0) Incoming(SIDE_BACK, i, j);
+		if(k == m_data.length - 1) Incoming(SIDE_FRONT, i, j);
+
+		if(level <= GetLevel(index, shift)) return false;
+
+		SetLevel(index, shift, level);
+		return true;
+	}
+
+	// Darkens a cell lit from a neighbour of the given level, queueing it for removal. A cell lit by something else is queued to refill the
+	//  removed area instead. Returns true if the cell was darkened.
+	bool CChunkLight::TakeBack(const Block* pBlockList, u32 index, CHANNEL channel, u8 level, bool bDown)
+	{
+		const u8 shift = CHANNEL_SHIFT[channel];
+		const u8 cellLevel = GetLevel(index, shift);
+		if(cellLevel == 0) return false;
+
+		if(cellLevel >= level && !(channel == CHANNEL_SKY && bDown && level == LIGHT_MAX && cellLevel == LIGHT_MAX))
+		{
+			m_queue.push_back(index);
+			return false;
+		}
+
+		SetLevel(index, shift, 0);
+		m_removeQueue.push_back(index << 4 | cellLevel);
+
+		if(channel == CHANNEL_BLOCK)
+		{ // Emitters keep their own light, and spread it again once the removal is done.
+			const u8 emission = GetEmission(pBlockList, index);
+			if(emission)
+			{
+				SetLevel(index, shift, emission);
+				m_queue.push_back(index);
+			}
+		}
+
+		return true;
+	}
+
+	// Breadth first removal of one channel from every cell in the remove queue. Cells it reaches on the border seed again from the neighbours
+	//  across that can't have been lit from them, and the rest are left to the neighbours, which see the cells dim once this side publishes.
+	void CChunkLight::Retract(const Block* pBlockList, const AdjList& adjList, CHANNEL channel)
+	{
+		const u32 strideI = m_data.length * m_data.height;
+		const u32 strideK = m_data.height;
+
+		for(size_t head = 0; head < m_removeQueue.size(); ++head)
+		{
+			const u32 index = m_removeQueue[head] >> 4;
+			const u8 level = m_removeQueue[head] & 0xF;
+			++m_stats.visitCount;
+
+			u32 i, j, k;
+			j = index % m_data.height;
+			k = (index / m_data.height) % m_data.length;
+			i = index / strideI;
+
+			if(i > 0) TakeBack(pBlockList, index - strideI, channel, level, false);
+			if(i < m_data.width - 1) TakeBack(pBlockList, index + strideI, channel, level, false);
+			if(j > 0) TakeBack(pBlockList, index - 1, channel, level, true);
+			if(j < m_data.height - 1) TakeBack(pBlockList, index + 1, channel, level, false);
+			if(k > 0) TakeBack(pBlockList, index - strideK, channel, level, false);
+			if(k < m_data.length - 1) TakeBack(pBlockList, index + strideK, channel, level, false);
+
+			if((i == 0 || i == m_data.width - 1 || j == 0 || j == m_data.height - 1 || k == 0 || k == m_data.length - 1) &&
+				Seed(pBlockList, adjList, index, channel, level))
+			{
+				m_queue.push_back(index);
+			}
+		}
+	}
+
+	// Breadth first spread of one channel from every cell in the queue.
+	void CChunkLight::Propagate(const Block* pBlockList, CHANNEL channel)
+	{
+		const u8 shift = CHANNEL_SHIFT[channel];
+		const u32 strideI = m_data.length * m_data.height;
+		const u32 strideK = m_data.height;
+
+		for(size_t head = 0; head < m_queue.size(); ++head)
+		{
+			const u32 index = m_queue[head];
+			const u8 level = GetLevel(index, shift);
+			++m_stats.visitCount;
+			if(level <= 1) continue;
+
+			u32 i, j, k;
+			j = index % m_data.height;
+			k = (index / m_data.height) % m_data.length;
+			i = index / strideI;
+
+			auto Spread = [&](u32 adjIndex, u8 adjLevel){
+				if(adjLevel <= GetLevel(adjIndex, shift) || IsOpaque(pBlockList, adjIndex)) return;
+				SetLevel(adjIndex, shift, adjLevel);
+				m_queue.push_back(adjIndex);
+			};
+
+			const u8 sideLevel = level - 1;
+			if(i > 0) Spread(index - strideI, sideLevel);
+			if(i < m_data.width - 1) Spread(index + strideI, sideLevel);
+			if(j > 0) Spread(index - 1, channel == CHANNEL_SKY && level == LIGHT_MAX ? LIGHT_MAX : sideLevel);
+			if(j < m_data.height - 1) Spread(index + 1, sideLevel);
+			if(k > 0) Spread(index - strideK, sideLevel);
+			if(k < m_data.length - 1) Spread(index + strideK, sideLevel);
+		}
+
+		m_queue.clear();
+	}
+
+	// Index of the cell on the side's face at the given index into its slice.
+	u32 CChunkLight::GetBorderIndex(SIDE side, u32 sliceIndex) const
+	{
+		const u32 strideI = m_data.length * m_data.height;
+		const u32 strideK = m_data.height;
+
+		switch(side)
+		{
+			case SIDE_LEFT: return sliceIndex;
+			case SIDE_RIGHT: return (m_data.width - 1) * strideI + sliceIndex;
+			case SIDE_BOTTOM: return (sliceIndex % m_data.width) * strideI + (sliceIndex / m_data.width) * strideK;
+			case SIDE_TOP: return (sliceIndex % m_data.width) * strideI + (sliceIndex / m_data.width) * strideK + m_data.height - 1;
+			case SIDE_BACK: return (sliceIndex % m_data.width) * strideI + sliceIndex / m_data.width;
+			default: return (sliceIndex % m_data.width) * strideI + (m_data.length - 1) * strideK + sliceIndex / m_data.width;
+		}
+	}
+
+	// Also clears the seam lists, which a compute, update or relight fills through the publish that follows it.
+	void CChunkLight::ResetChanges()
+	{
+		m_changeMin = m_data.height;
+		m_changeMax = 0;
+
+		for(u32 side = 0; side < 6; ++side)
+		{
+			m_seamList[side].clear();
+		}
+	}
+};
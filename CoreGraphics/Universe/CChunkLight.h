@@ -0,0 +1,156 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkLight.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKLIGHT_H
+#define CCHUNKLIGHT_H
+
+#include "CChunkData.h"
+#include <Globals/CGlobals.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Universe
+{
+	// Sky and block light of every block in a chunk, packed as (sky << 4 | block), at full resolution. Sky light enters from the top and falls
+	//  straight down without fading, while both kinds lose a level per step sideways. Light only moves through blocks that aren't opaque.
+	// Light crosses seams through each neighbour's published border slices, which seed propagation on this side. Publishing also lists the
+	//  border cells that changed, which the neighbour across queues and relights around, taking back any light the cell no longer passes on.
+	class CChunkLight
+	{
+	public:
+		static constexpr u8 LIGHT_MAX = 15;
+
+		enum CHANNEL : u8
+		{
+			CHANNEL_SKY,
+			CHANNEL_BLOCK,
+		};
+
+		struct Data
+		{
+			u32 width;
+			u32 height;
+			u32 length;
+		};
+
+		struct Stats
+		{
+			u32 visitCount; // Cells dequeued by the last compute or update.
+			float computeTime; // Milliseconds spent in the last full compute.
+			float updateTime; // Milliseconds spent in the last incremental update.
+		};
+
+		// Immutable once published, with the same coordinates as CChunkBorder::Slices.
+		class Slices
+		{
+		public:
+			inline u8 Get(SIDE side, u32 u, u32 v) const { return m_lightList[side][v * m_strideList[side] + u]; }
+
+		private:
+			friend class CChunkLight;
+
+			u32 m_strideList[6];
+			std::vector<u8> m_lightList[6];
+		};
+
+		typedef std::shared_ptr<const Slices> AdjList[6];
+
+	public:
+		CChunkLight();
+		~CChunkLight();
+		CChunkLight(const CChunkLight&) = delete;
+		CChunkLight(CChunkLight&&) = delete;
+		CChunkLight& operator = (const CChunkLight&) = delete;
+		CChunkLight& operator = (CChunkLight&&) = delete;
+
+		void Initialize();
+		void Compute(const Block* pBlockList, const AdjList& adjList);
+		void Update(const Block* pBlockList, const AdjList& adjList, const u32* pIndexList, size_t count);
+		void Relight(const Block* pBlockList, const AdjList& adjList);
+		u8 Publish();
+		void QueueSeam(SIDE side, const std::vector<u32>& seamList);
+		void Release();
+
+		// Accessors.
+		inline u8 Get(u32 index) const { return m_lightList[index]; }
+		inline const Stats& GetStats() const { return m_stats; }
+		inline std::shared_ptr<const Slices> Acquire() const { return m_slices.load(std::memory_order_acquire); }
+
+		// Border cells on the side that changed in the last publish, as (slice index << 8 | light before), for the neighbour to queue.
+		inline const std::vector<u32>& GetSeamList(SIDE side) const { return m_seamList[side]; }
+
+		inline bool IsSeamPending() const
+		{
+			for(const std::vector<u32>& pendingList : m_pendingList)
+			{
+				if(!pendingList.empty()) return true;
+			}
+
+			return false;
+		}
+
+		// Rows (inclusive) whose light changed in the last compute or update. Returns false if nothing changed.
+		inline bool GetChangedRows(u32& jMin, u32& jMax) const
+		{
+			jMin = m_changeMin;
+			jMax = m_changeMax;
+			return m_changeMin <= m_changeMax;
+		}
+
+		static inline u8 GetSky(u8 light) { return light >> 4; }
+		static inline u8 GetBlock(u8 light) { return light & 0xF; }
+
+		// Modifiers.
+		inline void SetData(const Data& data) { m_data = data; }
+
+	private:
+		inline u8 GetLevel(u32 index, u8 shift) const { return (m_lightList[index] >> shift) & 0xF; }
+
+		inline void SetLevel(u32 index, u8 shift, u8 level)
+		{
+			m_lightList[index] = (m_lightList[index] & ~(0xF << shift)) | (level << shift);
+
+			const u32 j = index % m_data.height;
+			m_changeMin = std::min(m_changeMin, j);
+			m_changeMax = std::max(m_changeMax, j);
+		}
+
+		bool Seed(const Block* pBlockList, const AdjList& adjList, u32 index, CHANNEL channel, u8 removedLevel = 0);
+		bool TakeBack(const Block* pBlockList, u32 index, CHANNEL channel, u8 level, bool bDown);
+		void Retract(const Block* pBlockList, const AdjList& adjList, CHANNEL channel);
+		void Propagate(const Block* pBlockList, CHANNEL channel);
+		u32 GetBorderIndex(SIDE side, u32 sliceIndex) const;
+		void ResetChanges();
+
+	private:
+		Data m_data;
+		Stats m_stats;
+
+		u32 m_changeMin;
+		u32 m_changeMax;
+
+		std::vector<u8> m_lightList;
+		std::vector<u8> m_lightListPrev;
+
+		// Cells to spread light from, and (index << 4 | level) of cells whose light is being taken back.
+		std::vector<u32> m_queue;
+		std::vector<u32> m_removeQueue;
+
+		// Border cells changed by the last publish, and those the neighbours changed that are yet to be relit, per side.
+		std::vector<u32> m_seamList[6];
+		std::vector<u32> m_pendingList[6];
+
+		std::atomic<std::shared_ptr<const Slices>> m_slices;
+	};
+};
+
+#endif
@@ -14,18 +14,32 @@
 #include "../Graphics/CMaterial.h"
 #include "../Graphics/CShader.h"
 #include "../Graphics/CRootSignature.h"
+#include "../Graphics/CRenderingSystem.h"
 #include "../Factory/CFactory.h"
 #include "../Resources/CResourceManager.h"
 #include <Application/CCommandManager.h>
+#include <Utilities/CAllocTracker.h>
 #include <Utilities/CMemoryFree.h>
+#include <Utilities/CFileSystem.h>
 #include <Math/CMathFNV.h>
+#include <algorithm>
+#include <thread>
+#include <tuple>
 
 namespace Universe
 {
 	CChunkManager::CChunkManager() : 
 		CVObject(L"Chunk Manager"),
+		m_bMeshletCulling(true),
+		m_bRecordCameraPath(false),
+		m_meshletStats{ },
 		m_pMaterial(nullptr),
-		m_pMaterialWire(nullptr)
+		m_pMaterialTranslucent(nullptr),
+		m_pMaterialWire(nullptr),
+		m_pResidentMetric(Util::CMetrics::Instance().GetGauge("chunks.resident")),
+		m_pMeshingMetric(Util::CMetrics::Instance().GetGauge("chunks.meshing")),
+		m_pPendingMetric(Util::CMetrics::Instance().GetGauge("chunks.rebuildPending")),
+		m_pBuildMetric(Util::CMetrics::Instance().GetCounter("chunks.sectionBuilds"))
 	{
 	}
 
@@ -38,6 +52,7 @@ namespace Universe
 		SetViewHash(m_data.viewHash);
 
 		m_pMaterial = reinterpret_cast<Graphics::CMaterial*>(Resources::CManager::Instance().GetResource(Resources::RESOURCE_TYPE_MATERIAL, Math::FNV1a_64("MATERIAL_VOXEL")));
+		m_pMaterialTranslucent = reinterpret_cast<Graphics::CMaterial*>(Resources::CManager::Instance().GetResource(Resources::RESOURCE_TYPE_MATERIAL, Math::FNV1a_64("MATERIAL_VOXEL_TRANSLUCENT")));
 		m_pMaterialWire = reinterpret_cast<Graphics::CMaterial*>(Resources::CManager::Instance().GetResource(Resources::RESOURCE_TYPE_MATERIAL, Math::FNV1a_64("MATERIAL_VOXELWIRE")));
 
 		{ // Setup commands.
@@ -47,20 +62,37 @@ namespace Universe
 
 			App::CCommandManager::Instance().RegisterCommand(CMD_KEY_BLOCK_EDIT, std::bind(&CChunkManager::BlockEdit, this, std::placeholders::_1, std::placeholders::_2), props);
 		}
+
+		m_occlusion.Initialize();
+
+		{ // Setup the mesh cache. Entries are keyed by content, so one cache is shared by every project.
+			const std::wstring& dataPath = Util::CFileSystem::Instance().GetDataPath();
+			if(!dataPath.empty())
+			{
+				CChunkMeshCache::Data data { };
+				data.directory = dataPath + L"/Starshade/MeshCache";
+				m_meshCache.SetData(data);
+				m_meshCache.Initialize();
+			}
+		}
 	}
 	
 	void CChunkManager::Update()
 	{
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_CHUNK);
+
 		static const u32 frameBufferHash = Math::FNV1a_32("DrawBuffer");
 		static const u32 viewHash = Math::FNV1a_32("View");
 		static const u32 projHash = Math::FNV1a_32("Proj");
-		static const u32 worldHash = Math::FNV1a_32("World");
 		static const u32 texHash = Math::FNV1a_32("diffuse_texture");
 
 		m_pMaterial->SetFloat(frameBufferHash, viewHash, App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetViewMatrixInv().f32, 16);
 		m_pMaterial->SetFloat(frameBufferHash, projHash, App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetProjectionMatrix().f32, 16);
 		m_pMaterial->SetTexture(texHash, m_pTexture);
-		m_pMaterial->SetFloat(frameBufferHash, worldHash, Math::SIMD_MTX4X4_IDENTITY.f32, 16);
+
+		m_pMaterialTranslucent->SetFloat(frameBufferHash, viewHash, App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetViewMatrixInv().f32, 16);
+		m_pMaterialTranslucent->SetFloat(frameBufferHash, projHash, App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetProjectionMatrix().f32, 16);
+		m_pMaterialTranslucent->SetTexture(texHash, m_pTexture);
 		
 		/*m_pMaterialWire->SetFloat(frameBufferHash, viewHash, App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetViewMatrix().f32, 16);
 		m_pMaterialWire->SetFloat(frameBufferHash, projHash, App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetProjectionMatrix().f32, 16);
@@ -70,15 +102,67 @@ namespace Universe
 	
 	void CChunkManager::LateUpdate()
 	{
-		while(!m_updateQueue.empty())
+		Util::CAllocTracker::Scope allocScope(Util::ALLOC_TAG_CHUNK);
+
+		if(m_lodPolicy.IsEnabled())
+		{ // Select LOD levels before draining the update queue so that any transitions start rebuilding this frame.
+			m_lodPolicy.Begin(App::CSceneManager::Instance().CameraManager().GetDefaultCamera());
+
+			for(auto& node : m_chunkMap)
+			{
+				for(auto& chunk : node.second)
+				{
+					m_lodPolicy.Evaluate(chunk.second);
+				}
+			}
+
+			m_lodPolicy.Apply();
+		}
+
+		// Chunks are prioritized by last frame's visibility, as this frame's cull waits on the updates below.
+		m_rebuildScheduler.Dispatch(App::CSceneManager::Instance().CameraManager().GetDefaultCamera(), m_renderList);
+
+		{ // Publish metrics.
+			size_t residentCount = 0;
+			for(const auto& node : m_chunkMap)
+			{
+				residentCount += node.second.size();
+			}
+
+			const CChunkRebuildScheduler::Stats& stats = m_rebuildScheduler.GetStats();
+			m_pResidentMetric->Set(residentCount);
+			m_pMeshingMetric->Set(stats.meshingCount);
+			m_pPendingMetric->Set(stats.pendingCount);
+			m_pBuildMetric->Add(stats.dispatchCount);
+		}
+
+		if(m_culler.IsDirty())
 		{
-			m_updateQueue.front()->LateUpdate();
-			m_updateQueue.pop();
+			std::vector<CChunk*> chunkList;
+			for(auto& node : m_chunkMap)
+			{
+				for(auto& chunk : node.second)
+				{
+					chunkList.push_back(chunk.second);
+				}
+			}
+
+			m_culler.Build(chunkList.data(), chunkList.size());
 		}
 
-		for(auto& node : m_chunkMap)
+		const Logic::CCamera* pCamera = App::CSceneManager::Instance().CameraManager().GetDefaultCamera();
+		m_culler.Cull(pCamera);
+		m_renderList = m_culler.GetVisibleList();
+
+		if(m_bRecordCameraPath)
 		{
-			node.first->FrustumCulling();
+			m_cameraPath.push_back(CChunkMeshlets::CameraSample::FromCamera(pCamera));
+		}
+
+		if(m_occlusion.IsEnabled())
+		{ // Reject frustum visible chunks hidden behind the solid faces of nearer chunks.
+			m_occlusion.Begin(pCamera->GetViewMatrix() * pCamera->GetProjectionMatrix());
+			m_occlusion.Cull(m_renderList, *(Math::Vector3*)pCamera->GetTransform()->GetPosition().ToFloat());
 		}
 	}
 
@@ -89,10 +173,54 @@ namespace Universe
 
 		m_pMaterial->GetShader()->GetRootSignature()->Bind();
 
-		while(!m_renderQueue.empty())
+		if(m_bMeshletCulling)
+		{ // Opaque clusters facing away from the camera, or outside of the frustum, are skipped within each visible chunk.
+			const CChunkMeshlets::CameraSample camera = CChunkMeshlets::CameraSample::FromCamera(App::CSceneManager::Instance().CameraManager().GetDefaultCamera());
+			m_meshletStats = { };
+
+			for(CChunk* pChunk : m_renderList)
+			{
+				pChunk->CullMeshlets(camera, m_meshletStats);
+				pChunk->RenderMeshlets();
+			}
+		}
+		else
 		{
-			m_renderQueue.front()->ForceRender(0);
-			m_renderQueue.pop();
+			for(CChunk* pChunk : m_renderList)
+			{
+				pChunk->ForceRender(CHUNK_MATERIAL_OPAQUE);
+			}
+		}
+	}
+
+	// Translucent ranges are drawn per section, farthest first, after all opaque geometry.
+	void CChunkManager::RenderTranslucent(u32 viewHash, const Math::SIMDVector& camPos)
+	{
+		if(m_chunkMap.empty() || m_chunkMap.begin()->first->GetViewHash() != viewHash) return;
+
+		m_translucentList.clear();
+		for(CChunk* pChunk : m_renderList)
+		{
+			for(u32 s = 0; s < pChunk->GetSectionCount(); ++s)
+			{
+				if(pChunk->HasTranslucentSection(s))
+				{
+					m_translucentList.push_back({ pChunk, s, pChunk->GetSectionCenter(s) });
+				}
+			}
+		}
+
+		if(m_translucentList.empty()) return;
+
+		Graphics::CRenderingSystem::SortBackToFront(camPos, m_translucentList, [](const TranslucentSection& section){
+			return Math::SIMDVector(section.center.x, section.center.y, section.center.z);
+		});
+
+		m_pMaterialTranslucent->GetShader()->GetRootSignature()->Bind();
+
+		for(const TranslucentSection& section : m_translucentList)
+		{
+			section.pChunk->RenderSection(section.section, CHUNK_MATERIAL_TRANSLUCENT);
 		}
 	}
 
@@ -105,8 +233,59 @@ namespace Universe
 				SAFE_RELEASE_DELETE(chunk.second);
 			}
 		}
+
+		m_rebuildScheduler.Release();
+		m_culler.Release();
+		m_occlusion.Release();
+		m_renderList.clear();
+		m_translucentList.clear();
 	}
 	
+	// Frustum culls the node's chunks for each sample, then rejects those hidden behind nearer chunks if 'bOcclusion' is set, as LateUpdate
+	//  would. Each sample's visible chunk coordinates are sorted, so the sets can be compared between runs.
+	void CChunkManager::MeasureOcclusion(const class CChunkNode* pChunkNode, const std::vector<CChunkMeshlets::CameraSample>& cameraPath, bool bOcclusion,
+		std::vector<std::vector<Math::VectorInt3>>& visibleList)
+	{
+		visibleList.clear();
+		visibleList.resize(cameraPath.size());
+
+		auto node = m_chunkMap.find(pChunkNode);
+		if(node == m_chunkMap.end()) return;
+
+		std::vector<CChunk*> chunkList;
+		for(size_t i = 0; i < cameraPath.size(); ++i)
+		{
+			const CChunkMeshlets::CameraSample& camera = cameraPath[i];
+
+			chunkList.clear();
+			for(auto& chunk : node->second)
+			{
+				Math::Vector3 mn, mx;
+				chunk.second->GetBounds(mn, mx);
+				if(CChunkMeshlets::IsBoxVisible(mn, mx, camera.planeList))
+				{
+					chunkList.push_back(chunk.second);
+				}
+			}
+
+			if(bOcclusion)
+			{
+				m_occlusion.Begin(camera.viewProj);
+				m_occlusion.Cull(chunkList, camera.position);
+			}
+
+			std::vector<Math::VectorInt3>& coordList = visibleList[i];
+			for(const CChunk* pChunk : chunkList)
+			{
+				coordList.push_back(pChunk->GetChunkCoord());
+			}
+
+			std::sort(coordList.begin(), coordList.end(), [](const Math::VectorInt3& a, const Math::VectorInt3& b){
+				return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+			});
+		}
+	}
+
 	//-----------------------------------------------------------------------------------------------
 	// Chunk methods.
 	//-----------------------------------------------------------------------------------------------
@@ -130,6 +309,7 @@ namespace Universe
 			}
 
 			node->second.insert({ chunkCoord, pChunk });
+			InvalidateVisibility();
 			return pChunk;
 		}
 
@@ -146,7 +326,9 @@ namespace Universe
 		{
 			auto pChunk = chunk->second;
 			node->second.erase(chunk);
+			m_rebuildScheduler.Remove(pChunk);
 			SAFE_RELEASE_DELETE(pChunk);
+			InvalidateVisibility();
 			return true;
 		}
 
@@ -161,10 +343,12 @@ namespace Universe
 		for(auto& chunk : node->second)
 		{
 			auto pChunk = chunk.second;
+			m_rebuildScheduler.Remove(pChunk);
 			SAFE_RELEASE_DELETE(pChunk);
 		}
 
 		m_chunkMap.erase(node);
+		InvalidateVisibility();
 		return true;
 	}
 	
@@ -216,6 +400,90 @@ namespace Universe
 		return node->second.begin()->second->GetLODLevel();
 	}
 
+	// Lets a frame end with the chunks in the same state however the job threads were scheduled, for the headless runner's lockstep mode.
+	void CChunkManager::Flush()
+	{
+		const Logic::CCamera* pCamera = App::CSceneManager::Instance().CameraManager().GetDefaultCamera();
+
+		while(m_rebuildScheduler.GetQueuedCount())
+		{
+			m_rebuildScheduler.Dispatch(pCamera, m_renderList);
+			m_pBuildMetric->Add(m_rebuildScheduler.GetStats().dispatchCount);
+
+			if(m_rebuildScheduler.GetQueuedCount())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	// Blocky and smooth meshing of every chunk in the node, summed, so both surfaces are measured on exactly the same blocks.
+	CChunk::SurfaceBenchmark CChunkManager::BenchmarkSurfaces(const class CChunkNode* pChunkNode, u32 iterationCount)
+	{
+		CChunk::SurfaceBenchmark total { };
+
+		auto node = m_chunkMap.find(pChunkNode);
+		if(node == m_chunkMap.end()) return total;
+
+		for(auto& chunk : node->second)
+		{
+			const CChunk::SurfaceBenchmark benchmark = chunk.second->BenchmarkSurfaces(iterationCount);
+			total.blockyTime += benchmark.blockyTime;
+			total.smoothTime += benchmark.smoothTime;
+			total.blockyTriangleCount += benchmark.blockyTriangleCount;
+			total.smoothTriangleCount += benchmark.smoothTriangleCount;
+			CChunkMeshOptimizer::Accumulate(total.blockyStats, benchmark.blockyStats);
+			CChunkMeshOptimizer::Accumulate(total.smoothStats, benchmark.smoothStats);
+		}
+
+		return total;
+	}
+
+	// Totals the light benchmark of every chunk in the node, with each chunk editing 'editCount' of its own columns.
+	CChunk::LightBenchmark CChunkManager::BenchmarkLight(const class CChunkNode* pChunkNode, u32 editCount)
+	{
+		CChunk::LightBenchmark total { };
+
+		auto node = m_chunkMap.find(pChunkNode);
+		if(node == m_chunkMap.end()) return total;
+
+		for(auto& chunk : node->second)
+		{
+			const CChunk::LightBenchmark benchmark = chunk.second->BenchmarkLight(editCount);
+			total.computeTime += benchmark.computeTime;
+			total.updateTime += benchmark.updateTime;
+			total.computeVisitCount += benchmark.computeVisitCount;
+			total.updateVisitCount += benchmark.updateVisitCount;
+			total.updateCount += benchmark.updateCount;
+		}
+
+		return total;
+	}
+
+	// Runs the cluster cull, without drawing, for every chunk inside the frustum of each sample, and totals the results.
+	//  Only needs built meshes, so it works the same with or without a device.
+	CChunkMeshlets::Stats CChunkManager::MeasureMeshletCulling(const std::vector<CChunkMeshlets::CameraSample>& cameraPath)
+	{
+		CChunkMeshlets::Stats stats { };
+
+		for(const CChunkMeshlets::CameraSample& camera : cameraPath)
+		{
+			for(auto& node : m_chunkMap)
+			{
+				for(auto& chunk : node.second)
+				{
+					Math::Vector3 mn, mx;
+					chunk.second->GetBounds(mn, mx);
+					if(!CChunkMeshlets::IsBoxVisible(mn, mx, camera.planeList)) continue;
+
+					chunk.second->CullMeshlets(camera, stats);
+				}
+			}
+		}
+
+		return stats;
+	}
+
 	//-----------------------------------------------------------------------------------------------
 	// Chunk methods.
 	//-----------------------------------------------------------------------------------------------
@@ -268,8 +536,12 @@ namespace Universe
 		data.height = pChunkNode->GetBlockCountY();
 		data.length = pChunkNode->GetBlockCountZ();
 		data.blockSize = pChunkNode->GetBlockSize();
+		data.meshOptimizeFlags = pChunkNode->GetMeshOptimizeFlags();
+		data.meshSurface = pChunkNode->GetMeshSurface();
+		data.lodLevelMax = pChunkNode->GetLODLevelMax();
 
 		data.matHash = Math::FNV1a_64("MATERIAL_VOXEL");;
+		data.matTranslucentHash = Math::FNV1a_64("MATERIAL_VOXEL_TRANSLUCENT");
 		data.matWireHash = Math::FNV1a_64("MATERIAL_VOXELWIRE");;
 
 		CChunk* pChunk = RegisterChunk(pChunkNode, chunkCoord, data, false);
@@ -12,12 +12,18 @@
 #define CCHUNKMANAGER_H
 
 #include "CChunk.h"
+#include "CChunkLODPolicy.h"
+#include "CChunkCuller.h"
+#include "CChunkOcclusion.h"
+#include "CChunkRebuildScheduler.h"
+#include "CChunkMeshCache.h"
 #include <Math/CMathVectorInt3.h>
 #include <Math/CMathFNV.h>
+#include <Math/CSIMDVector.h>
 #include <Objects/CVObject.h>
 #include <Logic/CTransform.h>
+#include <Utilities/CMetrics.h>
 #include <unordered_map>
-#include <queue>
 #include <cassert>
 #include <vector>
 
@@ -63,6 +69,13 @@ namespace Universe
 		};
 
 	private:
+		struct TranslucentSection
+		{
+			class CChunk* pChunk;
+			u32 section;
+			Math::Vector3 center;
+		};
+
 		struct ChunkKeyHasher
 		{
 			size_t operator()(const Math::VectorInt3& k) const
@@ -91,6 +104,7 @@ namespace Universe
 		void Update();
 		void LateUpdate();
 		void Render(u32 hash);
+		void RenderTranslucent(u32 hash, const Math::SIMDVector& camPos);
 		void Release();
 
 		bool ClearNode(const class CChunkNode* pChunkNode);
@@ -98,6 +112,15 @@ namespace Universe
 		u8 LODDown(const class CChunkNode* pChunkNode);
 		u8 LODUp(const class CChunkNode* pChunkNode);
 
+		// Dispatches until every queued edit is applied and every section build has finished, blocking the calling thread.
+		void Flush();
+
+		CChunk::SurfaceBenchmark BenchmarkSurfaces(const class CChunkNode* pChunkNode, u32 iterationCount);
+		CChunk::LightBenchmark BenchmarkLight(const class CChunkNode* pChunkNode, u32 editCount);
+		CChunkMeshlets::Stats MeasureMeshletCulling(const std::vector<CChunkMeshlets::CameraSample>& cameraPath);
+		void MeasureOcclusion(const class CChunkNode* pChunkNode, const std::vector<CChunkMeshlets::CameraSample>& cameraPath, bool bOcclusion,
+			std::vector<std::vector<Math::VectorInt3>>& visibleList);
+
 		// Accessors.
 		inline CChunk* GetChunk(const class CChunkNode* pChunkNode, const Math::VectorInt3& chunkCoord)
 		{
@@ -109,12 +132,24 @@ namespace Universe
 		}
 
 		inline std::unordered_map<Math::VectorInt3, CChunk*, ChunkKeyHasher>& GetChunkMap(const class CChunkNode* pNode) { return m_chunkMap.find(pNode)->second; }
+		inline CChunkLODPolicy& LODPolicy() { return m_lodPolicy; }
+		inline CChunkOcclusion& Occlusion() { return m_occlusion; }
+		inline CChunkRebuildScheduler& RebuildScheduler() { return m_rebuildScheduler; }
+		inline CChunkMeshCache& MeshCache() { return m_meshCache; }
+
+		inline bool IsMeshletCullingEnabled() const { return m_bMeshletCulling; }
+		inline const CChunkMeshlets::Stats& GetMeshletStats() const { return m_meshletStats; } // Opaque clusters drawn last frame.
+		inline const std::vector<CChunkMeshlets::CameraSample>& GetCameraPath() const { return m_cameraPath; }
 
 		// Modifiers.
 		inline void SetData(const Data& data) { m_data = data; }
 		inline void SetTexture(Graphics::CTexture* pTexture) { m_pTexture = pTexture; }
-		inline void QueueChunkUpdate(class CChunk* pChunk) { m_updateQueue.push(pChunk); }
-		inline void QueueChunkRender(class CChunk* pChunk) { m_renderQueue.push(pChunk); }
+		inline void QueueChunkUpdate(class CChunk* pChunk) { m_rebuildScheduler.Queue(pChunk); }
+		inline void SetMeshletCullingEnabled(bool bEnabled) { m_bMeshletCulling = bEnabled; }
+
+		// While recording, the default camera is sampled once a frame, for measuring culling against the same path later.
+		inline void SetCameraPathRecording(bool bRecording) { m_bRecordCameraPath = bRecording; }
+		inline void ClearCameraPath() { m_cameraPath.clear(); }
 		
 	private:
 		CChunk* RegisterChunk(const class CChunkNode* pChunkNode, const Math::VectorInt3& chunkCoord, const CChunk::Data& data, bool bInitIfNotFound = true);
@@ -122,19 +157,42 @@ namespace Universe
 
 		bool BlockEdit(const void* param, bool bInverse);
 
+		inline void InvalidateVisibility()
+		{
+			m_culler.MarkDirty();
+			m_renderList.clear();
+		}
+
 	public:
 		CChunk* CreateChunk(const class CChunkNode* pChunkNode, const Math::VectorInt3& chunkCoord, bool bBuild = true);
 
 	private:
 		Data m_data;
 
+		bool m_bMeshletCulling;
+		bool m_bRecordCameraPath;
+
 		std::unordered_map<const class CChunkNode*, std::unordered_map<Math::VectorInt3, CChunk*, ChunkKeyHasher>> m_chunkMap;
-		std::queue<class CChunk*> m_updateQueue;
-		std::queue<class CChunk*> m_renderQueue;
+		CChunkLODPolicy m_lodPolicy;
+		CChunkCuller m_culler;
+		CChunkOcclusion m_occlusion;
+		CChunkRebuildScheduler m_rebuildScheduler;
+		CChunkMeshCache m_meshCache;
+		std::vector<class CChunk*> m_renderList;
+		std::vector<TranslucentSection> m_translucentList;
+
+		CChunkMeshlets::Stats m_meshletStats;
+		std::vector<CChunkMeshlets::CameraSample> m_cameraPath;
 
 		Graphics::CMaterial* m_pMaterial;
+		Graphics::CMaterial* m_pMaterialTranslucent;
 		Graphics::CMaterial* m_pMaterialWire;
 		Graphics::CTexture* m_pTexture;
+
+		Util::CMetrics::Gauge* m_pResidentMetric;
+		Util::CMetrics::Gauge* m_pMeshingMetric;
+		Util::CMetrics::Gauge* m_pPendingMetric;
+		Util::CMetrics::Counter* m_pBuildMetric;
 	};
 };
 
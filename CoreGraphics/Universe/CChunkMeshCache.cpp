@@ -0,0 +1,307 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkMeshCache.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkMeshCache.h"
+#include <Utilities/CFileSystem.h>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+#ifdef PLATFORM_WINDOWS
+#include <Windows.h>
+#endif
+
+namespace Universe
+{
+	CChunkMeshCache::Entry::Entry() :
+		m_pView(nullptr),
+		m_hFile(nullptr),
+		m_hMapping(nullptr)
+	{
+	}
+
+	CChunkMeshCache::Entry::~Entry()
+	{
+		Release();
+	}
+
+	void CChunkMeshCache::Entry::Release()
+	{
+#ifdef PLATFORM_WINDOWS
+		if(m_hMapping)
+		{
+			UnmapViewOfFile(m_pView);
+			CloseHandle(m_hMapping);
+		}
+
+		if(m_hFile) CloseHandle(m_hFile);
+#endif
+
+		m_pView = nullptr;
+		m_hFile = m_hMapping = nullptr;
+		m_buffer.clear();
+	}
+
+	CChunkMeshCache::CChunkMeshCache() :
+		m_stats{ },
+		m_byteCount(0)
+	{
+	}
+
+	CChunkMeshCache::~CChunkMeshCache()
+	{
+	}
+
+	void CChunkMeshCache::Initialize()
+	{
+		if(!IsEnabled()) return;
+
+		if(!Util::CFileSystem::Instance().VerifyDirectory(m_data.directory.c_str()))
+		{
+			Util::CFileSystem::Instance().NewPath(m_data.directory.c_str());
+		}
+
+#ifdef PLATFORM_WINDOWS
+		{ // Index the entries already on disk, newest first, and remove any temporary files an interrupted store left behind.
+			struct Found
+			{
+				u64 key;
+				u64 size;
+				u64 writeTime;
+			};
+
+			std::vector<Found> foundList;
+
+			WIN32_FIND_DATAW findData;
+			HANDLE hFind = FindFirstFileW((m_data.directory + L"\\*").c_str(), &findData);
+			if(hFind != INVALID_HANDLE_VALUE)
+			{
+				do
+				{
+					if(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+
+					const std::wstring name = findData.cFileName;
+					if(name.size() > 4 && name.compare(name.size() - 4, 4, L".tmp") == 0)
+					{
+						Util::CFileSystem::Instance().RemoveFile((m_data.directory + L"\\" + name).c_str());
+						continue;
+					}
+
+					if(name.size() != 21 || name.compare(16, 5, L".mesh") != 0) continue;
+
+					u64 key = 0;
+					bool bValid = true;
+					for(size_t i = 0; i < 16 && bValid; ++i)
+					{
+						const wchar_t c = name[i];
+						if(c >= L'0' && c <= L'9') key = key << 4 | static_cast<u64>(c - L'0');
+						else if(c >= L'a' && c <= L'f') key = key << 4 | static_cast<u64>(c - L'a' + 10);
+						else bValid = false;
+					}
+
+					if(bValid)
+					{
+						const u64 size = static_cast<u64>(findData.nFileSizeHigh) << 32 | findData.nFileSizeLow;
+						const u64 writeTime = static_cast<u64>(findData.ftLastWriteTime.dwHighDateTime) << 32 | findData.ftLastWriteTime.dwLowDateTime;
+						foundList.push_back({ key, size, writeTime });
+					}
+				} while(FindNextFileW(hFind, &findData));
+
+				FindClose(hFind);
+			}
+
+			std::sort(foundList.begin(), foundList.end(), [](const Found& a, const Found& b){ return a.writeTime > b.writeTime; });
+
+			std::lock_guard<std::mutex> lk(m_mutex);
+			for(const Found& found : foundList)
+			{
+				m_lruList.push_back(found.key);
+				m_recordMap[found.key] = { found.size, std::prev(m_lruList.end()) };
+				m_byteCount += found.size;
+			}
+
+			// The budget may have shrunk since the last run.
+			Evict();
+		}
+#endif
+	}
+
+	// Maps the entry for key. Anything that doesn't match the key or is truncated counts as a miss.
+	bool CChunkMeshCache::Load(u64 key, Entry& entry)
+	{
+		entry.Release();
+		if(!IsEnabled()) return false;
+
+		const std::wstring path = GetPath(key);
+		u64 fileSize = 0;
+
+#ifdef PLATFORM_WINDOWS
+		HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if(hFile == INVALID_HANDLE_VALUE)
+		{
+			++m_stats.missCount;
+			return false;
+		}
+
+		LARGE_INTEGER size;
+		GetFileSizeEx(hFile, &size);
+		fileSize = static_cast<u64>(size.QuadPart);
+		entry.m_hFile = hFile;
+
+		if(fileSize >= sizeof(Header))
+		{
+			entry.m_hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if(entry.m_hMapping)
+			{
+				entry.m_pView = reinterpret_cast<const u8*>(MapViewOfFile(entry.m_hMapping, FILE_MAP_READ, 0, 0, 0));
+			}
+		}
+#else
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if(file.is_open())
+		{
+			fileSize = static_cast<u64>(file.tellg());
+			entry.m_buffer.resize(static_cast<size_t>(fileSize));
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(entry.m_buffer.data()), fileSize);
+			entry.m_pView = entry.m_buffer.data();
+		}
+#endif
+
+		bool bValid = entry.m_pView != nullptr && fileSize >= sizeof(Header);
+		if(bValid)
+		{
+			const Header& header = entry.GetHeader();
+			bValid = header.magic == MAGIC && header.version == VERSION && header.key == key && header.opaqueCount <= header.indexCount &&
+				fileSize == sizeof(Header) + sizeof(PackedChunkVertex) * static_cast<u64>(header.vertexCount) + sizeof(u32) * static_cast<u64>(header.indexCount);
+		}
+
+		if(!bValid)
+		{
+			entry.Release();
+			++m_stats.missCount;
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			Touch(key, fileSize);
+		}
+
+		++m_stats.hitCount;
+		return true;
+	}
+
+	// Written to a file private to this thread, then moved into place, so a reader never maps a partial entry.
+	void CChunkMeshCache::Store(u64 key, const PackedChunkVertex* pVertexList, u32 vertexCount, const u32* pIndexList, u32 indexCount, u32 opaqueCount)
+	{
+		if(!IsEnabled()) return;
+
+		const std::wstring path = GetPath(key);
+		const std::wstring tempPath = path + L"." + std::to_wstring(std::hash<std::thread::id>()(std::this_thread::get_id())) + L".tmp";
+
+		const u64 fileSize = sizeof(Header) + sizeof(PackedChunkVertex) * static_cast<u64>(vertexCount) + sizeof(u32) * static_cast<u64>(indexCount);
+
+		bool bWritten;
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if(!file.is_open()) return;
+
+			Header header { };
+			header.magic = MAGIC;
+			header.version = VERSION;
+			header.key = key;
+			header.vertexCount = vertexCount;
+			header.indexCount = indexCount;
+			header.opaqueCount = opaqueCount;
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(pVertexList), sizeof(PackedChunkVertex) * vertexCount);
+			file.write(reinterpret_cast<const char*>(pIndexList), sizeof(u32) * indexCount);
+			bWritten = file.good();
+		}
+
+		if(!bWritten)
+		{ // Out of space, most likely. The partial file would never be read, so it isn't left behind.
+			Util::CFileSystem::Instance().RemoveFile(tempPath.c_str());
+			return;
+		}
+
+#ifdef PLATFORM_WINDOWS
+		if(!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+		{ // Another thread stored the same mesh first.
+			Util::CFileSystem::Instance().RemoveFile(tempPath.c_str());
+			return;
+		}
+#else
+		if(!Util::CFileSystem::Instance().RenameFile(tempPath.c_str(), path.c_str()))
+		{
+			Util::CFileSystem::Instance().RemoveFile(tempPath.c_str());
+			return;
+		}
+#endif
+
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			Touch(key, fileSize);
+			Evict();
+		}
+
+		++m_stats.storeCount;
+	}
+
+	// Moves the key to the front of the LRU list, adding it if it's new. The lock must be held.
+	void CChunkMeshCache::Touch(u64 key, u64 size)
+	{
+		auto it = m_recordMap.find(key);
+		if(it == m_recordMap.end())
+		{
+			m_lruList.push_front(key);
+			m_recordMap[key] = { size, m_lruList.begin() };
+			m_byteCount += size;
+			return;
+		}
+
+		m_lruList.splice(m_lruList.begin(), m_lruList, it->second.lruIt);
+		m_byteCount = m_byteCount - it->second.size + size;
+		it->second.size = size;
+	}
+
+	// Deletes the least recently used entries until the cache is within its budget. Loads share deletion, so an entry that's still mapped is
+	//  removed once its last mapping is released. The lock must be held.
+	void CChunkMeshCache::Evict()
+	{
+		while(m_byteCount > m_data.byteBudget && !m_lruList.empty())
+		{
+			const u64 key = m_lruList.back();
+			Util::CFileSystem::Instance().RemoveFile(GetPath(key).c_str());
+
+			auto it = m_recordMap.find(key);
+			m_byteCount -= it->second.size;
+			m_recordMap.erase(it);
+			m_lruList.pop_back();
+
+			++m_stats.evictCount;
+		}
+	}
+
+	std::wstring CChunkMeshCache::GetPath(u64 key) const
+	{
+		wchar_t name[17];
+		static const wchar_t* hex = L"0123456789abcdef";
+		for(int i = 15; i >= 0; --i, key >>= 4)
+		{
+			name[i] = hex[key & 0xF];
+		}
+
+		name[16] = L'\0';
+		return m_data.directory + L"\\" + name + L".mesh";
+	}
+};
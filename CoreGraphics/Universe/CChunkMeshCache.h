@@ -0,0 +1,136 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkMeshCache.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKMESHCACHE_H
+#define CCHUNKMESHCACHE_H
+
+#include "CChunkVertex.h"
+#include <Globals/CGlobals.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Universe
+{
+	// On-disk cache of built section meshes, one file per mesh named after its key. The key is an FNV-1a hash of everything the build reads
+	//  (blocks, light, neighbour borders, LOD level and mesher settings), so an entry is never stale: any change simply produces a key that misses.
+	// Entries are memory-mapped on load, and uploaded straight from the mapping. Lookups and stores are safe from any thread.
+	// The cache is kept within a byte budget by evicting the least recently used entries as new ones are stored. Entries found on disk at
+	//  startup are ordered by when they were written.
+	class CChunkMeshCache
+	{
+	public:
+		static const u32 MAGIC = 0x48534D43; // "CMSH"
+		static const u32 VERSION = 3; // Bumped whenever the packed vertex layout or the mesher's output changes.
+
+		struct Data
+		{
+			std::wstring directory; // Caching is disabled while empty.
+			u64 byteBudget = 256ULL << 20; // Bytes of entries kept on disk.
+		};
+
+		struct Stats
+		{
+			Au32 hitCount;
+			Au32 missCount;
+			Au32 storeCount;
+			Au32 evictCount;
+		};
+
+	private:
+		struct Header
+		{
+			u32 magic;
+			u32 version;
+			u64 key;
+			u32 vertexCount;
+			u32 indexCount;
+			u32 opaqueCount; // Indices before the translucent range.
+			u32 padding;
+		};
+
+		struct Record
+		{
+			u64 size;
+			std::list<u64>::iterator lruIt;
+		};
+
+	public:
+		// A mapped mesh. The pointers stay valid until the entry is released or destroyed.
+		class Entry
+		{
+		public:
+			Entry();
+			~Entry();
+			Entry(const Entry&) = delete;
+			Entry(Entry&&) = delete;
+			Entry& operator = (const Entry&) = delete;
+			Entry& operator = (Entry&&) = delete;
+
+			void Release();
+
+			// Accessors.
+			inline const PackedChunkVertex* GetVertexList() const { return reinterpret_cast<const PackedChunkVertex*>(m_pView + sizeof(Header)); }
+			inline const u32* GetIndexList() const { return reinterpret_cast<const u32*>(m_pView + sizeof(Header) + sizeof(PackedChunkVertex) * GetHeader().vertexCount); }
+			inline u32 GetVertexCount() const { return GetHeader().vertexCount; }
+			inline u32 GetIndexCount() const { return GetHeader().indexCount; }
+			inline u32 GetOpaqueCount() const { return GetHeader().opaqueCount; }
+
+		private:
+			friend class CChunkMeshCache;
+
+			inline const Header& GetHeader() const { return *reinterpret_cast<const Header*>(m_pView); }
+
+			const u8* m_pView;
+			void* m_hFile;
+			void* m_hMapping;
+			std::vector<u8> m_buffer; // Used instead of a mapping where the platform has none.
+		};
+
+	public:
+		CChunkMeshCache();
+		~CChunkMeshCache();
+		CChunkMeshCache(const CChunkMeshCache&) = delete;
+		CChunkMeshCache(CChunkMeshCache&&) = delete;
+		CChunkMeshCache& operator = (const CChunkMeshCache&) = delete;
+		CChunkMeshCache& operator = (CChunkMeshCache&&) = delete;
+
+		void Initialize();
+
+		bool Load(u64 key, Entry& entry);
+		void Store(u64 key, const PackedChunkVertex* pVertexList, u32 vertexCount, const u32* pIndexList, u32 indexCount, u32 opaqueCount);
+
+		// Accessors.
+		inline bool IsEnabled() const { return !m_data.directory.empty(); }
+		inline const Stats& GetStats() const { return m_stats; }
+
+		// Modifiers.
+		inline void SetData(const Data& data) { m_data = data; }
+
+	private:
+		std::wstring GetPath(u64 key) const;
+
+		void Touch(u64 key, u64 size);
+		void Evict();
+
+	private:
+		Data m_data;
+		Stats m_stats;
+
+		std::mutex m_mutex;
+		std::list<u64> m_lruList; // Keys, most recently used first.
+		std::unordered_map<u64, Record> m_recordMap;
+		u64 m_byteCount;
+	};
+};
+
+#endif
@@ -0,0 +1,407 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkMeshOptimizer.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkMeshOptimizer.h"
+#include "CChunkMeshScratch.h"
+#include "CBlockRegistry.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace Universe
+{
+	namespace
+	{
+		static const u32 WELD_EMPTY = ~0U;
+		static const u32 VALENCE_TABLE_SIZE = 32;
+
+		// Scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+		static const float CACHE_DECAY_POWER = 1.5f;
+		static const float LAST_TRI_SCORE = 0.75f;
+		static const float VALENCE_BOOST_SCALE = 2.0f;
+		static const float VALENCE_BOOST_POWER = 0.5f;
+
+		inline u32 HashVertex(const PackedChunkVertex& vertex)
+		{
+			u64 key = (static_cast<u64>(vertex.word1) << 32) | vertex.word0;
+			key ^= key >> 33;
+			key *= 0xFF51AFD7ED558CCDULL;
+			key ^= key >> 33;
+			return static_cast<u32>(key);
+		}
+
+		struct ScoreTable
+		{
+			float cache[CChunkMeshOptimizer::CACHE_SIZE];
+			float valence[VALENCE_TABLE_SIZE];
+
+			ScoreTable()
+			{
+				for(u32 i = 0; i < CChunkMeshOptimizer::CACHE_SIZE; ++i)
+				{
+					// The three most recent vertices belong to the last triangle, and are scored flat so it isn't favoured over its neighbours.
+					cache[i] = i < 3 ? LAST_TRI_SCORE : powf(1.0f - static_cast<float>(i - 3) / (CChunkMeshOptimizer::CACHE_SIZE - 3), CACHE_DECAY_POWER);
+				}
+
+				valence[0] = 0.0f;
+				for(u32 i = 1; i < VALENCE_TABLE_SIZE; ++i)
+				{
+					valence[i] = VALENCE_BOOST_SCALE * powf(static_cast<float>(i), -VALENCE_BOOST_POWER);
+				}
+			}
+
+			inline float Score(s32 cachePos, u32 trisLeft) const
+			{
+				if(trisLeft == 0) return -1.0f;
+
+				const float cacheScore = cachePos >= 0 ? cache[cachePos] : 0.0f;
+				const float valenceScore = trisLeft < VALENCE_TABLE_SIZE ? valence[trisLeft] : VALENCE_BOOST_SCALE * powf(static_cast<float>(trisLeft), -VALENCE_BOOST_POWER);
+				return cacheScore + valenceScore;
+			}
+		};
+	};
+
+	void CChunkMeshOptimizer::Optimize(CChunkMeshScratch& scratch, u8 flags, Stats* pStats)
+	{
+		const bool bStats = pStats && (flags & MESH_OPTIMIZE_STATS);
+		if(bStats)
+		{
+			pStats->vertexCountIn = static_cast<u32>(scratch.vertexList.size());
+			pStats->triangleCount = static_cast<u32>(scratch.indexList.size() / 3);
+			pStats->acmrIn = ComputeACMR(scratch);
+		}
+
+		if(flags & MESH_OPTIMIZE_WELD) Weld(scratch);
+		if(flags & MESH_OPTIMIZE_VERTEX_CACHE) OptimizeVertexCache(scratch);
+		if(flags & MESH_OPTIMIZE_VERTEX_FETCH) OptimizeVertexFetch(scratch);
+
+		if(bStats)
+		{
+			pStats->vertexCountOut = static_cast<u32>(scratch.vertexList.size());
+			pStats->acmrOut = ComputeACMR(scratch);
+		}
+	}
+
+	// Adds a mesh's statistics to a running total. ACMR is weighted by triangle count, so the total reads as if the meshes were one.
+	void CChunkMeshOptimizer::Accumulate(Stats& total, const Stats& stats)
+	{
+		const u32 triangleCount = total.triangleCount + stats.triangleCount;
+		if(triangleCount)
+		{
+			total.acmrIn = (total.acmrIn * total.triangleCount + stats.acmrIn * stats.triangleCount) / triangleCount;
+			total.acmrOut = (total.acmrOut * total.triangleCount + stats.acmrOut * stats.triangleCount) / triangleCount;
+		}
+
+		total.vertexCountIn += stats.vertexCountIn;
+		total.vertexCountOut += stats.vertexCountOut;
+		total.triangleCount = triangleCount;
+	}
+
+	// Packed vertices are already quantized, so two vertices are identical exactly when both of their words match.
+	void CChunkMeshOptimizer::Weld(CChunkMeshScratch& scratch)
+	{
+		auto& vertexList = scratch.vertexList;
+		auto& indexList = scratch.indexList;
+
+		const u32 vertexCount = static_cast<u32>(vertexList.size());
+		if(vertexCount == 0) return;
+
+		u32 tableSize = 1;
+		while(tableSize < vertexCount * 2) tableSize <<= 1;
+
+		auto& table = scratch.weldTable;
+		table.assign(tableSize, WELD_EMPTY);
+
+		auto& remap = scratch.vertexRemapList;
+		remap.resize(vertexCount);
+
+		// Unique vertices are compacted in place, as the write cursor never passes the read cursor.
+		u32 weldedCount = 0;
+		for(u32 v = 0; v < vertexCount; ++v)
+		{
+			const PackedChunkVertex vertex = vertexList[v];
+			u32 slot = HashVertex(vertex) & (tableSize - 1);
+
+			while(true)
+			{
+				const u32 entry = table[slot];
+				if(entry == WELD_EMPTY)
+				{
+					table[slot] = weldedCount;
+					vertexList[weldedCount] = vertex;
+					remap[v] = weldedCount++;
+					break;
+				}
+
+				if(vertexList[entry].word0 == vertex.word0 && vertexList[entry].word1 == vertex.word1)
+				{
+					remap[v] = entry;
+					break;
+				}
+
+				slot = (slot + 1) & (tableSize - 1);
+			}
+		}
+
+		for(u32& index : indexList)
+		{
+			index = remap[index];
+		}
+
+		vertexList.resize(weldedCount);
+	}
+
+	// Greedily emits the highest scoring triangle touching the simulated LRU cache, falling back to the next unemitted triangle in input order
+	//  when no cached vertex has triangles left.
+	void CChunkMeshOptimizer::OptimizeVertexCache(CChunkMeshScratch& scratch)
+	{
+		static const ScoreTable scoreTable;
+
+		auto& indexList = scratch.indexList;
+		const u32 vertexCount = static_cast<u32>(scratch.vertexList.size());
+		const u32 triCount = static_cast<u32>(indexList.size() / 3);
+		if(triCount == 0) return;
+
+		auto& triCountList = scratch.vertexTriCountList;
+		auto& triOffsetList = scratch.vertexTriOffsetList;
+		auto& triList = scratch.vertexTriList;
+		auto& cachePosList = scratch.vertexCachePosList;
+		auto& vertexScoreList = scratch.vertexScoreList;
+		auto& triScoreList = scratch.triScoreList;
+		auto& triAddedList = scratch.triAddedList;
+
+		// Build vertex to triangle adjacency.
+		triCountList.assign(vertexCount, 0);
+		for(u32 index : indexList) ++triCountList[index];
+
+		triOffsetList.resize(vertexCount);
+		for(u32 v = 0, offset = 0; v < vertexCount; ++v)
+		{
+			triOffsetList[v] = offset;
+			offset += triCountList[v];
+			triCountList[v] = 0;
+		}
+
+		triList.resize(triCount * 3);
+		for(u32 t = 0; t < triCount; ++t)
+		{
+			for(u32 c = 0; c < 3; ++c)
+			{
+				const u32 v = indexList[t * 3 + c];
+				triList[triOffsetList[v] + triCountList[v]++] = t;
+			}
+		}
+
+		// Initial scores.
+		cachePosList.assign(vertexCount, -1);
+		vertexScoreList.resize(vertexCount);
+		for(u32 v = 0; v < vertexCount; ++v)
+		{
+			vertexScoreList[v] = scoreTable.Score(-1, triCountList[v]);
+		}
+
+		triScoreList.resize(triCount);
+		triAddedList.assign(triCount, 0);
+		for(u32 t = 0; t < triCount; ++t)
+		{
+			triScoreList[t] = vertexScoreList[indexList[t * 3]] + vertexScoreList[indexList[t * 3 + 1]] + vertexScoreList[indexList[t * 3 + 2]];
+		}
+
+		auto& outputList = scratch.indexListTemp;
+		outputList.clear();
+		outputList.reserve(indexList.size());
+
+		u32 cache[CACHE_SIZE + 3];
+		u32 cacheCount = 0;
+		u32 scanCursor = 0;
+		s64 bestTri = -1;
+
+		for(u32 emitted = 0; emitted < triCount; ++emitted)
+		{
+			if(bestTri < 0)
+			{
+				while(triAddedList[scanCursor]) ++scanCursor;
+				bestTri = scanCursor;
+			}
+
+			const u32 t = static_cast<u32>(bestTri);
+			triAddedList[t] = 1;
+
+			const u32 triVertexList[3] = { indexList[t * 3], indexList[t * 3 + 1], indexList[t * 3 + 2] };
+			u32 newCache[CACHE_SIZE + 3];
+			u32 newCount = 0;
+
+			for(u32 v : triVertexList)
+			{
+				outputList.push_back(v);
+
+				// Remove the triangle from the vertex's remaining adjacency.
+				u32* pTriList = &triList[triOffsetList[v]];
+				u32& count = triCountList[v];
+				for(u32 i = 0; i < count; ++i)
+				{
+					if(pTriList[i] == t)
+					{
+						std::swap(pTriList[i], pTriList[count - 1]);
+						--count;
+						break;
+					}
+				}
+
+				if(std::find(newCache, newCache + newCount, v) == newCache + newCount)
+				{
+					newCache[newCount++] = v;
+				}
+			}
+
+			// Shift the rest of the cache back behind this triangle's vertices.
+			for(u32 i = 0; i < cacheCount; ++i)
+			{
+				const u32 v = cache[i];
+				if(v != triVertexList[0] && v != triVertexList[1] && v != triVertexList[2])
+				{
+					newCache[newCount++] = v;
+				}
+			}
+
+			for(u32 i = 0; i < newCount; ++i)
+			{
+				const u32 v = newCache[i];
+				cachePosList[v] = i < CACHE_SIZE ? static_cast<s32>(i) : -1;
+				vertexScoreList[v] = scoreTable.Score(cachePosList[v], triCountList[v]);
+			}
+
+			cacheCount = std::min<u32>(newCount, CACHE_SIZE);
+			std::copy(newCache, newCache + cacheCount, cache);
+
+			// Rescore triangles touching any vertex whose score changed, and pick the best for the next step.
+			float bestScore = -FLT_MAX;
+			bestTri = -1;
+			for(u32 i = 0; i < newCount; ++i)
+			{
+				const u32 v = newCache[i];
+				const u32* pTriList = &triList[triOffsetList[v]];
+				for(u32 j = 0; j < triCountList[v]; ++j)
+				{
+					const u32 adj = pTriList[j];
+					const float score = vertexScoreList[indexList[adj * 3]] + vertexScoreList[indexList[adj * 3 + 1]] + vertexScoreList[indexList[adj * 3 + 2]];
+					triScoreList[adj] = score;
+
+					if(score > bestScore)
+					{
+						bestScore = score;
+						bestTri = adj;
+					}
+				}
+			}
+		}
+
+		indexList.swap(outputList);
+	}
+
+	// Renumbers vertices in the order the index list first references them, dropping any that are unreferenced.
+	void CChunkMeshOptimizer::OptimizeVertexFetch(CChunkMeshScratch& scratch)
+	{
+		auto& vertexList = scratch.vertexList;
+		auto& remap = scratch.vertexRemapList;
+		auto& outputList = scratch.vertexListTemp;
+
+		remap.assign(vertexList.size(), WELD_EMPTY);
+		outputList.clear();
+		outputList.reserve(vertexList.size());
+
+		for(u32& index : scratch.indexList)
+		{
+			if(remap[index] == WELD_EMPTY)
+			{
+				remap[index] = static_cast<u32>(outputList.size());
+				outputList.push_back(vertexList[index]);
+			}
+
+			index = remap[index];
+		}
+
+		vertexList.swap(outputList);
+	}
+
+	float CChunkMeshOptimizer::ComputeACMR(CChunkMeshScratch& scratch)
+	{
+		const auto& indexList = scratch.indexList;
+		const u32 triCount = static_cast<u32>(indexList.size() / 3);
+		if(triCount == 0) return 0.0f;
+
+		// A vertex is cached while fewer than CACHE_SIZE misses have happened since it was loaded.
+		auto& stampList = scratch.vertexRemapList;
+		stampList.assign(scratch.vertexList.size(), 0);
+
+		u32 time = CACHE_SIZE;
+		u32 missCount = 0;
+		for(u32 index : indexList)
+		{
+			if(time - stampList[index] >= CACHE_SIZE)
+			{
+				stampList[index] = ++time;
+				++missCount;
+			}
+		}
+
+		return static_cast<float>(missCount) / triCount;
+	}
+
+	// Moves translucent triangles behind all others, which keep their order, and sorts them back to front from sortOrigin in vertex coordinates.
+	//  Returns the number of indices before the translucent range.
+	u32 CChunkMeshOptimizer::SplitTranslucent(CChunkMeshScratch& scratch, const Math::Vector3& sortOrigin)
+	{
+		const CBlockRegistry& registry = CBlockRegistry::Instance();
+		const auto& vertexList = scratch.vertexList;
+		auto& indexList = scratch.indexList;
+		const u32 triCount = static_cast<u32>(indexList.size() / 3);
+
+		auto& sortList = scratch.triSortList;
+		sortList.clear();
+
+		auto& outputList = scratch.indexListTemp;
+		outputList.clear();
+		outputList.reserve(indexList.size());
+
+		for(u32 t = 0; t < triCount; ++t)
+		{
+			const u32* pTri = &indexList[t * 3];
+			if(!registry.IsTranslucent(vertexList[pTri[0]].GetId()))
+			{
+				outputList.insert(outputList.end(), pTri, pTri + 3);
+				continue;
+			}
+
+			// Squared distance to the centroid, scaled by 9 to skip the divide.
+			const Math::Vector3 centroid = vertexList[pTri[0]].GetPosition() + vertexList[pTri[1]].GetPosition() + vertexList[pTri[2]].GetPosition() - sortOrigin * 3.0f;
+			const float distance = centroid.LengthSq();
+
+			// Non-negative floats order the same as their bits, so inverting them sorts the farthest first.
+			u32 bits;
+			memcpy(&bits, &distance, sizeof(bits));
+			sortList.push_back((static_cast<u64>(~bits) << 32) | t);
+		}
+
+		const u32 opaqueCount = static_cast<u32>(outputList.size());
+		if(sortList.empty()) return opaqueCount;
+
+		std::sort(sortList.begin(), sortList.end());
+		for(u64 key : sortList)
+		{
+			const u32* pTri = &indexList[(key & 0xFFFFFFFF) * 3];
+			outputList.insert(outputList.end(), pTri, pTri + 3);
+		}
+
+		indexList.swap(outputList);
+		return opaqueCount;
+	}
+};
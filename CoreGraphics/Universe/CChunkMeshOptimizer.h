@@ -0,0 +1,59 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkMeshOptimizer.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKMESHOPTIMIZER_H
+#define CCHUNKMESHOPTIMIZER_H
+
+#include "CChunkVertex.h"
+#include <Math/CMathVector3.h>
+#include <Globals/CGlobals.h>
+#include <vector>
+
+namespace Universe
+{
+	enum MESH_OPTIMIZE : u8
+	{
+		MESH_OPTIMIZE_NONE = 0x0,
+		MESH_OPTIMIZE_WELD = 0x1, // Merge identical packed vertices.
+		MESH_OPTIMIZE_VERTEX_CACHE = 0x2, // Reorder triangles for post-transform cache hits.
+		MESH_OPTIMIZE_VERTEX_FETCH = 0x4, // Reorder vertices into first use order.
+		MESH_OPTIMIZE_STATS = 0x8, // Measure vertex counts and ACMR before and after.
+		MESH_OPTIMIZE_DEFAULT = MESH_OPTIMIZE_WELD | MESH_OPTIMIZE_VERTEX_CACHE | MESH_OPTIMIZE_VERTEX_FETCH,
+	};
+
+	// Post-pass run over a generated chunk mesh. Every working list lives in the calling thread's mesh scratch, so it adds no steady-state allocations.
+	class CChunkMeshOptimizer
+	{
+	public:
+		static constexpr u32 CACHE_SIZE = 32;
+
+		struct Stats
+		{
+			u32 vertexCountIn;
+			u32 vertexCountOut;
+			u32 triangleCount;
+			float acmrIn; // Average cache miss ratio, as vertex transforms per triangle for a FIFO cache of CACHE_SIZE entries.
+			float acmrOut;
+		};
+
+	public:
+		static void Optimize(class CChunkMeshScratch& scratch, u8 flags, Stats* pStats);
+
+		static void Weld(class CChunkMeshScratch& scratch);
+		static void OptimizeVertexCache(class CChunkMeshScratch& scratch);
+		static void OptimizeVertexFetch(class CChunkMeshScratch& scratch);
+		static float ComputeACMR(class CChunkMeshScratch& scratch);
+		static void Accumulate(Stats& total, const Stats& stats);
+
+		static u32 SplitTranslucent(class CChunkMeshScratch& scratch, const Math::Vector3& sortOrigin);
+	};
+};
+
+#endif
@@ -0,0 +1,59 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkMeshScratch.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkMeshScratch.h"
+
+namespace Universe
+{
+	CChunkMeshScratch& CChunkMeshScratch::Local()
+	{
+		static thread_local CChunkMeshScratch scratch;
+		return scratch;
+	}
+
+	CChunkMeshScratch::CChunkMeshScratch() :
+		pointListCount(0),
+		remapStamp(0),
+		meshletStamp(0)
+	{
+	}
+
+	CChunkMeshScratch::~CChunkMeshScratch()
+	{
+	}
+
+	// Resets the arena for a chunk with the given block and vertex grid counts. Lists only ever grow.
+	void CChunkMeshScratch::Prepare(u32 blockCount, u32 vertexCount)
+	{
+		vertexList.clear();
+		indexList.clear();
+		quadList[0].clear();
+		quadList[1].clear();
+		islandQueue.clear();
+		pointList.clear();
+		pointListCount = 0;
+		mergedList.clear();
+
+		if(pendingList.size() < blockCount) pendingList.resize(blockCount, 0);
+		if(shadeList[0].size() < blockCount)
+		{
+			shadeList[0].resize(blockCount, 0);
+			shadeList[1].resize(blockCount, 0);
+		}
+
+		edgeSet.Prepare(vertexCount);
+
+		if(remapList.size() < vertexCount)
+		{
+			remapList.resize(vertexCount, 0);
+			remapStampList.resize(vertexCount, 0);
+		}
+	}
+};
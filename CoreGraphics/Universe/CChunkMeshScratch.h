@@ -0,0 +1,165 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkMeshScratch.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKMESHSCRATCH_H
+#define CCHUNKMESHSCRATCH_H
+
+#include "CChunkVertex.h"
+#include <Math/CMathVector3.h>
+#include <Globals/CGlobals.h>
+#include <algorithm>
+#include <vector>
+
+namespace Universe
+{
+	// Working memory for the chunk mesher. One instance lives on each thread that builds meshes, and every list is cleared rather than freed
+	//  between rebuilds, so once the arena has grown to fit the largest chunk it has seen, rebuilding no longer touches the heap.
+	class CChunkMeshScratch
+	{
+	public:
+		// Dense replacement for an unordered_map<u32, u64> keyed by vertex index. Each vertex holds up to two outgoing edges, packed as (second << 32 | first).
+		class EdgeSet
+		{
+		public:
+			static constexpr u64 EMPTY = ~0ULL;
+
+		public:
+			EdgeSet() : m_cursor(0), m_count(0) { }
+
+			inline void Prepare(u32 vertexCount)
+			{
+				if(m_edgeList.size() < vertexCount) m_edgeList.resize(vertexCount, EMPTY);
+				Clear();
+			}
+
+			inline void Clear()
+			{
+				for(u32 key : m_keyList) m_edgeList[key] = EMPTY;
+				m_keyList.clear();
+				m_cursor = m_count = 0;
+			}
+
+			inline void Add(u32 a, u32 b)
+			{
+				u64& edge = m_edgeList[a];
+				if(edge != EMPTY)
+				{
+					edge <<= 32;
+					edge |= b;
+				}
+				else
+				{
+					edge = b;
+					m_keyList.push_back(a);
+					++m_count;
+				}
+			}
+
+			inline u64* Find(u32 a) { return m_edgeList[a] != EMPTY ? &m_edgeList[a] : nullptr; }
+			inline void Erase(u32 a) { m_edgeList[a] = EMPTY; --m_count; }
+
+			// Any vertex still in the set, in insertion order. Only valid while the set isn't empty.
+			inline u32 Front()
+			{
+				while(m_edgeList[m_keyList[m_cursor]] == EMPTY) ++m_cursor;
+				return m_keyList[m_cursor];
+			}
+
+			inline bool Empty() const { return m_count == 0; }
+
+		private:
+			std::vector<u64> m_edgeList;
+			std::vector<u32> m_keyList;
+			size_t m_cursor;
+			size_t m_count;
+		};
+
+	public:
+		static CChunkMeshScratch& Local();
+
+		CChunkMeshScratch();
+		~CChunkMeshScratch();
+		CChunkMeshScratch(const CChunkMeshScratch&) = delete;
+		CChunkMeshScratch(CChunkMeshScratch&&) = delete;
+		CChunkMeshScratch& operator = (const CChunkMeshScratch&) = delete;
+		CChunkMeshScratch& operator = (CChunkMeshScratch&&) = delete;
+
+		void Prepare(u32 blockCount, u32 vertexCount);
+
+		// Returns a cleared point list, reusing one from a previous island where possible.
+		inline std::vector<Math::Vector3>& AddPointList()
+		{
+			if(pointListCount == pointLists.size()) pointLists.emplace_back();
+			pointLists[pointListCount].clear();
+			return pointLists[pointListCount++];
+		}
+
+		// Starts a new vertex remap generation, so vertices shared by the previous polygon aren't reused by the next one.
+		inline void NextRemapStamp()
+		{
+			if(++remapStamp == 0)
+			{
+				std::fill(remapStampList.begin(), remapStampList.end(), 0);
+				remapStamp = 1;
+			}
+		}
+
+	public:
+		// Mesh output.
+		std::vector<PackedChunkVertex> vertexList;
+		std::vector<u32> indexList;
+
+		// Quads of the current slice, keyed as (id << 48 | shade << 32 | block index) so sorting groups them by block id, then by shading.
+		std::vector<u64> quadList[2];
+		// Shading of each quad in the matching quad list, by block index. Only quads with equal, uniform shading merge.
+		std::vector<u16> shadeList[2];
+		// Quads of the current block id that have yet to be assigned to an island.
+		std::vector<u8> pendingList;
+		std::vector<u32> islandQueue;
+		EdgeSet edgeSet;
+
+		// Island outlines.
+		std::vector<Math::Vector3> pointList;
+		std::vector<std::vector<Math::Vector3>> pointLists;
+		size_t pointListCount;
+		std::vector<u8> mergedList;
+
+		// Vertex grid index to output vertex, valid where the stamp matches the current one.
+		std::vector<u32> remapList;
+		std::vector<u32> remapStampList;
+		u32 remapStamp;
+
+		// Smooth surfaces. Occupancy samples (0x00 or 0xFF), corner masks and packed offsets, laid out as CChunkSurfaceNets describes.
+		std::vector<u8> sampleList;
+		std::vector<u8> maskList;
+		std::vector<u16> surfaceOffsetList;
+
+		// Meshlet builder. Vertices already in the open cluster carry its stamp.
+		std::vector<u32> meshletStampList;
+		std::vector<Math::Vector3> meshletNormalList;
+		u32 meshletStamp;
+
+		// Mesh optimizer.
+		std::vector<PackedChunkVertex> vertexListTemp;
+		std::vector<u32> indexListTemp;
+		std::vector<u32> weldTable;
+		std::vector<u32> vertexRemapList;
+		std::vector<u32> vertexTriOffsetList;
+		std::vector<u32> vertexTriCountList;
+		std::vector<u32> vertexTriList;
+		std::vector<s32> vertexCachePosList;
+		std::vector<float> vertexScoreList;
+		std::vector<float> triScoreList;
+		std::vector<u8> triAddedList;
+		std::vector<u64> triSortList;
+	};
+};
+
+#endif
@@ -0,0 +1,318 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkMeshlets.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkMeshlets.h"
+#include "CChunkMeshScratch.h"
+#include <Logic/CCamera.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+
+namespace Universe
+{
+	namespace
+	{
+		const u32 CAMERA_PATH_MAGIC = 0x48544150; // "PATH"
+
+		inline u8 GetFace(const PackedChunkVertex& vertex)
+		{
+			return static_cast<u8>((vertex.word0 >> 18) & 0x7);
+		}
+	};
+
+	CChunkMeshlets::CameraSample CChunkMeshlets::CameraSample::FromCamera(const Logic::CCamera* pCamera)
+	{
+		CameraSample sample;
+		sample.position = *(Math::Vector3*)pCamera->GetTransform()->GetPosition().ToFloat();
+
+		for(u32 i = 0; i < 6; ++i)
+		{
+			const float* pPlane = pCamera->GetFrustumPlane(i).ToFloat();
+			for(u32 j = 0; j < 4; ++j)
+			{
+				sample.planeList[i][j] = pPlane[j];
+			}
+		}
+
+		sample.viewProj = pCamera->GetViewMatrix() * pCamera->GetProjectionMatrix();
+
+		return sample;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Build methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// A counting sort over the six faces, through the optimizer's temporary index list.
+	void CChunkMeshlets::SortByFace(CChunkMeshScratch& scratch, u32 opaqueCount)
+	{
+		const u32 triangleCount = opaqueCount / 3;
+		u32 offsetList[7] = { };
+
+		for(u32 tri = 0; tri < triangleCount; ++tri)
+		{
+			++offsetList[GetFace(scratch.vertexList[scratch.indexList[tri * 3]]) + 1];
+		}
+
+		for(u32 face = 1; face < 7; ++face)
+		{
+			offsetList[face] += offsetList[face - 1];
+		}
+
+		scratch.indexListTemp.resize(opaqueCount);
+		for(u32 tri = 0; tri < triangleCount; ++tri)
+		{
+			const u32* pTri = scratch.indexList.data() + tri * 3;
+			u32* pOut = scratch.indexListTemp.data() + offsetList[GetFace(scratch.vertexList[pTri[0]])]++ * 3;
+			pOut[0] = pTri[0];
+			pOut[1] = pTri[1];
+			pOut[2] = pTri[2];
+		}
+
+		std::copy(scratch.indexListTemp.begin(), scratch.indexListTemp.begin() + opaqueCount, scratch.indexList.begin());
+	}
+
+	// Triangles are taken in order, and a cluster is closed as soon as the next triangle would take it past either limit.
+	void CChunkMeshlets::Build(CChunkMeshScratch& scratch, const PackedChunkVertex* pVertexList, u32 vertexCount, const u32* pIndexList, u32 opaqueCount,
+		std::vector<Meshlet>& meshletList)
+	{
+		meshletList.clear();
+		if(opaqueCount == 0) return;
+
+		if(scratch.meshletStampList.size() < vertexCount)
+		{
+			scratch.meshletStampList.resize(vertexCount, 0);
+		}
+
+		Meshlet meshlet { };
+		u32 meshletVertexCount = 0;
+		bool bLattice = true;
+
+		auto NextStamp = [&scratch](){
+			if(++scratch.meshletStamp == 0)
+			{
+				std::fill(scratch.meshletStampList.begin(), scratch.meshletStampList.end(), 0);
+				scratch.meshletStamp = 1;
+			}
+		};
+
+		auto Open = [&](u32 indexStart){
+			meshlet = { };
+			meshlet.indexStart = indexStart;
+			meshlet.boundsMin = Math::Vector3(FLT_MAX);
+			meshlet.boundsMax = Math::Vector3(-FLT_MAX);
+			meshletVertexCount = 0;
+			bLattice = true;
+			scratch.meshletNormalList.clear();
+			NextStamp();
+		};
+
+		// The cone is the average normal, widened to the normal furthest from it. Degenerate triangles from collapsed smooth corners don't count.
+		auto Close = [&](){
+			Math::Vector3 axis(0.0f);
+			for(const Math::Vector3& normal : scratch.meshletNormalList)
+			{
+				axis += normal;
+			}
+
+			meshlet.coneAxis = Math::Vector3(0.0f);
+			meshlet.coneCutoff = 1.0f;
+
+			const float length = axis.Length();
+			if(length > 1e-4f)
+			{
+				axis = axis / length;
+
+				float minDot = 1.0f;
+				for(const Math::Vector3& normal : scratch.meshletNormalList)
+				{
+					minDot = std::min(minDot, Math::Vector3::Dot(axis, normal));
+				}
+
+				meshlet.coneAxis = axis;
+				if(minDot > 0.1f) meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+			}
+
+			if(!bLattice) meshlet.faceMask = 0;
+			meshletList.push_back(meshlet);
+		};
+
+		Open(0);
+
+		for(u32 index = 0; index < opaqueCount; index += 3)
+		{
+			const u32* pTri = pIndexList + index;
+
+			u32 newVertexCount = 0;
+			for(u32 i = 0; i < 3; ++i)
+			{
+				newVertexCount += scratch.meshletStampList[pTri[i]] != scratch.meshletStamp;
+			}
+
+			if(meshletVertexCount + newVertexCount > VERTEX_MAX || meshlet.indexCount == TRIANGLE_MAX * 3)
+			{
+				Close();
+				Open(index);
+				newVertexCount = 3;
+			}
+
+			meshletVertexCount += newVertexCount;
+			meshlet.indexCount += 3;
+
+			Math::Vector3 position[3];
+			for(u32 i = 0; i < 3; ++i)
+			{
+				const PackedChunkVertex& vertex = pVertexList[pTri[i]];
+				scratch.meshletStampList[pTri[i]] = scratch.meshletStamp;
+
+				position[i] = vertex.GetPosition();
+				for(u32 axis = 0; axis < 3; ++axis)
+				{
+					meshlet.boundsMin[axis] = std::min(meshlet.boundsMin[axis], position[i][axis]);
+					meshlet.boundsMax[axis] = std::max(meshlet.boundsMax[axis], position[i][axis]);
+				}
+
+				bLattice &= (vertex.GetOffset() & PackedChunkVertex::OFFSET_SMOOTH) == 0;
+			}
+
+			meshlet.faceMask |= 1 << GetFace(pVertexList[pTri[0]]);
+
+			// Triangles are wound clockwise when seen from the front.
+			const Math::Vector3 normal = Math::Vector3::Cross(position[2] - position[0], position[1] - position[0]);
+			const float length = normal.Length();
+			if(length > 1e-6f) scratch.meshletNormalList.push_back(normal / length);
+		}
+
+		Close();
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Cull methods.
+	//-----------------------------------------------------------------------------------------------
+
+	void CChunkMeshlets::Cull(const std::vector<Meshlet>& meshletList, const CameraSample& localCamera, std::vector<Graphics::CMeshRenderer_::IndexRange>& rangeList, Stats& stats)
+	{
+		const Math::Vector3& camera = localCamera.position;
+		const size_t rangeStart = rangeList.size();
+
+		for(const Meshlet& meshlet : meshletList)
+		{
+			++stats.meshletCount;
+			stats.triangleCount += meshlet.indexCount / 3;
+
+			if(!IsBoxVisible(meshlet.boundsMin, meshlet.boundsMax, localCamera.planeList)) continue;
+
+			if(meshlet.faceMask)
+			{ // Faces of a side can only be seen from in front of the nearest of them.
+				bool bFacing = false;
+				for(u32 side = 0; side < 6 && !bFacing; ++side)
+				{
+					if(!(meshlet.faceMask & (1 << side))) continue;
+
+					const u32 axis = side >> 1;
+					bFacing = (side & 1) ? camera[axis] > meshlet.boundsMin[axis] : camera[axis] < meshlet.boundsMax[axis];
+				}
+
+				if(!bFacing) continue;
+			}
+
+			if(meshlet.coneCutoff < 1.0f)
+			{
+				const Math::Vector3 center = (meshlet.boundsMin + meshlet.boundsMax) * 0.5f;
+				const float radius = (meshlet.boundsMax - meshlet.boundsMin).Length() * 0.5f;
+				const Math::Vector3 toCenter = center - camera;
+
+				if(Math::Vector3::Dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * toCenter.Length() + radius) continue;
+			}
+
+			++stats.meshletDrawCount;
+			stats.triangleDrawCount += meshlet.indexCount / 3;
+
+			if(rangeList.size() > rangeStart && rangeList.back().start + rangeList.back().count == meshlet.indexStart)
+			{
+				rangeList.back().count += meshlet.indexCount;
+			}
+			else
+			{
+				rangeList.push_back({ meshlet.indexStart, meshlet.indexCount });
+			}
+		}
+
+		stats.rangeCount += static_cast<u32>(rangeList.size() - rangeStart);
+	}
+
+	// Local vertex coordinates are (world - offset) / blockSize, so each plane's normal is scaled by the block size and its distance shifted by the offset.
+	CChunkMeshlets::CameraSample CChunkMeshlets::ToLocal(const CameraSample& camera, const Math::Vector3& offset, float blockSize)
+	{
+		CameraSample local;
+		local.position = (camera.position - offset) / blockSize;
+
+		for(u32 i = 0; i < 6; ++i)
+		{
+			const float* pPlane = camera.planeList[i];
+			local.planeList[i][0] = pPlane[0] * blockSize;
+			local.planeList[i][1] = pPlane[1] * blockSize;
+			local.planeList[i][2] = pPlane[2] * blockSize;
+			local.planeList[i][3] = pPlane[0] * offset.x + pPlane[1] * offset.y + pPlane[2] * offset.z + pPlane[3];
+		}
+
+		return local;
+	}
+
+	// A box is outside once its corner furthest along a plane's normal is behind that plane.
+	bool CChunkMeshlets::IsBoxVisible(const Math::Vector3& mn, const Math::Vector3& mx, const float (&planeList)[6][4])
+	{
+		for(u32 i = 0; i < 6; ++i)
+		{
+			const float* pPlane = planeList[i];
+			const float distance = pPlane[0] * (pPlane[0] > 0.0f ? mx.x : mn.x) + pPlane[1] * (pPlane[1] > 0.0f ? mx.y : mn.y) +
+				pPlane[2] * (pPlane[2] > 0.0f ? mx.z : mn.z) + pPlane[3];
+
+			if(distance < 0.0f) return false;
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Camera path methods.
+	//-----------------------------------------------------------------------------------------------
+
+	bool CChunkMeshlets::SaveCameraPath(const std::wstring& path, const std::vector<CameraSample>& sampleList)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if(!file.is_open()) return false;
+
+		const u32 sampleCount = static_cast<u32>(sampleList.size());
+		file.write(reinterpret_cast<const char*>(&CAMERA_PATH_MAGIC), sizeof(CAMERA_PATH_MAGIC));
+		file.write(reinterpret_cast<const char*>(&sampleCount), sizeof(sampleCount));
+		file.write(reinterpret_cast<const char*>(sampleList.data()), sizeof(CameraSample) * sampleCount);
+
+		return file.good();
+	}
+
+	bool CChunkMeshlets::LoadCameraPath(const std::wstring& path, std::vector<CameraSample>& sampleList)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if(!file.is_open()) return false;
+
+		u32 magic = 0;
+		u32 sampleCount = 0;
+		file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+		file.read(reinterpret_cast<char*>(&sampleCount), sizeof(sampleCount));
+		if(!file.good() || magic != CAMERA_PATH_MAGIC) return false;
+
+		sampleList.resize(sampleCount);
+		file.read(reinterpret_cast<char*>(sampleList.data()), sizeof(CameraSample) * sampleCount);
+
+		return file.good();
+	}
+};
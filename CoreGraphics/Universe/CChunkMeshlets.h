@@ -0,0 +1,89 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkMeshlets.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKMESHLETS_H
+#define CCHUNKMESHLETS_H
+
+#include "CChunkVertex.h"
+#include "../Graphics/CMeshRenderer_.h"
+#include <Math/CMathVector3.h>
+#include <Math/CSIMDMatrix.h>
+#include <Globals/CGlobals.h>
+#include <string>
+#include <vector>
+
+namespace Logic
+{
+	class CCamera;
+};
+
+namespace Universe
+{
+	// Splits the opaque range of a chunk mesh into small clusters of consecutive triangles, each with bounds, a normal cone and the lattice faces it
+	//  holds, so clusters facing away from the camera or outside the frustum can be skipped, and the rest drawn as a few merged index ranges.
+	class CChunkMeshlets
+	{
+	public:
+		static constexpr u32 VERTEX_MAX = 64;
+		static constexpr u32 TRIANGLE_MAX = 124;
+
+		// Bounds and cone are in chunk local vertex coordinates.
+		struct Meshlet
+		{
+			u32 indexStart;
+			u32 indexCount;
+			Math::Vector3 boundsMin;
+			Math::Vector3 boundsMax;
+			Math::Vector3 coneAxis;
+			float coneCutoff; // Sine of the cone's spread. A cluster with a cutoff of 1 can face anywhere, and is never rejected by its cone.
+			u8 faceMask; // SIDE_FLAG mask of the lattice faces in the cluster, or none if any of its triangles have been moved off the lattice.
+		};
+
+		// A camera in world space. Plane normals point into the frustum.
+		struct CameraSample
+		{
+			Math::Vector3 position;
+			float planeList[6][4];
+			Math::SIMDMatrix viewProj; // For replaying occlusion culling.
+
+			static CameraSample FromCamera(const Logic::CCamera* pCamera);
+		};
+
+		struct Stats
+		{
+			u32 meshletCount; // Clusters tested.
+			u32 meshletDrawCount; // Clusters that passed.
+			u32 rangeCount; // Draw calls after merging neighbouring clusters.
+			u64 triangleCount; // Triangles in the clusters tested.
+			u64 triangleDrawCount;
+
+			inline float GetCulledRatio() const { return triangleCount ? 1.0f - static_cast<float>(triangleDrawCount) / static_cast<float>(triangleCount) : 0.0f; }
+		};
+
+	public:
+		// Groups the triangles of the opaque range by lattice face, keeping their order within each group, so clusters tend to face one way.
+		static void SortByFace(class CChunkMeshScratch& scratch, u32 opaqueCount);
+
+		static void Build(class CChunkMeshScratch& scratch, const PackedChunkVertex* pVertexList, u32 vertexCount, const u32* pIndexList, u32 opaqueCount,
+			std::vector<Meshlet>& meshletList);
+
+		// Appends the index ranges of visible clusters to rangeList, merging clusters that follow each other. The camera is in chunk local vertex coordinates.
+		static void Cull(const std::vector<Meshlet>& meshletList, const CameraSample& localCamera, std::vector<Graphics::CMeshRenderer_::IndexRange>& rangeList, Stats& stats);
+
+		static CameraSample ToLocal(const CameraSample& camera, const Math::Vector3& offset, float blockSize);
+		static bool IsBoxVisible(const Math::Vector3& mn, const Math::Vector3& mx, const float (&planeList)[6][4]);
+
+		// Recorded camera paths, for measuring culling offline against the same views.
+		static bool SaveCameraPath(const std::wstring& path, const std::vector<CameraSample>& sampleList);
+		static bool LoadCameraPath(const std::wstring& path, std::vector<CameraSample>& sampleList);
+	};
+};
+
+#endif
@@ -435,14 +435,14 @@ namespace Universe
 		pChunk->SetBlock(indices.second, block.bFilled ? block.id : 256);
 	}
 
-	void CChunkNode::ReadBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)> func) const
+	void CChunkNode::ReadBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)>& func) const
 	{
 		ProcessBlocksInExtentsRO(mn, mx, [&](u32 index, const std::pair<Math::VectorInt3, u32>& indices, class CChunk* pChunk){
 			func(index, pChunk->GetBlock(indices.second), indices);
 		});
 	}
 
-	void CChunkNode::WriteBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)> func)
+	void CChunkNode::WriteBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)>& func)
 	{
 		ProcessBlocksInExtents(mn, mx, [&](u32 index, const std::pair<Math::VectorInt3, u32>& indices, class CChunk* pChunk){
 			Block block;
@@ -453,8 +453,8 @@ namespace Universe
 		});
 	}
 
-	void CChunkNode::ReadWriteBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)> funcWrite,
-		std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)> funcRead)
+	void CChunkNode::ReadWriteBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)>& funcWrite,
+		const std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)>& funcRead)
 	{
 		ProcessBlocksInExtents(mn, mx, [&](u32 index, const std::pair<Math::VectorInt3, u32>& indices, class CChunk* pChunk){
 			Block block;
@@ -471,8 +471,8 @@ namespace Universe
 		});
 	}
 
-	void CChunkNode::ReadPaintBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)> funcWrite,
-		std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)> funcRead)
+	void CChunkNode::ReadPaintBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)>& funcWrite,
+		const std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)>& funcRead)
 	{
 		ProcessBlocksInExtents(mn, mx, [&](u32 index, const std::pair<Math::VectorInt3, u32>& indices, class CChunk* pChunk){
 			Block block;
@@ -489,13 +489,13 @@ namespace Universe
 		});
 	}
 	
-	void CChunkNode::ProcessBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<void(u32, const std::pair<Math::VectorInt3, u32>&, class CChunk*)> func)
+	void CChunkNode::ProcessBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<void(u32, const std::pair<Math::VectorInt3, u32>&, class CChunk*)>& func)
 	{
 		ProcessBlocksInExtentsRO(mn, mx, func, [this](const Math::VectorInt3& coord){ return CreateChunk(coord); });
 	}
 
-	void CChunkNode::ProcessBlocksInExtentsRO(const Math::Vector3& mn, const Math::Vector3& mx, std::function<void(u32, const std::pair<Math::VectorInt3, u32>&, class CChunk*)> func,
-		std::function<class CChunk*(const Math::VectorInt3&)> onChunkNotFound) const
+	void CChunkNode::ProcessBlocksInExtentsRO(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<void(u32, const std::pair<Math::VectorInt3, u32>&, class CChunk*)>& func,
+		const std::function<class CChunk*(const Math::VectorInt3&)>& onChunkNotFound) const
 	{
 		Math::VectorInt3 mnInt(
 			static_cast<int>(roundf(mn.x / m_data.blockSize)),
@@ -561,145 +561,7 @@ namespace Universe
 
 	CChunk* CChunkNode::CreateChunk(const Math::VectorInt3& coords)
 	{
-		for(size_t i = 0; i < 3; ++i)
-		{
-			m_minExtents[i] = std::min(m_minExtents[i], static_cast<float>(coords[i]) * m_data.chunkWidth * m_data.blockSize);
-			m_maxExtents[i] = std::max(m_maxExtents[i], static_cast<float>(coords[i] + 1) * m_data.chunkWidth * m_data.blockSize);
-		}
-
 		CChunk* pChunk = App::CSceneManager::Instance().UniverseManager().ChunkManager().CreateChunk(this, coords, false);
 		return pChunk;
 	}
-	
-	void CChunkNode::FrustumCulling() const
-	{
-		FrustumCulling(m_minExtents, m_maxExtents);
-	}
-
-	// Frustum culling with an implicit octree.
-	void CChunkNode::FrustumCulling(const Math::Vector3& mn, const Math::Vector3& mx) const
-	{
-		if(mn.x == mx.x || mn.y == mx.y || mn.z == mx.z) return;
-
-		const Math::Vector3* mnmx[2] = { &mn, &mx };
-
-		bool bIntersecting = true;
-
-		for(size_t i = 0; i < 6; ++i)
-		{
-			Math::Vector3 normal = *(Math::Vector3*)App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetFrustumPlane(i).ToFloat();
-			Math::Vector3 nearPoint(mnmx[normal.x > 0.0f]->x, mnmx[normal.y > 0.0f]->y, mnmx[normal.z > 0.0f]->z);
-
-			if(_mm_cvtss_f32(App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetFrustumPlane(i).DotCoord(nearPoint)) < 0.0f)
-			{
-				bIntersecting = false;
-				break;
-			}
-		}
-
-		const u32 chunkSize[3] = { m_data.chunkWidth, m_data.chunkHeight, m_data.chunkLength };
-
-		const Math::VectorInt3 mnInt(
-			static_cast<int>(roundf(mn.x / m_data.blockSize / m_data.chunkWidth)),
-			static_cast<int>(roundf(mn.y / m_data.blockSize / m_data.chunkHeight)),
-			static_cast<int>(roundf(mn.z / m_data.blockSize / m_data.chunkLength))
-		);
-
-		const Math::VectorInt3 mxInt(
-			static_cast<int>(roundf(mx.x / m_data.blockSize / m_data.chunkWidth)),
-			static_cast<int>(roundf(mx.y / m_data.blockSize / m_data.chunkHeight)),
-			static_cast<int>(roundf(mx.z / m_data.blockSize / m_data.chunkLength))
-		);
-
-		const Math::VectorInt3 diff = mxInt - mnInt;
-		const bool bSingleCell = diff.x == 1 && diff.y == 1 && diff.z == 1;
-
-		if(bIntersecting)
-		{
-			auto FullyInside = [&](){
-				if(!App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->CheckPoint(Math::Vector3(mn.x, mn.y, mn.z))) return false;
-				if(!App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->CheckPoint(Math::Vector3(mx.x, mn.y, mn.z))) return false;
-				if(!App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->CheckPoint(Math::Vector3(mn.x, mn.y, mx.z))) return false;
-				if(!App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->CheckPoint(Math::Vector3(mx.x, mn.y, mx.z))) return false;
-				if(!App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->CheckPoint(Math::Vector3(mn.x, mx.y, mn.z))) return false;
-				if(!App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->CheckPoint(Math::Vector3(mx.x, mx.y, mn.z))) return false;
-				if(!App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->CheckPoint(Math::Vector3(mn.x, mx.y, mx.z))) return false;
-				if(!App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->CheckPoint(Math::Vector3(mx.x, mx.y, mx.z))) return false;
-				return true;
-			};
-			
-			if(bSingleCell || FullyInside())
-			{ // Found cell at minimal size or fully inside frustum.
-				SetChunksInExtentsToRender(mnInt, mxInt);
-			}
-			else
-			{ // Continue with recursion.
-				Math::Vector3 half[2];
-				for(size_t i = 0; i < 3; ++i)
-				{
-					if(diff[i] & 0x1)
-					{ // Odd
-						half[0][i] = m_data.blockSize * ((diff[i] >> 1) * chunkSize[i]);
-						half[1][i] = m_data.blockSize * (((diff[i] >> 1) + 1) * chunkSize[i]);
-					}
-					else
-					{ // Even
-						half[0][i] = half[1][i] = m_data.blockSize * ((diff[i] >> 1) * chunkSize[i]);
-					}
-				}
-			
-				u32 mnMask = 0xFF;
-
-				if(half[0].x == 0) mnMask &= ~(2 | 8 | 32 | 128);
-				if(half[0].y == 0) mnMask &= ~(16 | 32 | 64 | 128);
-				if(half[0].z == 0) mnMask &= ~(4 | 8 | 64 | 128);
-				
-				for(u32 i = 0; i < 2; ++i)
-				{
-					for(u32 j = 0; j < 3; ++j)
-					{
-						half[i][j] = std::max(m_data.blockSize * chunkSize[j], half[i][j]);
-					}
-				}
-
-				const Math::Vector3 mnList[] = {
-					{ mn.x, mn.y, mn.z },
-					{ mn.x + half[1].x, mn.y, mn.z },
-					{ mn.x, mn.y, mn.z + half[1].z },
-					{ mn.x + half[1].x, mn.y, mn.z + half[1].z },
-
-					{ mn.x, mn.y + half[1].y, mn.z },
-					{ mn.x + half[1].x, mn.y + half[1].y, mn.z },
-					{ mn.x, mn.y + half[1].y, mn.z + half[1].z },
-					{ mn.x + half[1].x, mn.y + half[1].y, mn.z + half[1].z },
-				};
-
-				for(u32 i = 0; i < 8; ++i)
-				{
-					if(mnMask & (0x1 << i))
-					{
-						FrustumCulling(mnList[i], mnList[i] + Math::Vector3(half[!(i & 1)].x, half[!((i >> 2) & 1)].y, half[!((i >> 1) & 1)].z));
-					}
-				}
-			}
-		}
-	}
-
-	void CChunkNode::SetChunksInExtentsToRender(const Math::VectorInt3& mn, const Math::VectorInt3& mx) const
-	{
-		for(int i = mn.x; i < mx.x; ++i)
-		{
-			for(int j = mn.y; j < mx.y; ++j)
-			{
-				for(int k = mn.z; k < mx.z; ++k)
-				{
-					CChunk* pChunk = App::CSceneManager::Instance().UniverseManager().ChunkManager().GetChunk(this, Math::VectorInt3(i, j, k));
-					if(pChunk)
-					{
-						App::CSceneManager::Instance().UniverseManager().ChunkManager().QueueChunkRender(pChunk);
-					}
-				}
-			}
-		}
-	}
 };
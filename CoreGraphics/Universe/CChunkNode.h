@@ -12,6 +12,8 @@
 #define CCHUNKNODE_H
 
 #include "CChunkData.h"
+#include "CChunkMeshOptimizer.h"
+#include "CChunkSurfaceNets.h"
 #include "../Physics/CVolumeChunk.h"
 #include <Logic/CTransform.h>
 #include <Logic/CCallback.h>
@@ -35,6 +37,9 @@ namespace Universe
 			u32 chunkWidth = 32;
 			u32 chunkHeight = 32;
 			u32 chunkLength = 32;
+			u8 meshOptimizeFlags = MESH_OPTIMIZE_DEFAULT;
+			MESH_SURFACE meshSurface = MESH_SURFACE_BLOCKY;
+			u8 lodLevelMax = 0; // LOD levels kept beside the blocks. Every level is stored at full resolution, so each one costs another full block list per chunk.
 
 			class CChunkGen* pChunkGen = nullptr;
 		};
@@ -66,24 +71,20 @@ namespace Universe
 		Block ReadBlock(const std::pair<Math::VectorInt3, u32>& indices) const;
 		void WriteBlock(Block block, const std::pair<Math::VectorInt3, u32>& indices);
 		
-		void ReadBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)> func) const;
-		void WriteBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)> func);
+		void ReadBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)>& func) const;
+		void WriteBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)>& func);
 		
-		void ReadWriteBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)> funcWrite, 
-			std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)> funcRead);
-		void ReadPaintBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)> funcWrite, 
-			std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)> funcRead);
+		void ReadWriteBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)>& funcWrite, 
+			const std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)>& funcRead);
+		void ReadPaintBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<bool(u32, const std::pair<Math::VectorInt3, u32>&, Block&)>& funcWrite, 
+			const std::function<void(u32, Block, const std::pair<Math::VectorInt3, u32>&)>& funcRead);
 
 	private:
-		void ProcessBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, std::function<void(u32, const std::pair<Math::VectorInt3, u32>&, class CChunk*)> func);
-		void ProcessBlocksInExtentsRO(const Math::Vector3& mn, const Math::Vector3& mx, std::function<void(u32, const std::pair<Math::VectorInt3, u32>&, class CChunk*)> func, 
-			std::function<class CChunk*(const Math::VectorInt3&)> onChunkNotFound = nullptr) const;
-		
-		void FrustumCulling(const Math::Vector3& mn, const Math::Vector3& mx) const;
-		void SetChunksInExtentsToRender(const Math::VectorInt3& mn, const Math::VectorInt3& mx) const;
+		void ProcessBlocksInExtents(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<void(u32, const std::pair<Math::VectorInt3, u32>&, class CChunk*)>& func);
+		void ProcessBlocksInExtentsRO(const Math::Vector3& mn, const Math::Vector3& mx, const std::function<void(u32, const std::pair<Math::VectorInt3, u32>&, class CChunk*)>& func, 
+			const std::function<class CChunk*(const Math::VectorInt3&)>& onChunkNotFound = nullptr) const;
 
 	public:
-		void FrustumCulling() const;
 		class CChunk* CreateChunk(const Math::VectorInt3& coords);
 
 		// Accessors.
@@ -128,6 +129,9 @@ namespace Universe
 		inline float GetChunkHeight() const { return static_cast<float>(m_data.chunkHeight) * m_data.blockSize; }
 		inline float GetChunkLength() const { return static_cast<float>(m_data.chunkLength) * m_data.blockSize; }
 		inline float GetBlockSize() const { return m_data.blockSize; }
+		inline u8 GetMeshOptimizeFlags() const { return m_data.meshOptimizeFlags; }
+		inline MESH_SURFACE GetMeshSurface() const { return m_data.meshSurface; }
+		inline u8 GetLODLevelMax() const { return m_data.lodLevelMax; }
 		
 		inline Math::Vector3 GetChunkSize() const
 		{
@@ -163,8 +167,6 @@ namespace Universe
 
 		Abool m_bWorkspaceActive;
 		
-		Math::Vector3 m_minExtents;
-		Math::Vector3 m_maxExtents;
 		Math::Vector3 m_minExtentsPhysics;
 		Math::Vector3 m_maxExtentsPhysics;
 		Math::Vector3 m_minExtentsLocal;
@@ -0,0 +1,403 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkOcclusion.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkOcclusion.h"
+#include "CChunk.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Universe
+{
+	// Corner indices of each face, wound consistently. Corner n is { n & 1 ? mx.x : mn.x, n & 2 ? mx.y : mn.y, n & 4 ? mx.z : mn.z }.
+	static const u32 FACE_CORNER_LIST[6][4] = {
+		{ 0, 2, 6, 4 }, // Left.
+		{ 1, 5, 7, 3 }, // Right.
+		{ 0, 4, 5, 1 }, // Bottom.
+		{ 2, 3, 7, 6 }, // Top.
+		{ 0, 1, 3, 2 }, // Back.
+		{ 4, 6, 7, 5 }, // Front.
+	};
+
+	static inline Math::Vector3 GetCorner(const Math::Vector3& mn, const Math::Vector3& mx, u32 corner)
+	{
+		return Math::Vector3(corner & 1 ? mx.x : mn.x, corner & 2 ? mx.y : mn.y, corner & 4 ? mx.z : mn.z);
+	}
+
+	CChunkOcclusion::CChunkOcclusion() :
+		m_width(0),
+		m_viewProj{ }
+	{
+	}
+
+	CChunkOcclusion::~CChunkOcclusion()
+	{
+	}
+
+	void CChunkOcclusion::Initialize()
+	{
+		m_width = (std::max(m_data.width, 4U) + 3) & ~3U;
+		m_depthBuffer.assign(m_width * m_data.height, FLT_MAX);
+	}
+
+	void CChunkOcclusion::Release()
+	{
+		m_depthBuffer.clear();
+		m_occluderList.clear();
+		m_rasterList.clear();
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Raster methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// Clears the depth buffer for a new view. The matrix is expected as view * projection, transforming column vectors.
+	void CChunkOcclusion::Begin(const Math::SIMDMatrix& viewProj)
+	{
+		memcpy(m_viewProj, viewProj.f32, sizeof(m_viewProj));
+		std::fill(m_depthBuffer.begin(), m_depthBuffer.end(), FLT_MAX);
+	}
+
+	// Rasterizes the faces of a box listed in a SIDE_FLAG mask. 'pSharedEdgeList' optionally holds a mask per face, with bit n set when
+	//  the edge from corner n to corner n + 1 borders the same face of another occluder.
+	void CChunkOcclusion::RenderOccluder(const Math::Vector3& mn, const Math::Vector3& mx, u8 faceMask, const u8* pSharedEdgeList)
+	{
+		ScreenVertex vertexList[8];
+		u8 projectedMask = 0;
+
+		for(u32 side = 0; side < 6; ++side)
+		{
+			if((faceMask & (1 << side)) == 0) continue;
+
+			ScreenVertex faceList[4];
+			bool bValid = true;
+			for(u32 n = 0; n < 4 && bValid; ++n)
+			{
+				const u32 corner = FACE_CORNER_LIST[side][n];
+				if((projectedMask & (1 << corner)) == 0)
+				{
+					projectedMask |= 1 << corner;
+					if(!Project(GetCorner(mn, mx, corner), vertexList[corner]))
+					{ // Mark the corner so that faces sharing it are rejected too.
+						vertexList[corner].z = -1.0f;
+					}
+				}
+
+				faceList[n] = vertexList[corner];
+				bValid = faceList[n].z >= 0.0f;
+			}
+
+			// Faces crossing the near plane are skipped rather than clipped. This only loses occlusion, never correctness.
+			if(!bValid) continue;
+
+			RasterizeQuad(faceList, pSharedEdgeList ? pSharedEdgeList[side] : 0);
+		}
+	}
+
+	// Faces only write pixels they cover entirely, at the farthest depth the face reaches within each pixel. Shared edges are the
+	//  exception: they're sampled at pixel centers instead, so that neighbouring faces leave no gap along the seam between them.
+	//  A face is rasterized whole rather than as two triangles for the same reason.
+	void CChunkOcclusion::RasterizeQuad(const ScreenVertex (&vertexList)[4], u8 sharedEdgeMask)
+	{
+		float area = 0.0f;
+		for(u32 n = 0; n < 4; ++n)
+		{
+			const ScreenVertex& p = vertexList[n];
+			const ScreenVertex& q = vertexList[(n + 1) & 3];
+			area += p.x * q.y - p.y * q.x;
+		}
+
+		if(fabsf(area) < 1e-6f) return;
+		const float winding = area < 0.0f ? -1.0f : 1.0f;
+
+		float xMin = FLT_MAX, yMin = FLT_MAX;
+		float xMax = -FLT_MAX, yMax = -FLT_MAX;
+		for(const ScreenVertex& vertex : vertexList)
+		{
+			xMin = std::min(xMin, vertex.x); xMax = std::max(xMax, vertex.x);
+			yMin = std::min(yMin, vertex.y); yMax = std::max(yMax, vertex.y);
+		}
+
+		if(xMax < 0.0f || yMax < 0.0f || xMin >= static_cast<float>(m_width) || yMin >= static_cast<float>(m_data.height)) return;
+
+		const s32 x0 = std::max(static_cast<s32>(floorf(xMin)), 0) & ~3;
+		const s32 x1 = std::min(static_cast<s32>(floorf(xMax)), static_cast<s32>(m_width) - 1);
+		const s32 y0 = std::max(static_cast<s32>(floorf(yMin)), 0);
+		const s32 y1 = std::min(static_cast<s32>(floorf(yMax)), static_cast<s32>(m_data.height) - 1);
+
+		// Edge functions are positive inside. The function of a shared edge is the exact negation of its neighbour's, so every pixel
+		//  center along the seam passes for at least one of the two faces. Other edges are pulled in by half a pixel's extent.
+		float a[4], b[4], c[4];
+		for(u32 e = 0; e < 4; ++e)
+		{
+			const ScreenVertex& p = vertexList[e];
+			const ScreenVertex& q = vertexList[(e + 1) & 3];
+			a[e] = (p.y - q.y) * winding;
+			b[e] = (q.x - p.x) * winding;
+			c[e] = (p.x * q.y - p.y * q.x) * winding;
+			if((sharedEdgeMask & (1 << e)) == 0) c[e] -= 0.5f * (fabsf(a[e]) + fabsf(b[e]));
+		}
+
+		// Depth plane from the larger of the face's two triangles, biased toward the far side of each pixel.
+		const ScreenVertex& v0 = vertexList[0];
+		const ScreenVertex* pV1 = &vertexList[1];
+		const ScreenVertex* pV2 = &vertexList[2];
+		float triangleArea = (pV1->x - v0.x) * (pV2->y - v0.y) - (pV1->y - v0.y) * (pV2->x - v0.x);
+		const float otherArea = (vertexList[2].x - v0.x) * (vertexList[3].y - v0.y) - (vertexList[2].y - v0.y) * (vertexList[3].x - v0.x);
+		if(fabsf(otherArea) > fabsf(triangleArea))
+		{
+			pV1 = &vertexList[2];
+			pV2 = &vertexList[3];
+			triangleArea = otherArea;
+		}
+
+		const float invArea = 1.0f / triangleArea;
+		const float dzdx = ((pV1->z - v0.z) * (pV2->y - v0.y) - (pV2->z - v0.z) * (pV1->y - v0.y)) * invArea;
+		const float dzdy = ((pV2->z - v0.z) * (pV1->x - v0.x) - (pV1->z - v0.z) * (pV2->x - v0.x)) * invArea;
+		const float z0 = v0.z - dzdx * v0.x - dzdy * v0.y + 0.5f * (fabsf(dzdx) + fabsf(dzdy));
+
+		const vf32 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const vf32 zero = _mm_setzero_ps();
+		const vf32 a0 = _mm_set1_ps(a[0]), a1 = _mm_set1_ps(a[1]), a2 = _mm_set1_ps(a[2]), a3 = _mm_set1_ps(a[3]);
+		const vf32 vdzdx = _mm_set1_ps(dzdx);
+
+		for(s32 y = y0; y <= y1; ++y)
+		{
+			const float py = static_cast<float>(y) + 0.5f;
+			const vf32 r0 = _mm_set1_ps(b[0] * py + c[0]);
+			const vf32 r1 = _mm_set1_ps(b[1] * py + c[1]);
+			const vf32 r2 = _mm_set1_ps(b[2] * py + c[2]);
+			const vf32 r3 = _mm_set1_ps(b[3] * py + c[3]);
+			const vf32 rz = _mm_set1_ps(dzdy * py + z0);
+
+			float* pRow = m_depthBuffer.data() + y * m_width;
+
+			for(s32 x = x0; x <= x1; x += 4)
+			{
+				const vf32 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset);
+
+				vf32 mask = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), r0), zero);
+				mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), r1), zero));
+				mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), r2), zero));
+				mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a3, px), r3), zero));
+				if(_mm_movemask_ps(mask) == 0) continue;
+
+				const vf32 depth = _mm_add_ps(_mm_mul_ps(vdzdx, px), rz);
+				const vf32 current = _mm_loadu_ps(pRow + x);
+				const vf32 nearest = _mm_min_ps(current, depth);
+				_mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(mask, nearest), _mm_andnot_ps(mask, current)));
+			}
+		}
+	}
+
+	// Returns false only if every pixel the box covers holds an occluder nearer than the box's nearest point. Pixels are tested
+	//  against the convex outline of the projected corners, grown by half a pixel, rather than against its bounding rectangle.
+	bool CChunkOcclusion::TestBox(const Math::Vector3& mn, const Math::Vector3& mx) const
+	{
+		ScreenVertex vertexList[8];
+		float xMin = FLT_MAX, yMin = FLT_MAX, zMin = FLT_MAX;
+		float xMax = -FLT_MAX, yMax = -FLT_MAX;
+
+		for(u32 corner = 0; corner < 8; ++corner)
+		{
+			ScreenVertex& vertex = vertexList[corner];
+			if(!Project(GetCorner(mn, mx, corner), vertex) || vertex.z < 0.0f)
+			{ // Boxes crossing the near plane are always visible.
+				return true;
+			}
+
+			xMin = std::min(xMin, vertex.x); xMax = std::max(xMax, vertex.x);
+			yMin = std::min(yMin, vertex.y); yMax = std::max(yMax, vertex.y);
+			zMin = std::min(zMin, vertex.z);
+		}
+
+		if(xMax < 0.0f || yMax < 0.0f || xMin >= static_cast<float>(m_width) || yMin >= static_cast<float>(m_data.height)) return false;
+
+		// Build the outline with a monotone chain, counter clockwise. The last point repeats the first.
+		std::sort(std::begin(vertexList), std::end(vertexList), [](const ScreenVertex& a, const ScreenVertex& b){
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		});
+
+		auto Cross = [](const ScreenVertex& o, const ScreenVertex& a, const ScreenVertex& b){
+			return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+		};
+
+		ScreenVertex hullList[16];
+		u32 hullCount = 0;
+		for(u32 i = 0; i < 8; ++i)
+		{
+			while(hullCount >= 2 && Cross(hullList[hullCount - 2], hullList[hullCount - 1], vertexList[i]) <= 0.0f) --hullCount;
+			hullList[hullCount++] = vertexList[i];
+		}
+
+		for(u32 i = 7, upperStart = hullCount + 1; i-- > 0;)
+		{
+			while(hullCount >= upperStart && Cross(hullList[hullCount - 2], hullList[hullCount - 1], vertexList[i]) <= 0.0f) --hullCount;
+			hullList[hullCount++] = vertexList[i];
+		}
+
+		--hullCount;
+
+		// A degenerate outline falls back to the bounding rectangle alone.
+		float a[8], b[8], c[8];
+		const u32 edgeCount = hullCount >= 3 ? hullCount : 0;
+		for(u32 e = 0; e < edgeCount; ++e)
+		{
+			const ScreenVertex& p = hullList[e];
+			const ScreenVertex& q = hullList[e + 1];
+			a[e] = p.y - q.y;
+			b[e] = q.x - p.x;
+			c[e] = p.x * q.y - p.y * q.x + 0.5f * (fabsf(a[e]) + fabsf(b[e]));
+		}
+
+		const s32 x0 = std::max(static_cast<s32>(floorf(xMin)), 0);
+		const s32 x1 = std::min(static_cast<s32>(floorf(xMax)), static_cast<s32>(m_width) - 1);
+		const s32 y0 = std::max(static_cast<s32>(floorf(yMin)), 0);
+		const s32 y1 = std::min(static_cast<s32>(floorf(yMax)), static_cast<s32>(m_data.height) - 1);
+
+		const vf32 depth = _mm_set1_ps(zMin);
+		const vf32 zero = _mm_setzero_ps();
+		const vf32 laneIndex = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		const vf32 laneOffset = _mm_set1_ps(0.5f);
+		const vf32 xFirst = _mm_set1_ps(static_cast<float>(x0));
+		const vf32 xLast = _mm_set1_ps(static_cast<float>(x1));
+
+		for(s32 y = y0; y <= y1; ++y)
+		{
+			const float py = static_cast<float>(y) + 0.5f;
+			const float* pRow = m_depthBuffer.data() + y * m_width;
+
+			for(s32 x = x0 & ~3; x <= x1; x += 4)
+			{
+				const vf32 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneIndex);
+				vf32 inside = _mm_and_ps(_mm_cmpge_ps(px, xFirst), _mm_cmple_ps(px, xLast));
+
+				const vf32 center = _mm_add_ps(px, laneOffset);
+				for(u32 e = 0; e < edgeCount; ++e)
+				{
+					const vf32 edge = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[e]), center), _mm_set1_ps(b[e] * py + c[e]));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(edge, zero));
+				}
+
+				const vf32 visible = _mm_cmpge_ps(_mm_loadu_ps(pRow + x), depth);
+				if(_mm_movemask_ps(_mm_and_ps(inside, visible))) return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Projects a world space point into pixel coordinates and normalized depth. Fails for points behind the eye.
+	bool CChunkOcclusion::Project(const Math::Vector3& point, ScreenVertex& vertex) const
+	{
+		float clip[4];
+		for(u32 i = 0; i < 4; ++i)
+		{
+			clip[i] = m_viewProj[i][0] * point.x + m_viewProj[i][1] * point.y + m_viewProj[i][2] * point.z + m_viewProj[i][3];
+		}
+
+		if(clip[3] <= 1e-6f) return false;
+
+		const float invW = 1.0f / clip[3];
+		vertex.x = (clip[0] * invW * 0.5f + 0.5f) * static_cast<float>(m_width);
+		vertex.y = (clip[1] * invW * 0.5f + 0.5f) * static_cast<float>(m_data.height);
+		vertex.z = clip[2] * invW;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Cull methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// Rasterizes the nearest occluders among the given chunks, then removes any chunk that is hidden behind them.
+	void CChunkOcclusion::Cull(std::vector<CChunk*>& chunkList, const Math::Vector3& cameraPosition)
+	{
+		m_occluderList.clear();
+
+		for(CChunk* pChunk : chunkList)
+		{
+			if(pChunk->GetSolidFaceMask() == 0) continue;
+
+			Math::Vector3 mn, mx;
+			pChunk->GetBounds(mn, mx);
+			const Math::Vector3 offset = (mn + mx) * 0.5f - cameraPosition;
+			m_occluderList.push_back({ pChunk, offset.LengthSq() });
+		}
+
+		const size_t occluderCount = std::min(m_occluderList.size(), static_cast<size_t>(m_data.occluderBudget));
+		std::partial_sort(m_occluderList.begin(), m_occluderList.begin() + occluderCount, m_occluderList.end(), [](const Occluder& a, const Occluder& b){
+			return a.distanceSq < b.distanceSq;
+		});
+
+		m_rasterList.clear();
+		for(size_t i = 0; i < occluderCount; ++i)
+		{
+			m_rasterList.push_back(m_occluderList[i].pChunk);
+		}
+
+		std::sort(m_rasterList.begin(), m_rasterList.end());
+
+		for(size_t i = 0; i < occluderCount; ++i)
+		{
+			const CChunk* pChunk = m_occluderList[i].pChunk;
+			const u8 faceMask = pChunk->GetSolidFaceMask();
+
+			u8 sharedEdgeList[6] = { };
+			for(u32 side = 0; side < 6; ++side)
+			{
+				if(faceMask & (1 << side)) sharedEdgeList[side] = GetSharedEdgeMask(pChunk, side);
+			}
+
+			Math::Vector3 mn, mx;
+			pChunk->GetBounds(mn, mx);
+			RenderOccluder(mn, mx, faceMask, sharedEdgeList);
+		}
+
+		chunkList.erase(std::remove_if(chunkList.begin(), chunkList.end(), [this](CChunk* pChunk){
+			Math::Vector3 mn, mx;
+			pChunk->GetBounds(mn, mx);
+			return !TestBox(mn, mx);
+		}), chunkList.end());
+	}
+
+	// Returns the edges of a chunk's face that border the same face of a neighbouring chunk rasterized this frame. The neighbour's
+	//  face has to be in front of the near plane too, or it's skipped and the seam is an outer edge after all.
+	u8 CChunkOcclusion::GetSharedEdgeMask(const CChunk* pChunk, u32 side) const
+	{
+		u8 edgeMask = 0;
+		for(u32 n = 0; n < 4; ++n)
+		{
+			const u32 corner0 = FACE_CORNER_LIST[side][n];
+			const u32 corner1 = FACE_CORNER_LIST[side][(n + 1) & 3];
+
+			// The edge runs along one axis and the face faces along another, so the neighbour across the edge lies along the third.
+			const u32 edgeAxis = (corner0 ^ corner1) >> 1;
+			const u32 axis = 3 - (side >> 1) - edgeAxis;
+			const CChunk* pAdj = pChunk->GetAdjacentChunk(static_cast<SIDE>((axis << 1) + ((corner0 >> axis) & 1)));
+
+			if(pAdj == nullptr || (pAdj->GetSolidFaceMask() & (1 << side)) == 0) continue;
+			if(!std::binary_search(m_rasterList.begin(), m_rasterList.end(), pAdj)) continue;
+
+			Math::Vector3 mn, mx;
+			pAdj->GetBounds(mn, mx);
+
+			bool bInFront = true;
+			for(u32 i = 0; i < 4 && bInFront; ++i)
+			{
+				ScreenVertex vertex;
+				bInFront = Project(GetCorner(mn, mx, FACE_CORNER_LIST[side][i]), vertex) && vertex.z >= 0.0f;
+			}
+
+			if(bInFront) edgeMask |= 1 << n;
+		}
+
+		return edgeMask;
+	}
+};
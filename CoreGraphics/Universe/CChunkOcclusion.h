@@ -0,0 +1,93 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkOcclusion.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKOCCLUSION_H
+#define CCHUNKOCCLUSION_H
+
+#include <Math/CMathVector3.h>
+#include <Math/CSIMDMatrix.h>
+#include <Globals/CGlobals.h>
+#include <vector>
+
+namespace Universe
+{
+	// Software occlusion culling against a low resolution depth buffer. Occluders are the completely filled border faces of chunks,
+	//  and are rasterized conservatively so that a chunk is only rejected when every pixel it covers is behind an occluder. Faces of
+	//  neighbouring occluders that meet along an edge are rasterized watertight across it, so a solid layer occludes as a whole.
+	// Nothing here depends on the graphics API, so visibility sets can be produced headlessly from a view projection matrix.
+	class CChunkOcclusion
+	{
+	public:
+		struct Data
+		{
+			bool bEnabled = false;
+			u32 width = 256; // Rounded up to a multiple of 4.
+			u32 height = 128;
+			u32 occluderBudget = 256; // Maximum number of occluder chunks rasterized per frame.
+		};
+
+	private:
+		struct ScreenVertex
+		{
+			float x;
+			float y;
+			float z;
+		};
+
+		struct Occluder
+		{
+			class CChunk* pChunk;
+			float distanceSq;
+		};
+
+	public:
+		CChunkOcclusion();
+		~CChunkOcclusion();
+		CChunkOcclusion(const CChunkOcclusion&) = delete;
+		CChunkOcclusion(CChunkOcclusion&&) = delete;
+		CChunkOcclusion& operator = (const CChunkOcclusion&) = delete;
+		CChunkOcclusion& operator = (CChunkOcclusion&&) = delete;
+
+		void Initialize();
+		void Release();
+
+		void Begin(const Math::SIMDMatrix& viewProj);
+		void RenderOccluder(const Math::Vector3& mn, const Math::Vector3& mx, u8 faceMask, const u8* pSharedEdgeList = nullptr);
+		bool TestBox(const Math::Vector3& mn, const Math::Vector3& mx) const;
+
+		void Cull(std::vector<class CChunk*>& chunkList, const Math::Vector3& cameraPosition);
+
+		// Accessors.
+		inline bool IsEnabled() const { return m_data.bEnabled; }
+		inline u32 GetWidth() const { return m_width; }
+		inline u32 GetHeight() const { return m_data.height; }
+		inline const float* GetDepthBuffer() const { return m_depthBuffer.data(); }
+
+		// Modifiers.
+		inline void SetData(const Data& data) { m_data = data; }
+
+	private:
+		bool Project(const Math::Vector3& point, ScreenVertex& vertex) const;
+		void RasterizeQuad(const ScreenVertex (&vertexList)[4], u8 sharedEdgeMask);
+		u8 GetSharedEdgeMask(const class CChunk* pChunk, u32 side) const;
+
+	private:
+		Data m_data;
+		u32 m_width;
+
+		float m_viewProj[4][4];
+
+		std::vector<float> m_depthBuffer;
+		std::vector<Occluder> m_occluderList;
+		std::vector<const class CChunk*> m_rasterList; // Occluders rasterized this frame, sorted by address.
+	};
+};
+
+#endif
@@ -0,0 +1,95 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkRebuildScheduler.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkRebuildScheduler.h"
+#include "CChunk.h"
+#include <Logic/CCamera.h>
+#include <algorithm>
+
+namespace Universe
+{
+	CChunkRebuildScheduler::CChunkRebuildScheduler() :
+		m_stats{ }
+	{
+	}
+
+	CChunkRebuildScheduler::~CChunkRebuildScheduler()
+	{
+	}
+
+	void CChunkRebuildScheduler::Dispatch(const Logic::CCamera* pCamera, const std::vector<CChunk*>& visibleList)
+	{
+		m_stats = { };
+		if(m_queue.empty()) return;
+
+		m_visibleList.assign(visibleList.begin(), visibleList.end());
+		std::sort(m_visibleList.begin(), m_visibleList.end());
+
+		const Math::Vector3 cameraPosition = *(Math::Vector3*)pCamera->GetTransform()->GetPosition().ToFloat();
+
+		m_activeList.clear();
+		for(CChunk* pChunk : m_queue)
+		{
+			Math::Vector3 mn, mx;
+			pChunk->GetBounds(mn, mx);
+
+			// Distance from the camera to the closest point on the chunk.
+			Math::Vector3 closest;
+			for(size_t i = 0; i < 3; ++i)
+			{
+				closest[i] = std::min(std::max(cameraPosition[i], mn[i]), mx[i]);
+			}
+
+			float priority = (closest - cameraPosition).Length();
+			if(!std::binary_search(m_visibleList.begin(), m_visibleList.end(), pChunk))
+			{
+				priority = (priority + pChunk->GetBlockSize()) * m_data.hiddenPenalty;
+			}
+
+			m_activeList.push_back({ pChunk, priority });
+		}
+
+		m_queue.clear();
+
+		std::sort(m_activeList.begin(), m_activeList.end(), [](const Entry& a, const Entry& b){
+			return a.priority < b.priority;
+		});
+
+		// Every queued chunk is updated so that finished builds are swapped in, but only the nearest get to spend the budget.
+		Budget budget { };
+		budget.buildCount = m_data.buildBudget;
+		budget.deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<s64>(m_data.timeBudget * 1000.0f));
+
+		for(const Entry& entry : m_activeList)
+		{
+			entry.pChunk->ProcessUpdates(budget);
+		}
+
+		m_stats.updateCount = static_cast<u32>(m_activeList.size());
+		m_stats.dispatchCount = budget.dispatchCount;
+		m_stats.cancelCount = budget.cancelCount;
+		m_stats.meshingCount = budget.meshingCount;
+		m_stats.pendingCount = static_cast<u32>(m_queue.size());
+
+		m_activeList.clear();
+	}
+
+	void CChunkRebuildScheduler::Remove(const CChunk* pChunk)
+	{
+		m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), pChunk), m_queue.end());
+	}
+
+	void CChunkRebuildScheduler::Release()
+	{
+		m_queue.clear();
+		m_activeList.clear();
+		m_visibleList.clear();
+	}
+};
@@ -0,0 +1,98 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkRebuildScheduler.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKREBUILDSCHEDULER_H
+#define CCHUNKREBUILDSCHEDULER_H
+
+#include <Math/CMathVector3.h>
+#include <Globals/CGlobals.h>
+#include <chrono>
+#include <vector>
+
+namespace Logic
+{
+	class CCamera;
+};
+
+namespace Universe
+{
+	// Replaces the FIFO chunk update queue. Queued chunks are updated nearest first, with chunks outside the view pushed back, and the
+	//  number of section builds started and the time spent applying block edits are both capped per frame. Whatever doesn't fit stays queued.
+	class CChunkRebuildScheduler
+	{
+	public:
+		struct Data
+		{
+			u32 buildBudget = 16; // Maximum number of section builds started per frame.
+			float timeBudget = 2.0f; // Milliseconds per frame after which chunks stop applying block edits.
+			float hiddenPenalty = 4.0f; // Distance multiplier for chunks that weren't visible last frame.
+		};
+
+		// Handed to each chunk as it's updated, which spends from it.
+		struct Budget
+		{
+			u32 buildCount;
+			u32 dispatchCount;
+			u32 cancelCount;
+			u32 meshingCount;
+			std::chrono::steady_clock::time_point deadline;
+
+			inline bool CanBuild() const { return buildCount > 0; }
+			inline bool HasTime() const { return std::chrono::steady_clock::now() < deadline; }
+		};
+
+		struct Stats
+		{
+			u32 updateCount; // Chunks updated this frame.
+			u32 dispatchCount; // Section builds started this frame.
+			u32 cancelCount; // In flight builds that finished stale, and were discarded.
+			u32 meshingCount; // Chunks with section builds in flight.
+			u32 pendingCount; // Chunks left queued for the next frame.
+		};
+
+	private:
+		struct Entry
+		{
+			class CChunk* pChunk;
+			float priority;
+		};
+
+	public:
+		CChunkRebuildScheduler();
+		~CChunkRebuildScheduler();
+		CChunkRebuildScheduler(const CChunkRebuildScheduler&) = delete;
+		CChunkRebuildScheduler(CChunkRebuildScheduler&&) = delete;
+		CChunkRebuildScheduler& operator = (const CChunkRebuildScheduler&) = delete;
+		CChunkRebuildScheduler& operator = (CChunkRebuildScheduler&&) = delete;
+
+		void Dispatch(const Logic::CCamera* pCamera, const std::vector<class CChunk*>& visibleList);
+		void Remove(const class CChunk* pChunk);
+		void Release();
+
+		// Accessors.
+		inline const Stats& GetStats() const { return m_stats; }
+		inline size_t GetQueuedCount() const { return m_queue.size(); }
+
+		// Modifiers.
+		inline void SetData(const Data& data) { m_data = data; }
+		inline void Queue(class CChunk* pChunk) { m_queue.push_back(pChunk); }
+
+	private:
+		Data m_data;
+		Stats m_stats;
+
+		// Chunks queued while the active list is being updated are left for the next frame.
+		std::vector<class CChunk*> m_queue;
+		std::vector<Entry> m_activeList;
+		std::vector<const class CChunk*> m_visibleList;
+	};
+};
+
+#endif
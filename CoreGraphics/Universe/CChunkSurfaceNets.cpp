@@ -0,0 +1,117 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkSurfaceNets.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CChunkSurfaceNets.h"
+#include "CChunkMeshScratch.h"
+#include "CChunkVertex.h"
+#include <array>
+#include <cmath>
+
+namespace Universe
+{
+	namespace
+	{
+		// Packed offset of the dual cell vertex for each corner mask. Corner c of a cell is the block at (c & 1, (c >> 1) & 1, (c >> 2) & 1) from its
+		//  lowest block, and the vertex is the average of the midpoints of every edge whose corners differ.
+		std::array<u16, 256> BuildOffsetTable()
+		{
+			std::array<u16, 256> table { };
+
+			for(u32 mask = 0; mask < 256; ++mask)
+			{
+				float sum[3] = { 0.0f, 0.0f, 0.0f };
+				u32 crossingCount = 0;
+
+				for(u32 corner = 0; corner < 8; ++corner)
+				{
+					for(u32 axis = 0; axis < 3; ++axis)
+					{
+						const u32 bit = 1 << axis;
+						if((corner & bit) || ((mask >> corner) & 1) == ((mask >> (corner | bit)) & 1)) continue;
+
+						for(u32 a = 0; a < 3; ++a)
+						{
+							if(a != axis) sum[a] += (corner & (1 << a)) ? 0.5f : -0.5f;
+						}
+
+						++crossingCount;
+					}
+				}
+
+				if(crossingCount == 0)
+				{
+					table[mask] = PackedChunkVertex::OFFSET_SMOOTH;
+					continue;
+				}
+
+				s32 offset[3];
+				for(u32 a = 0; a < 3; ++a)
+				{
+					offset[a] = static_cast<s32>(std::lround(sum[a] / static_cast<float>(crossingCount) / PackedChunkVertex::OFFSET_SCALE));
+				}
+
+				table[mask] = PackedChunkVertex::PackOffset(offset[0], offset[1], offset[2]);
+			}
+
+			return table;
+		}
+	};
+
+	void CChunkSurfaceNets::Place(CChunkMeshScratch& scratch, u32 width, u32 length, u32 rowCount)
+	{
+		static const std::array<u16, 256> OFFSET_TABLE = BuildOffsetTable();
+
+		const u32 latticeStride = GetLatticeStride(rowCount);
+		const u32 columnStride = (length + 2) * GetSampleStride(rowCount);
+		const size_t latticeCount = static_cast<size_t>(width + 1) * (length + 1) * latticeStride;
+
+		if(scratch.maskList.size() < latticeCount) scratch.maskList.resize(latticeCount);
+		if(scratch.surfaceOffsetList.size() < latticeCount) scratch.surfaceOffsetList.resize(latticeCount);
+
+		__m128i bitList[8];
+		for(u32 corner = 0; corner < 8; ++corner)
+		{
+			bitList[corner] = _mm_set1_epi8(static_cast<char>(1 << corner));
+		}
+
+		const u8* pSampleList = scratch.sampleList.data();
+		for(u32 x = 0; x <= width; ++x)
+		{
+			for(u32 z = 0; z <= length; ++z)
+			{
+				// The four sample columns around this lattice column, as (dx, dz).
+				const u8* p00 = pSampleList + GetSampleIndex(x, z, 0, length, rowCount);
+				const u8* p01 = p00 + GetSampleStride(rowCount);
+				const u8* p10 = p00 + columnStride;
+				const u8* p11 = p10 + GetSampleStride(rowCount);
+
+				const u32 latticeIndex = GetLatticeIndex(x, z, 0, length, rowCount);
+				u8* pMaskList = scratch.maskList.data() + latticeIndex;
+				u16* pOffsetList = scratch.surfaceOffsetList.data() + latticeIndex;
+
+				for(u32 row = 0; row < latticeStride; row += 16)
+				{
+					auto Corner = [&](const u8* p, u32 dy, u32 corner){
+						return _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + row + dy)), bitList[corner]);
+					};
+
+					const __m128i lo = _mm_or_si128(_mm_or_si128(Corner(p00, 0, 0), Corner(p10, 0, 1)), _mm_or_si128(Corner(p00, 1, 2), Corner(p10, 1, 3)));
+					const __m128i hi = _mm_or_si128(_mm_or_si128(Corner(p01, 0, 4), Corner(p11, 0, 5)), _mm_or_si128(Corner(p01, 1, 6), Corner(p11, 1, 7)));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(pMaskList + row), _mm_or_si128(lo, hi));
+				}
+
+				for(u32 row = 0; row <= rowCount; ++row)
+				{
+					pOffsetList[row] = OFFSET_TABLE[pMaskList[row]];
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,45 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkSurfaceNets.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKSURFACENETS_H
+#define CCHUNKSURFACENETS_H
+
+#include <Globals/CGlobals.h>
+
+namespace Universe
+{
+	enum MESH_SURFACE : u8
+	{
+		MESH_SURFACE_BLOCKY, // Faces on the block lattice, merged as the optimize flags allow.
+		MESH_SURFACE_SMOOTH, // Surface Nets over block occupancy.
+	};
+
+	// Naive Surface Nets with occupancy as the density. Each lattice point (block corner) is the center of a dual cell spanning the eight blocks
+	//  around it, and is moved to the average of the crossings on that cell's edges. The chunk then emits its usual visible faces through the moved
+	//  corners, so culling and border handling are shared with the blocky mesher, and the two only differ in where corners end up.
+	// Occupancy is sampled into a padded grid of 0x00 and 0xFF bytes, one column per (x, z) with rows contiguous, so the corner masks of sixteen
+	//  lattice points are built at once with SSE2, and placement is a table lookup per point.
+	class CChunkSurfaceNets
+	{
+	public:
+		// Samples cover blocks -1 through width (and length) across, and the row below the first lattice row through the row above the last.
+		//  Columns are padded so every lattice row can be read sixteen at a time.
+		static inline u32 GetLatticeStride(u32 rowCount) { return (rowCount + 16) & ~15U; }
+		static inline u32 GetSampleStride(u32 rowCount) { return GetLatticeStride(rowCount) + 16; }
+		static inline u32 GetSampleIndex(u32 x, u32 z, u32 row, u32 length, u32 rowCount) { return (x * (length + 2) + z) * GetSampleStride(rowCount) + row; }
+		static inline u32 GetLatticeIndex(u32 x, u32 z, u32 row, u32 length, u32 rowCount) { return (x * (length + 1) + z) * GetLatticeStride(rowCount) + row; }
+
+		// Fills the scratch's surface offset list, in PackedChunkVertex::PackOffset form, for lattice points 0 through width, 0 through length,
+		//  and rows 0 through rowCount, from the scratch's sample list.
+		static void Place(class CChunkMeshScratch& scratch, u32 width, u32 length, u32 rowCount);
+	};
+};
+
+#endif
@@ -0,0 +1,136 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Static Library: Core Graphics
+//
+// File: Universe/CChunkVertex.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CCHUNKVERTEX_H
+#define CCHUNKVERTEX_H
+
+#include "CChunkData.h"
+#include "CBlockRegistry.h"
+#include <Math/CMathVector3.h>
+#include <Math/CMathVector4.h>
+#include <Globals/CGlobals.h>
+
+namespace Universe
+{
+	// Unpacked chunk vertex, matching what Voxel.shader reconstructs from a packed vertex.
+	struct ChunkVertex
+	{
+		Math::Vector3 position;
+		Math::Vector3 normal;
+		Math::Vector3 tangent;
+		Math::Vector4 texCoord;
+	};
+
+	// Chunk vertex packed into two 32-bit words.
+	//  Word 0: x (6) | y (6) | z (6) | normal (3) | tangent (3) | bitangent (3) | unused (5).
+	//  Word 1: block id (8) | cutout (1) | ambient occlusion (2) | sky light (4) | block light (4) | offset x, y, z (4 each) | smooth (1).
+	// Positions are chunk local vertex coordinates, and axes index SIDE_NORMAL. Texture coordinates are derived from both, as the mesher does.
+	// Smooth surfaces move each vertex off the lattice by a signed offset in eighths of a block, and are lit with the triangle's own normal.
+	struct PackedChunkVertex
+	{
+		static const u32 COORD_MAX = 0x3F;
+		static const u32 CUTOUT_BIT = 0x100; // Alpha tested by Voxel.shader. Taken from the block registry when packed.
+		static const u32 SHADE_SHIFT = 9;
+		static const u32 SHADE_MASK = 0x3FF;
+		static constexpr u16 SHADE_DEFAULT = 0x3FF; // Unoccluded, in full light.
+		static const u32 OFFSET_SHIFT = 19;
+		static const u32 OFFSET_MASK = 0x1FFF;
+		static constexpr u16 OFFSET_NONE = 0x0;
+		static constexpr u16 OFFSET_SMOOTH = 0x1000; // Set on every vertex of a smooth surface, including those left on the lattice.
+		static constexpr float OFFSET_SCALE = 1.0f / 8.0f;
+
+		u32 word0;
+		u32 word1;
+
+		static inline u8 GetAxisIndex(const Math::Vector3& axis)
+		{
+			for(u8 i = 0; i < 6; ++i)
+			{
+				if(SIDE_NORMAL[i] == axis) return i;
+			}
+
+			return 0;
+		}
+
+		// Baked vertex shading: ambient occlusion from 0 (fully occluded) to 3, and sky and block light levels up to 15.
+		static inline u16 PackShade(u8 ao, u8 sky, u8 block)
+		{
+			return static_cast<u16>((ao & 0x3) | ((sky & 0xF) << 2) | ((block & 0xF) << 6));
+		}
+
+		// Offset of a smooth surface vertex from its lattice point, with each component in eighths of a block from -8 to 7.
+		static inline u16 PackOffset(s32 x, s32 y, s32 z)
+		{
+			return static_cast<u16>(OFFSET_SMOOTH | (x & 0xF) | ((y & 0xF) << 4) | ((z & 0xF) << 8));
+		}
+
+		static inline Math::Vector3 UnpackOffset(u16 offset)
+		{
+			auto Component = [offset](u32 shift){
+				return static_cast<float>((static_cast<s32>((offset >> shift) & 0xF) ^ 0x8) - 0x8) * OFFSET_SCALE;
+			};
+
+			return Math::Vector3(Component(0), Component(4), Component(8));
+		}
+
+		static inline PackedChunkVertex Pack(u32 x, u32 y, u32 z, u8 normal, u8 tangent, u8 bitangent, BlockId id, u16 shade = SHADE_DEFAULT, u16 offset = OFFSET_NONE)
+		{
+			PackedChunkVertex vertex;
+			vertex.word0 = (x & COORD_MAX) | ((y & COORD_MAX) << 6) | ((z & COORD_MAX) << 12) | ((normal & 0x7) << 18) | ((tangent & 0x7) << 21) | ((bitangent & 0x7) << 24);
+			vertex.word1 = id | (CBlockRegistry::Instance().IsCutout(id) ? CUTOUT_BIT : 0) | ((shade & SHADE_MASK) << SHADE_SHIFT) | ((offset & OFFSET_MASK) << OFFSET_SHIFT);
+			return vertex;
+		}
+
+		static inline PackedChunkVertex Pack(const Math::Vector3& position, const Math::Vector3& normal, const Math::Vector3& tangent, const Math::Vector3& bitangent, BlockId id,
+			u16 shade = SHADE_DEFAULT, u16 offset = OFFSET_NONE)
+		{
+			return Pack(static_cast<u32>(position.x + 0.5f), static_cast<u32>(position.y + 0.5f), static_cast<u32>(position.z + 0.5f),
+				GetAxisIndex(normal), GetAxisIndex(tangent), GetAxisIndex(bitangent), id, shade, offset);
+		}
+
+		inline Math::Vector3 GetPosition() const
+		{
+			return Math::Vector3(static_cast<float>(word0 & COORD_MAX), static_cast<float>((word0 >> 6) & COORD_MAX), static_cast<float>((word0 >> 12) & COORD_MAX)) +
+				UnpackOffset(GetOffset());
+		}
+
+		inline BlockId GetId() const { return static_cast<BlockId>(word1 & 0xFF); }
+		inline u16 GetShade() const { return static_cast<u16>((word1 >> SHADE_SHIFT) & SHADE_MASK); }
+		inline u16 GetOffset() const { return static_cast<u16>((word1 >> OFFSET_SHIFT) & OFFSET_MASK); }
+
+		// Mirrors the unpacking done in Voxel.shader, with the chunk's offset and block size taking the place of its world matrix.
+		inline ChunkVertex Unpack(const Math::Vector3& offset, float blockSize) const
+		{
+			static const float u = 1.0f / 8.0f;
+			static const float v = 1.0f / 32.0f;
+
+			const Math::Vector3 position = GetPosition();
+			const Math::Vector3& normal = SIDE_NORMAL[(word0 >> 18) & 0x7];
+			const Math::Vector3& tangent = SIDE_NORMAL[(word0 >> 21) & 0x7];
+			const Math::Vector3& bitangent = SIDE_NORMAL[(word0 >> 24) & 0x7];
+			const BlockId id = GetId();
+
+			return {
+				offset + position * blockSize,
+				normal,
+				tangent,
+				Math::Vector4(Math::Vector3::Dot(tangent, position), Math::Vector3::Dot(bitangent, position), u * (id % 8), v * (id / 8))
+			};
+		}
+
+		// Used to verify packing against the float reference. Texture coordinates are compared exactly since both sides derive them identically.
+		static inline bool IsEquivalent(const ChunkVertex& a, const ChunkVertex& b)
+		{
+			return (a.position - b.position).LengthSq() < 1e-8f && a.normal == b.normal && a.tangent == b.tangent && a.texCoord == b.texCoord;
+		}
+	};
+};
+
+#endif
@@ -25,6 +25,8 @@ namespace Util
 	
 	void CGarbage::Process()
 	{
+		if(CFactory::Instance().IsHeadless()) return;
+
 		const u64 frame = CFactory::Instance().GetGraphicsAPI()->GetFrame();
 
 		Garbage g;
@@ -48,6 +50,12 @@ namespace Util
 	
 	void CGarbage::Dispose(std::function<void()> func)
 	{
+		if(CFactory::Instance().IsHeadless())
+		{ // Without a device nothing can still be in flight, so there's no frame to wait out.
+			func();
+			return;
+		}
+
 		Garbage g = { CFactory::Instance().GetGraphicsAPI()->GetFrame(), func };
 		m_garbageDeque.PushBack(g);
 	}
@@ -13,6 +13,12 @@
 #include "../Graphics/CGraphicsWorker.h"
 #include "../Graphics/CGraphicsAPI.h"
 #include "../Factory/CFactory.h"
+#include <Utilities/CFrameAllocator.h>
+#include <Utilities/CAllocTracker.h>
+#include <Utilities/CProfiler.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
 
 namespace Util
 {
@@ -20,7 +26,10 @@ namespace Util
 
 	CJobSystem::CJobSystem() : 
 		m_exitFlag(false),
-		m_threadCount(4)
+		m_threadCount(4),
+		m_pQueuedMetric(CMetrics::Instance().GetGauge("jobs.queued")),
+		m_pRunningMetric(CMetrics::Instance().GetGauge("jobs.running")),
+		m_pDurationMetric(CMetrics::Instance().GetHistogram("jobs.durationMicros"))
 	{
 	}
 
@@ -58,7 +67,7 @@ namespace Util
 		std::packaged_task<void()> task;
 		while(m_syncDeque.TryPopFront(task))
 		{
-			task();
+			RunTask(task, "Job (sync)");
 		}
 	}
 	
@@ -92,6 +101,8 @@ namespace Util
 
 		std::future<void> f = task.get_future();
 
+		m_pQueuedMetric->Add(1);
+
 		if(bAsync)
 		{
 			m_asyncDeque.PushBack(task);
@@ -112,6 +123,8 @@ namespace Util
 
 		std::future<void> f = task.get_future();
 		
+		m_pQueuedMetric->Add(1);
+
 		if(bAsync)
 		{
 			m_asyncDeque.PushBack(task);
@@ -132,6 +145,8 @@ namespace Util
 
 		std::future<void> f = task.get_future();
 		
+		m_pQueuedMetric->Add(1);
+
 		if(bAsync)
 		{
 			m_asyncDeque.PushBack(task);
@@ -144,6 +159,65 @@ namespace Util
 		return f;
 	}
 	
+	// Splits [0, count) into batches that are pulled by the calling thread and up to m_threadCount async jobs.
+	//  The caller always participates, so this is safe to use even when every job thread is busy.
+	void CJobSystem::ParallelFor(u32 count, u32 batchSize, std::function<void(u32, u32)> func)
+	{
+		if(count == 0) return;
+
+		batchSize = std::max(batchSize, 1U);
+		const u32 batchCount = (count + batchSize - 1) / batchSize;
+
+		if(batchCount == 1 || m_exitFlag)
+		{
+			func(0, count);
+			return;
+		}
+
+		struct Context
+		{
+			std::function<void(u32, u32)> func;
+			u32 count;
+			u32 batchSize;
+			u32 batchCount;
+			Au32 nextBatch;
+			Au32 completeCount;
+		};
+
+		// Shared so that jobs which start after the caller has finished only ever touch valid memory.
+		auto pContext = std::make_shared<Context>();
+		pContext->func = func;
+		pContext->count = count;
+		pContext->batchSize = batchSize;
+		pContext->batchCount = batchCount;
+		pContext->nextBatch = 0;
+		pContext->completeCount = 0;
+
+		auto Drain = [](Context* pContext){
+			u32 batch;
+			while((batch = pContext->nextBatch++) < pContext->batchCount)
+			{
+				PROFILE_ZONE("ParallelFor batch");
+				const u32 start = batch * pContext->batchSize;
+				pContext->func(start, std::min(start + pContext->batchSize, pContext->count));
+				++pContext->completeCount;
+			}
+		};
+
+		const u32 jobCount = std::min(batchCount - 1, m_threadCount);
+		for(u32 i = 0; i < jobCount; ++i)
+		{
+			JobCPU([pContext, Drain](){ Drain(pContext.get()); }, true);
+		}
+
+		Drain(pContext.get());
+
+		while(pContext->completeCount < batchCount)
+		{
+			std::this_thread::yield();
+		}
+	}
+	
 	//-----------------------------------------------------------------------------------------------
 	// Jobs thread, each with a separate worker.
 	//-----------------------------------------------------------------------------------------------
@@ -153,12 +227,17 @@ namespace Util
 		// Initialize per thread worker.
 		m_worker.Initialize(false);
 		std::packaged_task<void()> task;
+		PROFILE_THREAD("Job");
 
 		while(!m_exitFlag)
 		{
 			if(m_asyncDeque.TryPopFront(task))
 			{
-				task();
+				RunTask(task, "Job");
+
+				// Each job is a frame as far as scratch memory goes.
+				Util::CAllocTracker::Instance().EndFrame();
+				Util::CFrameAllocator::Instance().Reset();
 				std::this_thread::yield();
 			}
 			else
@@ -171,4 +250,19 @@ namespace Util
 
 		p.set_value();
 	}
+
+	void CJobSystem::RunTask(std::packaged_task<void()>& task, const char* zoneName)
+	{
+		m_pQueuedMetric->Add(-1);
+		m_pRunningMetric->Add(1);
+
+		const auto start = std::chrono::steady_clock::now();
+		{
+			PROFILE_ZONE(zoneName);
+			task();
+		}
+
+		m_pDurationMetric->Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+		m_pRunningMetric->Add(-1);
+	}
 };
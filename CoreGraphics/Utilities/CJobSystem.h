@@ -15,6 +15,7 @@
 #include <Globals/CGlobals.h>
 #include <Utilities/CTSDeque.h>
 #include <Utilities/CDeque.h>
+#include <Utilities/CMetrics.h>
 #include <functional>
 #include <future>
 
@@ -60,11 +61,16 @@ namespace Util
 		std::future<void> JobGraphics(std::function<void()> func, bool bAsync);
 		std::future<void> JobCompute(std::function<void()> func, bool bAsync);
 
+		void ParallelFor(u32 count, u32 batchSize, std::function<void(u32, u32)> func);
+
 		// Accessors.
+		inline u32 GetThreadCount() const { return m_threadCount; }
+
 		static CWorker& GetWorker() { return m_worker; }
 
 	private:
 		void JobThread(std::promise<void> p);
+		void RunTask(std::packaged_task<void()>& task, const char* zoneName);
 
 	private:
 		Abool m_exitFlag;
@@ -75,6 +81,10 @@ namespace Util
 		Util::CDeque<std::future<void>> m_threadDeque;
 
 		static thread_local CWorker m_worker;
+
+		CMetrics::Gauge* m_pQueuedMetric;
+		CMetrics::Gauge* m_pRunningMetric;
+		CMetrics::Histogram* m_pDurationMetric; // Microseconds per job.
 	};
 };
 
@@ -0,0 +1,61 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Console Application: Headless Runner
+//
+// File: Actors/CHeadlessBody.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CHeadlessBody.h"
+
+namespace Actor
+{
+	CHeadlessBody::CHeadlessBody(const std::wstring& name, const Math::Vector3& position, float radius) :
+		CVObject(name),
+		m_radius(radius),
+		m_transform(this),
+		m_volume(this),
+		m_rigidbody(this)
+	{
+		m_transform.SetPosition(Math::SIMDVector(position.x, position.y, position.z));
+	}
+
+	CHeadlessBody::~CHeadlessBody()
+	{
+	}
+
+	void CHeadlessBody::Initialize()
+	{
+		{ // Setup the rigid body.
+			Physics::CRigidbody::Data data { };
+			data.SetMass(1.0f);
+			data.damping = 0.95f;
+			data.pVolume = &m_volume;
+			m_rigidbody.SetData(data);
+		}
+
+		{ // Setup the collider.
+			Physics::CVolumeSphere::Data data { };
+			data.radius = m_radius;
+			data.colliderType = Physics::ColliderType::Collider;
+			data.pRigidbody = &m_rigidbody;
+			m_volume.SetData(data);
+
+			// The transform isn't calculated until the next core update, so the collider is placed from the spawn position.
+			m_volume.Register(Math::SIMDMatrix::Translate(m_transform.GetPosition()));
+		}
+	}
+
+	// Called after each physics step.
+	void CHeadlessBody::LateUpdate()
+	{
+		m_rigidbody.UpdateTransform(m_transform);
+	}
+
+	void CHeadlessBody::Release()
+	{
+		m_volume.Deregister();
+	}
+};
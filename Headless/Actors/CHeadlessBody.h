@@ -0,0 +1,49 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Console Application: Headless Runner
+//
+// File: Actors/CHeadlessBody.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CHEADLESSBODY_H
+#define CHEADLESSBODY_H
+
+#include <Objects/CVObject.h>
+#include <Logic/CTransform.h>
+#include <Physics/CVolumeSphere.h>
+#include <Physics/CRigidbody.h>
+#include <Math/CMathVector3.h>
+
+namespace Actor
+{
+	// A rigid sphere spawned by a scenario. Physics keys its objects by name, so every body needs a unique one.
+	class CHeadlessBody : public CVObject
+	{
+	public:
+		CHeadlessBody(const std::wstring& name, const Math::Vector3& position, float radius);
+		~CHeadlessBody();
+		CHeadlessBody(const CHeadlessBody&) = delete;
+		CHeadlessBody(CHeadlessBody&&) = delete;
+		CHeadlessBody& operator = (const CHeadlessBody&) = delete;
+		CHeadlessBody& operator = (CHeadlessBody&&) = delete;
+
+		void Initialize() final;
+		void LateUpdate() final;
+		void Release() final;
+
+		// Accessors.
+		inline const Math::SIMDVector& GetSolverPosition() const { return m_rigidbody.GetSolverPosition(); }
+
+	private:
+		float m_radius;
+
+		Logic::CTransform m_transform;
+		Physics::CVolumeSphere m_volume;
+		Physics::CRigidbody m_rigidbody;
+	};
+};
+
+#endif
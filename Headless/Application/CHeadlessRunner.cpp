@@ -0,0 +1,834 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Console Application: Headless Runner
+//
+// File: Application/CHeadlessRunner.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CHeadlessRunner.h"
+#include <Application/CSceneManager.h>
+#include <Application/CCommandManager.h>
+#include <Application/CCoreManager.h>
+#include <Factory/CFactory.h>
+#include <Logic/CNodeTransform.h>
+#include <Physics/CPhysics.h>
+#include <Universe/CUniverseManager.h>
+#include <Universe/CChunkManager.h>
+#include <Universe/CChunk.h>
+#include <Utilities/CJobSystem.h>
+#include <Utilities/CTimer.h>
+#include <Utilities/CFrameAllocator.h>
+#include <Utilities/CAllocTracker.h>
+#include <Utilities/CProfiler.h>
+#include <Utilities/CMetrics.h>
+#include <Utilities/CFileSystem.h>
+#include <Math/CMathFloat.h>
+#include <Math/CMathFNV.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <tuple>
+
+namespace App
+{
+	namespace
+	{
+		const char* PHASE_NAME_LIST[] = {
+			"commands",
+			"transforms",
+			"physics",
+			"chunks",
+			"audio",
+			"total",
+		};
+
+		// Integer hashing keeps the terrain identical across compilers and instruction sets, which floating point noise wouldn't.
+		inline u32 Hash(u32 seed, int x, int z)
+		{
+			u32 h = seed ^ 0x9E3779B9;
+			h = (h ^ static_cast<u32>(x)) * 0x85EBCA6B;
+			h = (h ^ static_cast<u32>(z)) * 0xC2B2AE35;
+			h ^= h >> 16;
+			return h;
+		}
+
+		inline float Elapsed(const std::chrono::steady_clock::time_point& start)
+		{
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+	};
+
+	CHeadlessRunner::CHeadlessRunner() :
+		CVObject(L"Headless Runner"),
+		m_data { },
+		m_cameraTransform(this),
+		m_camera(this, &m_cameraTransform),
+		m_chunkNode(L"Headless Chunk Node", 0),
+		m_eventIndex(0)
+	{
+	}
+
+	CHeadlessRunner::~CHeadlessRunner()
+	{
+	}
+
+	void CHeadlessRunner::Initialize()
+	{
+		const CScenario& scenario = *m_data.pScenario;
+
+		// Must come first, as the job system creates its graphics workers on initialization.
+		CFactory::Instance().SetHeadless(true);
+		Util::CTimer::Instance().SetFixedDelta(scenario.GetTimestep());
+
+		Util::CFileSystem::Instance().NewPath(m_data.outputPath.c_str());
+
+		if(m_data.bAllocs || !scenario.GetAllocBudgetList().empty()) Util::CAllocTracker::SetTagging(true);
+		if(m_data.bTrace) Util::CProfiler::StartCapture();
+		if(m_data.bMetrics) Util::CMetrics::Instance().OpenSink(m_data.outputPath + L"/metrics.csv");
+
+		PROFILE_THREAD("Main");
+
+		Util::CJobSystem::Instance().Initialize();
+		Logic::CNodeTransform::Get().SetParallelFor([](u32 count, u32 batchSize, std::function<void(u32, u32)> func){
+			Util::CJobSystem::Instance().ParallelFor(count, batchSize, func);
+		});
+		App::CCoreManager::Instance().NodeRegistry().SetParallelFor([](u32 count, u32 batchSize, std::function<void(u32, u32)> func){
+			Util::CJobSystem::Instance().ParallelFor(count, batchSize, func);
+		});
+
+		CCommandManager::Instance().Initialize();
+		CSceneManager::Instance().AudioMixer().Intialize();
+
+		{ // Setup the physics system. Its thread isn't started, as the runner steps it once a frame.
+			Physics::CPhysics::Data data { };
+			data.targetFPS = 1.0f / scenario.GetTimestep();
+			data.idleIterations = 4;
+			data.rayCastIterations = 6;
+			data.gravity = Math::SIMD_VEC_DOWN * 20.0f;
+			Physics::CPhysics::Instance().SetData(data);
+		}
+
+		{ // Setup the camera.
+			Logic::CCamera::Data data { };
+			data.projMode = Logic::CAMERA_PROJ_MODE_PERSPECTIVE;
+			data.nearView = 0.1f;
+			data.farView = 256.0f;
+			data.fov = 65.0f * Math::g_PiOver180;
+			data.aspectRatio = 16.0f / 9.0f;
+			m_camera.SetupProjection(data);
+			CSceneManager::Instance().CameraManager().SetDefault(&m_camera);
+
+			UpdateCamera(0);
+		}
+
+		Universe::CChunkManager& chunkManager = CSceneManager::Instance().UniverseManager().ChunkManager();
+
+		{ // Setup the chunk manager. Without materials it still meshes, but never draws.
+			chunkManager.Initialize();
+
+			// The mesh cache would make build timings depend on what earlier runs left on disk, and would write into the user's profile.
+			chunkManager.MeshCache().SetData({ });
+
+			if(scenario.IsLockstep())
+			{ // Edits are applied in full every frame, rather than when there's time left.
+				Universe::CChunkRebuildScheduler::Data data { };
+				data.timeBudget = 60000.0f;
+				chunkManager.RebuildScheduler().SetData(data);
+			}
+
+			for(const CScenario::Bench& bench : scenario.GetBenchList())
+			{
+				if(bench.type == CScenario::BENCH_MESHLETS || bench.type == CScenario::BENCH_OCCLUSION)
+				{
+					chunkManager.SetCameraPathRecording(true);
+				}
+			}
+		}
+
+		CCommandManager::Instance().ProcessActionRegistrationQueue();
+
+		App::CCoreManager::Instance().Initialize();
+		Util::CJobSystem::Instance().Open();
+
+		GenerateChunks();
+		CreateHierarchy();
+
+		// The first frame starts with every chunk built, so its timing isn't the world's initial meshing.
+		chunkManager.Flush();
+		Util::CJobSystem::Instance().Process();
+	}
+
+	void CHeadlessRunner::Release()
+	{
+		for(auto& pBody : m_bodyList)
+		{
+			pBody->Release();
+		}
+
+		m_chunkNode.Release();
+
+		Util::CJobSystem::Instance().Close();
+		CSceneManager::Instance().UniverseManager().ChunkManager().Release();
+		CSceneManager::Instance().Garbage().Release();
+		Util::CJobSystem::Instance().Release();
+		CSceneManager::Instance().AudioMixer().Release();
+		Physics::CPhysics::Instance().Release();
+
+		m_bodyList.clear();
+		m_hierarchyList.clear();
+
+		Util::CMetrics::Instance().CloseSink();
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Frame methods.
+	//-----------------------------------------------------------------------------------------------
+
+	int CHeadlessRunner::Run()
+	{
+		const u32 frameCount = m_data.pScenario->GetFrameCount();
+		m_frameTimeList.reserve(frameCount);
+
+		for(u32 frame = 0; frame < frameCount; ++frame)
+		{
+			Frame(frame);
+		}
+
+		return WriteReport();
+	}
+
+	// Updates each system in the order the scene manager would, and times each.
+	void CHeadlessRunner::Frame(u32 frame)
+	{
+		const CScenario& scenario = *m_data.pScenario;
+		std::array<float, PHASE_COUNT> timeList { };
+
+		const auto frameStart = std::chrono::steady_clock::now();
+		Util::CTimer::Instance().Tick();
+
+		{ // Scenario events.
+			PROFILE_ZONE("Commands");
+			const auto start = std::chrono::steady_clock::now();
+
+			const std::vector<CScenario::Event>& eventList = scenario.GetEventList();
+			for(; m_eventIndex < eventList.size() && eventList[m_eventIndex].frame <= frame; ++m_eventIndex)
+			{
+				ProcessEvent(eventList[m_eventIndex]);
+			}
+
+			timeList[PHASE_COMMANDS] = Elapsed(start);
+		}
+
+		{ // Transforms, including the camera.
+			PROFILE_ZONE("Transforms");
+			const auto start = std::chrono::steady_clock::now();
+
+			UpdateCamera(frame);
+
+			const u32 depth = scenario.GetHierarchyDepth();
+			const float angle = static_cast<float>(frame) * scenario.GetTimestep();
+			for(size_t i = 0; i < m_hierarchyList.size(); i += depth)
+			{
+				m_hierarchyList[i]->SetEuler(Math::SIMDVector(0.0f, angle, 0.0f));
+			}
+
+			App::CCoreManager::Instance().Update();
+			App::CCoreManager::Instance().LateUpdate();
+
+			timeList[PHASE_TRANSFORMS] = Elapsed(start);
+		}
+
+		{ // Physics.
+			PROFILE_ZONE("Physics");
+			const auto start = std::chrono::steady_clock::now();
+
+			Physics::CPhysics::Instance().Step();
+
+			for(auto& pBody : m_bodyList)
+			{
+				pBody->LateUpdate();
+			}
+
+			timeList[PHASE_PHYSICS] = Elapsed(start);
+		}
+
+		{ // Chunks.
+			PROFILE_ZONE("Chunks");
+			const auto start = std::chrono::steady_clock::now();
+
+			m_chunkNode.LateUpdate();
+
+			Universe::CChunkManager& chunkManager = CSceneManager::Instance().UniverseManager().ChunkManager();
+			chunkManager.LateUpdate();
+
+			if(scenario.IsLockstep())
+			{
+				chunkManager.Flush();
+			}
+
+			timeList[PHASE_CHUNKS] = Elapsed(start);
+		}
+
+		{ // Audio.
+			PROFILE_ZONE("Audio");
+			const auto start = std::chrono::steady_clock::now();
+
+			CSceneManager::Instance().AudioMixer().Update();
+
+			timeList[PHASE_AUDIO] = Elapsed(start);
+		}
+
+		CSceneManager::Instance().Garbage().Process();
+		Util::CJobSystem::Instance().Process();
+
+		timeList[PHASE_TOTAL] = Elapsed(frameStart);
+		m_frameTimeList.push_back(timeList);
+
+		Util::CAllocTracker::Instance().EndFrame();
+		Util::CAllocTracker::EndTagFrame();
+		PROFILE_FRAME();
+		Util::CFrameAllocator::Instance().Reset();
+		Util::CMetrics::Instance().Update();
+	}
+
+	void CHeadlessRunner::ProcessEvent(const CScenario::Event& e)
+	{
+		switch(e.type)
+		{
+			case CScenario::EVENT_EDIT:
+				EditBlocks(e);
+				break;
+			case CScenario::EVENT_UNDO:
+				CCommandManager::Instance().Execute(CCommandManager::CMD_KEY_UNDO);
+				break;
+			case CScenario::EVENT_REDO:
+				CCommandManager::Instance().Execute(CCommandManager::CMD_KEY_REDO);
+				break;
+			case CScenario::EVENT_SPAWN:
+			{ // Physics keys objects by name, so each body gets its own.
+				const std::wstring name = L"Headless Body " + std::to_wstring(m_bodyList.size());
+				m_bodyList.push_back(std::make_unique<Actor::CHeadlessBody>(name, e.position, e.radius));
+				m_bodyList.back()->Initialize();
+			} break;
+			default:
+				break;
+		}
+	}
+
+	// Builds the same block edit as the chunk node's interact callback, and skips it in the same cases, so replays record the same undo history.
+	void CHeadlessRunner::EditBlocks(const CScenario::Event& e)
+	{
+		const int brushIndices = static_cast<int>(e.size);
+		const int brushHalf = brushIndices >> 1;
+
+		Universe::CChunkManager::ChunkBlockUpdateData data { };
+		data.pChunkNode = &m_chunkNode;
+		data.coordCount = brushIndices * brushIndices * brushIndices;
+
+		bool bEmpty = true;
+		bool bFull = true;
+		short blockId = -1;
+
+		Math::Vector3 mnExtents, mxExtents;
+		m_chunkNode.GetExtentsWorking(mnExtents, mxExtents);
+
+		std::pair<Math::VectorInt3, u32> indices;
+		u32 coordIndex = 0;
+		for(int i = 0; i < brushIndices; ++i)
+		{
+			for(int j = 0; j < brushIndices; ++j)
+			{
+				for(int k = 0; k < brushIndices; ++k, ++coordIndex)
+				{
+					const Math::Vector3 offset(
+						static_cast<float>(i - brushHalf) + e.position.x,
+						static_cast<float>(j - brushHalf) + e.position.y,
+						static_cast<float>(k - brushHalf) + e.position.z
+					);
+
+					const Math::Vector3 realOffset = offset * m_chunkNode.GetBlockSize();
+					if(realOffset.x < mnExtents.x || realOffset.x >= mxExtents.x) continue;
+					if(realOffset.y < mnExtents.y || realOffset.y >= mxExtents.y) continue;
+					if(realOffset.z < mnExtents.z || realOffset.z >= mxExtents.z) continue;
+
+					const Universe::Block lastBlock = m_chunkNode.GetBlock(offset, &indices);
+					if(indices.second == std::numeric_limits<u32>::max()) continue;
+
+					bEmpty &= !lastBlock.bFilled;
+					bFull &= lastBlock.bFilled;
+
+					if(lastBlock.bFilled)
+					{
+						if(blockId < 0)
+						{
+							blockId = lastBlock.id;
+						}
+						else if(blockId != lastBlock.id)
+						{
+							blockId = 256;
+						}
+					}
+
+					Universe::CChunkManager::ChunkBlockUpdateData::Coord& coord = data.coordList[coordIndex];
+					coord.block.id = e.blockId;
+					coord.block.bFilled = e.action == 0 ? false : e.action == 1 ? true : lastBlock.bFilled;
+					coord.chunkCoord = indices.first;
+					coord.blockIndex = indices.second;
+				}
+			}
+		}
+
+		bool bValid = false;
+		switch(e.action)
+		{
+			case 0: bValid = !bEmpty; break; // Erase
+			case 1: bValid = !bFull; break; // Fill
+			case 2: bValid = blockId >= 0 && blockId != e.blockId; break; // Paint
+			default: break;
+		}
+
+		if(bValid)
+		{
+			CCommandManager::Instance().Execute(Universe::CChunkManager::CMD_KEY_BLOCK_EDIT, &data, data.GetSize(), alignof(Universe::CChunkManager::ChunkBlockUpdateData));
+		}
+	}
+
+	// Moves linearly between the keyframes either side of the frame, and holds at either end.
+	void CHeadlessRunner::UpdateCamera(u32 frame)
+	{
+		const std::vector<CScenario::CameraKey>& keyList = m_data.pScenario->GetCameraKeyList();
+		if(keyList.empty()) return;
+
+		size_t next = 0;
+		while(next < keyList.size() && keyList[next].frame <= frame) ++next;
+
+		const CScenario::CameraKey& a = keyList[next == 0 ? 0 : next - 1];
+		const CScenario::CameraKey& b = keyList[next == keyList.size() ? keyList.size() - 1 : next];
+
+		const float t = b.frame > a.frame ? static_cast<float>(frame - a.frame) / static_cast<float>(b.frame - a.frame) : 0.0f;
+		const float tc = std::clamp(t, 0.0f, 1.0f);
+
+		const Math::Vector3 position = a.position + (b.position - a.position) * tc;
+		const float pitch = a.pitch + (b.pitch - a.pitch) * tc;
+		const float yaw = a.yaw + (b.yaw - a.yaw) * tc;
+
+		m_cameraTransform.SetPosition(Math::SIMDVector(position.x, position.y, position.z));
+		m_cameraTransform.SetEuler(Math::SIMDVector(pitch * Math::g_PiOver180, yaw * Math::g_PiOver180, 0.0f));
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// World methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// Fills the chunk range with seeded terrain, a layer of dirt over stone, with the working extents set to cover it.
+	void CHeadlessRunner::GenerateChunks()
+	{
+		const CScenario& scenario = *m_data.pScenario;
+		const Math::VectorInt3& mn = scenario.GetChunkMin();
+		const Math::VectorInt3& mx = scenario.GetChunkMax();
+
+		m_chunkNode.SetData(Universe::CChunkNode::Data { });
+		m_chunkNode.Initialize();
+
+		const Math::Vector3 chunkSize = m_chunkNode.GetChunkSize();
+		m_chunkNode.SetExtentsWorkspace(
+			Math::Vector3(mn.x * chunkSize.x, mn.y * chunkSize.y, mn.z * chunkSize.z),
+			Math::Vector3((mx.x + 1) * chunkSize.x, (mx.y + 1) * chunkSize.y, (mx.z + 1) * chunkSize.z)
+		);
+		m_chunkNode.SetWorkspaceActive(true);
+
+		const int width = static_cast<int>(m_chunkNode.GetBlockCountX());
+		const int height = static_cast<int>(m_chunkNode.GetBlockCountY());
+		const int length = static_cast<int>(m_chunkNode.GetBlockCountZ());
+		const u32 seed = scenario.GetSeed();
+
+		for(int x = mn.x; x <= mx.x; ++x)
+		{
+			for(int y = mn.y; y <= mx.y; ++y)
+			{
+				for(int z = mn.z; z <= mx.z; ++z)
+				{
+					Universe::CChunk* pChunk = m_chunkNode.CreateChunk(Math::VectorInt3(x, y, z));
+					pChunk->Set([=](Universe::Block* pBlockList, size_t blockCount){
+						for(int i = 0; i < width; ++i)
+						{
+							for(int k = 0; k < length; ++k)
+							{
+								const int wx = x * width + i;
+								const int wz = z * length + k;
+
+								// Broad hills in steps of eight blocks, with single block roughness on top.
+								const int surface = 12 + static_cast<int>(Hash(seed, wx >> 3, wz >> 3) & 7) + static_cast<int>(Hash(seed + 1, wx, wz) & 1);
+
+								for(int j = 0; j < height; ++j)
+								{
+									const int wy = y * height + j;
+									const bool bFilled = wy < surface;
+									pBlockList[(i * length + k) * height + j] = Universe::Block(static_cast<BlockId>(wy < surface - 3 ? 2 : 1), bFilled);
+								}
+							}
+						}
+					});
+				}
+			}
+		}
+	}
+
+	// Chains of transforms, each a block above its parent, with the roots spread along the x axis.
+	void CHeadlessRunner::CreateHierarchy()
+	{
+		const u32 depth = m_data.pScenario->GetHierarchyDepth();
+		const u32 count = m_data.pScenario->GetHierarchyCount();
+
+		m_hierarchyList.reserve(count);
+		for(u32 i = 0; i < count; ++i)
+		{
+			m_hierarchyList.push_back(std::make_unique<Logic::CTransform>(nullptr));
+			Logic::CTransform* pTransform = m_hierarchyList.back().get();
+
+			if(i % depth == 0)
+			{
+				pTransform->SetPosition(Math::SIMDVector(static_cast<float>(i / depth), 0.0f, 0.0f));
+			}
+			else
+			{
+				pTransform->SetParent(m_hierarchyList[i - 1].get());
+				pTransform->SetLocalPosition(Math::SIMDVector(0.0f, 1.0f, 0.0f));
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------
+	// Report methods.
+	//-----------------------------------------------------------------------------------------------
+
+	// Replays the recorded camera path with occlusion culling off and on, and writes each sample's visible chunks to occlusion.txt. Culling
+	//  must only ever remove chunks, and the scenario's bottom layer of chunks is solid under terrain, so every view that looks down on it
+	//  must hide it behind the layer above. Returns false if any sample breaks either rule.
+	bool CHeadlessRunner::CheckOcclusion(std::ostream& report)
+	{
+		Universe::CChunkManager& chunkManager = CSceneManager::Instance().UniverseManager().ChunkManager();
+		const std::vector<Universe::CChunkMeshlets::CameraSample>& cameraPath = chunkManager.GetCameraPath();
+
+		std::vector<std::vector<Math::VectorInt3>> visibleOffList;
+		std::vector<std::vector<Math::VectorInt3>> visibleOnList;
+		chunkManager.MeasureOcclusion(&m_chunkNode, cameraPath, false, visibleOffList);
+		chunkManager.MeasureOcclusion(&m_chunkNode, cameraPath, true, visibleOnList);
+
+		auto IsLess = [](const Math::VectorInt3& a, const Math::VectorInt3& b){
+			return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+		};
+
+		std::ofstream file(m_data.outputPath + L"/occlusion.txt", std::ios::trunc);
+		auto WriteLine = [&](size_t sample, const char* pMode, const std::vector<Math::VectorInt3>& coordList){
+			file << sample << ' ' << pMode;
+			for(const Math::VectorInt3& coord : coordList)
+			{
+				file << ' ' << coord.x << ',' << coord.y << ',' << coord.z;
+			}
+
+			file << "\n";
+		};
+
+		const s32 bottomLayer = m_data.pScenario->GetChunkMin().y;
+
+		size_t offCount = 0;
+		size_t onCount = 0;
+		size_t downwardCount = 0;
+		size_t failureCount = 0;
+		for(size_t i = 0; i < cameraPath.size(); ++i)
+		{
+			const Universe::CChunkMeshlets::CameraSample& camera = cameraPath[i];
+			const std::vector<Math::VectorInt3>& offList = visibleOffList[i];
+			const std::vector<Math::VectorInt3>& onList = visibleOnList[i];
+
+			WriteLine(i, "off", offList);
+			WriteLine(i, "on", onList);
+			offCount += offList.size();
+			onCount += onList.size();
+
+			// Only the first few failures are listed, as one bad sample tends to drag its neighbours with it.
+			auto Fail = [&](const char* pReason, const Math::VectorInt3& coord){
+				if(failureCount++ < 8)
+				{
+					report << "  Sample " << i << ": " << pReason << " chunk " << coord.x << ',' << coord.y << ',' << coord.z << ", FAIL\n";
+				}
+			};
+
+			// Both sets are sorted, so culling added a chunk if the frustum's set doesn't include the culled one.
+			std::vector<Math::VectorInt3> addedList;
+			std::set_difference(onList.begin(), onList.end(), offList.begin(), offList.end(), std::back_inserter(addedList), IsLess);
+			for(const Math::VectorInt3& coord : addedList)
+			{
+				Fail("culling added", coord);
+			}
+
+			// The top of the view is below the horizon when the top frustum plane's inward normal leans back against the view direction.
+			//  The near plane's normal is the view direction.
+			const float (&topPlane)[4] = camera.planeList[3];
+			const float (&nearPlane)[4] = camera.planeList[4];
+			if(topPlane[0] * nearPlane[0] + topPlane[2] * nearPlane[2] >= 0.0f) continue;
+
+			++downwardCount;
+			for(const Math::VectorInt3& coord : onList)
+			{
+				if(coord.y == bottomLayer) Fail("culling kept bottom layer", coord);
+			}
+		}
+
+		report << "Occlusion: " << cameraPath.size() << " camera samples, " << downwardCount << " looking down; " << offCount <<
+			" chunks inside the frustum, " << onCount << " left after occlusion culling\n";
+		report << "  " << failureCount << " failures, " << (failureCount ? "FAIL" : "pass") << "\n";
+
+		return failureCount == 0;
+	}
+
+	// A hash of the state the scenario should always end in: every block, every body's solved position, and the mesh bytes resident.
+	//  Chunks are combined by addition, so their order in the map doesn't matter.
+	u64 CHeadlessRunner::CalculateDigest()
+	{
+		u64 digest = 0;
+
+		for(auto& chunk : CSceneManager::Instance().UniverseManager().ChunkManager().GetChunkMap(&m_chunkNode))
+		{
+			chunk.second->Read([&](const Universe::Block* pBlockList, size_t blockCount){
+				u64 hash = Math::FNV1a_64(reinterpret_cast<const char*>(&chunk.first), sizeof(Math::VectorInt3));
+				hash ^= Math::FNV1a_64(reinterpret_cast<const char*>(pBlockList), sizeof(Universe::Block) * blockCount);
+				digest += hash;
+			});
+		}
+
+		for(const auto& pBody : m_bodyList)
+		{
+			digest = digest * 0x100000001B3 ^ Math::FNV1a_64(reinterpret_cast<const char*>(pBody->GetSolverPosition().ToFloat()), sizeof(float) * 3);
+		}
+
+		const s64 meshBytes = Util::CMetrics::Instance().GetGauge("chunks.meshBytes")->Get();
+		digest = digest * 0x100000001B3 ^ static_cast<u64>(meshBytes);
+
+		return digest;
+	}
+
+	// Writes the report to the console and report.txt, and each frame's phase times to frames.csv. Budgets are checked against the
+	//  95th percentile, so a single hitch doesn't fail the gate, and allocation budgets against the tag's peak over the whole run and
+	//  its allocations in the last frame.
+	int CHeadlessRunner::WriteReport()
+	{
+		const CScenario& scenario = *m_data.pScenario;
+		Universe::CChunkManager& chunkManager = CSceneManager::Instance().UniverseManager().ChunkManager();
+
+		std::ostringstream report;
+		report << std::fixed << std::setprecision(3);
+
+		int result = 0;
+
+		report << "Frames: " << m_frameTimeList.size() << " at " << scenario.GetTimestep() * 1000.0f << " ms" <<
+			(scenario.IsLockstep() ? ", lockstep" : "") << "\n";
+		report << "Bodies: " << m_bodyList.size() << ", transforms: " << m_hierarchyList.size() << "\n\n";
+
+		std::array<float, PHASE_COUNT> p95List { };
+
+		report << std::left << std::setw(12) << "phase" << std::right << std::setw(10) << "mean" << std::setw(10) << "p50" <<
+			std::setw(10) << "p95" << std::setw(10) << "max" << "\n";
+
+		for(u32 phase = 0; phase < PHASE_COUNT; ++phase)
+		{
+			std::vector<float> timeList;
+			timeList.reserve(m_frameTimeList.size());
+			for(const auto& frameTime : m_frameTimeList)
+			{
+				timeList.push_back(frameTime[phase]);
+			}
+
+			if(timeList.empty()) continue;
+
+			std::sort(timeList.begin(), timeList.end());
+
+			float sum = 0.0f;
+			for(float time : timeList)
+			{
+				sum += time;
+			}
+
+			const size_t last = timeList.size() - 1;
+			p95List[phase] = timeList[last * 95 / 100];
+
+			report << std::left << std::setw(12) << PHASE_NAME_LIST[phase] << std::right << std::setw(10) << sum / timeList.size() <<
+				std::setw(10) << timeList[last / 2] << std::setw(10) << p95List[phase] << std::setw(10) << timeList[last] << "\n";
+		}
+
+		if(!scenario.GetBenchList().empty())
+		{
+			report << "\n";
+		}
+
+		for(const CScenario::Bench& bench : scenario.GetBenchList())
+		{
+			switch(bench.type)
+			{
+				case CScenario::BENCH_SURFACES:
+				{
+					const Universe::CChunk::SurfaceBenchmark benchmark = chunkManager.BenchmarkSurfaces(&m_chunkNode, bench.iterationCount);
+					report << "Surfaces: blocky " << benchmark.blockyTime << " ms, " << benchmark.blockyTriangleCount << " triangles; smooth " <<
+						benchmark.smoothTime << " ms, " << benchmark.smoothTriangleCount << " triangles\n";
+
+					auto WriteStats = [&](const char* pName, const Universe::CChunkMeshOptimizer::Stats& stats){
+						report << "  Optimized " << pName << ": vertices " << stats.vertexCountIn << " -> " << stats.vertexCountOut << ", ACMR " <<
+							stats.acmrIn << " -> " << stats.acmrOut << "\n";
+					};
+
+					WriteStats("blocky", benchmark.blockyStats);
+					WriteStats("smooth", benchmark.smoothStats);
+				} break;
+				case CScenario::BENCH_HIERARCHY:
+				{
+					const Logic::CNodeTransform::HierarchyBenchmark benchmark = Logic::CNodeTransform::Get().BenchmarkHierarchy(bench.count, bench.depth, bench.iterationCount);
+					report << "Hierarchy: " << benchmark.objectCount << " transforms in " << benchmark.layerCount << " layers; serial " <<
+						benchmark.serialTime << " ms, parallel " << benchmark.parallelTime << " ms\n";
+				} break;
+				case CScenario::BENCH_STORAGE:
+				{
+					const Logic::CNodeTransform::StorageBenchmark benchmark = Logic::CNodeTransform::BenchmarkStorage(bench.count, bench.iterationCount);
+					report << "Storage: " << benchmark.objectCount << " transforms; lookup map " << benchmark.mapLookupTime << " ms, pool " <<
+						benchmark.poolLookupTime << " ms, handle " << benchmark.poolHandleLookupTime << " ms; iterate map " << benchmark.mapIterateTime <<
+						" ms, pool " << benchmark.poolIterateTime << " ms\n";
+				} break;
+				case CScenario::BENCH_MESHLETS:
+				{
+					const Universe::CChunkMeshlets::Stats stats = chunkManager.MeasureMeshletCulling(chunkManager.GetCameraPath());
+					report << "Meshlets: " << chunkManager.GetCameraPath().size() << " camera samples; " << stats.meshletDrawCount << " of " <<
+						stats.meshletCount << " clusters drawn in " << stats.rangeCount << " ranges, " << stats.GetCulledRatio() * 100.0f <<
+						"% of triangles culled\n";
+				} break;
+				case CScenario::BENCH_LIGHT:
+				{
+					const Universe::CChunk::LightBenchmark benchmark = chunkManager.BenchmarkLight(&m_chunkNode, bench.count);
+					report << "Light: full relight " << benchmark.computeTime << " ms, " << benchmark.computeVisitCount << " cells visited; " <<
+						benchmark.updateCount << " single block updates " << benchmark.updateTime << " ms, " <<
+						(benchmark.updateCount ? benchmark.updateVisitCount / benchmark.updateCount : 0) << " cells visited each\n";
+				} break;
+				case CScenario::BENCH_OCCLUSION:
+					if(!CheckOcclusion(report)) result = 1;
+					break;
+				default:
+					break;
+			}
+		}
+
+		{ // The digest covers the final world state, so any change in how the scenario plays out changes it.
+			const u64 digest = CalculateDigest();
+			report << "\nDigest: " << std::hex << std::setfill('0') << std::setw(16) << digest;
+
+			if(scenario.HasDigest())
+			{
+				const bool bPass = digest == scenario.GetDigest();
+				report << ", expected " << std::setw(16) << scenario.GetDigest() << ", " << (bPass ? "pass" : "FAIL");
+
+				if(!bPass) result = 1;
+			}
+
+			report << std::dec << std::setfill(' ') << "\n";
+		}
+
+		if(!scenario.GetBudgetList().empty() || !scenario.GetAllocBudgetList().empty())
+		{
+			report << "\n";
+		}
+
+		for(const CScenario::Budget& budget : scenario.GetBudgetList())
+		{
+			const char** ppEnd = PHASE_NAME_LIST + PHASE_COUNT;
+			const char** ppName = std::find_if(PHASE_NAME_LIST, ppEnd, [&](const char* pName){ return budget.phase == pName; });
+
+			if(ppName == ppEnd)
+			{
+				report << "Budget " << budget.phase << ": unknown phase\n";
+				result = 1;
+				continue;
+			}
+
+			const float p95 = p95List[ppName - PHASE_NAME_LIST];
+			const bool bPass = p95 <= budget.p95;
+			report << "Budget " << budget.phase << ": p95 " << p95 << " ms of " << budget.p95 << " ms, " << (bPass ? "pass" : "FAIL") << "\n";
+
+			if(!bPass) result = 1;
+		}
+
+		for(const CScenario::AllocBudget& allocBudget : scenario.GetAllocBudgetList())
+		{
+			u32 tag = 0;
+			while(tag < Util::ALLOC_TAG_COUNT && allocBudget.tag != Util::CAllocTracker::GetTagName(static_cast<Util::ALLOC_TAG>(tag))) ++tag;
+
+			if(tag == Util::ALLOC_TAG_COUNT)
+			{
+				report << "Budget alloc " << allocBudget.tag << ": unknown tag\n";
+				result = 1;
+				continue;
+			}
+
+			if(!Util::CAllocTracker::IsEnabled())
+			{
+				report << "Budget alloc " << allocBudget.tag << ": unchecked, allocations aren't tracked in this build\n";
+				continue;
+			}
+
+			const Util::CAllocTracker::TagBudget budget { static_cast<Util::ALLOC_TAG>(tag), allocBudget.peakBytes, allocBudget.frameAllocCount };
+			const Util::CAllocTracker::TagStats stats = Util::CAllocTracker::GetTagStats(budget.tag);
+			const bool bPass = Util::CAllocTracker::CheckBudget(budget);
+			report << "Budget alloc " << allocBudget.tag << ": peak " << stats.peakBytes << " bytes of " << budget.peakBytesMax << ", last frame " <<
+				stats.frameAllocCount << " allocations of " << budget.frameAllocCountMax << ", " << (bPass ? "pass" : "FAIL") << "\n";
+
+			if(!bPass) result = 1;
+		}
+
+		std::cout << report.str();
+
+		{ // Report.
+			std::ofstream file(m_data.outputPath + L"/report.txt", std::ios::trunc);
+			file << report.str();
+		}
+
+		{ // Frame times.
+			std::ofstream file(m_data.outputPath + L"/frames.csv", std::ios::trunc);
+			file << std::fixed << std::setprecision(4) << "frame";
+			for(u32 phase = 0; phase < PHASE_COUNT; ++phase)
+			{
+				file << ',' << PHASE_NAME_LIST[phase];
+			}
+
+			file << "\n";
+
+			for(size_t i = 0; i < m_frameTimeList.size(); ++i)
+			{
+				file << i;
+				for(float time : m_frameTimeList[i])
+				{
+					file << ',' << time;
+				}
+
+				file << "\n";
+			}
+		}
+
+		if(m_data.bAllocs)
+		{
+			Util::CAllocTracker::DumpCSV(m_data.outputPath + L"/allocs.csv");
+		}
+
+		if(m_data.bTrace)
+		{
+			Util::CProfiler::StopCapture();
+			Util::CProfiler::ExportChromeTrace(m_data.outputPath + L"/trace.json");
+		}
+
+		return result;
+	}
+};
@@ -0,0 +1,110 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Console Application: Headless Runner
+//
+// File: Application/CHeadlessRunner.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CHEADLESSRUNNER_H
+#define CHEADLESSRUNNER_H
+
+#include "CScenario.h"
+#include "../Actors/CHeadlessBody.h"
+#include <Objects/CVObject.h>
+#include <Logic/CCamera.h>
+#include <Logic/CTransform.h>
+#include <Universe/CChunkNode.h>
+#include <array>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace App
+{
+	// Boots Core Engine and the parts of Core Graphics that don't draw, with the factory's null back ends in place of the device and
+	//  audio, then replays a scenario at a fixed timestep and reports how long each phase of the frame took.
+	// There's no scene manager boot, as that loads resources and views that need a device; the runner owns the camera, the chunk node
+	//  and the bodies itself, and updates each system in the order the scene manager would.
+	class CHeadlessRunner : public CVObject
+	{
+	public:
+		enum PHASE
+		{
+			PHASE_COMMANDS,
+			PHASE_TRANSFORMS,
+			PHASE_PHYSICS,
+			PHASE_CHUNKS,
+			PHASE_AUDIO,
+			PHASE_TOTAL,
+			PHASE_COUNT,
+		};
+
+		struct Data
+		{
+			const CScenario* pScenario;
+			std::wstring outputPath; // Directory the report, frame times and any captures are written to.
+			bool bMetrics; // Write metric snapshots to metrics.csv.
+			bool bAllocs; // Tag allocations, and dump them to allocs.csv.
+			bool bTrace; // Capture the profiler, and export it to trace.json.
+		};
+
+	public:
+		static CHeadlessRunner& Instance()
+		{
+			static CHeadlessRunner instance;
+			return instance;
+		}
+
+	private:
+		CHeadlessRunner();
+		~CHeadlessRunner();
+		CHeadlessRunner(const CHeadlessRunner&) = delete;
+		CHeadlessRunner(CHeadlessRunner&&) = delete;
+		CHeadlessRunner& operator = (const CHeadlessRunner&) = delete;
+		CHeadlessRunner& operator = (CHeadlessRunner&&) = delete;
+
+	public:
+		void Initialize() final;
+		void Release() final;
+
+		// Replays every frame of the scenario, runs its benchmarks and writes the report. Returns non-zero if a budget was exceeded, a
+		//  checked bench failed, or the digest differed from the scenario's.
+		int Run();
+
+		// Modifiers.
+		inline void SetData(const Data& data) { m_data = data; }
+
+	private:
+		void Frame(u32 frame);
+		void ProcessEvent(const CScenario::Event& e);
+		void EditBlocks(const CScenario::Event& e);
+		void UpdateCamera(u32 frame);
+
+		void GenerateChunks();
+		void CreateHierarchy();
+
+		bool CheckOcclusion(std::ostream& report);
+		u64 CalculateDigest();
+		int WriteReport();
+
+	private:
+		Data m_data;
+
+		Logic::CTransform m_cameraTransform;
+		Logic::CCamera m_camera;
+
+		Universe::CChunkNode m_chunkNode;
+
+		std::vector<std::unique_ptr<Logic::CTransform>> m_hierarchyList; // Roots are every 'depth'th transform.
+		std::vector<std::unique_ptr<Actor::CHeadlessBody>> m_bodyList;
+
+		size_t m_eventIndex;
+		std::vector<std::array<float, PHASE_COUNT>> m_frameTimeList; // Milliseconds.
+	};
+};
+
+#endif
@@ -0,0 +1,259 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Console Application: Headless Runner
+//
+// File: Application/CScenario.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "CScenario.h"
+#include <Utilities/CConvertUtil.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace App
+{
+	CScenario::CScenario() :
+		m_frameCount(600),
+		m_timestep(1.0f / 60.0f),
+		m_seed(0),
+		m_bLockstep(true),
+		m_chunkMin(0),
+		m_chunkMax(0),
+		m_hierarchyCount(0),
+		m_hierarchyDepth(1),
+		m_bDigest(false),
+		m_digest(0)
+	{
+	}
+
+	CScenario::~CScenario()
+	{
+	}
+
+	bool CScenario::Load(const std::wstring& path)
+	{
+		std::ifstream file(path);
+		if(!file.is_open())
+		{
+			m_error = "Unable to open the scenario file.";
+			return false;
+		}
+
+		std::string line;
+		u32 lineNumber = 0;
+		while(std::getline(file, line))
+		{
+			++lineNumber;
+
+			const size_t comment = line.find('#');
+			if(comment != std::string::npos) line.erase(comment);
+
+			if(!ParseLine(line))
+			{
+				m_error = "Line " + std::to_string(lineNumber) + ": " + m_error;
+				return false;
+			}
+		}
+
+		// Events of the same frame keep their file order, so an edit and its undo can share a frame.
+		std::stable_sort(m_eventList.begin(), m_eventList.end(), [](const Event& a, const Event& b){ return a.frame < b.frame; });
+		std::stable_sort(m_cameraKeyList.begin(), m_cameraKeyList.end(), [](const CameraKey& a, const CameraKey& b){ return a.frame < b.frame; });
+
+		return true;
+	}
+
+	bool CScenario::ParseLine(const std::string& line)
+	{
+		std::vector<std::string> tokenList;
+		{
+			std::istringstream iss(line);
+			std::string token;
+			while(iss >> token)
+			{
+				tokenList.push_back(token);
+			}
+		}
+
+		if(tokenList.empty()) return true;
+
+		auto GetU32 = [&](size_t index, u32& val){
+			long l;
+			if(index >= tokenList.size() || !Util::IsLong(tokenList[index], &l) || l < 0) return false;
+			val = static_cast<u32>(l);
+			return true;
+		};
+
+		auto GetInt = [&](size_t index, int& val){
+			long l;
+			if(index >= tokenList.size() || !Util::IsLong(tokenList[index], &l)) return false;
+			val = static_cast<int>(l);
+			return true;
+		};
+
+		auto GetFloat = [&](size_t index, float& val){
+			return index < tokenList.size() && Util::IsFloat(tokenList[index], &val);
+		};
+
+		auto GetU64 = [&](size_t index, u64& val){
+			if(index >= tokenList.size() || tokenList[index][0] == '-') return false;
+			std::istringstream iss(tokenList[index]);
+			iss >> std::noskipws >> val;
+			return iss.eof() && !iss.fail();
+		};
+
+		auto GetHex = [&](size_t index, u64& val){
+			if(index >= tokenList.size()) return false;
+			std::istringstream iss(tokenList[index]);
+			iss >> std::noskipws >> std::hex >> val;
+			return iss.eof() && !iss.fail();
+		};
+
+		const std::string& command = tokenList[0];
+		bool bValid = false;
+
+		if(command == "frames")
+		{
+			bValid = GetU32(1, m_frameCount);
+		}
+		else if(command == "timestep")
+		{
+			bValid = GetFloat(1, m_timestep) && m_timestep > 0.0f;
+		}
+		else if(command == "seed")
+		{
+			bValid = GetU32(1, m_seed);
+		}
+		else if(command == "lockstep")
+		{
+			u32 bLockstep;
+			bValid = GetU32(1, bLockstep);
+			m_bLockstep = bLockstep != 0;
+		}
+		else if(command == "chunks")
+		{
+			bValid = GetInt(1, m_chunkMin.x) && GetInt(2, m_chunkMin.y) && GetInt(3, m_chunkMin.z) &&
+				GetInt(4, m_chunkMax.x) && GetInt(5, m_chunkMax.y) && GetInt(6, m_chunkMax.z);
+		}
+		else if(command == "hierarchy")
+		{
+			bValid = GetU32(1, m_hierarchyCount) && GetU32(2, m_hierarchyDepth) && m_hierarchyDepth > 0;
+		}
+		else if(command == "camera")
+		{
+			CameraKey key { };
+			bValid = GetU32(1, key.frame) && GetFloat(2, key.position.x) && GetFloat(3, key.position.y) && GetFloat(4, key.position.z) &&
+				GetFloat(5, key.pitch) && GetFloat(6, key.yaw);
+			if(bValid) m_cameraKeyList.push_back(key);
+		}
+		else if(command == "edit")
+		{
+			Event e { };
+			e.type = EVENT_EDIT;
+
+			u32 blockId;
+			bValid = GetU32(1, e.frame) && GetFloat(2, e.position.x) && GetFloat(3, e.position.y) && GetFloat(4, e.position.z) &&
+				GetU32(5, e.size) && (e.size == 1 || e.size == 2 || e.size == 4) && tokenList.size() > 6 && GetU32(7, blockId) && blockId < 256;
+
+			if(bValid)
+			{
+				e.blockId = static_cast<u8>(blockId);
+
+				if(tokenList[6] == "erase") e.action = 0;
+				else if(tokenList[6] == "fill") e.action = 1;
+				else if(tokenList[6] == "paint") e.action = 2;
+				else bValid = false;
+			}
+
+			if(bValid) m_eventList.push_back(e);
+		}
+		else if(command == "undo" || command == "redo")
+		{
+			Event e { };
+			e.type = command == "undo" ? EVENT_UNDO : EVENT_REDO;
+			bValid = GetU32(1, e.frame);
+			if(bValid) m_eventList.push_back(e);
+		}
+		else if(command == "spawn")
+		{
+			Event e { };
+			e.type = EVENT_SPAWN;
+			bValid = GetU32(1, e.frame) && GetFloat(2, e.position.x) && GetFloat(3, e.position.y) && GetFloat(4, e.position.z) &&
+				GetFloat(5, e.radius) && e.radius > 0.0f;
+			if(bValid) m_eventList.push_back(e);
+		}
+		else if(command == "budget")
+		{
+			Budget budget { };
+			bValid = tokenList.size() > 2 && GetFloat(2, budget.p95);
+			if(bValid)
+			{
+				budget.phase = tokenList[1];
+				m_budgetList.push_back(budget);
+			}
+		}
+		else if(command == "allocbudget")
+		{
+			AllocBudget budget { };
+			bValid = tokenList.size() > 3 && GetU64(2, budget.peakBytes) && GetU64(3, budget.frameAllocCount);
+			if(bValid)
+			{
+				budget.tag = tokenList[1];
+				m_allocBudgetList.push_back(budget);
+			}
+		}
+		else if(command == "digest")
+		{
+			bValid = GetHex(1, m_digest);
+			m_bDigest = bValid;
+		}
+		else if(command == "bench" && tokenList.size() > 1)
+		{
+			Bench bench { };
+
+			const std::string& type = tokenList[1];
+			if(type == "surfaces")
+			{
+				bench.type = BENCH_SURFACES;
+				bValid = GetU32(2, bench.iterationCount);
+			}
+			else if(type == "hierarchy")
+			{
+				bench.type = BENCH_HIERARCHY;
+				bValid = GetU32(2, bench.count) && GetU32(3, bench.depth) && GetU32(4, bench.iterationCount);
+			}
+			else if(type == "storage")
+			{
+				bench.type = BENCH_STORAGE;
+				bValid = GetU32(2, bench.count) && GetU32(3, bench.iterationCount);
+			}
+			else if(type == "meshlets")
+			{
+				bench.type = BENCH_MESHLETS;
+				bValid = true;
+			}
+			else if(type == "light")
+			{
+				bench.type = BENCH_LIGHT;
+				bValid = GetU32(2, bench.count);
+			}
+			else if(type == "occlusion")
+			{
+				bench.type = BENCH_OCCLUSION;
+				bValid = true;
+			}
+
+			if(bValid) m_benchList.push_back(bench);
+		}
+
+		if(!bValid)
+		{
+			m_error = "Unable to parse '" + line + "'.";
+		}
+
+		return bValid;
+	}
+};
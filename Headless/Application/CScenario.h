@@ -0,0 +1,171 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Console Application: Headless Runner
+//
+// File: Application/CScenario.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef CSCENARIO_H
+#define CSCENARIO_H
+
+#include <Globals/CGlobals.h>
+#include <Math/CMathVector3.h>
+#include <Math/CMathVectorInt3.h>
+#include <string>
+#include <vector>
+
+namespace App
+{
+	// A scripted run for the headless runner, read from a text file with a command per line and '#' comments:
+	//
+	//  frames N                             Frames to run.
+	//  timestep DT                          Seconds every frame advances by.
+	//  seed S                               Seeds the generated terrain.
+	//  lockstep 0|1                         Finish every chunk build before the frame ends, so results don't depend on thread timing.
+	//  chunks X0 Y0 Z0 X1 Y1 Z1             Generates every chunk coordinate in the inclusive range.
+	//  hierarchy COUNT DEPTH                Transforms in chains DEPTH deep, every root turned each frame.
+	//  camera FRAME X Y Z PITCH YAW         A camera keyframe, in degrees. The camera moves linearly between keyframes.
+	//  edit FRAME X Y Z SIZE fill|erase|paint ID
+	//                                       A block edit through the command manager, with a brush of 1, 2 or 4 blocks a side.
+	//  undo FRAME / redo FRAME
+	//  spawn FRAME X Y Z RADIUS             Drops a rigid sphere.
+	//  budget PHASE MS                      Fails the run if the phase's 95th percentile frame time is over MS milliseconds.
+	//  allocbudget TAG PEAK FRAMEALLOCS     Fails the run if the allocation tag's peak live bytes are over PEAK, or the last frame
+	//                                       made more than FRAMEALLOCS allocations under it. Zero means no limit. Needs a build that
+	//                                       tracks allocations.
+	//  digest HEX                           Fails the run if the digest of the final world state, as the report prints it, isn't HEX.
+	//  bench surfaces ITERATIONS            Benchmarks run once the frames are done.
+	//  bench hierarchy COUNT DEPTH ITERATIONS
+	//  bench storage COUNT ITERATIONS
+	//  bench meshlets                       Measures meshlet culling along the recorded camera path.
+	//  bench light EDITS                    Relights every chunk in full, then times EDITS single block updates in each.
+	//  bench occlusion                      Replays the recorded camera path with occlusion culling off and on, and fails the run if
+	//                                       culling added a chunk, or kept one in the bottom layer of the chunk range in a view looking
+	//                                       down on it. The layers above it have to be solid.
+	class CScenario
+	{
+	public:
+		enum EVENT
+		{
+			EVENT_EDIT,
+			EVENT_UNDO,
+			EVENT_REDO,
+			EVENT_SPAWN,
+		};
+
+		enum BENCH
+		{
+			BENCH_SURFACES,
+			BENCH_HIERARCHY,
+			BENCH_STORAGE,
+			BENCH_MESHLETS,
+			BENCH_LIGHT,
+			BENCH_OCCLUSION,
+		};
+
+		struct Event
+		{
+			EVENT type;
+			u32 frame;
+			Math::Vector3 position;
+			u32 size; // Brush size for edits.
+			u8 action; // 0 erase, 1 fill, 2 paint, as the chunk node's interact callback takes them.
+			u8 blockId;
+			float radius;
+		};
+
+		struct CameraKey
+		{
+			u32 frame;
+			Math::Vector3 position;
+			float pitch; // Degrees.
+			float yaw;
+		};
+
+		struct Budget
+		{
+			std::string phase;
+			float p95;
+		};
+
+		struct AllocBudget
+		{
+			std::string tag; // As CAllocTracker names it.
+			u64 peakBytes;
+			u64 frameAllocCount;
+		};
+
+		struct Bench
+		{
+			BENCH type;
+			u32 count; // Objects for the hierarchy and storage benches, edits per chunk for the light bench.
+			u32 depth;
+			u32 iterationCount;
+		};
+
+	public:
+		CScenario();
+		~CScenario();
+		CScenario(const CScenario&) = delete;
+		CScenario(CScenario&&) = delete;
+		CScenario& operator = (const CScenario&) = delete;
+		CScenario& operator = (CScenario&&) = delete;
+
+		// Returns false, with the line that failed in the error, if the file can't be read.
+		bool Load(const std::wstring& path);
+
+		// Accessors.
+		inline u32 GetFrameCount() const { return m_frameCount; }
+		inline float GetTimestep() const { return m_timestep; }
+		inline u32 GetSeed() const { return m_seed; }
+		inline bool IsLockstep() const { return m_bLockstep; }
+
+		inline const Math::VectorInt3& GetChunkMin() const { return m_chunkMin; }
+		inline const Math::VectorInt3& GetChunkMax() const { return m_chunkMax; }
+
+		inline u32 GetHierarchyCount() const { return m_hierarchyCount; }
+		inline u32 GetHierarchyDepth() const { return m_hierarchyDepth; }
+
+		inline const std::vector<Event>& GetEventList() const { return m_eventList; } // Sorted by frame, in file order within a frame.
+		inline const std::vector<CameraKey>& GetCameraKeyList() const { return m_cameraKeyList; } // Sorted by frame.
+		inline const std::vector<Budget>& GetBudgetList() const { return m_budgetList; }
+		inline const std::vector<AllocBudget>& GetAllocBudgetList() const { return m_allocBudgetList; }
+		inline const std::vector<Bench>& GetBenchList() const { return m_benchList; }
+
+		inline bool HasDigest() const { return m_bDigest; }
+		inline u64 GetDigest() const { return m_digest; }
+
+		inline const std::string& GetError() const { return m_error; }
+
+	private:
+		bool ParseLine(const std::string& line);
+
+	private:
+		u32 m_frameCount;
+		float m_timestep;
+		u32 m_seed;
+		bool m_bLockstep;
+
+		Math::VectorInt3 m_chunkMin;
+		Math::VectorInt3 m_chunkMax;
+
+		u32 m_hierarchyCount;
+		u32 m_hierarchyDepth;
+
+		std::vector<Event> m_eventList;
+		std::vector<CameraKey> m_cameraKeyList;
+		std::vector<Budget> m_budgetList;
+		std::vector<AllocBudget> m_allocBudgetList;
+		std::vector<Bench> m_benchList;
+
+		bool m_bDigest;
+		u64 m_digest;
+
+		std::string m_error;
+	};
+};
+
+#endif
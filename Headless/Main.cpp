@@ -0,0 +1,64 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Console Application: Headless Runner
+//
+// File: Main.cpp
+//
+//-------------------------------------------------------------------------------------------------
+
+#include "Main.h"
+#include "Application/CScenario.h"
+#include "Application/CHeadlessRunner.h"
+#include <Utilities/CTextUtil.h>
+#include <iostream>
+#include <string>
+
+// Replays a scenario without a window or device, for benchmarking the engine's core systems and gating regressions on them.
+//	Usage: Headless <scenario> [-out <directory>] [-metrics] [-allocs] [-trace]
+//	Exits with 1 if a budget in the scenario was exceeded, a checked bench failed or the digest differed, and 2 if the scenario couldn't be run.
+int main(int argc, char* argv[])
+{
+	if(argc < 2)
+	{
+		std::cerr << "Usage: Headless <scenario> [-out <directory>] [-metrics] [-allocs] [-trace]\n";
+		return 2;
+	}
+
+	App::CHeadlessRunner::Data data { };
+	data.outputPath = L".";
+
+	for(int i = 2; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if(arg == "-out" && i + 1 < argc) data.outputPath = Util::s2ws(argv[++i]);
+		else if(arg == "-metrics") data.bMetrics = true;
+		else if(arg == "-allocs") data.bAllocs = true;
+		else if(arg == "-trace") data.bTrace = true;
+		else
+		{
+			std::cerr << "Unknown argument '" << arg << "'.\n";
+			return 2;
+		}
+	}
+
+	App::CScenario scenario;
+	if(!scenario.Load(Util::s2ws(argv[1])))
+	{
+		std::cerr << scenario.GetError() << "\n";
+		return 2;
+	}
+
+	data.pScenario = &scenario;
+
+	App::CHeadlessRunner& runner = App::CHeadlessRunner::Instance();
+	runner.SetData(data);
+	runner.Initialize();
+
+	const int result = runner.Run();
+
+	runner.Release();
+
+	return result;
+}
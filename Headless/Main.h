@@ -0,0 +1,17 @@
+//-------------------------------------------------------------------------------------------------
+//
+// Copyright (c) Ryan Alasandro
+//
+// Console Application: Headless Runner
+//
+// File: Main.h
+//
+//-------------------------------------------------------------------------------------------------
+
+#ifndef MAIN_H
+#define MAIN_H
+
+#pragma comment(lib, "CoreEngine.lib")
+#pragma comment(lib, "CoreGraphics.lib")
+
+#endif
@@ -67,6 +67,7 @@
 		( MATERIAL_UI_VIEW_PT, "Materials/UIViewPt.mat" )
 	
 		( MATERIAL_VOXEL, "Materials/Voxel.mat" )
+		( MATERIAL_VOXEL_TRANSLUCENT, "Materials/VoxelTranslucent.mat" )
 		( MATERIAL_VOXELWIRE, "Materials/VoxelWire.mat" )
 	}
 
@@ -12,12 +12,13 @@
 //#define WIRE
 #endif
 
+#ifndef TRANSLUCENT
+//#define TRANSLUCENT
+#endif
+
 $
 	/* { pSemanticName, semanticIndex, format, inputSlot, alignedByteOffset, inputSlotClass, instanceDataStepRate } */
-	input							( POSITION:0:R32G32B32_FLOAT:0:0:VERTEX:0 )
-	input							( NORMAL:0:R32G32B32_FLOAT:0:12:VERTEX:0 )
-	input							( TANGENT:0:R32G32B32_FLOAT:0:24:VERTEX:0 )
-	input							( TEXCOORD:0:R32G32B32A32_FLOAT:0:36:VERTEX:0 )
+	input							( POSITION:0:R32G32_UINT:0:0:VERTEX:0 )
 	
 	cbv								( CONSTANTS:VERTEX:DYNAMIC )
 	
@@ -42,6 +43,12 @@ $
 	blend							( TRUE:FALSE:SRC_ALPHA:INV_SRC_ALPHA:ADD:SRC_ALPHA:INV_SRC_ALPHA:ADD:NOOP:R|G|B|A )
 #endif
 
+#ifdef TRANSLUCENT
+	depth_write				false
+
+	blend							( TRUE:FALSE:SRC_ALPHA:INV_SRC_ALPHA:ADD:SRC_ALPHA:INV_SRC_ALPHA:ADD:NOOP:R|G|B|A )
+#endif
+
 	topology					TRIANGLELIST
 	color							R32G32B32A32_FLOAT|R32G32B32A32_FLOAT
 	depth							D32_FLOAT
@@ -49,6 +56,25 @@ $
 
 #define TILE_SIZE_X 0.125f
 #define TILE_SIZE_Y 0.03125f
+#define CUTOUT_BIT 0x100
+#define SHADE_SHIFT 9
+#define OFFSET_SHIFT 19
+#define OFFSET_SCALE 0.125f
+#define SMOOTH_BIT 0x80000000
+#define LIGHT_MIN 0.06f
+
+// Brightness of each baked ambient occlusion level, from fully occluded to open.
+static const float AO_LIST[4] = { 0.45f, 0.65f, 0.82f, 1.0f };
+
+// Matches SIDE_NORMAL in CChunkData.h.
+static const float3 AXIS_LIST[6] = {
+	float3(-1.0f, 0.0f, 0.0f),
+	float3( 1.0f, 0.0f, 0.0f),
+	float3( 0.0f,-1.0f, 0.0f),
+	float3( 0.0f, 1.0f, 0.0f),
+	float3( 0.0f, 0.0f,-1.0f),
+	float3( 0.0f, 0.0f, 1.0f),
+};
 
 cbuffer DrawBuffer : register(b0)
 {
@@ -57,12 +83,10 @@ cbuffer DrawBuffer : register(b0)
 	float4x4 Proj;
 };
 
+// Packed chunk vertex. See PackedChunkVertex in CChunkVertex.h.
 struct a2v
 {
-	float4 Position : POSITION;
-	float4 Normal : NORMAL;
-	float4 Tangent : TANGENT;
-	float4 TexCoord : TEXCOORD;
+	uint2 Packed : POSITION;
 };
 
 struct v2p
@@ -70,6 +94,10 @@ struct v2p
 	float4 Position : SV_POSITION;
 	float3 Normal : NORMAL;
 	float4 TexCoord : TEXCOORD;
+	nointerpolation uint Cutout : CUTOUT;
+	nointerpolation uint Smooth : SMOOTH;
+	float Shade : SHADE;
+	float3 WorldPosition : WORLDPOSITION;
 };
 
 struct p2f
@@ -81,16 +109,31 @@ struct p2f
 v2p VShader(in a2v input)
 {
 	v2p output;
+
+	// Smooth surfaces move vertices off the lattice by a signed 4-bit offset per axis, in eighths of a block.
+	const int3 offset = int3(input.Packed.y << 9, input.Packed.y << 5, input.Packed.y << 1) >> 28;
+	const float3 position = float3(input.Packed.x & 0x3F, (input.Packed.x >> 6) & 0x3F, (input.Packed.x >> 12) & 0x3F) + offset * OFFSET_SCALE;
+	const float3 normal = AXIS_LIST[(input.Packed.x >> 18) & 0x7];
+	const float3 tangent = AXIS_LIST[(input.Packed.x >> 21) & 0x7];
+	const float3 bitangent = AXIS_LIST[(input.Packed.x >> 24) & 0x7];
+	const uint id = input.Packed.y & 0xFF;
 	
-	input.Position.w = 1.0f;
-	output.Position = mul(input.Position, World);
+	output.Position = mul(float4(position, 1.0f), World);
+	output.WorldPosition = output.Position.xyz;
 	output.Position.xyz -= float3(View._41, View._42, View._43);
 	output.Position.xyz = mul(output.Position.xyz, transpose((float3x3)View));
 	output.Position = mul(output.Position, Proj);
 
-	output.Normal.xyz = mul(input.Normal.xyz, (float3x3)World);
+	output.Normal.xyz = mul(normal, (float3x3)World);
 
-	output.TexCoord = input.TexCoord;
+	output.TexCoord = float4(dot(tangent, position), dot(bitangent, position), (id % 8) * TILE_SIZE_X, (id / 8) * TILE_SIZE_Y);
+	output.Cutout = input.Packed.y & CUTOUT_BIT;
+	output.Smooth = input.Packed.y & SMOOTH_BIT;
+
+	// Baked ambient occlusion (2 bits), then sky and block light (4 bits each). The brighter of the two lights the vertex.
+	const uint shade = input.Packed.y >> SHADE_SHIFT;
+	const float light = max((shade >> 2) & 0xF, (shade >> 6) & 0xF) / 15.0f;
+	output.Shade = AO_LIST[shade & 0x3] * lerp(LIGHT_MIN, 1.0f, light);
 
 	return output;
 }
@@ -107,6 +150,11 @@ p2f PShader(in v2p input)
 #ifndef WIRE
 	float2 texCoord = frac(input.TexCoord.xy) * float2(TILE_SIZE_X - 2e-4f, TILE_SIZE_Y - 2e-4f) + input.TexCoord.zw + 1e-4f;
 	output.Color = saturate(diffuse_texture.Sample(g_sampler, texCoord));
+
+	// Cutout blocks are drawn with the opaque pass, so texels are either kept or discarded.
+	if(input.Cutout) clip(output.Color.a - 0.5f);
+
+	output.Color.rgb *= input.Shade;
 #endif
 
 #ifdef WIRE
@@ -114,5 +162,16 @@ p2f PShader(in v2p input)
 #endif
 
 	output.Normal = float4(normalize(input.Normal.xyz), 0.0f);
+
+	if(input.Smooth)
+	{ // Smooth triangles are lit with their own face normal, turned to the same side as the lattice face they were moved from.
+		const float3 faceNormal = normalize(cross(ddy(input.WorldPosition), ddx(input.WorldPosition)));
+		output.Normal.xyz = dot(faceNormal, output.Normal.xyz) < 0.0f ? -faceNormal : faceNormal;
+	}
+
+#ifdef TRANSLUCENT
+	// Blending uses each target's own alpha, so the normal is blended by the surface's coverage too.
+	output.Normal.w = output.Color.a;
+#endif
 	return output;
 }
@@ -68,5 +68,17 @@ namespace App
 			data.viewHash = 0;
 			CSceneManager::Instance().UniverseManager().ChunkManager().SetData(data);
 		}
+
+		{ // Setup automatic chunk LOD selection.
+			Universe::CChunkLODPolicy::Data data { };
+			data.bEnabled = true;
+			CSceneManager::Instance().UniverseManager().ChunkManager().LODPolicy().SetData(data);
+		}
+
+		{ // Setup chunk occlusion culling.
+			Universe::CChunkOcclusion::Data data { };
+			data.bEnabled = true;
+			CSceneManager::Instance().UniverseManager().ChunkManager().Occlusion().SetData(data);
+		}
 	}
 };
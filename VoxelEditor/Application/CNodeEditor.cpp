@@ -99,7 +99,7 @@ namespace App
 					static const u32 viewHash = Math::FNV1a_32("View");
 					static const u32 projHash = Math::FNV1a_32("Proj");
 
-					auto& transform = *reinterpret_cast<Logic::CNodeTransform::Data*>(App::CCoreManager::Instance().NodeRegistry().GetComponentFromObject(Logic::CNodeTransform::HASH, m_rootNode.GetSelectedObject()->GetHash()));
+					auto& transform = *reinterpret_cast<Logic::CNodeTransform::Data*>(App::CCoreManager::Instance().NodeRegistry().GetComponentFromObject(Logic::CNodeTransform::HASH, m_rootNode.GetSelectedObject()->GetHandle()));
 
 					pMaterial->SetFloat(matrixBufferHash, worldHash, transform.GetWorldMatrix().f32, 16);
 					pMaterial->SetFloat(matrixBufferHash, viewHash, App::CSceneManager::Instance().CameraManager().GetDefaultCamera()->GetViewMatrixInv().f32, 16);
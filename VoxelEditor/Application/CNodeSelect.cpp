@@ -254,7 +254,7 @@ namespace App
 	{
 		// Cast ray for picking.
 		Physics::QueryRay ray { };
-		ray.callback = [this](const std::vector<Physics::RaycastInfo>& contacts){
+		ray.callback = [this](const std::pmr::vector<Physics::RaycastInfo>& contacts){
 			const Physics::RaycastInfo* pRaycastInfo = nullptr;
 
 			for(size_t i = 0; i < contacts.size(); ++i)